@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "Action.hpp"
+#include "Board.hpp"
+
+namespace catan_game {
+
+    Action makeAction(ActionOpcode opcode, size_t seat, int target)
+    {
+        return Action{opcode, static_cast<uint8_t>(seat), static_cast<uint16_t>(target), makeResourceVector(0, 0, 0, 0, 0)};
+    }
+
+    bool isBoardVertex(int row, int col)
+    {
+        return !Board::isOutOfBound(row, col);
+    }
+
+    int encodeVertex(int row, int col)
+    {
+        if(!isBoardVertex(row, col)) return -1;
+        return row * NUM_MATRIX_COLS + col;
+    }
+
+    bool decodeVertex(int vertexId, int& row, int& col)
+    {
+        if(vertexId < 0) return false;
+        row = vertexId / NUM_MATRIX_COLS;
+        col = vertexId % NUM_MATRIX_COLS;
+        return isBoardVertex(row, col);
+    }
+
+    // Same adjacency as the board - left/right in the row, and down from a vertex with an even row+col
+    int encodeEdge(int fromRow, int fromCol, int toRow, int toCol)
+    {
+        if(!isBoardVertex(fromRow, fromCol) || !isBoardVertex(toRow, toCol)) return -1;
+
+        if(fromRow == toRow && std::abs(fromCol - toCol) == 1)
+        {
+            return 2 * encodeVertex(fromRow, std::min(fromCol, toCol));
+        }
+
+        int upperRow = std::min(fromRow, toRow);
+        if(fromCol == toCol && std::abs(fromRow - toRow) == 1 && (upperRow + fromCol) % 2 == 0)
+        {
+            return 2 * encodeVertex(upperRow, fromCol) + 1;
+        }
+        return -1;
+    }
+
+    bool decodeEdge(int edgeId, int& fromRow, int& fromCol, int& toRow, int& toCol)
+    {
+        if(edgeId < 0 || !decodeVertex(edgeId / 2, fromRow, fromCol)) return false;
+
+        bool isVertical = (edgeId % 2) == 1;
+        toRow = isVertical ? fromRow + 1 : fromRow;
+        toCol = isVertical ? fromCol : fromCol + 1;
+        return encodeEdge(fromRow, fromCol, toRow, toCol) == edgeId;
+    }
+
+    int robberTarget(int tileIndex, int victimSeat)
+    {
+        return (tileIndex & 0xFF) | ((victimSeat + 1) << 8);
+    }
+
+    int robberTileOf(const Action& action)
+    {
+        return action.target & 0xFF;
+    }
+
+    int robberVictimOf(const Action& action)
+    {
+        return (action.target >> 8) - 1;
+    }
+
+    ResourceVector toTradeResources(const ResourceVector& give, const ResourceVector& want)
+    {
+        return give - want;
+    }
+
+    void splitTradeResources(const ResourceVector& resources, ResourceVector& give, ResourceVector& want)
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            give[type] = std::max(resources[type], 0);
+            want[type] = std::max(-resources[type], 0);
+        }
+    }
+
+    // true when the vector gives something and wants something
+    static bool isTradeResources(const ResourceVector& resources)
+    {
+        bool gives = false, wants = false;
+        for(int amount: resources.amounts)
+        {
+            gives = gives || amount > 0;
+            wants = wants || amount < 0;
+        }
+        return gives && wants;
+    }
+
+    void encodeAction(const Action& action, uint8_t* out)
+    {
+        out[0] = static_cast<uint8_t>(action.opcode);
+        out[1] = action.seat;
+        out[2] = static_cast<uint8_t>(action.target & 0xFF);
+        out[3] = static_cast<uint8_t>(action.target >> 8);
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            out[4 + type] = static_cast<uint8_t>(static_cast<int8_t>(action.resources[type]));
+        }
+        out[9] = 0;
+    }
+
+    bool decodeAction(const uint8_t* in, Action& action)
+    {
+        if(in[0] >= static_cast<uint8_t>(ActionOpcode::Count)) return false;
+
+        action.opcode = static_cast<ActionOpcode>(in[0]);
+        action.seat = in[1];
+        action.target = static_cast<uint16_t>(in[2] | (in[3] << 8));
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            action.resources[type] = static_cast<int8_t>(in[4 + type]);
+        }
+        return true;
+    }
+
+    ActionStatus validateAction(const Action& action, size_t numOfSeats)
+    {
+        if(action.seat >= numOfSeats) return ActionStatus::MalformedAction;
+        for(int amount: action.resources.amounts)
+        {
+            if(amount < INT8_MIN || amount > INT8_MAX) return ActionStatus::MalformedAction; // must fit the frame
+        }
+
+        int row, col, toRow, toCol;
+        switch(action.opcode)
+        {
+            case ActionOpcode::RollDice:
+            case ActionOpcode::EndTurn:
+            case ActionOpcode::BuyDevelopmentCard:
+            case ActionOpcode::PlayKnight:
+            case ActionOpcode::PlayRoadBuilding:
+                return (action.target == 0 && action.resources.isZero()) ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::BuildRoad:
+                return (decodeEdge(action.target, row, col, toRow, toCol) && action.resources.isZero())
+                        ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::BuildSettlement:
+            case ActionOpcode::BuildCity:
+                return (decodeVertex(action.target, row, col) && action.resources.isZero())
+                        ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::Discard:
+                return (action.target == 0 && action.resources.isNonNegative() && action.resources.total() > 0)
+                        ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::PostTrade:
+                return (action.target <= numOfSeats && isTradeResources(action.resources))
+                        ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::BankTrade:
+                return (action.target == 0 && isTradeResources(action.resources)) ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::MoveRobber:
+                return (robberVictimOf(action) < static_cast<int>(numOfSeats) && action.resources.isZero())
+                        ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::AcceptTrade:
+            case ActionOpcode::CancelTrade:
+                return (action.target > 0 && action.resources.isZero()) ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::PlayMonopoly:
+                return (action.target < NUM_RESOURCE_TYPES && action.resources.isZero()) ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            case ActionOpcode::PlayYearOfPlenty:
+                return (action.target == 0 && action.resources.isNonNegative() && action.resources.total() == YEAR_OF_PLENTY_CARDS)
+                        ? ActionStatus::Ok : ActionStatus::MalformedAction;
+
+            default:
+                return ActionStatus::MalformedAction; // server frames are never accepted from a client
+        }
+    }
+
+    // read the next integer of the text, false when there is none
+    static bool parseInt(const char*& text, int& value)
+    {
+        char* end = nullptr;
+        long number = std::strtol(text, &end, 10);
+        if(end == text) return false;
+        value = static_cast<int>(number);
+        text = end;
+        return true;
+    }
+
+    // true when the text starts with the word (followed by a space or the end)
+    static bool startsWithWord(const char*& text, const char* word)
+    {
+        size_t length = std::strlen(word);
+        if(std::strncmp(text, word, length) != 0 || (text[length] != '\0' && text[length] != ' ')) return false;
+        text += length;
+        return true;
+    }
+
+    bool parseAction(const char* text, size_t seat, Action& action)
+    {
+        action = makeAction(ActionOpcode::None, seat);
+        const char* start = text;
+        int row, col, toRow, toCol;
+
+        if(startsWithWord(text, "ROLL"))
+        {
+            action.opcode = ActionOpcode::RollDice;
+        }
+        else if(startsWithWord(text, "END"))
+        {
+            action.opcode = ActionOpcode::EndTurn;
+        }
+        else if(startsWithWord(text, "BUY"))
+        {
+            action.opcode = ActionOpcode::BuyDevelopmentCard;
+        }
+        else if(startsWithWord(text, "KNIGHT"))
+        {
+            action.opcode = ActionOpcode::PlayKnight;
+        }
+        else if(startsWithWord(text, "ROADS"))
+        {
+            action.opcode = ActionOpcode::PlayRoadBuilding;
+        }
+        else if(startsWithWord(text, "ROBBER"))
+        {
+            action.opcode = ActionOpcode::MoveRobber;
+            int tileIndex, victimSeat;
+            if(!parseInt(text, tileIndex) || !parseInt(text, victimSeat)) return false;
+            if(tileIndex < 0 || tileIndex > 0xFF || victimSeat < -1 || victimSeat > 254) return false;
+            action.target = static_cast<uint16_t>(robberTarget(tileIndex, victimSeat));
+        }
+        else if(startsWithWord(text, "SETTLE") || startsWithWord(text, "CITY"))
+        {
+            action.opcode = (std::strncmp(start, "CITY", 4) == 0) ? ActionOpcode::BuildCity : ActionOpcode::BuildSettlement;
+            if(!parseInt(text, row) || !parseInt(text, col)) return false;
+            int vertexId = encodeVertex(row, col);
+            if(vertexId < 0) return false;
+            action.target = static_cast<uint16_t>(vertexId);
+        }
+        else if(startsWithWord(text, "ROAD"))
+        {
+            action.opcode = ActionOpcode::BuildRoad;
+            if(!parseInt(text, row) || !parseInt(text, col) || !parseInt(text, toRow) || !parseInt(text, toCol)) return false;
+            int edgeId = encodeEdge(row, col, toRow, toCol);
+            if(edgeId < 0) return false;
+            action.target = static_cast<uint16_t>(edgeId);
+        }
+        else if(startsWithWord(text, "DISCARD"))
+        {
+            action.opcode = ActionOpcode::Discard;
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(!parseInt(text, action.resources[type])) return false;
+            }
+        }
+        else if(startsWithWord(text, "OFFER"))
+        {
+            action.opcode = ActionOpcode::PostTrade;
+            int toSeat;
+            if(!parseInt(text, toSeat) || toSeat < -1 || toSeat > 254) return false;
+            action.target = static_cast<uint16_t>(toSeat + 1);
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(!parseInt(text, action.resources[type])) return false;
+            }
+        }
+        else if(startsWithWord(text, "BANK"))
+        {
+            action.opcode = ActionOpcode::BankTrade;
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(!parseInt(text, action.resources[type])) return false;
+            }
+        }
+        else if(startsWithWord(text, "MONOPOLY"))
+        {
+            action.opcode = ActionOpcode::PlayMonopoly;
+            int type;
+            if(!parseInt(text, type) || type < 0 || type >= NUM_RESOURCE_TYPES) return false;
+            action.target = static_cast<uint16_t>(type);
+        }
+        else if(startsWithWord(text, "PLENTY"))
+        {
+            action.opcode = ActionOpcode::PlayYearOfPlenty;
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(!parseInt(text, action.resources[type])) return false;
+            }
+        }
+        else if(startsWithWord(text, "ACCEPT") || startsWithWord(text, "CANCEL"))
+        {
+            action.opcode = (std::strncmp(start, "ACCEPT", 6) == 0) ? ActionOpcode::AcceptTrade : ActionOpcode::CancelTrade;
+            int offerId;
+            if(!parseInt(text, offerId) || offerId <= 0 || offerId > 0xFFFF) return false;
+            action.target = static_cast<uint16_t>(offerId);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    static std::string resourcesToString(const ResourceVector& resources)
+    {
+        std::string text;
+        for(int amount: resources.amounts)
+        {
+            text += " " + std::to_string(amount);
+        }
+        return text;
+    }
+
+    std::string actionToString(const Action& action)
+    {
+        int row, col, toRow, toCol;
+        switch(action.opcode)
+        {
+            case ActionOpcode::RollDice:
+                return action.target ? "ROLLED " + std::to_string(action.target) : "ROLL";
+            case ActionOpcode::EndTurn:
+                return "END";
+            case ActionOpcode::BuyDevelopmentCard:
+                return "BUY";
+            case ActionOpcode::BuildSettlement:
+            case ActionOpcode::BuildCity:
+                if(!decodeVertex(action.target, row, col)) break;
+                return std::string(action.opcode == ActionOpcode::BuildCity ? "CITY " : "SETTLE ")
+                        + std::to_string(row) + " " + std::to_string(col);
+            case ActionOpcode::BuildRoad:
+                if(!decodeEdge(action.target, row, col, toRow, toCol)) break;
+                return "ROAD " + std::to_string(row) + " " + std::to_string(col) + " "
+                        + std::to_string(toRow) + " " + std::to_string(toCol);
+            case ActionOpcode::PlayKnight:
+                return "KNIGHT";
+            case ActionOpcode::MoveRobber:
+                return "ROBBER " + std::to_string(robberTileOf(action)) + " " + std::to_string(robberVictimOf(action));
+            case ActionOpcode::Discard:
+                return "DISCARD" + resourcesToString(action.resources);
+            case ActionOpcode::PostTrade:
+                return "OFFER " + std::to_string(static_cast<int>(action.target) - 1) + resourcesToString(action.resources);
+            case ActionOpcode::BankTrade:
+                return "BANK" + resourcesToString(action.resources);
+            case ActionOpcode::AcceptTrade:
+                return "ACCEPT " + std::to_string(action.target);
+            case ActionOpcode::CancelTrade:
+                return "CANCEL " + std::to_string(action.target);
+            case ActionOpcode::PlayMonopoly:
+                return "MONOPOLY " + std::to_string(action.target);
+            case ActionOpcode::PlayYearOfPlenty:
+                return "PLENTY" + resourcesToString(action.resources);
+            case ActionOpcode::PlayRoadBuilding:
+                return "ROADS";
+            case ActionOpcode::Result:
+                return "RESULT " + std::to_string(action.target);
+            case ActionOpcode::Turn:
+                return "TURN " + std::to_string(action.seat) + " " + std::to_string(action.target);
+            case ActionOpcode::Start:
+                return "START " + std::to_string(action.target);
+            case ActionOpcode::Winner:
+                return "WINNER " + std::to_string(action.seat);
+            case ActionOpcode::Left:
+                return "LEFT " + std::to_string(action.seat);
+            case ActionOpcode::Offered:
+                return "OFFERED " + std::to_string(action.seat) + " " + std::to_string(action.target) + resourcesToString(action.resources);
+            case ActionOpcode::Traded:
+                return "TRADED " + std::to_string(action.seat) + " " + std::to_string(action.target) + resourcesToString(action.resources);
+            default:
+                break;
+        }
+        return "UNKNOWN";
+    }
+}
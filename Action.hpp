@@ -0,0 +1,98 @@
+#ifndef ACTION_HPP
+#define ACTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Resources.hpp"
+#include "Game.hpp"
+
+namespace catan_game {
+
+    // Binary action protocol - what clients, logs and bots exchange.
+    // Every action is a fixed ACTION_WIRE_SIZE frame:
+    //   byte 0     opcode
+    //   byte 1     seat
+    //   byte 2-3   target, little endian - vertex id, edge id, dice sum, offer id or status by opcode
+    //   byte 4-8   resource vector as signed bytes (Tree, Clay, Crop, Wool, Iron)
+    //   byte 9     reserved, 0
+    enum class ActionOpcode : uint8_t {
+        None = 0,
+        RollDice,
+        EndTurn,
+        BuildRoad,
+        BuildSettlement,
+        BuildCity,
+        BuyDevelopmentCard,
+        Discard,
+        PostTrade,    // target = to seat + 1 (0 open to all), resources = given positive, wanted negative
+        AcceptTrade,  // target = offer id
+        CancelTrade,  // target = offer id
+        BankTrade,    // resources = given positive, wanted negative
+        PlayKnight,
+        MoveRobber,   // target = tile index in the low byte, victim seat + 1 in the high byte (0 nobody)
+
+        // server to client frames
+        Result,       // target = ActionStatus of the seat's last frame
+        Turn,         // target = GamePhase, seat = current seat
+        Start,        // target = table id
+        Winner,       // seat = winner
+        Left,         // seat = the seat whose connection closed
+        Offered,      // seat = poster, target = new offer id, resources as in PostTrade
+        Traded,       // seat = maker, target = taker, resources = what the maker gave positive, got negative
+
+        // client frames added after the server ones, so the values of the older opcodes stay
+        PlayMonopoly,     // target = the resource type taken from the other seats
+        PlayYearOfPlenty, // resources = the two resources taken from the bank
+        PlayRoadBuilding, // the next ROAD_BUILDING_ROADS roads of the turn are free
+
+        Count
+    };
+
+    constexpr size_t ACTION_WIRE_SIZE = 10;
+
+    struct Action {
+        ActionOpcode opcode;
+        uint8_t seat;
+        uint16_t target;
+        ResourceVector resources;
+    };
+
+    Action makeAction(ActionOpcode opcode, size_t seat, int target = 0);
+
+    // Ids of the board positions, computed from the coordinates without looking at a board.
+    // A vertex is row * columns + column, an edge is twice its anchor vertex (the left end of
+    // a horizontal edge, the upper end of a vertical one) plus 1 when vertical.
+    int encodeVertex(int row, int col);
+    bool decodeVertex(int vertexId, int& row, int& col);
+    int encodeEdge(int fromRow, int fromCol, int toRow, int toCol);
+    bool decodeEdge(int edgeId, int& fromRow, int& fromCol, int& toRow, int& toCol);
+
+    // Target of a MoveRobber frame and its two parts
+    int robberTarget(int tileIndex, int victimSeat);
+    int robberTileOf(const Action& action);
+    int robberVictimOf(const Action& action);
+
+    // true when the coordinates are a vertex of the board
+    bool isBoardVertex(int row, int col);
+
+    // Trade frames carry both sides in one vector - given amounts positive, wanted negative
+    ResourceVector toTradeResources(const ResourceVector& give, const ResourceVector& want);
+    void splitTradeResources(const ResourceVector& resources, ResourceVector& give, ResourceVector& want);
+
+    // Write/read exactly ACTION_WIRE_SIZE bytes, decode fails on unknown opcodes
+    void encodeAction(const Action& action, uint8_t* out);
+    bool decodeAction(const uint8_t* in, Action& action);
+
+    // Structural validation of a client action - opcode, seat, target and resources.
+    // The rules themselves are checked by the game when the action is applied. Never allocates.
+    ActionStatus validateAction(const Action& action, size_t numOfSeats);
+
+    // Text form used by the line protocol and the logs, e.g. "ROAD 0 2 0 3", "DISCARD 1 0 2 0 0"
+    // or "OFFER -1 2 0 0 0 -1" (give 2 Tree for 1 Iron to anybody), "ROBBER 4 1" (tile 4, rob seat 1),
+    // "MONOPOLY 2" (every Crop), "PLENTY 1 0 0 0 1" (a Tree and an Iron)
+    bool parseAction(const char* text, size_t seat, Action& action);
+    std::string actionToString(const Action& action);
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include "Agent.hpp"
+#include "GreedyDiscardPolicy.hpp"
+
+namespace catan_game
+{
+
+    ResourceVector Agent::chooseDiscard(const Game& game, size_t seat, int numOfCards)
+    {
+        return GreedyDiscardPolicy().chooseDiscard(game.getPlayers()[seat]->getResourceVector(), numOfCards);
+    }
+
+    bool Agent::acceptTrade(const Game& game, size_t seat, const TradeOffer& offer)
+    {
+        return false;
+    }
+
+    TileType Agent::chooseMonopoly(const Game& game, size_t seat)
+    {
+        ResourceVector others = makeResourceVector(0, 0, 0, 0, 0);
+        for(size_t other = 0; other < game.getNumOfSeats(); ++other)
+        {
+            if(other != seat) others += game.getPlayers()[other]->getResourceVector();
+        }
+        int best = 0;
+        for(int type = 1; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(others[type] > others[best]) best = type;
+        }
+        return static_cast<TileType>(best);
+    }
+
+    ResourceVector Agent::chooseYearOfPlenty(const Game& game, size_t seat)
+    {
+        ResourceVector hand = game.getPlayers()[seat]->getResourceVector();
+        ResourceVector taken = makeResourceVector(0, 0, 0, 0, 0);
+        for(int card = 0; card < YEAR_OF_PLENTY_CARDS; ++card)
+        {
+            int least = 0;
+            for(int type = 1; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(hand[type] < hand[least]) least = type;
+            }
+            ++hand[least];
+            ++taken[least];
+        }
+        return taken;
+    }
+
+    Action Agent::decide(const Game& game, size_t seat)
+    {
+        GamePhase phase = game.getPhase();
+        if(phase == GamePhase::SetupSettlement || phase == GamePhase::SetupRoad)
+        {
+            return choosePlacement(game, seat);
+        }
+        if(phase == GamePhase::Discard)
+        {
+            Action discard = makeAction(ActionOpcode::Discard, seat);
+            discard.resources = chooseDiscard(game, seat, game.getPendingDiscard(seat));
+            return discard;
+        }
+
+        Action action = chooseAction(game, seat);
+        if(action.opcode == ActionOpcode::PlayMonopoly)
+        {
+            action.target = static_cast<uint16_t>(chooseMonopoly(game, seat));
+        }
+        else if(action.opcode == ActionOpcode::PlayYearOfPlenty)
+        {
+            action.resources = chooseYearOfPlenty(game, seat);
+        }
+        return action;
+    }
+
+    int findTradeTaker(const Game& game, const TradeOffer& offer, std::span<Agent* const> seatAgents)
+    {
+        size_t numOfSeats = std::min(game.getNumOfSeats(), seatAgents.size());
+        for(size_t step = 1; step < numOfSeats; ++step)
+        {
+            size_t seat = (offer.seat + step) % numOfSeats;
+            if(seatAgents[seat] == nullptr) continue;
+
+            Action accept = makeAction(ActionOpcode::AcceptTrade, seat, offer.id);
+            ActionStatus status;
+            game.validate(std::span<const Action>(&accept, 1), std::span<ActionStatus>(&status, 1));
+            if(status == ActionStatus::Ok && seatAgents[seat]->acceptTrade(game, seat, offer)) return static_cast<int>(seat);
+        }
+        return -1;
+    }
+}
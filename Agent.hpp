@@ -0,0 +1,59 @@
+#ifndef AGENT_HPP
+#define AGENT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include "Action.hpp"
+#include "Game.hpp"
+
+namespace catan_game
+{
+    // Plays a seat of a hosted game - the simulator, the tournament and the server's bot seats ask the
+    // agent of the seat through these callbacks. An agent plays one game at a time, hosts that play games
+    // in parallel make one agent per game.
+    class Agent {
+    public:
+
+        virtual ~Agent() {}  // Virtual destructor
+
+        // Called before the game's first action. Agents that draw random numbers seed them from
+        // the game seed, so a seed replays the same game.
+        virtual void startGame(const Game& game, size_t seat, unsigned seed) {}
+
+        // Initial placement - a settlement of the setup draft, then the road leaving it
+        virtual Action choosePlacement(const Game& game, size_t seat) = 0;
+
+        // Turn decision - roll, build, buy, trade, play a card, move the robber or end the turn.
+        // A PlayMonopoly or PlayYearOfPlenty is completed by chooseMonopoly or chooseYearOfPlenty.
+        virtual Action chooseAction(const Game& game, size_t seat) = 0;
+
+        // Discard on 7 - numOfCards of the seat's hand, from the largest piles unless overridden
+        virtual ResourceVector chooseDiscard(const Game& game, size_t seat, int numOfCards);
+
+        // Trade response - true takes the resting offer of another seat. Never by default
+        virtual bool acceptTrade(const Game& game, size_t seat, const TradeOffer& offer);
+
+        // The resource a monopoly takes - by default what the other seats hold most of
+        virtual TileType chooseMonopoly(const Game& game, size_t seat);
+
+        // The YEAR_OF_PLENTY_CARDS resources taken from the bank - by default the ones the seat has least of
+        virtual ResourceVector chooseYearOfPlenty(const Game& game, size_t seat);
+
+        // The seat's next action - the placement, the discard or the turn decision by the game's phase, with the card choice
+        Action decide(const Game& game, size_t seat);
+    };
+
+    // A named source of agents, built-in or loaded from a plugin
+    struct AgentFactory {
+        std::string name;
+        std::function<std::unique_ptr<Agent>()> makeAgent;
+    };
+
+    // The first seat after the offer's own (in turn order) that may take the resting offer and whose agent
+    // accepts it, -1 when none does. Seats without an agent (nullptr) are not asked.
+    int findTradeTaker(const Game& game, const TradeOffer& offer, std::span<Agent* const> seatAgents);
+}
+#endif
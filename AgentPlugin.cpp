@@ -0,0 +1,82 @@
+#include <dlfcn.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include "AgentPlugin.hpp"
+#include "LadderAgent.hpp"
+#include "PluginAgent.hpp"
+
+namespace catan_game
+{
+    // Every plugin of the major version fills at least the callbacks of its first minor version
+    constexpr size_t BASE_API_SIZE = offsetof(CatanAgentApi, chooseYearOfPlenty) + sizeof(CatanAgentApi::chooseYearOfPlenty);
+
+    AgentPlugin::AgentPlugin(const std::string& libraryPath) :
+                    handle(nullptr),
+                    api(),
+                    path(libraryPath)
+    {
+        // a bare name would be searched on the library path, the plugin is the file named
+        std::string openPath = libraryPath.find('/') == std::string::npos ? "./" + libraryPath : libraryPath;
+        this->handle = dlopen(openPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if(this->handle == nullptr)
+        {
+            throw std::runtime_error("Can't load agent plugin " + libraryPath + ": " + dlerror());
+        }
+
+        CatanAgentEntry entry = reinterpret_cast<CatanAgentEntry>(dlsym(this->handle, CATAN_AGENT_ENTRY));
+        const CatanAgentApi* pluginApi = entry == nullptr ? nullptr : entry();
+        std::string problem;
+        if(entry == nullptr) problem = "doesn't export " CATAN_AGENT_ENTRY;
+        else if(pluginApi == nullptr) problem = "returned no api";
+        else if(CATAN_AGENT_ABI_MAJOR_OF(pluginApi->abiVersion) != CATAN_AGENT_ABI_MAJOR)
+        {
+            problem = "was built for agent ABI major version " + std::to_string(CATAN_AGENT_ABI_MAJOR_OF(pluginApi->abiVersion));
+        }
+        else if(pluginApi->apiSize < BASE_API_SIZE) problem = "has a truncated api";
+        else
+        {
+            // a newer minor version of the plugin has callbacks this host doesn't know, an older one leaves ours null
+            std::memcpy(&this->api, pluginApi, std::min<size_t>(pluginApi->apiSize, sizeof(CatanAgentApi)));
+            if(this->api.create == nullptr || this->api.destroy == nullptr ||
+               this->api.choosePlacement == nullptr || this->api.chooseAction == nullptr) problem = "lacks a required callback";
+        }
+        if(!problem.empty())
+        {
+            dlclose(this->handle);
+            throw std::runtime_error("Agent plugin " + libraryPath + " " + problem);
+        }
+    }
+
+    AgentPlugin::~AgentPlugin()
+    {
+        dlclose(this->handle);
+    }
+
+    const CatanAgentApi& AgentPlugin::getApi() const
+    {
+        return this->api;
+    }
+
+    const std::string& AgentPlugin::getPath() const
+    {
+        return this->path;
+    }
+
+    AgentFactory makeAgentFactory(const std::string& spec)
+    {
+        if(spec.find(".so") != std::string::npos)
+        {
+            std::shared_ptr<const AgentPlugin> plugin = std::make_shared<const AgentPlugin>(spec);
+            std::string name = plugin->getApi().name != nullptr ? plugin->getApi().name : spec;
+            return {name, [plugin]() -> std::unique_ptr<Agent> { return std::make_unique<PluginAgent>(plugin); }};
+        }
+        if(makeBuiltinAgent(spec) == nullptr)
+        {
+            throw std::invalid_argument("Unknown bot " + spec);
+        }
+        return {spec, [spec]() { return makeBuiltinAgent(spec); }};
+    }
+}
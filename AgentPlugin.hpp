@@ -0,0 +1,34 @@
+#ifndef AGENTPLUGIN_HPP
+#define AGENTPLUGIN_HPP
+
+#include <string>
+#include "Agent.hpp"
+#include "AgentPluginApi.h"
+
+namespace catan_game
+{
+    // A loaded agent plugin - a shared library exporting CATAN_AGENT_ENTRY. The library stays loaded
+    // while the plugin lives, the agents it made hold on to it.
+    class AgentPlugin {
+    private:
+        void* handle;
+        CatanAgentApi api; // the plugin's callbacks up to its apiSize, the newer ones null
+        std::string path;
+
+    public:
+        // Throws std::runtime_error when the library can't be loaded, doesn't export the entry,
+        // was built against another CATAN_AGENT_ABI_MAJOR or lacks a required callback
+        explicit AgentPlugin(const std::string& libraryPath);
+        ~AgentPlugin();
+        AgentPlugin(const AgentPlugin&) = delete;
+        AgentPlugin& operator=(const AgentPlugin&) = delete;
+
+        const CatanAgentApi& getApi() const;
+        const std::string& getPath() const;
+    };
+
+    // The agents of a bot spec - a built-in name, or the path of a plugin (anything naming a .so file).
+    // Throws std::invalid_argument for an unknown name and std::runtime_error for a plugin that fails to load.
+    AgentFactory makeAgentFactory(const std::string& spec);
+}
+#endif
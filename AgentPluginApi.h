@@ -0,0 +1,121 @@
+#ifndef AGENTPLUGINAPI_H
+#define AGENTPLUGINAPI_H
+
+/* Stable C ABI of agent plugins - a shared library that exports catan_agent_api() can play any seat
+ * of the simulator, the tournament and the server without recompiling the engine.
+ * Only fixed width fields cross the boundary. A new minor version only ever adds fields at the end of
+ * the structs, and each side passes the size of its struct: the host reads no callback past the
+ * plugin's apiSize and a plugin reads no view field past the host's viewSize. The host refuses a
+ * plugin built against another major version. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CATAN_AGENT_ABI_MAJOR 1
+#define CATAN_AGENT_ABI_MINOR 1
+#define CATAN_AGENT_ABI_VERSION ((CATAN_AGENT_ABI_MAJOR << 16) | CATAN_AGENT_ABI_MINOR)
+#define CATAN_AGENT_ABI_MAJOR_OF(version) ((version) >> 16)
+#define CATAN_AGENT_ABI_MINOR_OF(version) ((version) & 0xFFFF)
+
+#define CATAN_MAX_SEATS 8
+#define CATAN_NUM_RESOURCES 5      /* Tree, Clay, Crop, Wool, Iron */
+#define CATAN_NUM_TILES 19         /* the standard board */
+#define CATAN_NUM_VERTEX_IDS 66    /* vertex id = row * 11 + column */
+#define CATAN_NUM_EDGE_IDS 132     /* edge id = 2 * the id of its left or upper vertex, + 1 when vertical */
+#define CATAN_ACTION_SIZE 10       /* the binary action frame of the protocol, see Action.hpp */
+
+/* Frame opcodes a plugin is offered, as ActionOpcode. Byte 1 of a frame is the seat, bytes 2-3 the
+ * little endian target and bytes 4-8 the signed resource amounts. */
+enum {
+    CATAN_OP_ROLL_DICE = 1,
+    CATAN_OP_END_TURN = 2,
+    CATAN_OP_BUILD_ROAD = 3,
+    CATAN_OP_BUILD_SETTLEMENT = 4,
+    CATAN_OP_BUILD_CITY = 5,
+    CATAN_OP_BUY_DEVELOPMENT_CARD = 6,
+    CATAN_OP_POST_TRADE = 8,
+    CATAN_OP_ACCEPT_TRADE = 9,
+    CATAN_OP_CANCEL_TRADE = 10,
+    CATAN_OP_BANK_TRADE = 11,
+    CATAN_OP_PLAY_KNIGHT = 12,
+    CATAN_OP_MOVE_ROBBER = 13,
+    CATAN_OP_PLAY_MONOPOLY = 21,
+    CATAN_OP_PLAY_YEAR_OF_PLENTY = 22,
+    CATAN_OP_PLAY_ROAD_BUILDING = 23   /* since minor version 1 */
+};
+
+/* Game phases, as GamePhase */
+enum {
+    CATAN_PHASE_SETUP_SETTLEMENT = 0,
+    CATAN_PHASE_SETUP_ROAD,
+    CATAN_PHASE_ROLL,
+    CATAN_PHASE_DISCARD,
+    CATAN_PHASE_MOVE_ROBBER,
+    CATAN_PHASE_MAIN,
+    CATAN_PHASE_FINISHED
+};
+
+/* The game as the asked seat sees it, filled by the host before every callback */
+typedef struct CatanGameView {
+    uint32_t abiVersion;           /* CATAN_AGENT_ABI_VERSION of the host */
+    uint32_t viewSize;             /* sizeof(CatanGameView) of the host */
+    uint8_t numOfSeats;
+    uint8_t seat;                  /* the seat asked */
+    uint8_t currentSeat;
+    uint8_t phase;
+    int8_t lastRoll;               /* 0 before the first roll */
+    int8_t winner;                 /* -1 while nobody won */
+    uint8_t robberTile;
+    uint8_t reserved;
+    int16_t points[CATAN_MAX_SEATS];
+    int16_t hands[CATAN_MAX_SEATS][CATAN_NUM_RESOURCES];
+    int16_t developmentCards[CATAN_MAX_SEATS];
+    uint8_t tradeRates[CATAN_NUM_RESOURCES];     /* of the asked seat */
+    uint8_t tileTypes[CATAN_NUM_TILES];          /* a resource, 5 the desert */
+    uint8_t tileNumbers[CATAN_NUM_TILES];        /* 0 the desert */
+    uint8_t vertexOwners[CATAN_NUM_VERTEX_IDS];  /* 0 free or not a vertex, otherwise seat + 1 */
+    uint8_t vertexCities[CATAN_NUM_VERTEX_IDS];  /* 1 when the building is a city */
+    uint8_t roadOwners[CATAN_NUM_EDGE_IDS];      /* 0 free or not an edge, otherwise seat + 1 */
+} CatanGameView;
+
+/* The callbacks of a plugin. create and destroy, choosePlacement and chooseAction are required,
+ * a null optional callback leaves the decision to the host's default. */
+typedef struct CatanAgentApi {
+    uint32_t abiVersion;           /* CATAN_AGENT_ABI_VERSION the plugin was built against */
+    uint32_t apiSize;              /* sizeof(CatanAgentApi) of the plugin */
+    const char* name;
+
+    /* One agent for one game, seeded with the game seed */
+    void* (*create)(uint32_t seat, uint32_t seed);
+    void (*destroy)(void* agent);
+
+    /* Initial placement and turn decision - the index of the chosen one of the numOfLegal frames of
+     * CATAN_ACTION_SIZE bytes, anything else gives up the game. The monopoly and year of plenty frames
+     * carry no choice, the host asks chooseMonopoly and chooseYearOfPlenty when one is chosen. */
+    int32_t (*choosePlacement)(void* agent, const CatanGameView* view, const uint8_t* legalFrames, uint32_t numOfLegal);
+    int32_t (*chooseAction)(void* agent, const CatanGameView* view, const uint8_t* legalFrames, uint32_t numOfLegal);
+
+    /* Discard on 7 - write numOfCards resources of the seat's hand */
+    void (*chooseDiscard)(void* agent, const CatanGameView* view, int32_t numOfCards, int8_t discard[CATAN_NUM_RESOURCES]);
+
+    /* Trade response - non zero takes the offer of fromSeat, who gives `give` for `want` */
+    int32_t (*acceptTrade)(void* agent, const CatanGameView* view, uint32_t fromSeat,
+                           const int8_t give[CATAN_NUM_RESOURCES], const int8_t want[CATAN_NUM_RESOURCES]);
+
+    /* The resource a monopoly takes, and the 2 resources a year of plenty takes from the bank */
+    int32_t (*chooseMonopoly)(void* agent, const CatanGameView* view);
+    void (*chooseYearOfPlenty)(void* agent, const CatanGameView* view, int8_t taken[CATAN_NUM_RESOURCES]);
+} CatanAgentApi;
+
+/* The one symbol a plugin exports */
+#define CATAN_AGENT_ENTRY "catan_agent_api"
+typedef const CatanAgentApi* (*CatanAgentEntry)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,160 +1,203 @@
 #include <algorithm>
 #include <iomanip>
 #include <random>
-#include <ctime>
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include "Vertex.hpp"
 #include "Edge.hpp"
 #include "Board.hpp"
 
-constexpr auto NUM_MATRIX_ROWS = 6;
-constexpr auto NUM_MATRIX_COLS = 11;
-
 namespace catan_game {
 
-    // Static member initialization
-    Board* Board::boardInstance = nullptr;
+    // The layout gets its own stream of the seed, apart from a game's dice and deck
+    static std::minstd_rand layoutEngine(unsigned seed)
+    {
+        std::seed_seq sequence{seed, 0x6c61u};
+        return std::minstd_rand(sequence);
+    }
 
-    // Constructor - private to prevent instantiation
-    Board::Board()      
-    { 
-        initializeVertices(); // Initialize All the vertices of the board
-        deleteAndUpdateInvalidVertex(); // Update the Invalid Verteics and delete the memory allocation
-        updateVertexNeighbors(); // Update the neighbors of the vertices(Valid ones)
-        initializeEdges(); // Initialize the edges of the board
-        initializeTiles(); // Initialize the Tiles of the board and the type of the tiles with random selections
-        assignNumbers(); // Assign the numbers to the tiles on the board - for dice rolls
-        assignVertexToTiles(); // Assign the vertex to the tiles
+    // Bytes the board takes from its arena - the objects, the adjacency vectors (up to 3 neighbours
+    // and 3 edges a vertex, 6 vertices a tile), the board's vectors, the production index (a tile
+    // once) and a quarter more for alignment
+    static size_t arenaSize(int boardRadius)
+    {
+        if(boardRadius < 1) return 0;
+        size_t radius = static_cast<size_t>(boardRadius);
+        size_t numOfTiles = 3 * radius * (radius + 1) + 1;
+        size_t numOfVertices = 6 * (radius + 1) * (radius + 1);
+        size_t numOfEdges = 9 * radius * radius + 15 * radius + 6;
+        size_t numOfCells = (2 * radius + 2) * (4 * radius + 3);
+        size_t bytes = numOfTiles * (sizeof(Tile) + 8 * sizeof(Tile*))
+                     + numOfVertices * (sizeof(Vertex) + 6 * sizeof(void*))
+                     + numOfEdges * (sizeof(Edge) + sizeof(Edge*))
+                     + numOfCells * sizeof(Vertex*) + (2 * radius + 2) * sizeof(std::pmr::vector<Vertex*>)
+                     + numOfEdges * sizeof(Harbor);
+        return bytes + bytes / 4;
     }
 
-    Board::~Board() {
-    for (auto& vertexRow : boardVertices) {
-        for (auto vertex : vertexRow) {
-            if(vertex != nullptr) {
-                delete vertex;
-                vertex = nullptr;
-            }
-        }
+    // An empty tile list a roll, each on the arena - an array member can't take the allocator otherwise
+    template<size_t... Rolls>
+    static std::array<std::pmr::vector<Tile*>, sizeof...(Rolls)> makeProductionIndex(std::pmr::polymorphic_allocator<> allocator,
+                                                                                     std::index_sequence<Rolls...>)
+    {
+        return {((void)Rolls, std::pmr::vector<Tile*>(allocator))...};
     }
 
-    for (auto edge : boardEdges) {
-        if(edge != nullptr)
+    // Constructor - the board is generated for any radius, the standard board (radius 2) has 19 tiles.
+    // The tiles, numbers and harbors are shuffled from the seed only, so a seed always gives the same board
+    Board::Board(int boardRadius, unsigned seed) :
+                    arena(std::max<size_t>(arenaSize(boardRadius), 1)),
+                    allocator(&arena),
+                    radius(boardRadius),
+                    numOfRows(2 * boardRadius + 2),
+                    numOfCols(4 * boardRadius + 3),
+                    boardVertices(allocator),
+                    boardEdges(allocator),
+                    boardTiles(allocator),
+                    boardHarbors(allocator),
+                    productionByRoll(makeProductionIndex(allocator, std::make_index_sequence<MAX_DICE_ROLL + 1>())),
+                    robberTileIndex(-1),
+                    openVertices((2 * boardRadius + 2) * (4 * boardRadius + 3), allocator),
+                    reachableVertices(allocator),
+                    roadFrontiers(allocator)
+    {
+        if(boardRadius < 1)
         {
-            delete edge;
-            edge = nullptr;
+            throw std::invalid_argument("Board radius must be at least 1");
         }
+        std::minstd_rand layoutRng = layoutEngine(seed);
+        initializeTiles(layoutRng); // Initialize the Tiles of the board and the type of the tiles with random selections
+        initializeVertices(); // Create the vertices of every tile from its axial coordinates
+        updateVertexNeighbors(); // Update the neighbors of the vertices
+        initializeEdges(); // Initialize the edges of the board
+        assignNumbers(layoutRng); // Assign the numbers to the tiles on the board - for dice rolls
+        initializeHarbors(layoutRng); // Spread the harbors along the coast
+        indexProduction(); // Index the tiles by their numbers, the robber starts in the desert
+    }
+
+    // Nothing is deleted one by one - the vertices, edges and tiles hold nothing but arena memory,
+    // the arena gives its blocks back when it is destroyed after the other members
+    Board::~Board() {}
+
+    const std::pmr::vector<Tile *> &Board::getTiles() const
+    {
+        return this->boardTiles;
+    }
+
+    const std::pmr::vector<Edge *> &Board::getEdges() const
+    {
+        return this->boardEdges;
+    }
+
+    const std::pmr::vector<Harbor>& Board::getHarbors() const
+    {
+        return this->boardHarbors;
     }
 
-    for (auto tile : boardTiles) {
-        if(tile != nullptr)
+    int Board::getRadius() const
+    {
+        return this->radius;
+    }
+
+    int Board::getNumOfRows() const
+    {
+        return this->numOfRows;
+    }
+
+    int Board::getNumOfCols() const
+    {
+        return this->numOfCols;
+    }
+
+    // return the vertex at the coordinates, nullptr if out of the board
+    Vertex *Board::getVertex(int row, int col) const
+    {
+        if(!isOnBoard(row, col))
         {
-            delete tile;
-            tile = nullptr;
+            return nullptr;
         }
+        return this->boardVertices[row][col];
     }
-}
 
-    // static method - Singleton instance creation/return
-    Board *Board::getBoardInstance()
+    // Hex row r (-radius..radius) of the axial coordinates is tile row r + radius of the matrix,
+    // its tiles lie side by side from this column and each one covers 3 columns of 2 vertex rows
+    static int firstTileColumn(int boardRadius, int tileRow)
     {
-        if(boardInstance == nullptr){
-            boardInstance = new Board();
-        }
-        return boardInstance;
+        return std::abs(tileRow - boardRadius);
     }
 
-    const std::vector<Tile *> &Board::getTiles() const
+    // A vertical edge goes down from the vertices with an even row + col + radius
+    bool Board::isVerticalDown(int row, int col) const
     {
-        return this->boardTiles;
+        return ((row + col + this->radius) % 2) == 0;
     }
 
-    // Initialize the verteics of the board
+    // Create the vertices of every tile - the axial coordinates (q, r) of the tiles satisfy
+    // |q|, |r|, |q + r| <= radius. A vertex shared by tiles is created by the first one only.
     void Board::initializeVertices()
     {
-        boardVertices.resize(NUM_MATRIX_ROWS, std::vector<Vertex*>(NUM_MATRIX_COLS,nullptr));
+        boardVertices.resize(this->numOfRows); // the rows take the arena from the outer vector
+        for(std::pmr::vector<Vertex*>& vertexRow: boardVertices)
+        {
+            vertexRow.assign(this->numOfCols, nullptr);
+        }
 
-        for(int row = 0; row < NUM_MATRIX_ROWS; ++row)
+        size_t numTile = 0;
+        for(int r = -this->radius; r <= this->radius; ++r)
         {
-            for(int col = 0; col < NUM_MATRIX_COLS; ++col)
-            {
-                    boardVertices[row][col] = new Vertex(row, col);
+            int tileRow = r + this->radius;
+            int firstQ = std::max(-this->radius, -r - this->radius);
+            int lastQ = std::min(this->radius, -r + this->radius);
+            for(int q = firstQ; q <= lastQ; ++q)
+            {
+                int firstCol = firstTileColumn(this->radius, tileRow) + 2 * (q - firstQ);
+                Tile* tile = boardTiles[numTile++];
+                for(int col = firstCol; col <= firstCol + 2; ++col)
+                {
+                    for(int row = tileRow; row <= tileRow + 1; ++row)
+                    {
+                        if(boardVertices[row][col] == nullptr)
+                        {
+                            boardVertices[row][col] = allocator.new_object<Vertex>(row, col);
+                            openVertices.set(getCell(row, col));
+                        }
+                        tile->setVertex(boardVertices[row][col]);
+                    }
+                }
             }
         }
-    }       
-    
-    // Update the Invalid Verteics and delete the memory allocation
-    void Board::deleteAndUpdateInvalidVertex()
-    {
-        /* Set the invalid positions */
-        //First row of the matrix
-        int idxMin = 0;  // index of the first column and rows
-        delete boardVertices[idxMin][idxMin];
-        boardVertices[idxMin][idxMin] = nullptr;  // [0][0]
-        delete boardVertices[idxMin][idxMin+1];
-        boardVertices[idxMin][idxMin+1] = nullptr;  // [0][1]
-        delete boardVertices[idxMin][NUM_MATRIX_COLS-2];
-        boardVertices[idxMin][NUM_MATRIX_COLS-2] = nullptr;  // [0][9]
-        delete boardVertices[idxMin][NUM_MATRIX_COLS-1];
-        boardVertices[idxMin][NUM_MATRIX_COLS-1] = nullptr; // [0][10]
-
-        //Second row of the matrix
-        delete boardVertices[idxMin+1][idxMin];
-        boardVertices[idxMin+1][idxMin] = nullptr;  //[1][0]
-        delete boardVertices[idxMin+1][NUM_MATRIX_COLS-1];
-        boardVertices[idxMin+1][NUM_MATRIX_COLS-1] = nullptr; //[1][10]
-
-        //Fifth row of the matrix
-        delete boardVertices[NUM_MATRIX_ROWS-2][idxMin];  //[5][1
-        boardVertices[NUM_MATRIX_ROWS-2][idxMin] = nullptr;  //[5][0]
-        delete boardVertices[NUM_MATRIX_ROWS-2][NUM_MATRIX_COLS-1];  //[5][1
-        boardVertices[NUM_MATRIX_ROWS-2][NUM_MATRIX_COLS-1] = nullptr; //[5][10]
-
-        //Sixth row of the matrix
-        delete boardVertices[NUM_MATRIX_ROWS-1][idxMin];  //[10][0]
-        boardVertices[NUM_MATRIX_ROWS-1][idxMin] = nullptr; //[10][0]
-        delete boardVertices[NUM_MATRIX_ROWS-1][idxMin+1];  //[10][1]
-        boardVertices[NUM_MATRIX_ROWS-1][idxMin+1] = nullptr; //[10][1]
-        delete boardVertices[NUM_MATRIX_ROWS-1][NUM_MATRIX_COLS-2];  //[10][9]
-        boardVertices[NUM_MATRIX_ROWS-1][NUM_MATRIX_COLS-2] = nullptr; //[10][9]
-        delete boardVertices[NUM_MATRIX_ROWS-1][NUM_MATRIX_COLS-1];
-        boardVertices[NUM_MATRIX_ROWS-1][NUM_MATRIX_COLS-1] = nullptr; //[10][10]
     }
 
     // Update the neighbors of the vertices
     void Board::updateVertexNeighbors()
     {
-        for(int row = 0; row < NUM_MATRIX_ROWS; ++row)
+        std::vector<Vertex*> myVertexNeighbors; // reused, the vertex copies it into the arena
+        for(int row = 0; row < this->numOfRows; ++row)
         {
-            for(int col = 0; col < NUM_MATRIX_COLS; ++col)
+            for(int col = 0; col < this->numOfCols; ++col)
             {
                 if(boardVertices[row][col] != nullptr)
                 {
-                    std::vector<Vertex*> myVertexNeighbors;
-                    if(col + 1 < NUM_MATRIX_COLS && boardVertices[row][col + 1] != nullptr)
+                    myVertexNeighbors.clear();
+                    if(Vertex* right = getVertex(row, col + 1))
                     {
-                        myVertexNeighbors.push_back(boardVertices[row][col + 1]); 
+                        myVertexNeighbors.push_back(right);
                     }
-                    
-                    if(col - 1 >= 0 && boardVertices[row][col - 1] != nullptr)
+
+                    if(Vertex* left = getVertex(row, col - 1))
                     {
-                        myVertexNeighbors.push_back(boardVertices[row][col - 1]); 
+                        myVertexNeighbors.push_back(left);
                     }
-                    
-                    if(((row + col) % 2) == 0) //even
-                    {
-                        if(row + 1 < NUM_MATRIX_ROWS && boardVertices[row + 1][col] != nullptr)
-                        {
-                            myVertexNeighbors.push_back(boardVertices[row + 1][col]); 
-                        }
-                    }
-                    else //odd
+
+                    if(Vertex* vertical = getVertex(isVerticalDown(row, col) ? row + 1 : row - 1, col))
                     {
-                        if(row - 1 >= 0 && boardVertices[row - 1][col] != nullptr)
-                        {
-                            myVertexNeighbors.push_back(boardVertices[row - 1][col]); 
-                        }
+                        myVertexNeighbors.push_back(vertical);
                     }
 
                     boardVertices[row][col]->setMyVertexNeighbors(myVertexNeighbors);
@@ -163,92 +206,66 @@ namespace catan_game {
         }
     }
 
-    // Initialize the edges of the board
+    // Initialize the edges of the board - every vertex creates the edge to its right and the one down,
+    // so each edge is created once and no lookup is needed. The surrounding edges of a vertex
+    // are right, left and vertical like its neighbors.
     void Board::initializeEdges()
     {
-        for(int row = 0; row < NUM_MATRIX_ROWS; ++row)
+        // the edges to the right and down of every cell, row * columns + column
+        std::vector<Edge*> rightEdges(this->numOfRows * this->numOfCols, nullptr);
+        std::vector<Edge*> downEdges(this->numOfRows * this->numOfCols, nullptr);
+        auto cell = [this](int row, int col) { return row * this->numOfCols + col; };
+        boardEdges.reserve(9 * this->radius * this->radius + 15 * this->radius + 6);
+
+        for(int row = 0; row < this->numOfRows; ++row)
         {
-            for(int col = 0; col < NUM_MATRIX_COLS; ++col)
+            for(int col = 0; col < this->numOfCols; ++col)
             {
-                if(boardVertices[row][col] != nullptr)
+                Vertex* vertex = boardVertices[row][col];
+                if(vertex == nullptr) continue;
+
+                if(Vertex* right = getVertex(row, col + 1))
                 {
-                    std::vector<Edge*> mySurroundingEdges;
-                    if(col + 1 < NUM_MATRIX_COLS && boardVertices[row][col + 1] != nullptr)
-                    {
-                        Edge* edge = addEdge(boardVertices[row][col], boardVertices[row][col + 1]);
-                        if(edge != nullptr)
-                        {
-                            mySurroundingEdges.push_back(edge);
-                        }
-                    }
-                    
-                    if(col - 1 >= 0 && boardVertices[row][col - 1] != nullptr)
-                    {
-                        Edge* edge = addEdge(boardVertices[row][col], boardVertices[row][col - 1]);
-                        if(edge != nullptr)
-                        {
-                            mySurroundingEdges.push_back(edge);
-                        }
-                    }
-                    
-                    if(((row + col) % 2) == 0) //even
-                    {
-                        if(row + 1 < NUM_MATRIX_ROWS && boardVertices[row + 1][col] != nullptr)
-                        {
-                            Edge* edge = addEdge(boardVertices[row][col], boardVertices[row + 1][col]);
-                            if(edge != nullptr)
-                            {
-                                mySurroundingEdges.push_back(edge);
-                            }
-                        }
-                    }
-                    else //odd
-                    {
-                        if(row - 1 >= 0 && boardVertices[row - 1][col] != nullptr)
-                        {
-                            Edge* edge = addEdge(boardVertices[row][col], boardVertices[row - 1][col]);
-                            if(edge != nullptr)
-                            {
-                                mySurroundingEdges.push_back(edge);
-                            }
-                        }
-                    }
-                    boardVertices[row][col]->setMyEdges(mySurroundingEdges);
+                    rightEdges[cell(row, col)] = allocator.new_object<Edge>(vertex, right);
+                    boardEdges.push_back(rightEdges[cell(row, col)]);
+                }
+                Vertex* down = getVertex(row + 1, col);
+                if(down != nullptr && isVerticalDown(row, col))
+                {
+                    downEdges[cell(row, col)] = allocator.new_object<Edge>(vertex, down);
+                    boardEdges.push_back(downEdges[cell(row, col)]);
                 }
             }
         }
-    }
-    
-    // Add edges to the board of vertices
-    Edge* Board::addEdge(Vertex *vertex1, Vertex *vertex2)
-    {       
-        if(vertex1 == nullptr || vertex2 == nullptr)
-        {
-            return nullptr;
-        }
-        
-        for(Edge* existingEdge: boardEdges)
+
+        std::vector<Edge*> mySurroundingEdges; // reused, the vertex copies it into the arena
+        for(int row = 0; row < this->numOfRows; ++row)
         {
-            if(existingEdge->getVertices().first == vertex1 && existingEdge->getVertices().second == vertex2)
-            {
-                return existingEdge;
-            }
-            else if(existingEdge->getVertices().first == vertex2 && existingEdge->getVertices().second == vertex1)
+            for(int col = 0; col < this->numOfCols; ++col)
             {
-                return existingEdge;
+                if(boardVertices[row][col] == nullptr) continue;
+
+                mySurroundingEdges.clear();
+                for(Edge* edge: {rightEdges[cell(row, col)],
+                                 col > 0 ? rightEdges[cell(row, col - 1)] : nullptr,
+                                 isVerticalDown(row, col) ? downEdges[cell(row, col)] : (row > 0 ? downEdges[cell(row - 1, col)] : nullptr)})
+                {
+                    if(edge != nullptr)
+                    {
+                        mySurroundingEdges.push_back(edge);
+                    }
+                }
+                boardVertices[row][col]->setMyEdges(mySurroundingEdges);
             }
         }
-        Edge* tempEdge = new Edge(vertex1, vertex2);
-        
-        boardEdges.push_back(tempEdge);
-        return tempEdge;
     }
 
-    // Initialize the Tiles of the board and the type of the tiles with random selections
-    void Board::initializeTiles() 
+    // Initialize the Tiles of the board and the type of the tiles with random selections.
+    // A larger board repeats the standard set of tiles.
+    void Board::initializeTiles(std::minstd_rand& layoutRng)
     {
-        // Create a vector with the exact number of each Tile::Type
-        std::vector<TileType> tileTypes = 
+        // The exact number of each Tile::Type on the standard board
+        const std::vector<TileType> standardTypes = 
         {
                 TileType::Tree, TileType::Tree, TileType::Tree, TileType::Tree,
                 TileType::Clay, TileType::Clay, TileType::Clay,
@@ -258,26 +275,40 @@ namespace catan_game {
                 TileType::Sand
         };
 
+        size_t numOfTiles = 3 * this->radius * (this->radius + 1) + 1;
+        std::vector<TileType> tileTypes;
+        for(size_t tileAtIndex = 0; tileAtIndex < numOfTiles; ++tileAtIndex)
+        {
+            tileTypes.push_back(standardTypes[tileAtIndex % standardTypes.size()]);
+        }
+
         // Shuffle the tileTypes vector
-        std::shuffle(tileTypes.begin(), tileTypes.end(),
-                    std::default_random_engine(static_cast<unsigned>(std::time(0))));
+        std::shuffle(tileTypes.begin(), tileTypes.end(), layoutRng);
 
         // Create a Tile for each type in tileTypes and add it to the tiles vector
+        boardTiles.reserve(tileTypes.size());
         for (size_t tileAtIndex = 0; tileAtIndex < tileTypes.size(); ++tileAtIndex) 
         {
-            boardTiles.push_back(new Tile(tileTypes[tileAtIndex]));
+            boardTiles.push_back(allocator.new_object<Tile>(tileTypes[tileAtIndex], static_cast<int>(tileAtIndex)));
         }
     }
 
-    // Assign the numbers to the tiles on the board - for dice rolls
-    void Board::assignNumbers() 
+    // Assign the numbers to the tiles on the board - for dice rolls, a larger board repeats the standard numbers
+    void Board::assignNumbers(std::minstd_rand& layoutRng)
     {   
-        std::vector<int> numbers = {2, 3, 3, 4, 4, 5, 5, 6, 6, 8, 8, 9, 9, 10, 10, 11, 11, 12};
+        const std::vector<int> standardNumbers = {2, 3, 3, 4, 4, 5, 5, 6, 6, 8, 8, 9, 9, 10, 10, 11, 11, 12};
+        std::vector<int> numbers;
+        for(Tile* tile: boardTiles)
+        {
+            if(tile->getType() != TileType::Sand)
+            {
+                numbers.push_back(standardNumbers[numbers.size() % standardNumbers.size()]);
+            }
+        }
         int atIndex = 0;
 
         // Shuffle the numbers vector
-        std::shuffle(numbers.begin(), numbers.end(),
-                    std::default_random_engine(static_cast<unsigned>(std::time(0))));
+        std::shuffle(numbers.begin(), numbers.end(), layoutRng);
 
         for (Tile* tile: boardTiles) 
         {
@@ -289,182 +320,167 @@ namespace catan_game {
         }
     }
 
-    // Assign the vertex to the tiles
-    void Board::assignVertexToTiles()
+    // The coast is the edges that belong to a single tile. Walk it around the island
+    // and put the harbors at even distances, with the types shuffled like the tiles.
+    // The standard coast of 30 edges gets the 9 harbors, a larger one proportionally more.
+    void Board::initializeHarbors(std::minstd_rand& layoutRng)
     {
-        int numTile = 0;
-        int row = 0;
-        for(int col = 2; col <= 8; col+= 2)
-        {
-            boardTiles[numTile]->setVertex(boardVertices[row][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+2]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+2]);
-            if(numTile == 2) break;
-            numTile++;
-        }
+        // The 6 sides of a tile as indices into its vertices (top, bottom and the two vertical sides)
+        constexpr int TILE_SIDES[6][2] = {{0, 2}, {2, 4}, {1, 3}, {3, 5}, {0, 1}, {4, 5}};
+        constexpr size_t STANDARD_COAST_EDGES = 30;
 
-        row++;
-        numTile++;
-        for(int col = 1; col <= 9; col+= 2)
+        std::unordered_map<const Edge*, int> numOfTiles;
+        for(Tile* tile: boardTiles)
         {
-            boardTiles[numTile]->setVertex(boardVertices[row][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+2]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+2]);
-            if(numTile == 6) break;
-            numTile++;
+            const std::pmr::vector<Vertex*>& vertices = tile->getVertices();
+            for(const auto& side: TILE_SIDES)
+            {
+                ++numOfTiles[findEdge(vertices[side[0]]->getRow(), vertices[side[0]]->getColumn(),
+                                      vertices[side[1]]->getRow(), vertices[side[1]]->getColumn())];
+            }
         }
 
-        row++;
-        numTile++;
-        for(int col = 0; col <= 10; col+= 2)
+        // Every coastal vertex has exactly two coastal edges
+        std::unordered_map<const Vertex*, std::vector<Edge*>> coastAt;
+        Edge* start = nullptr;
+        size_t coastSize = 0;
+        for(Edge* edge: boardEdges)
         {
-            boardTiles[numTile]->setVertex(boardVertices[row][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+2]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+2]);
-            if(numTile == 11) break;
-            numTile++;
+            if(numOfTiles[edge] != 1) continue;
+            if(start == nullptr) start = edge;
+            coastAt[edge->getVertices().first].push_back(edge);
+            coastAt[edge->getVertices().second].push_back(edge);
+            ++coastSize;
         }
+        if(coastSize < NUM_HARBORS) return;
 
-        row++;
-        numTile++;
-        for(int col = 1; col <= 9; col+= 2)
+        std::vector<Edge*> coastline = {start};
+        Vertex* end = start->getVertices().second;
+        while(coastline.size() < coastSize)
+        {
+            const std::vector<Edge*>& edges = coastAt[end];
+            Edge* next = (edges[0] == coastline.back()) ? edges[1] : edges[0];
+            coastline.push_back(next);
+            end = (next->getVertices().first == end) ? next->getVertices().second : next->getVertices().first;
+        }
+
+        const std::vector<Harbor> standardHarbors = {
+            {nullptr, nullptr, true, TileType::Sand}, {nullptr, nullptr, true, TileType::Sand},
+            {nullptr, nullptr, true, TileType::Sand}, {nullptr, nullptr, true, TileType::Sand},
+            {nullptr, nullptr, false, TileType::Tree}, {nullptr, nullptr, false, TileType::Clay},
+            {nullptr, nullptr, false, TileType::Crop}, {nullptr, nullptr, false, TileType::Wool},
+            {nullptr, nullptr, false, TileType::Iron}
+        };
+        std::vector<Harbor> harbors;
+        size_t numOfHarbors = coastSize * NUM_HARBORS / STANDARD_COAST_EDGES;
+        for(size_t index = 0; index < numOfHarbors; ++index)
         {
-            boardTiles[numTile]->setVertex(boardVertices[row][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+2]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+2]);
-            if(numTile == 15) break;
-            numTile++;
+            harbors.push_back(standardHarbors[index % standardHarbors.size()]);
         }
+        std::shuffle(harbors.begin(), harbors.end(), layoutRng);
 
-        row++;
-        numTile++;
-        for(int col = 2; col <= 8; col+= 2)
+        // The vertices keep pointers into boardHarbors - it is never resized after this
+        this->boardHarbors.assign(harbors.begin(), harbors.end());
+        for(size_t index = 0; index < this->boardHarbors.size(); ++index)
         {
-            boardTiles[numTile]->setVertex(boardVertices[row][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+1]);
-            boardTiles[numTile]->setVertex(boardVertices[row][col+2]);
-            boardTiles[numTile]->setVertex(boardVertices[row+1][col+2]);
-            if(numTile == 18) break;
-            numTile++;
+            Edge* edge = coastline[index * coastline.size() / this->boardHarbors.size()];
+            Harbor& harbor = this->boardHarbors[index];
+            harbor.first = edge->getVertices().first;
+            harbor.second = edge->getVertices().second;
+            harbor.first->setHarbor(&harbor);
+            harbor.second->setHarbor(&harbor);
         }
     }
 
     // Place a settlement on the board
     Vertex* Board::placeSettlement(int row, int col, Player *player, bool isCity, bool isResouceCheckRequire)
     {
-        if(isOutOfBound(row,col))
+        if(!isOnBoard(row, col))
         {
             std::cout<<"Coordination Out-of-bound"<<std::endl;
             return nullptr;
         }
-        
-        if(boardVertices[row][col] != nullptr)
+
+        Vertex* vertex = boardVertices[row][col];
+        if(canPlaceSettlement(row, col, player, isCity)
+            && player->addBuilding(vertex, isCity, isCity ? false : isResouceCheckRequire))
         {
-            if(!isCity){
-                if((boardVertices[row][col]->getOwner()) == nullptr && (boardVertices[row][col]->isSettlementBuildable(isCity)))
-                {
-                    if((player->addBuilding(boardVertices[row][col], isCity, isResouceCheckRequire)))
-                    {
-                        return boardVertices[row][col];
-                    }
-                }
-            }
-            else{
-                if((boardVertices[row][col]->getOwner() == player) && (boardVertices[row][col]->isSettlementBuildable(isCity)))
-                {
-                    if((player->addBuilding(boardVertices[row][col], isCity, false)))
-                    {
-                        return boardVertices[row][col];
-                    }
-                }
+            // the settlement and its neighbours are closed by the distance rule
+            this->openVertices.reset(getCell(row, col));
+            for(const Vertex* neighbor: vertex->getMyVertexNeighbors())
+            {
+                this->openVertices.reset(getCell(neighbor->getRow(), neighbor->getColumn()));
             }
+            this->roadFrontiers.try_emplace(player, 2 * this->openVertices.size());
+            refreshRoadFrontiers(vertex);
+            return vertex;
         }
         return nullptr;
     }
 
-    // Place a road on the board
     Edge *Board::placeRoad(int fromRow, int fromCol, int toRow, int toCol, Player *player, bool freeFromResource)
     {
-        if(isOutOfBound(fromRow, fromCol) || isOutOfBound(toRow, toCol) || (fromRow == toRow && fromCol == toCol))
+        if(!isOnBoard(fromRow, fromCol) || !isOnBoard(toRow, toCol) || (fromRow == toRow && fromCol == toCol))
         {
             std::cout<<"Out of bound Or Invliad arguments"<<std::endl;
             return nullptr;
         }
 
-        //Looking for the edge in the boardEdges
-        auto it = std::find_if(boardEdges.begin(), boardEdges.end(), [&](Edge* edge)
+        Edge* edge = findEdge(fromRow, fromCol, toRow, toCol);
+        if(edge != nullptr && edge->hasRoad())
         {
-            return ( edge->getVertices().first->getRow() == fromRow && edge->getVertices().first->getColumn() == fromCol 
-                     && edge->getVertices().second->getRow() == toRow && edge->getVertices().second->getColumn() == toCol)
-                || ( edge->getVertices().first->getRow() == toRow && edge->getVertices().first->getColumn() == toCol
-                     && edge->getVertices().second->getRow() == fromRow && edge->getVertices().second->getColumn() == fromCol);
-        });
-                
-        Edge* edge = (it != boardEdges.end()) ? *it : nullptr; 
+            std::cout<<"Edge already has road"<<std::endl;
+            return nullptr;
+        }
 
-        //If the edge exist
-        if(edge != nullptr)
+        //The road must be next to a settlement, city or other road of the player
+        if(!canPlaceRoad(fromRow, fromCol, toRow, toCol, player))
         {
-            //if the edge already has a road
-            if(edge->hasRoad())
-            {
-                std::cout<<"Edge already has road"<<std::endl;
-                return nullptr;
-            }
+            std::cout<<"Road Must be next to City or Road"<<std::endl;
+            return nullptr;
+        }
 
-            //If there is a settlement or city in the vertex, is connected to the road of player
-            else if(boardVertices[fromRow][fromCol]->getOwner() == player || boardVertices[toRow][toCol]->getOwner() == player)
-            {
-                if(player->addRoad(edge, freeFromResource))
-                {
-                    return edge;
-                }
-            }
+        if(!player->addRoad(edge, freeFromResource)) return nullptr;
 
-            //If there is no settelemnt or city in the vertex, is connected to other road of player from vertex 1
-            std::vector<Edge*> firstVertexSurrondEdges = edge->getVertices().first->getMySurroundingEdges();
-            for(Edge* surroundingEdge : firstVertexSurrondEdges)
-            {
-                if(surroundingEdge->hasRoad() && surroundingEdge->getRoadOwner() == player)
-                {
-                    if(player->addRoad(edge, freeFromResource))
-                    {
-                    return edge;
-                    }
-                }
-            }
+        auto reachable = this->reachableVertices.try_emplace(player, this->openVertices.size()).first;
+        reachable->second.set(getCell(fromRow, fromCol));
+        reachable->second.set(getCell(toRow, toCol));
+        this->roadFrontiers.try_emplace(player, 2 * this->openVertices.size());
+        refreshRoadFrontiers(edge->getVertices().first);
+        refreshRoadFrontiers(edge->getVertices().second);
+        return edge;
+    }
 
-            //If there is no settelemnt or city in the vertex, is connected to other road of player from vertex 2
-            std::vector<Edge*> secondVertexSurrondEdges = edge->getVertices().second->getMySurroundingEdges();
-            for(Edge* surroundingEdge : secondVertexSurrondEdges)
-            {
-                if(surroundingEdge->hasRoad() && (surroundingEdge->getRoadOwner() == player))
-                {
-                    if(player->addRoad(edge, freeFromResource))
-                    {
-                        return edge;
-                    }
-                }
-            }
+    // Look only at the edges around the first vertex - at most 3
+    Edge* Board::findEdge(int fromRow, int fromCol, int toRow, int toCol) const
+    {
+        Vertex* from = getVertex(fromRow, fromCol);
+        Vertex* to = getVertex(toRow, toCol);
+        if(from == nullptr || to == nullptr) return nullptr;
+
+        for(Edge* edge: from->getMySurroundingEdges())
+        {
+            if(edge->getVertices().first == to || edge->getVertices().second == to) return edge;
         }
-        std::cout<<"Road Must be next to City or Road"<<std::endl;
         return nullptr;
     }
 
+    bool Board::canPlaceSettlement(int row, int col, const Player* player, bool isCity) const
+    {
+        const Vertex* vertex = getVertex(row, col);
+        if(player == nullptr || vertex == nullptr) return false;
+        // the settlement under a city already kept the distance rule, a new one needs an open vertex
+        return isCity ? (vertex->getOwner() == player && !vertex->isCity()) : this->openVertices.test(getCell(row, col));
+    }
+
+    // A road must touch a building or another road of the player
+    bool Board::canPlaceRoad(int fromRow, int fromCol, int toRow, int toCol, const Player* player) const
+    {
+        const Edge* edge = findEdge(fromRow, fromCol, toRow, toCol);
+        if(player == nullptr || edge == nullptr) return false;
+        return getRoadSpots(player).test(getEdgeSlot(edge));
+    }
+
     // Send the starting resources to the players
     void Board::sendStartingResources()
     {
@@ -477,547 +493,325 @@ namespace catan_game {
         }
     }
 
-    // Check if the coordinates are out of bound
-    bool Board::isOutOfBound(int row, int col) const
+    // Check if the coordinates are out of bound - a vertex belongs to a tile of the row above or below it
+    bool Board::isOutOfBound(int row, int col, int boardRadius)
     {
-        if((row < 0 || row > 5 || col < 0 || col > 11)  
-            ||((row == 0 || row == 5) && (col == 0 || col == 1 || col == 9 || col == 10))
-            || ((row == 1 || row == 4) && (col == 0 || col == 10)) )
-            {
-                return true;
-            }
-        return false;
+        for(int tileRow = row - 1; tileRow <= row; ++tileRow)
+        {
+            if(tileRow < 0 || tileRow > 2 * boardRadius) continue;
+            int firstCol = firstTileColumn(boardRadius, tileRow);
+            if(col >= firstCol && col <= 4 * boardRadius + 2 - firstCol) return false;
+        }
+        return true;
     }
 
-    // After rolling the dices the method distribute the resources
+    bool Board::isOnBoard(int row, int col) const
+    {
+        return !isOutOfBound(row, col, this->radius);
+    }
+
+    // After rolling the dices the method distribute the resources - only the tiles indexed by the roll produce
     void Board::distrbuteResources(int diceRoll)
     {
-        for(Tile* tile: boardTiles)
+        for(Tile* tile: getProducingTiles(diceRoll))
         {
-            if(tile->getValue() == diceRoll)
+            for(Vertex* vertex: tile->getVertices())
             {
-                for(Vertex* vertex: tile->getVertices())
-                {
-                    vertex->addResources(tile->getType());
-                }
+                vertex->addResources(tile->getType());
             }
         }
     }
 
-    // Print the board coordinates and structure
-    void Board::printBoard() const 
+    // The robber starts on the first desert, a board without desert starts with the robber off the board
+    void Board::indexProduction()
     {
-        int dynSize = -1;
-        int counter = -1;
-        std::vector<std::string> tileVectorType;
-        std::vector<int> tileVectorValue;
-
-        for(int row = 0; row < NUM_MATRIX_ROWS-1; ++row)
+        // reserved for every tile of the number, the robber's too, so moving the robber never grows a list
+        std::array<size_t, MAX_DICE_ROLL + 1> numOfTiles{};
+        for(const Tile* tile: boardTiles)
         {
-            if(row == 0 || row == 4) {
-                dynSize = 2;
-                counter = (row == 0) ? 16 : 0;
-            }
-            else if(row == 1 || row == 3)
-            {
-                dynSize = 3;
-                counter = (row == 1) ? 12 : 3;
-            }
-            else if(row == 2)
-            {
-                dynSize = 4;
-                counter = 7;        
-            }
-
-            
-            for(int col = 0; col <= dynSize; ++col)
-            {
-                tileVectorValue.push_back(boardTiles[counter]->getValue());
-
-                switch(boardTiles[counter]->getType())
-                {
-                    case TileType::Tree:
-                        tileVectorType.push_back("Tree");
-                        break;
-                    case TileType::Clay:
-                        tileVectorType.push_back("Clay");
-                        break;
-                    case TileType::Crop:
-                        tileVectorType.push_back("Crop");
-                        break;
-                    case TileType::Wool:
-                        tileVectorType.push_back("Wool");
-                        break;
-                    case TileType::Iron:
-                        tileVectorType.push_back("Iron");
-                        break;
-                    case TileType::Sand:
-                        tileVectorType.push_back("Sand");
-                        break;
-                }
-                ++counter;
-            }
-            if(counter == 18) break;
-        }
-        
-        std::cout << "******************************* CATAN BOARD *******************************" << std::endl;
-        int typeIndex = 0;
-        int valueIndex = 0;
-        
-        // Row 5
-        std::cout << "          ";
-        for (int col = 0; col < 10; col++) {
-            if (boardVertices[5][col] != nullptr && ((col % 2) != 0)) {
-                std::cout << (*boardVertices[5][col]) << "___  ";
-            }else if(col == 0 || col == 1 || col == 8 || col == 9){
-                std::cout << "     ";
-            } else {
-                std::cout << "___";
-            }
+            if(tile->getValue() >= MIN_DICE_ROLL && tile->getValue() <= MAX_DICE_ROLL) ++numOfTiles[tile->getValue()];
         }
-        std::cout << std::endl;
-
-        // Row 3
-        std::cout << "                 ";
-        for (int col = 2; col <= 8; col++) {
-            if(col % 2 == 0){
-                switch(col){
-                    case 2:
-                        std::cout << "  /   ";
-                        break;
-                    case 8:
-                        std::cout << "  \\ ";
-                        break;
-                    default:
-                        std::cout << "  \\/   ";
-                        break;
-                }
-            }
-            else{
-                std::cout << "  .   ";
-            }
+        for(int roll = MIN_DICE_ROLL; roll <= MAX_DICE_ROLL; ++roll)
+        {
+            this->productionByRoll[roll].reserve(numOfTiles[roll]);
         }
-        std::cout << std::endl;
 
-        // Row 5
-        std::cout << "   ";
-        for (int col = 0; col < 10; col++) {
-            if (boardVertices[5][col] != nullptr && ((col % 2) == 0)) {
-                std::cout << (*boardVertices[5][col])<<"   ";
-            } else if(col > 1 && col < 9){
-                if(tileVectorValue[valueIndex] > 9 || tileVectorValue[valueIndex] < 0)
-                {
-                    std::cout<<tileVectorValue[valueIndex++]<<"   ";
-                }else{
-                    std::cout<<tileVectorValue[valueIndex++]<<"    ";
-                }
-                
-            }else{
-                std::cout << "       ";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 4
-        std::cout << "           ";
-        for (int col = 0; col < 10; col++) {
-            if(col == 0|| col == 9){
-                std::cout << "       ";
-            }else if(col == 1){
-                std::cout << "| ";
-            }else if(col % 2 != 0){
-                std::cout << "|";
-            }else if(col > 1 && col < 8){
-                std::cout << "    "<<tileVectorType[typeIndex++]<<"    ";
-            }else{
-                std::cout << "       ";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 4
-        std::cout << "        ";
-        for (int col = 0; col < 10; col++) {
-            if (boardVertices[4][col] != nullptr && ((col % 2) == 0)) {
-                std::cout << (*boardVertices[4][col]) << "___. ";
-            }else if(col == 0 || col == 9){
-                std::cout << "      ";
-            } 
-            else {
-                std::cout << "___";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 4
-        std::cout << "     ";
-        for (int col = 0; col <= 10; col++) {
-            if(col % 2 != 0){
-                switch(col){
-                    case 1:
-                        std::cout << "  /   ";
-                        break;
-                    case 9:
-                        std::cout << "  \\ ";
-                        break;
-                    default:
-                        std::cout << "  \\/   ";
-                        break;
-                }
-            }
-            else if(col > 1 && col < 9)
+        for(size_t tileAtIndex = 0; tileAtIndex < boardTiles.size(); ++tileAtIndex)
+        {
+            Tile* tile = boardTiles[tileAtIndex];
+            if(tile->getType() == TileType::Sand && this->robberTileIndex == -1)
             {
-                std::cout << "  .   ";
+                this->robberTileIndex = static_cast<int>(tileAtIndex);
             }
-            else
+            else if(tile->getValue() >= MIN_DICE_ROLL && tile->getValue() <= MAX_DICE_ROLL)
             {
-                std::cout << "      ";
+                this->productionByRoll[tile->getValue()].push_back(tile);
+                addTileYield(tile, 1);
             }
         }
-        std::cout << std::endl;
+    }
 
-        // Row 4
-        std::cout << "    ";
-        for (int col = 0; col <= 10; col++) {
-            if (boardVertices[4][col] != nullptr && ((col % 2) != 0)) 
-            {
-                std::cout << (*boardVertices[4][col])<<"   ";
-            } 
-            else if(col > 1 && col < 9)
-            {
-                if(tileVectorValue[valueIndex] > 9 || tileVectorValue[valueIndex] < 0)
-                {
-                    std::cout<<tileVectorValue[valueIndex++]<<"   ";
-                }
-                else
-                {
-                    std::cout<<tileVectorValue[valueIndex++]<<"    ";
-                }
-            }
-            else{
-                std::cout << "       ";
-            }
-        }
-        std::cout << std::endl;
+    // Add (sign 1) or take back (sign -1) what the tile produces per roll to its vertices and their owners
+    void Board::addTileYield(const Tile* tile, int sign)
+    {
+        if(tile->getType() == TileType::Sand) return;
 
-        // Row 3
-        std::cout << "           ";
-        for (int col = 0; col < 10; col++) 
+        ResourceVector amounts = makeResourceVector(0, 0, 0, 0, 0);
+        amounts[tile->getType()] = sign * diceWays(tile->getValue());
+        for(Vertex* vertex: tile->getVertices())
         {
-            if(col == 0)
-            {
-                std::cout << " |    ";
-            }
-            else if(col % 2 == 0)
-            {
-                std::cout << "  |   ";
-            }
-            else if(col > 0 && col < 9){
-                std::cout<<" "<<tileVectorType[typeIndex++]<<"  ";
-            }
-            else
-            {
-                std::cout << "       ";
-            }
+            vertex->addYield(amounts);
+            if(vertex->getOwner() == nullptr) continue;
+            vertex->getOwner()->addExpectedIncome(amounts);
+            if(vertex->isCity()) vertex->getOwner()->addExpectedIncome(amounts);
         }
-        std::cout << std::endl;
+    }
 
-        // Row 3
-        std::cout << "        ";
-        for (int col = 0; col < 10; col++) {
-            if (boardVertices[3][col] != nullptr && ((col % 2) != 0) ) {
-                std::cout << (*boardVertices[3][col]) << "___  ";
-            } else {
-                std::cout << "___";
-            }
+    const std::pmr::vector<Tile*>& Board::getProducingTiles(int diceRoll) const
+    {
+        static const std::pmr::vector<Tile*> noTiles;
+        if(diceRoll < MIN_DICE_ROLL || diceRoll > MAX_DICE_ROLL) return noTiles;
+        return this->productionByRoll[diceRoll];
+    }
+
+    int Board::getRobberTileIndex() const
+    {
+        return this->robberTileIndex;
+    }
+
+    Tile* Board::getRobberTile() const
+    {
+        return (this->robberTileIndex < 0) ? nullptr : this->boardTiles[this->robberTileIndex];
+    }
+
+    // Give the production of the old tile back and take the new tile out of its roll - at most a few tiles
+    // share a number, so a move never walks the board. The yields of the 12 vertices follow.
+    bool Board::moveRobber(int tileIndex)
+    {
+        if(tileIndex < 0 || tileIndex >= static_cast<int>(boardTiles.size()) || tileIndex == this->robberTileIndex)
+        {
+            return false;
         }
-        std::cout << std::endl;
-
-        // Row 3
-        std::cout << "     ";
-        for (int col = 0; col <= 10; col++) {
-            if(col % 2 == 0){
-                switch(col){
-                    case 0:
-                        std::cout << "  /   ";
-                        break;
-                    case 10:
-                        std::cout << "  \\ ";
-                        break;
-                    default:
-                        std::cout << "  \\/   ";
-                        break;
-                }
-            }
-            else{
-                std::cout << "  .   ";
-            }
+
+        Tile* oldTile = getRobberTile();
+        if(oldTile != nullptr && oldTile->getValue() >= MIN_DICE_ROLL && oldTile->getValue() <= MAX_DICE_ROLL)
+        {
+            this->productionByRoll[oldTile->getValue()].push_back(oldTile);
+            addTileYield(oldTile, 1);
         }
-        std::cout << std::endl;
-        
-        // Row 3
-        std::cout << "     ";
-        for (int col = 0; col <= 10; col++) 
+
+        Tile* newTile = boardTiles[tileIndex];
+        if(newTile->getValue() >= MIN_DICE_ROLL && newTile->getValue() <= MAX_DICE_ROLL)
         {
-            if (boardVertices[3][col] != nullptr && ((col % 2) == 0)) 
+            std::pmr::vector<Tile*>& tiles = this->productionByRoll[newTile->getValue()];
+            auto it = std::find(tiles.begin(), tiles.end(), newTile);
+            if(it != tiles.end())
             {
-                std::cout << (*boardVertices[3][col])<<"   ";
-            } 
-            else
-            {
-                if(tileVectorValue[valueIndex] > 9 || tileVectorValue[valueIndex] < 0)
-                {
-                    std::cout<<tileVectorValue[valueIndex++]<<"   ";
-                }
-                else
-                {
-                    std::cout<<tileVectorValue[valueIndex++]<<"    ";
-                }
-
+                *it = tiles.back();
+                tiles.pop_back();
             }
+            addTileYield(newTile, -1);
         }
-        std::cout << std::endl;
-        
-        // Row 2
-        std::cout << "      ";
-        for (int col = 0; col <= 10; col++) 
+        this->robberTileIndex = tileIndex;
+        return true;
+    }
+
+    size_t Board::getCell(int row, int col) const
+    {
+        return static_cast<size_t>(row * this->numOfCols + col);
+    }
+
+    Vertex* Board::getVertexOfCell(size_t cell) const
+    {
+        return getVertex(static_cast<int>(cell) / this->numOfCols, static_cast<int>(cell) % this->numOfCols);
+    }
+
+    const BoardMask& Board::getOpenVertices() const
+    {
+        return this->openVertices;
+    }
+
+    const BoardMask& Board::getReachableVertices(const Player* player) const
+    {
+        static const BoardMask noVertices;
+        auto it = this->reachableVertices.find(player);
+        return (it == this->reachableVertices.end()) ? noVertices : it->second;
+    }
+
+    void Board::getSettlementSpots(const Player* player, BoardMask& spots) const
+    {
+        const BoardMask& reachable = getReachableVertices(player);
+        if(reachable.size() == 0)
         {
-            if(col == 0)
-            {
-                std::cout << "|";
-            }
-            else if(col % 2 == 0)
-            {
-                std::cout << "|";
-            }
-            else
-            {
-                std::cout<<"    "<<tileVectorType[typeIndex++]<<"    ";
-            }
+            spots.assignAnd(this->openVertices, this->openVertices);
+            spots.clear();
+            return;
         }
-        std::cout << std::endl;
+        spots.assignAnd(this->openVertices, reachable);
+    }
+
+    // The vertex and its neighbours may open again, unless another settlement still keeps them closed
+    void Board::removeBuilding(Vertex* vertex, bool isCity)
+    {
+        Player* player = vertex->getOwner();
+        if(player == nullptr) return;
+        player->undoBuilding(vertex, isCity);
+        if(isCity) return;
 
-        // Row 2
-        std::cout << "     ";
-        for (int col = 0; col <= 10; col++) 
+        auto isOpen = [](const Vertex* spot)
         {
-            if (boardVertices[2][col] != nullptr && ((col % 2) == 0)) 
+            if(spot->isSettled()) return false;
+            for(const Vertex* neighbor: spot->getMyVertexNeighbors())
             {
-                std::cout << (*boardVertices[2][col]) << " ";
-            } 
-            else 
-            {
-                std::cout << "  .    ";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 2
-        std::cout << "     ";
-        for (int col = 0; col <= 10; col++) {
-            if(col % 2 == 0){
-                switch(col){
-                    case 0:
-                        std::cout << "  \\___";
-                        break;
-                    case 10:
-                        std::cout << "___/  ";
-                        break;
-                    default:
-                        std::cout << "___/\\___";
-                        break;
-                }
-            }
-            else{
-                std::cout << "  .  ";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 1
-        std::cout << "           ";
-        for (int col = 1; col <= 10; col++) {
-            if (boardVertices[2][col] != nullptr && ((col % 2) != 0)) {
-                std::cout << (*boardVertices[2][col]) << "   ";
-            } else if(col > 1&& col < 10){
-                std::cout << ".    ";
-            }else {
-                std::cout << "     ";
+                if(neighbor->isSettled()) return false;
             }
+            return true;
+        };
+        if(isOpen(vertex)) this->openVertices.set(getCell(vertex->getRow(), vertex->getColumn()));
+        for(const Vertex* neighbor: vertex->getMyVertexNeighbors())
+        {
+            if(isOpen(neighbor)) this->openVertices.set(getCell(neighbor->getRow(), neighbor->getColumn()));
         }
-        std::cout << std::endl;
+        refreshRoadFrontiers(vertex);
+    }
 
-        // Row 1
-        std::cout << "            ";
-        for (int col = 0; col < 10; col++) {
-            if(col == 0)
-            {
-                std::cout << "| ";
-            }
-            else if(col % 2 == 0)
-            {
-                std::cout << "|";
-            }
-            else if(col > 0 && col < 9)
+    // An end stays reachable while another road of the player touches it
+    void Board::removeRoad(Edge* edge)
+    {
+        Player* player = edge->getRoadOwner();
+        if(player == nullptr) return;
+        player->undoRoad(edge);
+
+        auto reachable = this->reachableVertices.find(player);
+        for(const Vertex* end: {edge->getVertices().first, edge->getVertices().second})
+        {
+            if(reachable != this->reachableVertices.end())
             {
-                std::cout << "     ";
-                if(tileVectorValue[valueIndex] > 9 || tileVectorValue[valueIndex] < 0)
-                {
-                    std::cout<<tileVectorValue[valueIndex++]<<"     ";
-                }
-                else
+                bool isReached = false;
+                for(const Edge* other: end->getMySurroundingEdges())
                 {
-                    std::cout<<tileVectorValue[valueIndex++]<<"      ";
+                    isReached = isReached || other->getRoadOwner() == player;
                 }
+                if(!isReached) reachable->second.reset(getCell(end->getRow(), end->getColumn()));
             }
-            else
-            {
-                std::cout << "       ";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 1 
-        std::cout << "           ";
-        for (int col = 1; col <= 10; col++) {
-            if (boardVertices[1][col] != nullptr && ((col % 2) != 0)) {
-                std::cout << (*boardVertices[1][col]);
-            } else if(col > 1 && col < 9) {
-                std::cout<<"  "<<tileVectorType[typeIndex++]<<"  ";
-            }else{
-                std::cout << "     ";
-            }
+            refreshRoadFrontiers(end);
         }
-        std::cout << std::endl;
-        
-        //row 1
-        std::cout << "          ";
-        for (int col = 1; col <= 9; col++) {
-            if(col % 2 != 0){
-                switch(col){
-                    case 1:
-                        std::cout << "   \\___";
-                        break;
-                    case 9:
-                        std::cout << "___/ ";
-                        break;
-                    default:
-                        std::cout << "___/\\___";
-                        break;
-                }
-            }
-            else{
-                std::cout << "  .  ";
-            }
-        }
-        std::cout << std::endl;
-
-        // Row 1
-        std::cout << "       ";
-        for (int col = 0; col <= 10; col++) {
-            if (boardVertices[1][col] != nullptr && ((col % 2) == 0)) {
-                std::cout << (*boardVertices[1][col]) << "   ";
-            } else if(col > 1 && col < 9){
-                std::cout << " .   ";
-            }else{
-                std::cout << "     ";
-            }
-        }
-        std::cout << std::endl;
-
+    }
 
-        // Row 4
-        std::cout << "                   ";
-        for (int col = 0; col < 9; col++) 
+    // The edges of the anchor are roads the player may build - its own building, or its road
+    // at a vertex that isn't an opponent's: a settlement cuts the other players' roads through it
+    bool Board::isRoadAnchor(const Vertex* vertex, const Player* player) const
+    {
+        if(vertex->getOwner() != nullptr) return vertex->getOwner() == player;
+        for(const Edge* edge: vertex->getMySurroundingEdges())
         {
+            if(edge->getRoadOwner() == player) return true;
+        }
+        return false;
+    }
 
-            if(col == 1)
-            {
-                std::cout << "|";
-            }
-            else if(col % 2 != 0)
-            {
-                std::cout << "|";
-            }
-            else if(col > 1 && col < 8)
+    // A piece at the vertex changes only the edges around it - each of them is decided again
+    // for every player from its two ends
+    void Board::refreshRoadFrontiers(const Vertex* vertex)
+    {
+        for(auto& [player, frontier]: this->roadFrontiers)
+        {
+            for(const Edge* edge: vertex->getMySurroundingEdges())
             {
-                std::cout << "     ";
-                if(tileVectorValue[valueIndex] > 9 || tileVectorValue[valueIndex] < 0)
+                size_t slot = getEdgeSlot(edge);
+                if(!edge->hasRoad() && (isRoadAnchor(edge->getVertices().first, player) || isRoadAnchor(edge->getVertices().second, player)))
                 {
-                    std::cout<<tileVectorValue[valueIndex++]<<"     ";
+                    frontier.set(slot);
                 }
                 else
                 {
-                    std::cout<<" "<<tileVectorValue[valueIndex++]<<"     ";
+                    frontier.reset(slot);
                 }
             }
-
         }
-        std::cout << std::endl;
+    }
 
-        // Row 0
-        std::cout << "       ";
-        for (int col = 0; col <= 10; col++) {
-            if (boardVertices[0][col] != nullptr && ((col % 2) == 0)) 
-            {
-                std::cout << (*boardVertices[0][col]);
-            } 
-            else if (col > 2 && col < 8)
-            {
-                std::cout<<"  "<<tileVectorType[typeIndex++]<< "  ";
-                //std::cout << " .   ";
-            }
-            else
-            {
-                std::cout << "     ";
-            }
-        }
-        std::cout << std::endl;
+    // The board creates every edge from its left or upper end
+    size_t Board::getEdgeSlot(const Edge* edge) const
+    {
+        const Vertex* anchor = edge->getVertices().first;
+        bool isVertical = anchor->getRow() != edge->getVertices().second->getRow();
+        return 2 * getCell(anchor->getRow(), anchor->getColumn()) + (isVertical ? 1 : 0);
+    }
 
-        std::cout << "            ";
-        for (int col = 0; col < 8; col++) 
+    Edge* Board::getEdgeOfSlot(size_t slot) const
+    {
+        int row = static_cast<int>(slot / 2) / this->numOfCols;
+        int col = static_cast<int>(slot / 2) % this->numOfCols;
+        return (slot % 2 == 0) ? findEdge(row, col, row, col + 1) : findEdge(row, col, row + 1, col);
+    }
+
+    const BoardMask& Board::getRoadSpots(const Player* player) const
+    {
+        static const BoardMask noEdges;
+        auto it = this->roadFrontiers.find(player);
+        return (it == this->roadFrontiers.end()) ? noEdges : it->second;
+    }
+
+    // Print the board coordinates and structure - every vertex row with its roads ('_' free, '=' built),
+    // between two vertex rows the vertical roads ('|' free, '#' built) and the tiles with their numbers
+    void Board::printBoard() const 
+    {
+        constexpr int CELL_WIDTH = 7;
+        const int lineWidth = this->numOfCols * CELL_WIDTH;
+
+        std::cout << "******************************* CATAN BOARD *******************************" << std::endl;
+        size_t numTile = 0;
+        for(int row = 0; row < this->numOfRows; ++row)
         {
-            if(col % 2 != 0)
+            std::string vertexLine(lineWidth, ' ');
+            for(int col = 0; col < this->numOfCols; ++col)
             {
-                switch(col)
+                const Vertex* vertex = boardVertices[row][col];
+                if(vertex == nullptr) continue;
+
+                std::ostringstream text;
+                text << *vertex;
+                vertexLine.replace(col * CELL_WIDTH, text.str().size(), text.str());
+
+                const Edge* right = findEdge(row, col, row, col + 1);
+                if(right != nullptr)
                 {
-                    case 1:
-                        std::cout << "   \\___";
-                        break;
-                    case 7:
-                        std::cout << "___/ ";
-                        break;
-                    default:
-                        std::cout << "___/\\___";
-                        break;
+                    size_t from = col * CELL_WIDTH + text.str().size();
+                    vertexLine.replace(from, (col + 1) * CELL_WIDTH - from, (col + 1) * CELL_WIDTH - from, right->hasRoad() ? '=' : '_');
                 }
             }
-            else if(col > 1)
-            {
-                std::cout << "  .  ";
-            }
-            else 
+            std::cout << vertexLine.substr(0, vertexLine.find_last_not_of(' ') + 1) << std::endl;
+            if(row + 1 == this->numOfRows) break;
+
+            std::string tileLine(lineWidth, ' ');
+            for(int col = 0; col < this->numOfCols; ++col)
             {
-                std::cout << "     ";
+                const Edge* down = isVerticalDown(row, col) ? findEdge(row, col, row + 1, col) : nullptr;
+                if(down != nullptr)
+                {
+                    tileLine[col * CELL_WIDTH + 2] = down->hasRoad() ? '#' : '|';
+                }
             }
-        }
-        std::cout << std::endl;
 
-        // Row 0
-        std::cout << "            ";
-        for (int col = 0; col <= 8 ; col++) 
-        {
-            if (boardVertices[0][col] != nullptr && ((col % 2) != 0)) 
-            {
-                std::cout << (*boardVertices[0][col]) << "    ";
-            } 
-            else 
+            // the tiles of this row are the next ones in the tiles vector, from the first tile column
+            int numOfTilesInRow = 2 * this->radius + 1 - std::abs(row - this->radius);
+            for(int tileInRow = 0; tileInRow < numOfTilesInRow; ++tileInRow)
             {
-                std::cout << "    ";
+                const Tile* tile = boardTiles[numTile++];
+                std::string label = tileTypeToString(tile->getType());
+                if(tile->getType() != TileType::Sand)
+                {
+                    label += " " + std::to_string(tile->getValue());
+                }
+                if(tile == getRobberTile())
+                {
+                    label += " (R)";
+                }
+                int middleCol = firstTileColumn(this->radius, row) + 2 * tileInRow + 1;
+                tileLine.replace(middleCol * CELL_WIDTH + 3 - label.size() / 2, label.size(), label);
             }
+            std::cout << tileLine.substr(0, tileLine.find_last_not_of(' ') + 1) << std::endl;
         }
-        std::cout << std::endl;
-
-        std::cout << "***************************************************************************" << std::endl;
     }
 }
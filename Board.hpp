@@ -2,41 +2,135 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
+#include <array>
+#include <memory_resource>
+#include <random>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include "Vertex.hpp"
 #include "Edge.hpp"
 #include "Tile.hpp"
 #include "Card.hpp"
+#include "Harbor.hpp"
+#include "BoardMask.hpp"
 
 namespace catan_game {
+    // Radius of the standard board in tiles around the center tile - 19 tiles
+    constexpr int STANDARD_BOARD_RADIUS = 2;
+
+    // The vertices matrix of a board of radius R has 2R + 2 rows of 4R + 3 columns, the corners outside
+    // the hexagon are not vertices. The standard board has 6 rows of 11 columns.
+    constexpr int NUM_MATRIX_ROWS = 2 * STANDARD_BOARD_RADIUS + 2;
+    constexpr int NUM_MATRIX_COLS = 4 * STANDARD_BOARD_RADIUS + 3;
+
+    // The dice sums, production is indexed by them
+    constexpr int MIN_DICE_ROLL = 2;
+    constexpr int MAX_DICE_ROLL = 12;
+    constexpr int DICE_OUTCOMES = 36;
+
+    // Ways two dice make the roll out of DICE_OUTCOMES - the pips of the number tokens
+    constexpr int diceWays(int roll)
+    {
+        if(roll < MIN_DICE_ROLL || roll > MAX_DICE_ROLL) return 0;
+        return (roll <= 7) ? roll - 1 : 13 - roll;
+    }
+
     class Board {
     private:
-        static Board* boardInstance;
-        std::vector<std::vector<Vertex*>> boardVertices;
-        std::vector<Edge*> boardEdges;
-        std::vector<Tile*> boardTiles;
-        
-        Board();
+        // Every vertex, edge and tile of the board, their adjacency and the board's own vectors
+        // are carved from the arena and released at once with the board. Vertex, Edge and Tile
+        // declare allocator_type, so the board hands the arena down to their adjacency vectors.
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::polymorphic_allocator<> allocator;
+        int radius;
+        int numOfRows;
+        int numOfCols;
+        std::pmr::vector<std::pmr::vector<Vertex*>> boardVertices;
+        std::pmr::vector<Edge*> boardEdges;
+        std::pmr::vector<Tile*> boardTiles;
+        std::pmr::vector<Harbor> boardHarbors;
+        std::array<std::pmr::vector<Tile*>, MAX_DICE_ROLL + 1> productionByRoll; // tiles that produce on each roll, without the robber's
+        int robberTileIndex;
+        BoardMask openVertices; // free of the distance rule - no settlement on the vertex or next to it
+        std::pmr::unordered_map<const Player*, BoardMask> reachableVertices; // the ends of each player's roads
+        std::pmr::unordered_map<const Player*, BoardMask> roadFrontiers; // the edges each player can build a road on
+
+        bool isVerticalDown(int row, int col) const;
         void initializeVertices();
-        void deleteAndUpdateInvalidVertex();
         void updateVertexNeighbors();
         void initializeEdges();
-        Edge* addEdge(Vertex* vertex1, Vertex* vertex2);
-        void initializeTiles();
-        void assignNumbers();
-        void assignVertexToTiles();
+        void initializeTiles(std::minstd_rand& layoutRng);
+        void assignNumbers(std::minstd_rand& layoutRng);
+        void initializeHarbors(std::minstd_rand& layoutRng);
+        void indexProduction();
+        void addTileYield(const Tile* tile, int sign);
+        bool isRoadAnchor(const Vertex* vertex, const Player* player) const;
+        void refreshRoadFrontiers(const Vertex* vertex);
         
     public:
+        // Every game owns its board. The layout is generated from the radius and shuffled from the seed,
+        // the standard radius keeps the coordinates of the classic board
+        explicit Board(int boardRadius = STANDARD_BOARD_RADIUS, unsigned seed = 0);
         ~Board();
-        static Board* getBoardInstance();
-        const std::vector<Tile*>& getTiles() const;
+        Board(const Board&) = delete;
+        Board& operator=(const Board&) = delete;
+        const std::pmr::vector<Tile*>& getTiles() const;
+        const std::pmr::vector<Edge*>& getEdges() const;
+        const std::pmr::vector<Harbor>& getHarbors() const;
+        int getRadius() const;
+        int getNumOfRows() const;
+        int getNumOfCols() const;
+        Vertex* getVertex(int row, int col) const;
         Vertex* placeSettlement(int row, int col, Player *player, bool isCity, bool freeFromResource);
         Edge* placeRoad(int fromRow, int fromCol, int toRow, int toCol, Player *player, bool freeFromResource);
+        // The edge between two neighbour vertices, nullptr when there is none
+        Edge* findEdge(int fromRow, int fromCol, int toRow, int toCol) const;
+        // The placement rules of placeSettlement/placeRoad without placing anything, resources are not checked.
+        // A road must touch the player's building, or its road at a vertex without an opponent's building.
+        bool canPlaceSettlement(int row, int col, const Player* player, bool isCity) const;
+        bool canPlaceRoad(int fromRow, int fromCol, int toRow, int toCol, const Player* player) const;
         void sendStartingResources();
         void printBoard() const;
-        bool isOutOfBound(int row, int col) const;
+        // true when the coordinates are not a vertex of a board of the radius
+        static bool isOutOfBound(int row, int col, int boardRadius = STANDARD_BOARD_RADIUS);
+        bool isOnBoard(int row, int col) const;
         void distrbuteResources(int diceRoll);
+
+        // The tiles a roll produces from - the robber's tile is never among them
+        const std::pmr::vector<Tile*>& getProducingTiles(int diceRoll) const;
+
+        // Index in getTiles() of the tile blocked by the robber, -1 when the robber is off the board
+        int getRobberTileIndex() const;
+        Tile* getRobberTile() const;
+
+        // Move the robber to another tile, false when the index is not a tile or the robber is already there
+        bool moveRobber(int tileIndex);
+
+        // Bit of a vertex in the masks - row * getNumOfCols() + col, the vertex id of the protocol on the standard board
+        size_t getCell(int row, int col) const;
+        Vertex* getVertexOfCell(size_t cell) const;
+
+        // Masks kept up to date by placeSettlement and placeRoad. The open vertices are the setup spots,
+        // the ones a player's roads reach are empty when the player has no road.
+        const BoardMask& getOpenVertices() const;
+        const BoardMask& getReachableVertices(const Player* player) const;
+
+        // Open vertices at the end of the player's roads, written into spots without allocating once it has the size
+        void getSettlementSpots(const Player* player, BoardMask& spots) const;
+
+        // Take back a building or road placed on the board, with the masks - used to undo actions.
+        // The owner's resources are the caller's.
+        void removeBuilding(Vertex* vertex, bool isCity);
+        void removeRoad(Edge* edge);
+
+        // Bit of an edge in the road masks - twice the cell of its left or upper end, plus 1 when vertical
+        size_t getEdgeSlot(const Edge* edge) const;
+        Edge* getEdgeOfSlot(size_t slot) const;
+
+        // Free edges the player can build a road on - next to its building, or to its road at a vertex
+        // no opponent has settled. Updated by placeSettlement and placeRoad, empty when the player has no piece.
+        const BoardMask& getRoadSpots(const Player* player) const;
     };
 }
 
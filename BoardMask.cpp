@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <bit>
+#include "BoardMask.hpp"
+
+namespace catan_game {
+
+    BoardMask::BoardMask(const allocator_type& allocator) : words(allocator), numOfBits(0)
+    {
+    }
+
+    BoardMask::BoardMask(size_t bits, const allocator_type& allocator) :
+                    words((bits + WORD_BITS - 1) / WORD_BITS, 0, allocator),
+                    numOfBits(bits)
+    {
+    }
+
+    BoardMask::BoardMask(const BoardMask& other, const allocator_type& allocator) :
+                    words(other.words, allocator),
+                    numOfBits(other.numOfBits)
+    {
+    }
+
+    size_t BoardMask::size() const
+    {
+        return this->numOfBits;
+    }
+
+    bool BoardMask::test(size_t bit) const
+    {
+        if(bit >= this->numOfBits) return false;
+        return (this->words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+    }
+
+    void BoardMask::set(size_t bit)
+    {
+        if(bit < this->numOfBits) this->words[bit / WORD_BITS] |= uint64_t(1) << (bit % WORD_BITS);
+    }
+
+    void BoardMask::reset(size_t bit)
+    {
+        if(bit < this->numOfBits) this->words[bit / WORD_BITS] &= ~(uint64_t(1) << (bit % WORD_BITS));
+    }
+
+    void BoardMask::clear()
+    {
+        std::fill(this->words.begin(), this->words.end(), 0);
+    }
+
+    size_t BoardMask::count() const
+    {
+        size_t sum = 0;
+        for(uint64_t word: this->words)
+        {
+            sum += std::popcount(word);
+        }
+        return sum;
+    }
+
+    bool BoardMask::any() const
+    {
+        for(uint64_t word: this->words)
+        {
+            if(word != 0) return true;
+        }
+        return false;
+    }
+
+    void BoardMask::assignAnd(const BoardMask& first, const BoardMask& second)
+    {
+        this->numOfBits = std::min(first.numOfBits, second.numOfBits);
+        this->words.resize((this->numOfBits + WORD_BITS - 1) / WORD_BITS);
+        for(size_t index = 0; index < this->words.size(); ++index)
+        {
+            this->words[index] = first.words[index] & second.words[index];
+        }
+    }
+
+    size_t BoardMask::findNext(size_t from) const
+    {
+        if(from >= this->numOfBits) return this->numOfBits;
+        size_t index = from / WORD_BITS;
+        uint64_t word = this->words[index] & (~uint64_t(0) << (from % WORD_BITS));
+        while(word == 0)
+        {
+            if(++index == this->words.size()) return this->numOfBits;
+            word = this->words[index];
+        }
+        return index * WORD_BITS + std::countr_zero(word);
+    }
+
+    bool BoardMask::operator==(const BoardMask& other) const
+    {
+        return this->numOfBits == other.numOfBits && this->words == other.words;
+    }
+}
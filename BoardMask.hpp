@@ -0,0 +1,49 @@
+#ifndef BOARDMASK_HPP
+#define BOARDMASK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace catan_game {
+
+    // A set of vertices or edges of a board as a bitmask - a vertex is bit row * columns + column of the
+    // board's vertices matrix, an edge twice its anchor vertex plus 1 when vertical (like the protocol ids).
+    // The board keeps its masks up to date as pieces are placed, so the legal spots of a player
+    // are a mask or the AND of two instead of a walk over the board.
+    class BoardMask {
+    private:
+        static constexpr size_t WORD_BITS = 64;
+        std::pmr::vector<uint64_t> words;
+        size_t numOfBits;
+
+    public:
+        // The words are allocated from the allocator - the board passes its arena
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        explicit BoardMask(const allocator_type& allocator = {});
+        explicit BoardMask(size_t bits, const allocator_type& allocator = {});
+        BoardMask(const BoardMask& other, const allocator_type& allocator = {});
+        BoardMask& operator=(const BoardMask& other) = default;
+
+        size_t size() const;
+        bool test(size_t bit) const;
+        void set(size_t bit);
+        void reset(size_t bit);
+        void clear(); // every bit off, the size stays
+        size_t count() const;
+        bool any() const;
+
+        // this = first & second - masks of the same size, the words are reused so nothing is allocated
+        void assignAnd(const BoardMask& first, const BoardMask& second);
+
+        // The first set bit at or after `from`, size() when there is none - walks set bits word by word:
+        // for(size_t bit = mask.findNext(0); bit < mask.size(); bit = mask.findNext(bit + 1))
+        size_t findNext(size_t from) const;
+
+        bool operator==(const BoardMask& other) const;
+    };
+}
+
+#endif
@@ -2,7 +2,7 @@
 #define CARD_HPP
 
 #include <string>
-#include "Player.hpp"
+#include <string_view>
 
 namespace catan_game
 {
@@ -13,7 +13,8 @@ namespace catan_game
         
         virtual ~Card() {}  // Virtual destructor
         virtual int getPoints() const = 0; 
-        virtual std::string getName() const = 0;
+        // the name is a view of a literal or a member of the card, comparing it never allocates
+        virtual std::string_view getName() const = 0;
 
     };
 }
@@ -0,0 +1,19 @@
+#ifndef DISCARDPOLICY_HPP
+#define DISCARDPOLICY_HPP
+
+#include "Resources.hpp"
+
+namespace catan_game
+{
+    // Chooses the resources a player gives back after a 7, without asking anybody.
+    // Bots supply their own policy by implementing chooseDiscard.
+    class DiscardPolicy {
+    public:
+
+        virtual ~DiscardPolicy() {}  // Virtual destructor
+
+        // The amounts to discard from the hand - numOfCards in total, none more than the hand holds
+        virtual ResourceVector chooseDiscard(const ResourceVector& hand, int numOfCards) = 0;
+    };
+}
+#endif
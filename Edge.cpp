@@ -3,7 +3,7 @@
 
 namespace catan_game{
 
-    Edge::Edge(Vertex *pt_ver1, Vertex *pt_ver2)
+    Edge::Edge(Vertex *pt_ver1, Vertex *pt_ver2, const allocator_type& allocator) : edgeNeighbours(allocator)
     {
         edgeVertices.first = pt_ver1;
         edgeVertices.second = pt_ver2;
@@ -15,7 +15,7 @@ namespace catan_game{
         return edgeVertices;
     }
 
-    const std::vector<Edge *>& Edge::getNeighbours() const
+    const std::pmr::vector<Edge *>& Edge::getNeighbours() const
     {
         return edgeNeighbours;
     }
@@ -25,14 +25,14 @@ namespace catan_game{
         return this->roadOwner;
     }
 
-    bool Edge::hasRoad()
+    bool Edge::hasRoad() const
     {
         return (this->roadOwner != nullptr);
     }
 
-    void Edge::setMyNeighbors(std::vector<Edge *> neighbors)
+    void Edge::setMyNeighbors(std::span<Edge* const> neighbors)
     {
-        this->edgeNeighbours = neighbors;
+        this->edgeNeighbours.assign(neighbors.begin(), neighbors.end());
     }
 
     void Edge::setRoad(Player* player)
@@ -1,6 +1,8 @@
 #ifndef EDGE_HPP
 #define EDGE_HPP
 #include <array>
+#include <memory_resource>
+#include <span>
 #include <vector>
 #include "Vertex.hpp"
 #include "Player.hpp"
@@ -12,18 +14,20 @@ namespace catan_game{
     
     private:
     std::pair<Vertex*,Vertex*> edgeVertices;
-    std::vector<Edge*> edgeNeighbours;
+    std::pmr::vector<Edge*> edgeNeighbours;
     Player* roadOwner;
     
     public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
         // Constructor
-        Edge(Vertex* pt_ver1, Vertex* pt_ver2);
+        Edge(Vertex* pt_ver1, Vertex* pt_ver2, const allocator_type& allocator = {});
         // edge vertex getter
         const std::pair<Vertex*,Vertex*>& getVertices() const;
-        const std::vector<Edge*>& getNeighbours() const;
+        const std::pmr::vector<Edge*>& getNeighbours() const;
         Player* getRoadOwner() const;
-        bool hasRoad();
-        void setMyNeighbors(std::vector<Edge *> neighbors);
+        bool hasRoad() const;
+        void setMyNeighbors(std::span<Edge* const> neighbors);
         void setRoad(Player* player);
         bool operator==(const Edge& edge) const;
         friend std::ostream& operator<<(std::ostream &stream, const catan_game::Edge& edg);
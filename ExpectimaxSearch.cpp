@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <limits>
+#include "ExpectimaxSearch.hpp"
+
+namespace catan_game {
+
+    constexpr double WIN_SCORE = 1e9;
+
+    ExpectimaxSearch::ExpectimaxSearch(int depthLimit) : maxDepth(depthLimit)
+    {
+    }
+
+    double ExpectimaxSearch::score(const SearchState& state, size_t rootSeat)
+    {
+        if(state.getWinner() >= 0) return (static_cast<size_t>(state.getWinner()) == rootSeat) ? WIN_SCORE : -WIN_SCORE;
+
+        double best = -std::numeric_limits<double>::infinity();
+        for(size_t seat = 0; seat < state.getNumOfSeats(); ++seat)
+        {
+            if(seat != rootSeat) best = std::max(best, state.evaluate(seat));
+        }
+        return state.evaluate(rootSeat) - (state.getNumOfSeats() > 1 ? best : 0.0);
+    }
+
+    // Best moves first for the seat to move - the root seat likes a high score, the others a low one
+    std::vector<Action> ExpectimaxSearch::orderedMoves(const SearchState& state, const Context& context) const
+    {
+        std::vector<Action> moves = state.legalMoves();
+        std::vector<std::pair<double, size_t>> keys;
+        for(size_t index = 0; index < moves.size(); ++index)
+        {
+            SearchState child = state;
+            child.apply(moves[index]);
+            double childScore = score(child, context.rootSeat);
+            keys.emplace_back(state.getCurrentSeat() == context.rootSeat ? -childScore : childScore, index);
+        }
+        std::stable_sort(keys.begin(), keys.end(), [](const auto& first, const auto& second) { return first.first < second.first; });
+
+        std::vector<Action> ordered;
+        for(const auto& key: keys)
+        {
+            ordered.push_back(moves[key.second]);
+        }
+        return ordered;
+    }
+
+    double ExpectimaxSearch::value(const SearchState& state, int depth, Context& context) const
+    {
+        ++context.numOfNodes;
+        if(depth == 0 || state.getWinner() >= 0) return score(state, context.rootSeat);
+        if((context.numOfNodes & 255) == 0 && std::chrono::steady_clock::now() > context.deadline) context.timedOut = true;
+        if(context.timedOut) return 0.0;
+
+        if(state.isChanceNode())
+        {
+            double expected = 0.0;
+            for(int roll = MIN_DICE_ROLL; roll <= MAX_DICE_ROLL; ++roll)
+            {
+                SearchState child = state;
+                child.applyRoll(roll);
+                expected += value(child, depth - 1, context) * diceWays(roll) / DICE_OUTCOMES;
+            }
+            return expected;
+        }
+
+        bool isRootSeat = state.getCurrentSeat() == context.rootSeat;
+        double best = isRootSeat ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        for(const Action& move: orderedMoves(state, context))
+        {
+            SearchState child = state;
+            child.apply(move);
+            double childValue = value(child, depth - 1, context);
+            best = isRootSeat ? std::max(best, childValue) : std::min(best, childValue);
+            if(context.timedOut) break;
+        }
+        return best;
+    }
+
+    ExpectimaxSearch::Result ExpectimaxSearch::search(const SearchState& root, std::chrono::microseconds budget) const
+    {
+        Context context{root.getCurrentSeat(), std::chrono::steady_clock::now() + budget, 0, false};
+        Result result{makeAction(ActionOpcode::None, root.getCurrentSeat()), score(root, context.rootSeat), 0, 0};
+
+        std::vector<Action> moves = orderedMoves(root, context);
+        if(moves.empty()) return result;
+        result.bestMove = moves.front();
+        if(moves.size() == 1) return result; // nothing to choose, e.g. the roll
+
+        for(int depth = 1; depth <= this->maxDepth; ++depth)
+        {
+            double bestValue = -std::numeric_limits<double>::infinity();
+            size_t bestIndex = 0;
+            for(size_t index = 0; index < moves.size() && !context.timedOut; ++index)
+            {
+                SearchState child = root;
+                child.apply(moves[index]);
+                double childValue = value(child, depth - 1, context);
+                if(!context.timedOut && childValue > bestValue)
+                {
+                    bestValue = childValue;
+                    bestIndex = index;
+                }
+            }
+            if(context.timedOut) break;
+
+            // the next depth starts from this depth's best move
+            std::rotate(moves.begin(), moves.begin() + bestIndex, moves.begin() + bestIndex + 1);
+            result.bestMove = moves.front();
+            result.value = bestValue;
+            result.depth = depth;
+        }
+        result.numOfNodes = context.numOfNodes;
+        return result;
+    }
+}
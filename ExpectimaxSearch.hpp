@@ -0,0 +1,47 @@
+#ifndef EXPECTIMAXSEARCH_HPP
+#define EXPECTIMAXSEARCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include "Action.hpp"
+#include "SearchState.hpp"
+
+namespace catan_game {
+
+    // Depth limited expectimax over a SearchState, from the root seat's point of view.
+    // The root seat picks its best move, the other seats the move worst for it, and a roll is
+    // a chance node that weighs the 11 dice sums by their odds. Depth counts moves and rolls.
+    // Iterative deepening runs until the budget is spent, children are tried in the order of their
+    // cheap evaluation (the best move of the last depth first) and an unfinished depth is thrown away.
+    class ExpectimaxSearch {
+    public:
+        struct Result {
+            Action bestMove;   // None when the root has no move
+            double value;
+            int depth;         // deepest depth searched completely
+            size_t numOfNodes;
+        };
+
+        explicit ExpectimaxSearch(int depthLimit = 8);
+
+        Result search(const SearchState& root, std::chrono::microseconds budget) const;
+
+        // Root seat's score of a state - its evaluation over the best of the other seats'
+        static double score(const SearchState& state, size_t rootSeat);
+
+    private:
+        struct Context {
+            size_t rootSeat;
+            std::chrono::steady_clock::time_point deadline;
+            size_t numOfNodes;
+            bool timedOut;
+        };
+
+        int maxDepth;
+
+        double value(const SearchState& state, int depth, Context& context) const;
+        std::vector<Action> orderedMoves(const SearchState& state, const Context& context) const;
+    };
+}
+
+#endif
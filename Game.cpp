@@ -0,0 +1,1054 @@
+#include <algorithm>
+#include <stdexcept>
+#include "Game.hpp"
+#include "Action.hpp"
+#include "Tile.hpp"
+#include "KnightCard.hpp"
+#include "VictoryPointCard.hpp"
+#include "YearOfPlentyCard.hpp"
+#include "RoadCard.hpp"
+#include "MonopolyCard.hpp"
+
+namespace catan_game {
+
+    constexpr int SEVEN_PENALTY_LIMIT = 7;
+
+    // The seed goes through a seed sequence - the first numbers of a small engine seeded with
+    // neighbouring table seeds would otherwise be alike
+    static std::minstd_rand seededEngine(unsigned seed)
+    {
+        std::seed_seq sequence{seed};
+        return std::minstd_rand(sequence);
+    }
+
+    Game::Game(const std::vector<std::string>& names, unsigned seed) :
+                    board(STANDARD_BOARD_RADIUS, seed),
+                    players(),
+                    deckCards(),
+                    usedCards(),
+                    rng(seededEngine(seed)),
+                    phase(GamePhase::SetupSettlement),
+                    currentSeat(0),
+                    setupStep(0),
+                    lastRoll(0),
+                    winner(-1),
+                    lastSetupSettlement(nullptr),
+                    pendingDiscards(names.size(), 0),
+                    tradeBook(),
+                    robberReturnPhase(GamePhase::Main),
+                    playedKnights(names.size(), 0),
+                    playedMonopolies(names.size(), 0),
+                    playedYearsOfPlenty(names.size(), 0),
+                    playedRoadBuildings(names.size(), 0),
+                    freeRoads(0),
+                    discardPolicies(names.size(), nullptr)
+    {
+        if(names.empty())
+        {
+            throw std::invalid_argument("Game must have at least one player");
+        }
+
+        for(const std::string& name: names)
+        {
+            this->players.push_back(new Player(name));
+        }
+        initCardsDeck();
+    }
+
+    Game::~Game()
+    {
+        for(Player* player: this->players)
+        {
+            delete player;
+        }
+
+        for(Card* card: this->deckCards)
+        {
+            delete card;
+        }
+
+        for(Card* card: this->usedCards)
+        {
+            delete card;
+        }
+    }
+
+    // Same deck as the interactive game, shuffled with the game seed
+    void Game::initCardsDeck()
+    {
+        for (int index = 0; index < 3; ++index) {
+            this->deckCards.push_back(new KnightCard());
+        }
+        for (int index = 0; index < 4; ++index) {
+            this->deckCards.push_back(new VictoryPointCard());
+        }
+        for (int index = 0; index < 3; ++index) {
+            this->deckCards.push_back(new YearOfPlentyCard());
+            this->deckCards.push_back(new RoadCard());
+            this->deckCards.push_back(new MonopolyCard());
+        }
+        std::shuffle(this->deckCards.begin(), this->deckCards.end(), this->rng);
+        this->usedCards.reserve(this->deckCards.size());
+    }
+
+    Board& Game::getBoard()
+    {
+        return this->board;
+    }
+
+    const Board& Game::getBoard() const
+    {
+        return this->board;
+    }
+
+    const std::vector<Player*>& Game::getPlayers() const
+    {
+        return this->players;
+    }
+
+    size_t Game::getNumOfSeats() const
+    {
+        return this->players.size();
+    }
+
+    size_t Game::getCurrentSeat() const
+    {
+        return this->currentSeat;
+    }
+
+    GamePhase Game::getPhase() const
+    {
+        return this->phase;
+    }
+
+    int Game::getLastRoll() const
+    {
+        return this->lastRoll;
+    }
+
+    int Game::getWinner() const
+    {
+        return this->winner;
+    }
+
+    int Game::getPendingDiscard(size_t seat) const
+    {
+        return seat < this->pendingDiscards.size() ? this->pendingDiscards[seat] : 0;
+    }
+
+    void Game::setDiscardPolicy(size_t seat, DiscardPolicy* policy)
+    {
+        if(seat < this->discardPolicies.size()) this->discardPolicies[seat] = policy;
+    }
+
+    const TradeBook& Game::getTradeBook() const
+    {
+        return this->tradeBook;
+    }
+
+    // Setup is a snake draft - 0,1,..,n-1 then n-1,..,1,0
+    size_t Game::setupSeat(size_t step) const
+    {
+        size_t numOfSeats = this->players.size();
+        return step < numOfSeats ? step : (2 * numOfSeats - 1 - step);
+    }
+
+    // Move to the next seat of the setup, or start the first turn when everybody placed twice
+    void Game::advanceSetup()
+    {
+        ++this->setupStep;
+        this->lastSetupSettlement = nullptr;
+        if(this->setupStep == 2 * this->players.size())
+        {
+            this->board.sendStartingResources();
+            this->currentSeat = 0;
+            this->phase = GamePhase::Roll;
+            return;
+        }
+        this->currentSeat = setupSeat(this->setupStep);
+        this->phase = GamePhase::SetupSettlement;
+    }
+
+    void Game::checkWinner(size_t seat)
+    {
+        if(this->players[seat]->getMyPoints() >= WINNING_POINTS)
+        {
+            this->winner = static_cast<int>(seat);
+            this->phase = GamePhase::Finished;
+        }
+    }
+
+    // Common checks of a turn action - the game is on, it is the seat's turn and the phase fits
+    ActionStatus Game::checkTurn(size_t seat, GamePhase expected) const
+    {
+        if(this->phase == GamePhase::Finished) return ActionStatus::GameOver;
+        if(seat != this->currentSeat) return ActionStatus::NotYourTurn;
+        if(this->phase != expected) return ActionStatus::WrongPhase;
+        return ActionStatus::Ok;
+    }
+
+    static size_t countCities(const Player* player)
+    {
+        size_t numOfCities = 0;
+        for(const Vertex* vertex: player->getMyBuildings())
+        {
+            if(vertex->isCity()) ++numOfCities;
+        }
+        return numOfCities;
+    }
+
+    ActionStatus Game::checkSettlement(size_t seat, int row, int col) const
+    {
+        bool isSetup = this->phase == GamePhase::SetupSettlement;
+        ActionStatus status = checkTurn(seat, isSetup ? GamePhase::SetupSettlement : GamePhase::Main);
+        if(status != ActionStatus::Ok) return status;
+
+        const Player* player = this->players[seat];
+        if(!isSetup && !player->hasResourcesForSettlement()) return ActionStatus::NotEnoughResources;
+        if(player->getMyBuildings().size() - countCities(player) >= MAX_SETTLEMENTS) return ActionStatus::NoPiecesLeft;
+        if(!this->board.canPlaceSettlement(row, col, player, false)) return ActionStatus::IllegalPlacement;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkCity(size_t seat, int row, int col) const
+    {
+        ActionStatus status = checkTurn(seat, GamePhase::Main);
+        if(status != ActionStatus::Ok) return status;
+
+        const Player* player = this->players[seat];
+        if(!player->hasResourcesForCity()) return ActionStatus::NotEnoughResources;
+        if(countCities(player) >= MAX_CITIES) return ActionStatus::NoPiecesLeft;
+        if(!this->board.canPlaceSettlement(row, col, player, true)) return ActionStatus::IllegalPlacement;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkRoad(size_t seat, int fromRow, int fromCol, int toRow, int toCol) const
+    {
+        bool isSetup = this->phase == GamePhase::SetupRoad;
+        ActionStatus status = checkTurn(seat, isSetup ? GamePhase::SetupRoad : GamePhase::Main);
+        if(status != ActionStatus::Ok) return status;
+
+        const Player* player = this->players[seat];
+        if(isSetup)
+        {
+            // The setup road must leave the settlement that was just placed
+            int row = this->lastSetupSettlement->getRow();
+            int col = this->lastSetupSettlement->getColumn();
+            bool touchesSettlement = (fromRow == row && fromCol == col) || (toRow == row && toCol == col);
+            if(!touchesSettlement) return ActionStatus::IllegalPlacement;
+        }
+        else if(this->freeRoads == 0 && !player->hasResourcesForRoad())
+        {
+            return ActionStatus::NotEnoughResources;
+        }
+        if(player->getMyRoads().size() >= MAX_ROADS) return ActionStatus::NoPiecesLeft;
+
+        if(!this->board.canPlaceRoad(fromRow, fromCol, toRow, toCol, player)) return ActionStatus::IllegalPlacement;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkBuyDevelopmentCard(size_t seat) const
+    {
+        ActionStatus status = checkTurn(seat, GamePhase::Main);
+        if(status != ActionStatus::Ok) return status;
+        if(this->deckCards.empty()) return ActionStatus::DeckEmpty;
+        if(!this->players[seat]->hasResourcesForDevelopmentCard()) return ActionStatus::NotEnoughResources;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkDiscard(size_t seat, const ResourceVector& amounts) const
+    {
+        if(this->phase == GamePhase::Finished) return ActionStatus::GameOver;
+        if(this->phase != GamePhase::Discard) return ActionStatus::WrongPhase;
+        if(seat >= this->players.size() || this->pendingDiscards[seat] == 0) return ActionStatus::InvalidDiscard;
+
+        if(!isValidDiscard(this->players[seat]->getResourceVector(), amounts, this->pendingDiscards[seat]))
+        {
+            return ActionStatus::InvalidDiscard;
+        }
+        return ActionStatus::Ok;
+    }
+
+    // Like the interactive game a seat may pass without rolling (e.g. after playing a card)
+    ActionStatus Game::checkEndTurn(size_t seat) const
+    {
+        return checkTurn(seat, (this->phase == GamePhase::Roll) ? GamePhase::Roll : GamePhase::Main);
+    }
+
+    ActionStatus Game::placeSettlement(size_t seat, int row, int col)
+    {
+        ActionStatus status = checkSettlement(seat, row, col);
+        if(status != ActionStatus::Ok) return status;
+
+        Vertex* vertex = this->board.placeSettlement(row, col, this->players[seat], false, this->phase == GamePhase::SetupSettlement);
+        if(vertex == nullptr) return ActionStatus::IllegalPlacement;
+
+        if(this->phase == GamePhase::SetupSettlement)
+        {
+            this->lastSetupSettlement = vertex;
+            this->phase = GamePhase::SetupRoad;
+            return ActionStatus::Ok;
+        }
+        checkWinner(seat);
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::placeCity(size_t seat, int row, int col)
+    {
+        ActionStatus status = checkCity(seat, row, col);
+        if(status != ActionStatus::Ok) return status;
+
+        if(this->board.placeSettlement(row, col, this->players[seat], true, false) == nullptr) return ActionStatus::IllegalPlacement;
+        checkWinner(seat);
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::placeRoad(size_t seat, int fromRow, int fromCol, int toRow, int toCol)
+    {
+        ActionStatus status = checkRoad(seat, fromRow, fromCol, toRow, toCol);
+        if(status != ActionStatus::Ok) return status;
+
+        bool isSetup = this->phase == GamePhase::SetupRoad;
+        bool isFree = !isSetup && this->freeRoads > 0;
+        if(this->board.placeRoad(fromRow, fromCol, toRow, toCol, this->players[seat], isSetup || isFree) == nullptr)
+        {
+            return ActionStatus::IllegalPlacement;
+        }
+        if(isFree) --this->freeRoads;
+        if(isSetup) advanceSetup();
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::rollDice(size_t seat)
+    {
+        ActionStatus status = checkTurn(seat, GamePhase::Roll);
+        if(status != ActionStatus::Ok) return status;
+
+        std::uniform_int_distribution<int> dice(1, 6);
+        this->lastRoll = dice(this->rng) + dice(this->rng);
+
+        if(this->lastRoll != SEVEN_PENALTY_LIMIT)
+        {
+            this->board.distrbuteResources(this->lastRoll);
+            this->phase = GamePhase::Main;
+            return ActionStatus::Ok;
+        }
+
+        // Rolled 7 - every player with 7 or more resources discards half of them, then the robber moves
+        this->phase = GamePhase::MoveRobber;
+        this->robberReturnPhase = GamePhase::Main;
+        for(size_t index = 0; index < this->players.size(); ++index)
+        {
+            int numOfResources = this->players[index]->getNumOfResources();
+            this->pendingDiscards[index] = (numOfResources >= SEVEN_PENALTY_LIMIT) ? numOfResources / 2 : 0;
+            if(this->pendingDiscards[index] > 0 && this->discardPolicies[index] != nullptr)
+            {
+                this->players[index]->sevenPenalty(*this->discardPolicies[index]); // decided at once, nobody is asked
+                this->pendingDiscards[index] = 0;
+            }
+            if(this->pendingDiscards[index] > 0)
+            {
+                this->phase = GamePhase::Discard;
+            }
+        }
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::discard(size_t seat, const ResourceVector& amounts)
+    {
+        ActionStatus status = checkDiscard(seat, amounts);
+        if(status != ActionStatus::Ok) return status;
+
+        this->players[seat]->addResources(-amounts);
+        this->pendingDiscards[seat] = 0;
+
+        if(std::all_of(this->pendingDiscards.begin(), this->pendingDiscards.end(), [](int left) { return left == 0; }))
+        {
+            this->phase = GamePhase::MoveRobber;
+        }
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::buyDevelopmentCard(size_t seat)
+    {
+        ActionStatus status = checkBuyDevelopmentCard(seat);
+        if(status != ActionStatus::Ok) return status;
+
+        Player* player = this->players[seat];
+        if(!player->removeResourceForDevCard()) return ActionStatus::NotEnoughResources;
+
+        Card* card = this->deckCards.back();
+        this->deckCards.pop_back();
+        this->usedCards.push_back(card);
+        player->addDevelopmentCard(card);
+        checkWinner(seat);
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::endTurn(size_t seat)
+    {
+        ActionStatus status = checkEndTurn(seat);
+        if(status != ActionStatus::Ok) return status;
+
+        this->currentSeat = (this->currentSeat + 1) % this->players.size();
+        this->phase = GamePhase::Roll;
+        this->freeRoads = 0;
+        this->tradeBook.clearOffers();
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkPlayKnight(size_t seat) const
+    {
+        ActionStatus status = checkTurn(seat, (this->phase == GamePhase::Roll) ? GamePhase::Roll : GamePhase::Main);
+        if(status != ActionStatus::Ok) return status;
+
+        const std::vector<Card*>& cards = this->players[seat]->getMyDevelopmentCards();
+        long numOfKnights = std::count_if(cards.begin(), cards.end(), [](const Card* card) { return card->getName() == "Knight"; });
+        if(numOfKnights <= this->playedKnights[seat]) return ActionStatus::NoCard;
+        return ActionStatus::Ok;
+    }
+
+    // The seat holds more of the card than it has played
+    ActionStatus Game::checkPlayCard(size_t seat, std::string_view cardName, const std::vector<int>& played) const
+    {
+        ActionStatus status = checkTurn(seat, GamePhase::Main);
+        if(status != ActionStatus::Ok) return status;
+
+        const std::vector<Card*>& cards = this->players[seat]->getMyDevelopmentCards();
+        long numOfCards = std::count_if(cards.begin(), cards.end(), [cardName](const Card* card) { return card->getName() == cardName; });
+        if(numOfCards <= played[seat]) return ActionStatus::NoCard;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkPlayYearOfPlenty(size_t seat, const ResourceVector& taken) const
+    {
+        ActionStatus status = checkPlayCard(seat, "Year of Plenty", this->playedYearsOfPlenty);
+        if(status != ActionStatus::Ok) return status;
+        if(!taken.isNonNegative() || taken.total() != YEAR_OF_PLENTY_CARDS) return ActionStatus::MalformedAction;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::playMonopoly(size_t seat, TileType type)
+    {
+        ActionStatus status = checkPlayCard(seat, "Monopoly", this->playedMonopolies);
+        if(status != ActionStatus::Ok) return status;
+        if(static_cast<int>(type) < 0 || static_cast<int>(type) >= NUM_RESOURCE_TYPES) return ActionStatus::MalformedAction;
+
+        ++this->playedMonopolies[seat];
+        for(size_t other = 0; other < this->players.size(); ++other)
+        {
+            if(other == seat) continue;
+            ResourceVector taken = makeResourceVector(0, 0, 0, 0, 0);
+            taken[type] = this->players[other]->getResourceVector()[type];
+            this->players[other]->addResources(-taken);
+            this->players[seat]->addResources(taken);
+        }
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::playYearOfPlenty(size_t seat, const ResourceVector& taken)
+    {
+        ActionStatus status = checkPlayYearOfPlenty(seat, taken);
+        if(status != ActionStatus::Ok) return status;
+
+        ++this->playedYearsOfPlenty[seat];
+        this->players[seat]->addResources(taken);
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::playRoadBuilding(size_t seat)
+    {
+        ActionStatus status = checkPlayCard(seat, "Road Building", this->playedRoadBuildings);
+        if(status != ActionStatus::Ok) return status;
+
+        ++this->playedRoadBuildings[seat];
+        this->freeRoads = ROAD_BUILDING_ROADS;
+        return ActionStatus::Ok;
+    }
+
+    int Game::getFreeRoads() const
+    {
+        return this->freeRoads;
+    }
+
+    // A victim is another seat with a building on the tile and something to steal
+    bool Game::isRobberVictim(size_t seat, int tileIndex, size_t victim) const
+    {
+        if(victim == seat || victim >= this->players.size() || this->players[victim]->getNumOfResources() == 0) return false;
+        for(const Vertex* vertex: this->board.getTiles()[tileIndex]->getVertices())
+        {
+            if(vertex->getOwner() == this->players[victim]) return true;
+        }
+        return false;
+    }
+
+    ActionStatus Game::checkMoveRobber(size_t seat, int tileIndex, int victimSeat) const
+    {
+        ActionStatus status = checkTurn(seat, GamePhase::MoveRobber);
+        if(status != ActionStatus::Ok) return status;
+        if(tileIndex < 0 || tileIndex >= static_cast<int>(this->board.getTiles().size())
+            || tileIndex == this->board.getRobberTileIndex())
+        {
+            return ActionStatus::IllegalPlacement;
+        }
+
+        if(victimSeat >= 0) return isRobberVictim(seat, tileIndex, victimSeat) ? ActionStatus::Ok : ActionStatus::IllegalPlacement;
+        for(size_t victim = 0; victim < this->players.size(); ++victim)
+        {
+            if(isRobberVictim(seat, tileIndex, victim)) return ActionStatus::IllegalPlacement; // somebody must be robbed
+        }
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::playKnight(size_t seat)
+    {
+        ActionStatus status = checkPlayKnight(seat);
+        if(status != ActionStatus::Ok) return status;
+
+        ++this->playedKnights[seat];
+        this->robberReturnPhase = this->phase;
+        this->phase = GamePhase::MoveRobber;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::moveRobber(size_t seat, int tileIndex, int victimSeat)
+    {
+        ActionStatus status = checkMoveRobber(seat, tileIndex, victimSeat);
+        if(status != ActionStatus::Ok) return status;
+
+        this->board.moveRobber(tileIndex);
+        if(victimSeat >= 0)
+        {
+            // one uniform card of the victim's hand
+            Player* victim = this->players[victimSeat];
+            ResourceVector hand = victim->getResourceVector();
+            std::uniform_int_distribution<int> card(0, hand.total() - 1);
+            ResourceVector stolen = makeResourceVector(0, 0, 0, 0, 0);
+            stolen[resourceOfCard(hand, card(this->rng))] = 1;
+            victim->addResources(-stolen);
+            this->players[seat]->addResources(stolen);
+        }
+        this->phase = this->robberReturnPhase;
+        return ActionStatus::Ok;
+    }
+
+    // Both sides are checked before anything moves, so a trade is all or nothing
+    ActionStatus Game::checkTrade(size_t seat, const ResourceVector& give, const ResourceVector& want, int toSeat) const
+    {
+        if(this->phase == GamePhase::Finished) return ActionStatus::GameOver;
+        if(this->phase != GamePhase::Main) return ActionStatus::WrongPhase;
+        if(seat >= this->players.size()) return ActionStatus::InvalidTrade;
+        if(toSeat >= static_cast<int>(this->players.size()) || toSeat == static_cast<int>(seat)) return ActionStatus::InvalidTrade;
+
+        // the other seats trade only with the seat whose turn it is
+        if(seat != this->currentSeat && toSeat != static_cast<int>(this->currentSeat)) return ActionStatus::NotYourTurn;
+
+        if(!give.isNonNegative() || !want.isNonNegative() || give.isZero() || want.isZero()) return ActionStatus::InvalidTrade;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(give[type] > 0 && want[type] > 0) return ActionStatus::InvalidTrade;
+        }
+
+        if(!this->players[seat]->getResourceVector().covers(give)) return ActionStatus::NotEnoughResources;
+        return ActionStatus::Ok;
+    }
+
+    // The resting offer's terms - its seat gives `give` and gets `want`, the taker the other way around
+    void Game::settleTrade(const TradeOffer& resting, size_t taker)
+    {
+        TradeFill fill{resting.id, resting.seat, taker, resting.give, resting.want};
+        this->players[resting.seat]->addResources(resting.want - resting.give);
+        this->players[taker]->addResources(resting.give - resting.want);
+        this->tradeBook.remove(resting.id);
+        this->tradeBook.addFill(fill);
+    }
+
+    ActionStatus Game::postTrade(size_t seat, const ResourceVector& give, const ResourceVector& want, int toSeat, int counterTo)
+    {
+        if(counterTo >= 0)
+        {
+            const TradeOffer* countered = this->tradeBook.find(counterTo);
+            if(countered == nullptr) return ActionStatus::InvalidTrade;
+            toSeat = static_cast<int>(countered->seat);
+        }
+
+        ActionStatus status = checkTrade(seat, give, want, toSeat);
+        if(status != ActionStatus::Ok) return status;
+
+        TradeOffer offer{0, seat, toSeat, counterTo, give, want};
+        int index = this->tradeBook.findMatch(offer);
+        while(index >= 0)
+        {
+            const TradeOffer& resting = this->tradeBook.getOffers()[index];
+            if(this->players[resting.seat]->getResourceVector().covers(resting.give))
+            {
+                settleTrade(resting, seat);
+                return ActionStatus::Ok;
+            }
+            // the resting seat spent the resources since it posted - drop the stale offer
+            this->tradeBook.remove(resting.id);
+            index = this->tradeBook.findMatch(offer, static_cast<size_t>(index));
+        }
+
+        this->tradeBook.add(offer);
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkAcceptTrade(size_t seat, int offerId) const
+    {
+        const TradeOffer* offer = this->tradeBook.find(offerId);
+        if(offer == nullptr) return ActionStatus::InvalidTrade;
+        if(offer->toSeat >= 0 && static_cast<size_t>(offer->toSeat) != seat) return ActionStatus::InvalidTrade;
+
+        ActionStatus status = checkTrade(seat, offer->want, offer->give, static_cast<int>(offer->seat));
+        if(status != ActionStatus::Ok) return status;
+        if(!this->players[offer->seat]->getResourceVector().covers(offer->give)) return ActionStatus::NotEnoughResources;
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::checkCancelTrade(size_t seat, int offerId) const
+    {
+        const TradeOffer* offer = this->tradeBook.find(offerId);
+        return (offer != nullptr && offer->seat == seat) ? ActionStatus::Ok : ActionStatus::InvalidTrade;
+    }
+
+    ActionStatus Game::acceptTrade(size_t seat, int offerId)
+    {
+        ActionStatus status = checkAcceptTrade(seat, offerId);
+        if(status != ActionStatus::Ok) return status;
+        settleTrade(*this->tradeBook.find(offerId), seat);
+        return ActionStatus::Ok;
+    }
+
+    ActionStatus Game::cancelTrade(size_t seat, int offerId)
+    {
+        ActionStatus status = checkCancelTrade(seat, offerId);
+        if(status != ActionStatus::Ok) return status;
+        this->tradeBook.remove(offerId);
+        return ActionStatus::Ok;
+    }
+
+    // The rates come from the player's table, nothing here walks the buildings
+    ActionStatus Game::checkBankTrade(size_t seat, const ResourceVector& give, const ResourceVector& want) const
+    {
+        ActionStatus status = checkTrade(seat, give, want, -1);
+        if(status != ActionStatus::Ok) return status;
+
+        const Player* player = this->players[seat];
+        int numOfBought = 0;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            int rate = player->getTradeRate(static_cast<TileType>(type));
+            if(give[type] % rate != 0) return ActionStatus::InvalidTrade;
+            numOfBought += give[type] / rate;
+        }
+        return (numOfBought == want.total()) ? ActionStatus::Ok : ActionStatus::InvalidTrade;
+    }
+
+    ActionStatus Game::bankTrade(size_t seat, const ResourceVector& give, const ResourceVector& want)
+    {
+        ActionStatus status = checkBankTrade(seat, give, want);
+        if(status != ActionStatus::Ok) return status;
+        this->players[seat]->addResources(want - give);
+        return ActionStatus::Ok;
+    }
+
+    // One pass over the batch against the same state - every action is decoded and checked,
+    // nothing is allocated, placed or paid
+    void Game::validate(std::span<const Action> actions, std::span<ActionStatus> statuses) const
+    {
+        size_t numOfActions = std::min(actions.size(), statuses.size());
+        for(size_t index = 0; index < numOfActions; ++index)
+        {
+            const Action& action = actions[index];
+            ActionStatus status = validateAction(action, this->players.size());
+            if(status == ActionStatus::Ok)
+            {
+                int row = -1, col = -1, toRow = -1, toCol = -1;
+                switch(action.opcode)
+                {
+                    case ActionOpcode::RollDice:
+                        status = checkTurn(action.seat, GamePhase::Roll);
+                        break;
+                    case ActionOpcode::EndTurn:
+                        status = checkEndTurn(action.seat);
+                        break;
+                    case ActionOpcode::BuyDevelopmentCard:
+                        status = checkBuyDevelopmentCard(action.seat);
+                        break;
+                    case ActionOpcode::BuildSettlement:
+                        decodeVertex(action.target, row, col);
+                        status = checkSettlement(action.seat, row, col);
+                        break;
+                    case ActionOpcode::BuildCity:
+                        decodeVertex(action.target, row, col);
+                        status = checkCity(action.seat, row, col);
+                        break;
+                    case ActionOpcode::BuildRoad:
+                        decodeEdge(action.target, row, col, toRow, toCol);
+                        status = checkRoad(action.seat, row, col, toRow, toCol);
+                        break;
+                    case ActionOpcode::Discard:
+                        status = checkDiscard(action.seat, action.resources);
+                        break;
+                    case ActionOpcode::PostTrade:
+                    {
+                        ResourceVector give, want;
+                        splitTradeResources(action.resources, give, want);
+                        status = checkTrade(action.seat, give, want, static_cast<int>(action.target) - 1);
+                        break;
+                    }
+                    case ActionOpcode::AcceptTrade:
+                        status = checkAcceptTrade(action.seat, action.target);
+                        break;
+                    case ActionOpcode::CancelTrade:
+                        status = checkCancelTrade(action.seat, action.target);
+                        break;
+                    case ActionOpcode::BankTrade:
+                    {
+                        ResourceVector give, want;
+                        splitTradeResources(action.resources, give, want);
+                        status = checkBankTrade(action.seat, give, want);
+                        break;
+                    }
+                    case ActionOpcode::PlayKnight:
+                        status = checkPlayKnight(action.seat);
+                        break;
+                    case ActionOpcode::PlayMonopoly:
+                        status = checkPlayCard(action.seat, "Monopoly", this->playedMonopolies);
+                        break;
+                    case ActionOpcode::PlayYearOfPlenty:
+                        status = checkPlayYearOfPlenty(action.seat, action.resources);
+                        break;
+                    case ActionOpcode::PlayRoadBuilding:
+                        status = checkPlayCard(action.seat, "Road Building", this->playedRoadBuildings);
+                        break;
+                    case ActionOpcode::MoveRobber:
+                        status = checkMoveRobber(action.seat, robberTileOf(action), robberVictimOf(action));
+                        break;
+                    default:
+                        status = ActionStatus::MalformedAction;
+                        break;
+                }
+            }
+            statuses[index] = status;
+        }
+    }
+
+    // Save what the action may change - the trade book only for the actions that touch it
+    ActionStatus Game::apply(const Action& action, UndoRecord& undo)
+    {
+        undo.status = ActionStatus::MalformedAction;
+        undo.opcode = action.opcode;
+        undo.seat = action.seat;
+        undo.vertex = nullptr;
+        undo.edge = nullptr;
+        undo.phase = this->phase;
+        undo.robberReturnPhase = this->robberReturnPhase;
+        undo.currentSeat = this->currentSeat;
+        undo.setupStep = this->setupStep;
+        undo.lastRoll = this->lastRoll;
+        undo.winner = this->winner;
+        undo.robberTileIndex = this->board.getRobberTileIndex();
+        undo.playedKnights = (action.seat < this->playedKnights.size()) ? this->playedKnights[action.seat] : 0;
+        undo.playedCards = 0;
+        undo.freeRoads = this->freeRoads;
+        undo.lastSetupSettlement = this->lastSetupSettlement;
+        undo.rng = this->rng;
+        undo.hands.resize(this->players.size());
+        for(size_t seat = 0; seat < this->players.size(); ++seat)
+        {
+            undo.hands[seat] = this->players[seat]->getResourceVector();
+        }
+        undo.pendingDiscards.assign(this->pendingDiscards.begin(), this->pendingDiscards.end());
+        undo.offers.clear();
+        undo.numOfFills = this->tradeBook.getNumOfFills();
+        undo.overwrittenFill = this->tradeBook.getOverwrittenFill();
+        undo.nextOfferId = this->tradeBook.getNextOfferId();
+
+        ActionStatus status = validateAction(action, this->players.size());
+        if(status != ActionStatus::Ok)
+        {
+            undo.status = status;
+            return status;
+        }
+
+        int row = -1, col = -1, toRow = -1, toCol = -1;
+        ResourceVector give, want;
+        switch(action.opcode)
+        {
+            case ActionOpcode::RollDice:
+                status = rollDice(action.seat);
+                break;
+            case ActionOpcode::EndTurn:
+                undo.offers.assign(this->tradeBook.getOffers().begin(), this->tradeBook.getOffers().end());
+                status = endTurn(action.seat);
+                break;
+            case ActionOpcode::BuyDevelopmentCard:
+                status = buyDevelopmentCard(action.seat);
+                break;
+            case ActionOpcode::BuildSettlement:
+                decodeVertex(action.target, row, col);
+                undo.vertex = this->board.getVertex(row, col);
+                status = placeSettlement(action.seat, row, col);
+                break;
+            case ActionOpcode::BuildCity:
+                decodeVertex(action.target, row, col);
+                undo.vertex = this->board.getVertex(row, col);
+                status = placeCity(action.seat, row, col);
+                break;
+            case ActionOpcode::BuildRoad:
+                decodeEdge(action.target, row, col, toRow, toCol);
+                undo.edge = this->board.findEdge(row, col, toRow, toCol);
+                status = placeRoad(action.seat, row, col, toRow, toCol);
+                break;
+            case ActionOpcode::Discard:
+                status = discard(action.seat, action.resources);
+                break;
+            case ActionOpcode::PostTrade:
+                undo.offers.assign(this->tradeBook.getOffers().begin(), this->tradeBook.getOffers().end());
+                splitTradeResources(action.resources, give, want);
+                status = postTrade(action.seat, give, want, static_cast<int>(action.target) - 1);
+                break;
+            case ActionOpcode::AcceptTrade:
+                undo.offers.assign(this->tradeBook.getOffers().begin(), this->tradeBook.getOffers().end());
+                status = acceptTrade(action.seat, action.target);
+                break;
+            case ActionOpcode::CancelTrade:
+                undo.offers.assign(this->tradeBook.getOffers().begin(), this->tradeBook.getOffers().end());
+                status = cancelTrade(action.seat, action.target);
+                break;
+            case ActionOpcode::BankTrade:
+                splitTradeResources(action.resources, give, want);
+                status = bankTrade(action.seat, give, want);
+                break;
+            case ActionOpcode::PlayKnight:
+                status = playKnight(action.seat);
+                break;
+            case ActionOpcode::MoveRobber:
+                status = moveRobber(action.seat, robberTileOf(action), robberVictimOf(action));
+                break;
+            case ActionOpcode::PlayMonopoly:
+                undo.playedCards = this->playedMonopolies[action.seat];
+                status = playMonopoly(action.seat, static_cast<TileType>(action.target));
+                break;
+            case ActionOpcode::PlayYearOfPlenty:
+                undo.playedCards = this->playedYearsOfPlenty[action.seat];
+                status = playYearOfPlenty(action.seat, action.resources);
+                break;
+            case ActionOpcode::PlayRoadBuilding:
+                undo.playedCards = this->playedRoadBuildings[action.seat];
+                status = playRoadBuilding(action.seat);
+                break;
+            default:
+                status = ActionStatus::MalformedAction;
+                break;
+        }
+        undo.status = status;
+        return status;
+    }
+
+    // The pieces and cards go back first, then the saved hands and turn state overwrite the rest
+    void Game::undo(const UndoRecord& record)
+    {
+        if(record.status != ActionStatus::Ok) return;
+
+        switch(record.opcode)
+        {
+            case ActionOpcode::BuildSettlement:
+                this->board.removeBuilding(record.vertex, false);
+                break;
+            case ActionOpcode::BuildCity:
+                this->board.removeBuilding(record.vertex, true);
+                break;
+            case ActionOpcode::BuildRoad:
+                this->board.removeRoad(record.edge);
+                break;
+            case ActionOpcode::BuyDevelopmentCard:
+                this->players[record.seat]->undoDevelopmentCard();
+                this->deckCards.push_back(this->usedCards.back());
+                this->usedCards.pop_back();
+                break;
+            case ActionOpcode::PlayKnight:
+                this->playedKnights[record.seat] = record.playedKnights;
+                break;
+            case ActionOpcode::PlayMonopoly:
+                this->playedMonopolies[record.seat] = record.playedCards;
+                break;
+            case ActionOpcode::PlayYearOfPlenty:
+                this->playedYearsOfPlenty[record.seat] = record.playedCards;
+                break;
+            case ActionOpcode::PlayRoadBuilding:
+                this->playedRoadBuildings[record.seat] = record.playedCards;
+                break;
+            case ActionOpcode::MoveRobber:
+                this->board.moveRobber(record.robberTileIndex);
+                break;
+            case ActionOpcode::EndTurn:
+            case ActionOpcode::PostTrade:
+            case ActionOpcode::AcceptTrade:
+            case ActionOpcode::CancelTrade:
+                this->tradeBook.rollback(record.offers, record.numOfFills, record.nextOfferId, record.overwrittenFill);
+                break;
+            default:
+                break;
+        }
+
+        for(size_t seat = 0; seat < this->players.size(); ++seat)
+        {
+            Player* player = this->players[seat];
+            player->addResources(record.hands[seat] - player->getResourceVector());
+        }
+        std::copy(record.pendingDiscards.begin(), record.pendingDiscards.end(), this->pendingDiscards.begin());
+        this->phase = record.phase;
+        this->robberReturnPhase = record.robberReturnPhase;
+        this->currentSeat = record.currentSeat;
+        this->setupStep = record.setupStep;
+        this->lastRoll = record.lastRoll;
+        this->freeRoads = record.freeRoads;
+        this->winner = record.winner;
+        this->lastSetupSettlement = record.lastSetupSettlement;
+        this->rng = record.rng;
+    }
+
+    // FNV-1a over the values, one 64 bit word at a time
+    static void hashValue(uint64_t& hash, uint64_t value)
+    {
+        constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+        hash = (hash ^ value) * FNV_PRIME;
+    }
+
+    static void hashResources(uint64_t& hash, const ResourceVector& resources)
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            hashValue(hash, static_cast<uint64_t>(resources[type]));
+        }
+    }
+
+    uint64_t Game::stateHash() const
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        auto seatOf = [this](const Player* player) -> uint64_t
+        {
+            auto it = std::find(this->players.begin(), this->players.end(), player);
+            return (it == this->players.end()) ? 0 : static_cast<uint64_t>(it - this->players.begin()) + 1;
+        };
+
+        for(int row = 0; row < this->board.getNumOfRows(); ++row)
+        {
+            for(int col = 0; col < this->board.getNumOfCols(); ++col)
+            {
+                const Vertex* vertex = this->board.getVertex(row, col);
+                if(vertex != nullptr) hashValue(hash, seatOf(vertex->getOwner()) * 2 + (vertex->isCity() ? 1 : 0));
+            }
+        }
+        for(const Edge* edge: this->board.getEdges())
+        {
+            hashValue(hash, seatOf(edge->getRoadOwner()));
+        }
+        hashValue(hash, static_cast<uint64_t>(this->board.getRobberTileIndex()));
+
+        for(size_t seat = 0; seat < this->players.size(); ++seat)
+        {
+            const Player* player = this->players[seat];
+            hashResources(hash, player->getResourceVector());
+            hashResources(hash, player->getExpectedIncome());
+            hashValue(hash, static_cast<uint64_t>(player->getMyPoints()));
+            hashValue(hash, player->getMyRoads().size());
+            hashValue(hash, player->getMyBuildings().size());
+            for(int rate: player->getTradeRates())
+            {
+                hashValue(hash, static_cast<uint64_t>(rate));
+            }
+            for(const Card* card: player->getMyDevelopmentCards())
+            {
+                hashValue(hash, std::hash<std::string_view>()(card->getName()));
+            }
+            hashValue(hash, static_cast<uint64_t>(this->pendingDiscards[seat]));
+            hashValue(hash, static_cast<uint64_t>(this->playedKnights[seat]));
+            hashValue(hash, static_cast<uint64_t>(this->playedMonopolies[seat]));
+            hashValue(hash, static_cast<uint64_t>(this->playedYearsOfPlenty[seat]));
+            hashValue(hash, static_cast<uint64_t>(this->playedRoadBuildings[seat]));
+        }
+
+        hashValue(hash, this->deckCards.size());
+        for(const TradeOffer& offer: this->tradeBook.getOffers())
+        {
+            hashValue(hash, static_cast<uint64_t>(offer.id));
+            hashValue(hash, offer.seat);
+            hashValue(hash, static_cast<uint64_t>(offer.toSeat));
+            hashResources(hash, offer.give);
+            hashResources(hash, offer.want);
+        }
+        hashValue(hash, this->tradeBook.getNumOfFills());
+        hashValue(hash, static_cast<uint64_t>(this->tradeBook.getNextOfferId()));
+
+        hashValue(hash, static_cast<uint64_t>(this->phase));
+        hashValue(hash, static_cast<uint64_t>(this->robberReturnPhase));
+        hashValue(hash, this->currentSeat);
+        hashValue(hash, this->setupStep);
+        hashValue(hash, static_cast<uint64_t>(this->lastRoll));
+        hashValue(hash, static_cast<uint64_t>(this->freeRoads));
+        hashValue(hash, static_cast<uint64_t>(this->winner));
+        const Vertex* setupSettlement = this->lastSetupSettlement;
+        hashValue(hash, (setupSettlement == nullptr) ? 0 : encodeVertex(setupSettlement->getRow(), setupSettlement->getColumn()) + 1);
+        std::minstd_rand dice = this->rng;
+        hashValue(hash, dice());
+        return hash;
+    }
+
+    std::string actionStatusToString(ActionStatus status)
+    {
+        switch (status) {
+            case ActionStatus::Ok:
+                return "Ok";
+            case ActionStatus::NotYourTurn:
+                return "NotYourTurn";
+            case ActionStatus::WrongPhase:
+                return "WrongPhase";
+            case ActionStatus::IllegalPlacement:
+                return "IllegalPlacement";
+            case ActionStatus::NotEnoughResources:
+                return "NotEnoughResources";
+            case ActionStatus::DeckEmpty:
+                return "DeckEmpty";
+            case ActionStatus::InvalidDiscard:
+                return "InvalidDiscard";
+            case ActionStatus::MalformedAction:
+                return "MalformedAction";
+            case ActionStatus::InvalidTrade:
+                return "InvalidTrade";
+            case ActionStatus::NoCard:
+                return "NoCard";
+            case ActionStatus::GameOver:
+                return "GameOver";
+            case ActionStatus::NoPiecesLeft:
+                return "NoPiecesLeft";
+            default:
+                return "Unknown";
+        }
+    }
+
+    std::string gamePhaseToString(GamePhase phase)
+    {
+        switch (phase) {
+            case GamePhase::SetupSettlement:
+                return "SetupSettlement";
+            case GamePhase::SetupRoad:
+                return "SetupRoad";
+            case GamePhase::Roll:
+                return "Roll";
+            case GamePhase::Discard:
+                return "Discard";
+            case GamePhase::MoveRobber:
+                return "MoveRobber";
+            case GamePhase::Main:
+                return "Main";
+            case GamePhase::Finished:
+                return "Finished";
+            default:
+                return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,218 @@
+#ifndef GAME_HPP
+#define GAME_HPP
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Board.hpp"
+#include "Player.hpp"
+#include "Card.hpp"
+#include "Resources.hpp"
+#include "TradeBook.hpp"
+#include "DiscardPolicy.hpp"
+
+namespace catan_game {
+
+    // The phase of a game, every action is legal only in some of the phases
+    enum class GamePhase {
+        SetupSettlement,
+        SetupRoad,
+        Roll,
+        Discard,
+        MoveRobber,
+        Main,
+        Finished
+    };
+
+    // Resources a year of plenty takes from the bank
+    constexpr int YEAR_OF_PLENTY_CARDS = 2;
+
+    // Roads a road building places without paying
+    constexpr int ROAD_BUILDING_ROADS = 2;
+
+    // Result of an action applied to a game
+    enum class ActionStatus {
+        Ok,
+        NotYourTurn,
+        WrongPhase,
+        IllegalPlacement,
+        NotEnoughResources,
+        DeckEmpty,
+        InvalidDiscard,
+        MalformedAction,
+        InvalidTrade,
+        NoCard,
+        GameOver,
+        NoPiecesLeft    // the seat has built all its roads, settlements or cities
+    };
+
+    struct Action;
+    enum class ActionOpcode : uint8_t;
+
+    // What Game::apply changed, enough for Game::undo to put the game back exactly. The hands of the
+    // seats and the trade offers are copied into the vectors, so a record reused at the same search
+    // depth stops allocating once its vectors have grown.
+    struct UndoRecord {
+        ActionStatus status;        // Ok when there is something to undo
+        ActionOpcode opcode;
+        size_t seat;
+        Vertex* vertex;             // the settlement or city built
+        Edge* edge;                 // the road built
+        GamePhase phase;
+        GamePhase robberReturnPhase;
+        size_t currentSeat;
+        size_t setupStep;
+        int lastRoll;
+        int winner;
+        int robberTileIndex;
+        int playedKnights;          // of the seat
+        int playedCards;            // monopolies, years of plenty or road buildings of the seat, by the opcode
+        int freeRoads;              // of a road building, the roads built with it take them
+        Vertex* lastSetupSettlement;
+        std::minstd_rand rng;
+        std::vector<ResourceVector> hands;
+        std::vector<int> pendingDiscards;
+        std::vector<TradeOffer> offers; // only for the actions that change the trade book
+        size_t numOfFills;
+        TradeFill overwrittenFill;      // the ring slot a settled trade writes over
+        int nextOfferId;
+    };
+
+    // One table of Catan - owns its board, players and development cards deck.
+    // Unlike the interactive game in catan.cpp nothing here reads from the console,
+    // every decision arrives as an action of a seat, so a server can host many games at once.
+    class Game {
+    private:
+        Board board;
+        std::vector<Player*> players;
+        std::vector<Card*> deckCards;
+        std::vector<Card*> usedCards;
+        std::minstd_rand rng; // one word of state, so an undo record carries it
+        GamePhase phase;
+        size_t currentSeat;
+        size_t setupStep;
+        int lastRoll;
+        int winner;
+        Vertex* lastSetupSettlement;
+        std::vector<int> pendingDiscards;
+        TradeBook tradeBook;
+        GamePhase robberReturnPhase; // phase the turn goes back to once the robber moved
+        std::vector<int> playedKnights; // knights stay in the hand for the largest army, played ones are counted
+        std::vector<int> playedMonopolies; // like the knights, the played progress cards stay in the hand
+        std::vector<int> playedYearsOfPlenty;
+        std::vector<int> playedRoadBuildings;
+        int freeRoads; // roads of the current seat's road building still to place, dropped at the end of the turn
+        std::vector<DiscardPolicy*> discardPolicies; // not owned, nullptr asks the seat for a Discard action
+
+        void initCardsDeck();
+        size_t setupSeat(size_t step) const;
+        void advanceSetup();
+        void checkWinner(size_t seat);
+
+        // Rule checks shared by the actions and validate() - never change the game
+        ActionStatus checkTurn(size_t seat, GamePhase expected) const;
+        ActionStatus checkSettlement(size_t seat, int row, int col) const;
+        ActionStatus checkCity(size_t seat, int row, int col) const;
+        ActionStatus checkRoad(size_t seat, int fromRow, int fromCol, int toRow, int toCol) const;
+        ActionStatus checkBuyDevelopmentCard(size_t seat) const;
+        ActionStatus checkDiscard(size_t seat, const ResourceVector& amounts) const;
+        ActionStatus checkEndTurn(size_t seat) const;
+        ActionStatus checkTrade(size_t seat, const ResourceVector& give, const ResourceVector& want, int toSeat) const;
+        ActionStatus checkAcceptTrade(size_t seat, int offerId) const;
+        ActionStatus checkCancelTrade(size_t seat, int offerId) const;
+        ActionStatus checkBankTrade(size_t seat, const ResourceVector& give, const ResourceVector& want) const;
+        void settleTrade(const TradeOffer& resting, size_t taker);
+        ActionStatus checkPlayKnight(size_t seat) const;
+        ActionStatus checkPlayCard(size_t seat, std::string_view cardName, const std::vector<int>& played) const;
+        ActionStatus checkPlayYearOfPlenty(size_t seat, const ResourceVector& taken) const;
+        ActionStatus checkMoveRobber(size_t seat, int tileIndex, int victimSeat) const;
+        bool isRobberVictim(size_t seat, int tileIndex, size_t victim) const;
+
+    public:
+        static constexpr int WINNING_POINTS = 10;
+
+        // Create a game for the players names, the seed drives the dice and the deck shuffle
+        Game(const std::vector<std::string>& names, unsigned seed);
+        ~Game();
+
+        Game(const Game&) = delete;
+        Game& operator=(const Game&) = delete;
+
+        Board& getBoard();
+        const Board& getBoard() const;
+        const std::vector<Player*>& getPlayers() const;
+        size_t getNumOfSeats() const;
+        size_t getCurrentSeat() const;
+        GamePhase getPhase() const;
+        int getLastRoll() const;
+        int getWinner() const;
+
+        // number of resources the seat still has to discard after a 7 was rolled
+        int getPendingDiscard(size_t seat) const;
+
+        // Let the policy discard for the seat after a 7 instead of waiting for its Discard action,
+        // nullptr goes back to asking. The game doesn't own the policy.
+        void setDiscardPolicy(size_t seat, DiscardPolicy* policy);
+
+        // offers of the current turn and every trade settled in the game
+        const TradeBook& getTradeBook() const;
+
+        ActionStatus placeSettlement(size_t seat, int row, int col);
+        ActionStatus placeCity(size_t seat, int row, int col);
+        ActionStatus placeRoad(size_t seat, int fromRow, int fromCol, int toRow, int toCol);
+        ActionStatus rollDice(size_t seat);
+        ActionStatus buyDevelopmentCard(size_t seat);
+        ActionStatus discard(size_t seat, const ResourceVector& amounts);
+        ActionStatus endTurn(size_t seat);
+
+        // Trades of the main phase - every trade has the current seat on one side.
+        // A posted offer is settled at once against the earliest compatible resting offer,
+        // otherwise it rests in the book until it is taken, cancelled or the turn ends.
+        // A counter offer (counterTo = id) is directed to the seat of the offer it counters.
+        ActionStatus postTrade(size_t seat, const ResourceVector& give, const ResourceVector& want,
+                               int toSeat = -1, int counterTo = -1);
+        ActionStatus acceptTrade(size_t seat, int offerId);
+        ActionStatus cancelTrade(size_t seat, int offerId);
+
+        // Trade with the bank at the seat's rates - every wanted resource costs `rate` of one given resource
+        ActionStatus bankTrade(size_t seat, const ResourceVector& give, const ResourceVector& want);
+
+        // Play a knight before or after rolling - the seat moves the robber before anything else
+        ActionStatus playKnight(size_t seat);
+
+        // Move the robber away from its tile after a 7 or a knight and steal one random resource of the victim.
+        // The victim must have a building on the new tile and resources, -1 only when nobody there can be robbed.
+        ActionStatus moveRobber(size_t seat, int tileIndex, int victimSeat = -1);
+
+        // Progress cards of the main phase - a monopoly takes every card of the resource from the other seats,
+        // a year of plenty takes YEAR_OF_PLENTY_CARDS resources of the seat's choice from the bank,
+        // a road building lets the next ROAD_BUILDING_ROADS roads of the turn be placed without paying
+        ActionStatus playMonopoly(size_t seat, TileType type);
+        ActionStatus playYearOfPlenty(size_t seat, const ResourceVector& taken);
+        ActionStatus playRoadBuilding(size_t seat);
+        int getFreeRoads() const;
+
+        // Apply the action like the seat's own call would, and record what undo needs to put it back.
+        // undo takes the records back in the reverse order they were applied - a depth first search
+        // walks a single game this way instead of copying it at every node.
+        ActionStatus apply(const Action& action, UndoRecord& undo);
+        void undo(const UndoRecord& record);
+
+        // Hash of everything the actions change - the board pieces, robber, hands, cards, points, phase,
+        // turn, trade book and the dice generator. Equal games hash equal.
+        uint64_t stateHash() const;
+
+        // Status every action would get if it was applied alone to the current state,
+        // statuses[i] answers actions[i]. Nothing is placed or paid, the game is unchanged.
+        void validate(std::span<const Action> actions, std::span<ActionStatus> statuses) const;
+    };
+
+    std::string actionStatusToString(ActionStatus status);
+    std::string gamePhaseToString(GamePhase phase);
+}
+
+#endif
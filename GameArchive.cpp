@@ -0,0 +1,436 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GameArchive.hpp"
+
+namespace catan_game {
+
+    constexpr char ARCHIVE_MAGIC[8] = {'C', 'A', 'T', 'A', 'N', 'A', 'R', 'C'};
+    constexpr uint32_t ARCHIVE_VERSION = 1;
+
+    struct ArchiveHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t numOfGames;
+    };
+    static_assert(sizeof(ArchiveHeader) == 24, "The header layout is the file format");
+
+    // The lookup file - the header, then numOfGames pairs of seed and game sorted by seed, the starts of
+    // the winner buckets and their games, the starts of the turn buckets and their games. All uint32_t.
+    constexpr char LOOKUP_MAGIC[8] = {'C', 'A', 'T', 'A', 'N', 'L', 'K', 'P'};
+    constexpr size_t NUM_WINNER_BUCKETS = ARCHIVE_MAX_SEATS + 1; // the turn limit stops, then every seat
+
+    struct LookupHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t numOfTurnBuckets;
+        uint64_t numOfGames;
+    };
+    static_assert(sizeof(LookupHeader) == 24, "The header layout is the file format");
+
+    static std::string actionsPath(const std::string& path)
+    {
+        return path + ".actions";
+    }
+
+    static std::string lookupPath(const std::string& path)
+    {
+        return path + ".lookup";
+    }
+
+    static size_t lookupBytes(size_t numOfGames)
+    {
+        return sizeof(LookupHeader) + sizeof(uint32_t) * (4 * numOfGames + NUM_WINNER_BUCKETS + 1 + ARCHIVE_NUM_TURN_BUCKETS + 1);
+    }
+
+    // A winner outside the seats (a damaged record) is bucketed with the games nobody won
+    static size_t winnerBucket(const ArchivedGame& game)
+    {
+        return (game.winner >= 0 && static_cast<size_t>(game.winner) < ARCHIVE_MAX_SEATS) ? static_cast<size_t>(game.winner) + 1 : 0;
+    }
+
+    // Counting sort of the games into buckets, a stable one so every bucket keeps the archive's order
+    template<typename BucketOf>
+    static uint32_t* writeBuckets(std::span<const ArchivedGame> games, size_t numOfBuckets, BucketOf bucketOf, uint32_t* out)
+    {
+        uint32_t* starts = out;
+        uint32_t* bucketGames = out + numOfBuckets + 1;
+        std::fill(starts, bucketGames, 0);
+        for(const ArchivedGame& game: games)
+        {
+            ++starts[bucketOf(game) + 1];
+        }
+        for(size_t bucket = 0; bucket < numOfBuckets; ++bucket)
+        {
+            starts[bucket + 1] += starts[bucket];
+        }
+        std::vector<uint32_t> next(starts, starts + numOfBuckets);
+        for(size_t game = 0; game < games.size(); ++game)
+        {
+            bucketGames[next[bucketOf(games[game])]++] = static_cast<uint32_t>(game);
+        }
+        return bucketGames + games.size();
+    }
+
+    static std::vector<uint8_t> buildLookup(std::span<const ArchivedGame> games)
+    {
+        std::vector<uint8_t> lookup(lookupBytes(games.size()));
+        LookupHeader header;
+        std::memcpy(header.magic, LOOKUP_MAGIC, sizeof(LOOKUP_MAGIC));
+        header.version = ARCHIVE_VERSION;
+        header.numOfTurnBuckets = ARCHIVE_NUM_TURN_BUCKETS;
+        header.numOfGames = games.size();
+        std::memcpy(lookup.data(), &header, sizeof(header));
+
+        uint32_t* out = reinterpret_cast<uint32_t*>(lookup.data() + sizeof(header));
+        std::vector<std::pair<uint32_t, uint32_t>> seeds(games.size());
+        for(size_t game = 0; game < games.size(); ++game)
+        {
+            seeds[game] = {games[game].seed, static_cast<uint32_t>(game)};
+        }
+        std::sort(seeds.begin(), seeds.end());
+        for(const auto& [seed, game]: seeds)
+        {
+            *out++ = seed;
+            *out++ = game;
+        }
+        out = writeBuckets(games, NUM_WINNER_BUCKETS, winnerBucket, out);
+        writeBuckets(games, ARCHIVE_NUM_TURN_BUCKETS, [](const ArchivedGame& game) { return archiveTurnBucket(game.numOfTurns); }, out);
+        return lookup;
+    }
+
+    static bool isArchiveHeader(const ArchiveHeader& header)
+    {
+        return std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0
+            && header.version == ARCHIVE_VERSION && header.recordSize == sizeof(ArchivedGame);
+    }
+
+    static void writeAll(int fd, const void* data, size_t size, uint64_t offset)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        while(size > 0)
+        {
+            ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+            if(written < 0)
+            {
+                if(errno == EINTR) continue;
+                throw std::runtime_error(std::string("archive write: ") + std::strerror(errno));
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+    }
+
+    GameArchiveWriter::GameArchiveWriter(const std::string& path) :
+                    path(path),
+                    indexFd(-1),
+                    actionsFd(-1),
+                    numOfGames(0),
+                    actionsSize(0),
+                    appendMutex(),
+                    frames()
+    {
+        this->indexFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        this->actionsFd = ::open(actionsPath(path).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if(this->indexFd < 0 || this->actionsFd < 0)
+        {
+            std::string error = std::strerror(errno);
+            if(this->indexFd >= 0) ::close(this->indexFd);
+            if(this->actionsFd >= 0) ::close(this->actionsFd);
+            throw std::runtime_error("Can't open archive " + path + ": " + error);
+        }
+
+        ArchiveHeader header;
+        ssize_t numOfBytes = ::pread(this->indexFd, &header, sizeof(header), 0);
+        if(numOfBytes == 0)
+        {
+            std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+            header.version = ARCHIVE_VERSION;
+            header.recordSize = sizeof(ArchivedGame);
+            header.numOfGames = 0;
+            writeAll(this->indexFd, &header, sizeof(header), 0);
+        }
+        else if(numOfBytes != sizeof(header) || !isArchiveHeader(header))
+        {
+            ::close(this->indexFd);
+            ::close(this->actionsFd);
+            throw std::runtime_error(path + " is not a game archive of version " + std::to_string(ARCHIVE_VERSION));
+        }
+
+        // A write cut short leaves frames or a record past the count - they are written over
+        this->numOfGames = header.numOfGames;
+        if(this->numOfGames > 0)
+        {
+            ArchivedGame last;
+            uint64_t lastOffset = sizeof(ArchiveHeader) + (this->numOfGames - 1) * sizeof(ArchivedGame);
+            if(::pread(this->indexFd, &last, sizeof(last), static_cast<off_t>(lastOffset)) == sizeof(last))
+            {
+                this->actionsSize = last.actionOffset + static_cast<uint64_t>(last.numOfActions) * ACTION_WIRE_SIZE;
+            }
+        }
+        if(::ftruncate(this->indexFd, static_cast<off_t>(sizeof(ArchiveHeader) + this->numOfGames * sizeof(ArchivedGame))) < 0
+            || ::ftruncate(this->actionsFd, static_cast<off_t>(this->actionsSize)) < 0)
+        {
+            std::string error = std::strerror(errno);
+            ::close(this->indexFd);
+            ::close(this->actionsFd);
+            throw std::runtime_error("Can't truncate archive " + path + ": " + error);
+        }
+    }
+
+    GameArchiveWriter::~GameArchiveWriter()
+    {
+        // without the file a reader rebuilds the lookup itself, a failed write only costs it the time
+        try
+        {
+            writeLookup();
+        }
+        catch(const std::runtime_error&)
+        {
+        }
+        ::close(this->indexFd);
+        ::close(this->actionsFd);
+    }
+
+    void GameArchiveWriter::writeLookup()
+    {
+        std::lock_guard<std::mutex> lock(this->appendMutex);
+        std::vector<ArchivedGame> games(this->numOfGames);
+        size_t numOfBytes = games.size() * sizeof(ArchivedGame);
+        if(numOfBytes > 0 && ::pread(this->indexFd, games.data(), numOfBytes, sizeof(ArchiveHeader)) != static_cast<ssize_t>(numOfBytes))
+        {
+            throw std::runtime_error("Can't read archive " + this->path + " back");
+        }
+        std::vector<uint8_t> lookup = buildLookup(games);
+
+        // written aside and renamed over the old one, a reader maps either lookup whole
+        std::string writtenPath = lookupPath(this->path) + ".tmp";
+        int fd = ::open(writtenPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(fd < 0)
+        {
+            throw std::runtime_error("Can't open archive lookup " + writtenPath + ": " + std::strerror(errno));
+        }
+        try
+        {
+            writeAll(fd, lookup.data(), lookup.size(), 0);
+        }
+        catch(...)
+        {
+            ::close(fd);
+            ::unlink(writtenPath.c_str());
+            throw;
+        }
+        ::close(fd);
+        if(::rename(writtenPath.c_str(), lookupPath(this->path).c_str()) < 0)
+        {
+            ::unlink(writtenPath.c_str());
+            throw std::runtime_error("Can't replace archive lookup " + lookupPath(this->path) + ": " + std::strerror(errno));
+        }
+    }
+
+    void GameArchiveWriter::append(ArchivedGame game, std::span<const Action> actions)
+    {
+        std::lock_guard<std::mutex> lock(this->appendMutex);
+        this->frames.resize(actions.size() * ACTION_WIRE_SIZE);
+        for(size_t index = 0; index < actions.size(); ++index)
+        {
+            encodeAction(actions[index], this->frames.data() + index * ACTION_WIRE_SIZE);
+        }
+        game.actionOffset = this->actionsSize;
+        game.numOfActions = static_cast<uint32_t>(actions.size());
+        writeAll(this->actionsFd, this->frames.data(), this->frames.size(), this->actionsSize);
+        writeAll(this->indexFd, &game, sizeof(game), sizeof(ArchiveHeader) + this->numOfGames * sizeof(ArchivedGame));
+
+        uint64_t count = this->numOfGames + 1;
+        writeAll(this->indexFd, &count, sizeof(count), offsetof(ArchiveHeader, numOfGames));
+        this->numOfGames = count;
+        this->actionsSize += this->frames.size();
+    }
+
+    uint64_t GameArchiveWriter::getNumOfGames() const
+    {
+        return this->numOfGames;
+    }
+
+    // A whole file mapped read only, nullptr for an empty one
+    static const uint8_t* mapFile(const std::string& path, size_t& size)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0)
+        {
+            throw std::runtime_error("Can't open archive " + path + ": " + std::strerror(errno));
+        }
+        struct stat status;
+        if(::fstat(fd, &status) < 0)
+        {
+            std::string error = std::strerror(errno);
+            ::close(fd);
+            throw std::runtime_error("Can't read archive " + path + ": " + error);
+        }
+        size = static_cast<size_t>(status.st_size);
+        if(size == 0)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(data == MAP_FAILED)
+        {
+            throw std::runtime_error("Can't map archive " + path + ": " + std::strerror(errno));
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL); // scans go front to back
+        return static_cast<const uint8_t*>(data);
+    }
+
+    GameArchiveReader::GameArchiveReader(const std::string& path) :
+                    index(nullptr),
+                    indexSize(0),
+                    actions(nullptr),
+                    actionsSize(0),
+                    numOfGames(0),
+                    lookup(nullptr),
+                    lookupSize(0),
+                    builtLookup(),
+                    seedIndex(nullptr),
+                    winnerStarts(nullptr),
+                    winnerGames(nullptr),
+                    turnStarts(nullptr),
+                    turnGames(nullptr)
+    {
+        this->index = mapFile(path, this->indexSize);
+        try
+        {
+            this->actions = mapFile(actionsPath(path), this->actionsSize);
+        }
+        catch(...)
+        {
+            if(this->index != nullptr) ::munmap(const_cast<uint8_t*>(this->index), this->indexSize);
+            throw;
+        }
+
+        ArchiveHeader header;
+        if(this->indexSize < sizeof(header) || (std::memcpy(&header, this->index, sizeof(header)), !isArchiveHeader(header)))
+        {
+            if(this->index != nullptr) ::munmap(const_cast<uint8_t*>(this->index), this->indexSize);
+            if(this->actions != nullptr) ::munmap(const_cast<uint8_t*>(this->actions), this->actionsSize);
+            throw std::runtime_error(path + " is not a game archive of version " + std::to_string(ARCHIVE_VERSION));
+        }
+
+        // the complete prefix of the games - counted, inside the index and with their frames in the stream
+        size_t numOfRecords = std::min<uint64_t>(header.numOfGames, (this->indexSize - sizeof(header)) / sizeof(ArchivedGame));
+        std::span<const ArchivedGame> records(reinterpret_cast<const ArchivedGame*>(this->index + sizeof(header)), numOfRecords);
+        while(this->numOfGames < numOfRecords)
+        {
+            const ArchivedGame& game = records[this->numOfGames];
+            if(game.actionOffset + static_cast<uint64_t>(game.numOfActions) * ACTION_WIRE_SIZE > this->actionsSize) break;
+            ++this->numOfGames;
+        }
+
+        try
+        {
+            this->lookup = mapFile(lookupPath(path), this->lookupSize);
+        }
+        catch(const std::runtime_error&)
+        {
+            this->lookup = nullptr; // no lookup written yet
+        }
+        if(!useLookup(this->lookup, this->lookupSize))
+        {
+            this->builtLookup = buildLookup(getGames());
+            useLookup(this->builtLookup.data(), this->builtLookup.size());
+        }
+    }
+
+    GameArchiveReader::~GameArchiveReader()
+    {
+        if(this->index != nullptr) ::munmap(const_cast<uint8_t*>(this->index), this->indexSize);
+        if(this->actions != nullptr) ::munmap(const_cast<uint8_t*>(this->actions), this->actionsSize);
+        if(this->lookup != nullptr) ::munmap(const_cast<uint8_t*>(this->lookup), this->lookupSize);
+    }
+
+    // Point the queries into a lookup of exactly the games of the archive, false leaves them unset
+    bool GameArchiveReader::useLookup(const uint8_t* data, size_t size)
+    {
+        LookupHeader header;
+        if(data == nullptr || size != lookupBytes(this->numOfGames)) return false;
+        std::memcpy(&header, data, sizeof(header));
+        if(std::memcmp(header.magic, LOOKUP_MAGIC, sizeof(LOOKUP_MAGIC)) != 0 || header.version != ARCHIVE_VERSION
+            || header.numOfTurnBuckets != ARCHIVE_NUM_TURN_BUCKETS || header.numOfGames != this->numOfGames) return false;
+
+        const uint32_t* words = reinterpret_cast<const uint32_t*>(data + sizeof(header));
+        const uint32_t* seeds = words;
+        const uint32_t* winners = seeds + 2 * this->numOfGames;
+        const uint32_t* turns = winners + NUM_WINNER_BUCKETS + 1 + this->numOfGames;
+        auto validStarts = [this](const uint32_t* starts, size_t numOfBuckets)
+        {
+            return starts[0] == 0 && std::is_sorted(starts, starts + numOfBuckets + 1) && starts[numOfBuckets] == this->numOfGames;
+        };
+        if(!validStarts(winners, NUM_WINNER_BUCKETS) || !validStarts(turns, ARCHIVE_NUM_TURN_BUCKETS)) return false;
+
+        this->seedIndex = seeds;
+        this->winnerStarts = winners;
+        this->winnerGames = winners + NUM_WINNER_BUCKETS + 1;
+        this->turnStarts = turns;
+        this->turnGames = turns + ARCHIVE_NUM_TURN_BUCKETS + 1;
+        return true;
+    }
+
+    size_t GameArchiveReader::size() const
+    {
+        return this->numOfGames;
+    }
+
+    std::span<const ArchivedGame> GameArchiveReader::getGames() const
+    {
+        if(this->numOfGames == 0) return {};
+        return std::span<const ArchivedGame>(reinterpret_cast<const ArchivedGame*>(this->index + sizeof(ArchiveHeader)), this->numOfGames);
+    }
+
+    const ArchivedGame* GameArchiveReader::findSeed(unsigned seed) const
+    {
+        // binary search of the pairs, the first of a seed is its first game
+        size_t low = 0, high = this->numOfGames;
+        while(low < high)
+        {
+            size_t middle = (low + high) / 2;
+            if(this->seedIndex[2 * middle] < seed) low = middle + 1;
+            else high = middle;
+        }
+        if(low == this->numOfGames || this->seedIndex[2 * low] != seed) return nullptr;
+        uint32_t game = this->seedIndex[2 * low + 1];
+        return (game < this->numOfGames) ? &getGames()[game] : nullptr;
+    }
+
+    std::span<const uint32_t> GameArchiveReader::getGamesWonBy(int winner) const
+    {
+        if(winner < -1 || winner >= static_cast<int>(ARCHIVE_MAX_SEATS)) return {};
+        size_t bucket = static_cast<size_t>(winner + 1);
+        return std::span<const uint32_t>(this->winnerGames + this->winnerStarts[bucket], this->winnerStarts[bucket + 1] - this->winnerStarts[bucket]);
+    }
+
+    std::span<const uint32_t> GameArchiveReader::getGamesOfTurnBucket(size_t bucket) const
+    {
+        if(bucket >= ARCHIVE_NUM_TURN_BUCKETS) return {};
+        return std::span<const uint32_t>(this->turnGames + this->turnStarts[bucket], this->turnStarts[bucket + 1] - this->turnStarts[bucket]);
+    }
+
+    const uint8_t* GameArchiveReader::getActionFrames(const ArchivedGame& game) const
+    {
+        return game.numOfActions == 0 ? nullptr : this->actions + game.actionOffset;
+    }
+
+    bool GameArchiveReader::getAction(const ArchivedGame& game, size_t actionIndex, Action& action) const
+    {
+        if(actionIndex >= game.numOfActions) return false;
+        return decodeAction(getActionFrames(game) + actionIndex * ACTION_WIRE_SIZE, action);
+    }
+}
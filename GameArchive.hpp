@@ -0,0 +1,119 @@
+#ifndef GAMEARCHIVE_HPP
+#define GAMEARCHIVE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Action.hpp"
+
+namespace catan_game {
+
+    constexpr size_t ARCHIVE_MAX_SEATS = 8;
+
+    // Games are bucketed by their numOfTurns in the lookup, the last bucket takes every longer game
+    constexpr unsigned ARCHIVE_TURN_BUCKET_WIDTH = 16;
+    constexpr size_t ARCHIVE_NUM_TURN_BUCKETS = 32;
+
+    constexpr size_t archiveTurnBucket(unsigned numOfTurns)
+    {
+        return std::min<size_t>(numOfTurns / ARCHIVE_TURN_BUCKET_WIDTH, ARCHIVE_NUM_TURN_BUCKETS - 1);
+    }
+
+    // Fixed record of one finished game in the archive index - scanned in place from the mapped file.
+    // The actions are ACTION_WIRE_SIZE frames in the action stream, a RollDice frame carries the dice sum
+    // in its target like the server's broadcast (clear it to replay the frame through Game::apply).
+    struct ArchivedGame {
+        uint32_t seed;
+        uint32_t numOfActions;
+        uint64_t actionOffset;   // byte offset of the first frame in the action stream
+        uint64_t finalHash;      // state hash at the end of the last turn played
+        uint16_t numOfTurns;
+        int8_t winner;           // -1 when the turn limit stopped the game
+        uint8_t numOfSeats;
+        uint32_t reserved;
+        uint8_t points[ARCHIVE_MAX_SEATS]; // victory points of every seat at the end
+    };
+    static_assert(sizeof(ArchivedGame) == 40 && std::is_trivially_copyable_v<ArchivedGame>, "The record layout is the file format");
+
+    // Appends finished games to an archive - the index file at the path (a header and one ArchivedGame per game)
+    // and the action stream next to it at path + ".actions". An existing archive is extended, the records are
+    // written in the machine's byte order. The frames are written before their record and the record before the
+    // header's count, so a reader never sees a game that isn't complete. append may be called from many threads.
+    // Closing the writer rebuilds the lookup at path + ".lookup" - the games sorted by seed and bucketed by
+    // winner and by number of turns.
+    class GameArchiveWriter {
+    private:
+        std::string path;
+        int indexFd;
+        int actionsFd;
+        uint64_t numOfGames;
+        uint64_t actionsSize;
+        std::mutex appendMutex;
+        std::vector<uint8_t> frames;
+
+    public:
+        // Throws std::runtime_error when the files can't be opened or the index isn't an archive of this version
+        explicit GameArchiveWriter(const std::string& path);
+        ~GameArchiveWriter();
+        GameArchiveWriter(const GameArchiveWriter&) = delete;
+        GameArchiveWriter& operator=(const GameArchiveWriter&) = delete;
+
+        // The offset and the number of actions of the record are filled in. Throws std::runtime_error when a write fails.
+        void append(ArchivedGame game, std::span<const Action> actions);
+        uint64_t getNumOfGames() const;
+
+        // Throws std::runtime_error when the lookup can't be written, the destructor ignores that
+        void writeLookup();
+    };
+
+    // Maps an archive read only - the games are iterated in place, no game is decoded until it is asked for.
+    // Records past the header's count or pointing outside the action stream are not part of the archive.
+    // The lookup is mapped too, a missing one or one written for another number of games is rebuilt in memory.
+    class GameArchiveReader {
+    private:
+        const uint8_t* index;
+        size_t indexSize;
+        const uint8_t* actions;
+        size_t actionsSize;
+        size_t numOfGames;
+        const uint8_t* lookup;
+        size_t lookupSize;
+        std::vector<uint8_t> builtLookup; // the lookup when the file couldn't be used
+        const uint32_t* seedIndex;        // seed and game of every game, by seed and then by game
+        const uint32_t* winnerStarts;     // winner + 1 -> first entry of winnerGames, one past the last bucket at the end
+        const uint32_t* winnerGames;
+        const uint32_t* turnStarts;       // the same for the turn buckets
+        const uint32_t* turnGames;
+
+        bool useLookup(const uint8_t* data, size_t size);
+
+    public:
+        // Throws std::runtime_error when the files can't be mapped or the index isn't an archive of this version
+        explicit GameArchiveReader(const std::string& path);
+        ~GameArchiveReader();
+        GameArchiveReader(const GameArchiveReader&) = delete;
+        GameArchiveReader& operator=(const GameArchiveReader&) = delete;
+
+        size_t size() const;
+        std::span<const ArchivedGame> getGames() const;
+
+        // The first game of the seed, nullptr when the archive has none
+        const ArchivedGame* findSeed(unsigned seed) const;
+
+        // Indexes into getGames() in the archive's order - the games the seat won (-1 the games the turn limit
+        // stopped), and the games in a bucket of archiveTurnBucket
+        std::span<const uint32_t> getGamesWonBy(int winner) const;
+        std::span<const uint32_t> getGamesOfTurnBucket(size_t bucket) const;
+
+        // The numOfActions frames of the game, ACTION_WIRE_SIZE bytes each
+        const uint8_t* getActionFrames(const ArchivedGame& game) const;
+        bool getAction(const ArchivedGame& game, size_t actionIndex, Action& action) const;
+    };
+}
+
+#endif
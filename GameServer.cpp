@@ -0,0 +1,833 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "GameServer.hpp"
+#include "GreedyDiscardPolicy.hpp"
+#include "LadderAgent.hpp"
+
+namespace catan_game {
+
+    constexpr int MAX_EPOLL_EVENTS = 256;
+    constexpr size_t READ_CHUNK_SIZE = 4096;
+    constexpr size_t MAX_LINE_LENGTH = 1024;
+
+    GameServer::GameServer(const std::string& path, size_t seats, unsigned seed, std::vector<AgentFactory> seatBots) :
+                    socketPath(path),
+                    seatsPerTable(seats),
+                    baseSeed(seed),
+                    bots(std::move(seatBots)),
+                    listenFd(-1),
+                    epollFd(-1),
+                    running(false),
+                    openTableId(-1),
+                    nextTableId(0)
+    {
+        if(seats == 0)
+        {
+            throw std::invalid_argument("Table must have at least one seat");
+        }
+        if(this->bots.size() >= seats)
+        {
+            throw std::invalid_argument("Table must have a seat left for a player");
+        }
+
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(path.size() >= sizeof(address.sun_path))
+        {
+            throw std::invalid_argument("Socket path is too long");
+        }
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+        this->listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(this->listenFd < 0)
+        {
+            throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+        }
+
+        ::unlink(path.c_str());
+        if(::bind(this->listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+            || ::listen(this->listenFd, SOMAXCONN) < 0)
+        {
+            std::string error = std::strerror(errno);
+            ::close(this->listenFd);
+            throw std::runtime_error("bind/listen: " + error);
+        }
+
+        this->epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if(this->epollFd < 0)
+        {
+            ::close(this->listenFd);
+            throw std::runtime_error(std::string("epoll_create1: ") + std::strerror(errno));
+        }
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = this->listenFd;
+        ::epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->listenFd, &event);
+    }
+
+    GameServer::~GameServer()
+    {
+        for(const auto& entry: this->connections)
+        {
+            ::close(entry.first);
+        }
+        if(this->epollFd >= 0) ::close(this->epollFd);
+        if(this->listenFd >= 0) ::close(this->listenFd);
+        ::unlink(this->socketPath.c_str());
+    }
+
+    size_t GameServer::getNumOfTables() const
+    {
+        return this->tables.size();
+    }
+
+    size_t GameServer::getNumOfConnections() const
+    {
+        return this->connections.size();
+    }
+
+    void GameServer::run()
+    {
+        this->running = true;
+        while(this->running)
+        {
+            pollOnce(-1);
+        }
+    }
+
+    void GameServer::stop()
+    {
+        this->running = false;
+    }
+
+    void GameServer::pollOnce(int timeoutMs)
+    {
+        epoll_event events[MAX_EPOLL_EVENTS];
+        int numOfEvents = ::epoll_wait(this->epollFd, events, MAX_EPOLL_EVENTS, timeoutMs);
+        for(int index = 0; index < numOfEvents; ++index)
+        {
+            int fd = events[index].data.fd;
+            if(fd == this->listenFd)
+            {
+                acceptConnections();
+                continue;
+            }
+            if(events[index].events & (EPOLLERR | EPOLLHUP))
+            {
+                closeConnection(fd);
+                continue;
+            }
+            if(events[index].events & EPOLLIN)
+            {
+                readConnection(fd);
+            }
+            if((events[index].events & EPOLLOUT) && this->connections.count(fd))
+            {
+                flushConnection(fd);
+            }
+        }
+    }
+
+    void GameServer::acceptConnections()
+    {
+        for(;;)
+        {
+            int fd = ::accept4(this->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if(fd < 0)
+            {
+                return; // EAGAIN - no more pending connections
+            }
+
+            Connection connection{fd, std::string(), std::string(), -1, 0, false, false, false};
+            this->connections.emplace(fd, std::move(connection));
+
+            epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            ::epoll_ctl(this->epollFd, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    void GameServer::readConnection(int fd)
+    {
+        char buffer[READ_CHUNK_SIZE];
+        for(;;)
+        {
+            ssize_t numOfBytes = ::read(fd, buffer, sizeof(buffer));
+            if(numOfBytes > 0)
+            {
+                this->connections[fd].inBuffer.append(buffer, static_cast<size_t>(numOfBytes));
+                continue;
+            }
+            if(numOfBytes == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                closeConnection(fd);
+                return;
+            }
+            break;
+        }
+
+        // Handle every complete line or frame, handling may close the connection
+        for(;;)
+        {
+            auto it = this->connections.find(fd);
+            if(it == this->connections.end()) return;
+
+            std::string& input = it->second.inBuffer;
+            if(it->second.binary)
+            {
+                if(input.size() < ACTION_WIRE_SIZE) return;
+
+                Action action;
+                bool isDecoded = decodeAction(reinterpret_cast<const uint8_t*>(input.data()), action);
+                input.erase(0, ACTION_WIRE_SIZE);
+                if(isDecoded) handleAction(it->second, action);
+                else reply(it->second, ActionStatus::MalformedAction);
+                continue;
+            }
+
+            size_t end = input.find('\n');
+            if(end == std::string::npos)
+            {
+                if(input.size() > MAX_LINE_LENGTH) closeConnection(fd);
+                return;
+            }
+
+            std::string line = input.substr(0, end);
+            input.erase(0, end + 1);
+            if(!line.empty() && line.back() == '\r') line.pop_back();
+            if(!line.empty()) handleLine(fd, line);
+        }
+    }
+
+    void GameServer::flushConnection(int fd)
+    {
+        Connection& connection = this->connections[fd];
+        while(!connection.outBuffer.empty())
+        {
+            ssize_t numOfBytes = ::send(fd, connection.outBuffer.data(), connection.outBuffer.size(), MSG_NOSIGNAL);
+            if(numOfBytes < 0)
+            {
+                if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+                // Peer is gone - the hang-up is reported by epoll and closed there,
+                // closing here would pull the connection from under the command being handled
+                connection.outBuffer.clear();
+                ::shutdown(fd, SHUT_RDWR);
+                break;
+            }
+            connection.outBuffer.erase(0, static_cast<size_t>(numOfBytes));
+        }
+        updateInterest(connection);
+    }
+
+    // Ask for EPOLLOUT only while there is pending output
+    void GameServer::updateInterest(Connection& connection)
+    {
+        bool wantsWrite = !connection.outBuffer.empty();
+        if(wantsWrite == connection.wantsWrite) return;
+        connection.wantsWrite = wantsWrite;
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | (wantsWrite ? EPOLLOUT : 0);
+        event.data.fd = connection.fd;
+        ::epoll_ctl(this->epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    }
+
+    void GameServer::closeConnection(int fd)
+    {
+        auto it = this->connections.find(fd);
+        if(it == this->connections.end()) return;
+
+        int tableId = it->second.tableId;
+        size_t leavingSeat = it->second.seat;
+        bool isWatcher = it->second.watching;
+        ::epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        this->connections.erase(it);
+
+        auto tableIt = this->tables.find(tableId);
+        if(tableIt == this->tables.end()) return;
+        Table& table = tableIt->second;
+        if(isWatcher)
+        {
+            std::erase(table.watcherFds, fd);
+            return;
+        }
+
+        if(!table.game)
+        {
+            // Table still waiting for players - give the seat to the next joiner
+            for(size_t seat = 0; seat < table.seatFds.size(); ++seat)
+            {
+                if(table.seatFds[seat] == fd)
+                {
+                    table.seatFds.erase(table.seatFds.begin() + seat);
+                    table.names.erase(table.names.begin() + seat);
+                    break;
+                }
+            }
+            for(size_t seat = 0; seat < table.seatFds.size(); ++seat)
+            {
+                this->connections[table.seatFds[seat]].seat = seat;
+            }
+        }
+        else
+        {
+            // The game goes on for the others - a built-in agent takes the seat over
+            for(int& seatFd: table.seatFds)
+            {
+                if(seatFd == fd) seatFd = -1;
+            }
+            table.agents[leavingSeat] = makeBuiltinAgent("builder");
+            table.agents[leavingSeat]->startGame(*table.game, leavingSeat, this->baseSeed + static_cast<unsigned>(table.id));
+            broadcastEvent(table, makeAction(ActionOpcode::Left, leavingSeat));
+        }
+
+        bool isEmpty = true;
+        for(int seatFd: table.seatFds)
+        {
+            if(seatFd >= 0) isEmpty = false;
+        }
+        if(isEmpty)
+        {
+            if(this->openTableId == tableId) this->openTableId = -1;
+            std::vector<int> watcherFds = std::move(table.watcherFds);
+            this->tables.erase(tableIt);
+            for(int watcherFd: watcherFds)
+            {
+                closeConnection(watcherFd); // nothing left to watch
+            }
+            return;
+        }
+        if(!table.game) return;
+        try
+        {
+            playBots(table);
+        }
+        catch(const std::exception& e)
+        {
+            closeTable(tableId, e.what());
+        }
+    }
+
+    // A table whose game failed - logged, and every seat and watcher disconnected
+    void GameServer::closeTable(int tableId, const std::string& reason)
+    {
+        auto tableIt = this->tables.find(tableId);
+        if(tableIt == this->tables.end()) return;
+
+        std::cerr<<"Table "<<tableId<<" closed: "<<reason<<std::endl;
+        std::vector<int> fds = std::move(tableIt->second.watcherFds);
+        for(int seatFd: tableIt->second.seatFds)
+        {
+            if(seatFd >= 0) fds.push_back(seatFd);
+        }
+        if(this->openTableId == tableId) this->openTableId = -1;
+        this->tables.erase(tableIt);
+        for(int fd: fds)
+        {
+            closeConnection(fd); // the table is gone, nobody takes the seat over
+        }
+    }
+
+    void GameServer::queueOutput(int fd, const char* data, size_t size)
+    {
+        auto it = this->connections.find(fd);
+        if(it == this->connections.end()) return;
+
+        bool wasEmpty = it->second.outBuffer.empty();
+        it->second.outBuffer.append(data, size);
+        if(wasEmpty)
+        {
+            // Try to write right away, the common case never touches EPOLLOUT
+            flushConnection(fd);
+        }
+    }
+
+    void GameServer::sendLine(int fd, const std::string& line)
+    {
+        std::string data = line + "\n";
+        queueOutput(fd, data.data(), data.size());
+    }
+
+    // Events go out as frames to binary connections and as text lines to the others
+    void GameServer::sendEvent(int fd, const Action& event)
+    {
+        auto it = this->connections.find(fd);
+        if(it == this->connections.end()) return;
+
+        if(it->second.binary)
+        {
+            uint8_t frame[ACTION_WIRE_SIZE];
+            encodeAction(event, frame);
+            queueOutput(fd, reinterpret_cast<const char*>(frame), ACTION_WIRE_SIZE);
+            return;
+        }
+
+        std::string seat = std::to_string(event.seat);
+        switch(event.opcode)
+        {
+            case ActionOpcode::RollDice:
+                sendLine(fd, "ROLLED " + seat + " " + std::to_string(event.target));
+                break;
+            case ActionOpcode::Turn:
+                sendLine(fd, "TURN " + seat + " " + gamePhaseToString(static_cast<GamePhase>(event.target)));
+                break;
+            case ActionOpcode::Start:
+                sendLine(fd, "START " + std::to_string(event.target));
+                break;
+            case ActionOpcode::Winner:
+                sendLine(fd, "WINNER " + seat);
+                break;
+            case ActionOpcode::Left:
+                sendLine(fd, "LEFT " + seat);
+                break;
+            case ActionOpcode::Offered:
+            case ActionOpcode::Traded:
+                sendLine(fd, actionToString(event));
+                break;
+            default:
+                sendLine(fd, "DID " + seat + " " + actionToString(event));
+                break;
+        }
+    }
+
+    void GameServer::broadcastEvent(const Table& table, const Action& event)
+    {
+        for(int fd: table.seatFds)
+        {
+            if(fd >= 0) sendEvent(fd, event);
+        }
+    }
+
+    // Answer of a game action - "OK"/"ERR <status>" or a Result frame
+    void GameServer::reply(Connection& connection, ActionStatus status)
+    {
+        if(connection.binary)
+        {
+            sendEvent(connection.fd, makeAction(ActionOpcode::Result, connection.seat, static_cast<int>(status)));
+            return;
+        }
+        sendLine(connection.fd, (status == ActionStatus::Ok) ? std::string("OK") : "ERR " + actionStatusToString(status));
+    }
+
+    void GameServer::handleLine(int fd, const std::string& line)
+    {
+        Connection& connection = this->connections[fd];
+        if(connection.watching) return;
+        size_t split = line.find(' ');
+        std::string command = line.substr(0, split);
+        std::string args = (split == std::string::npos) ? std::string() : line.substr(split + 1);
+
+        if(command == "JOIN")
+        {
+            handleJoin(connection, args);
+            return;
+        }
+        if(command == "WATCH")
+        {
+            handleWatch(connection, args);
+            return;
+        }
+        if(command == "BINARY")
+        {
+            // Everything after this line, in both directions, is ACTION_WIRE_SIZE frames
+            sendLine(fd, "OK BINARY");
+            connection.binary = true;
+            return;
+        }
+
+        if(connection.tableId < 0)
+        {
+            sendLine(fd, "ERR NotSeated");
+            return;
+        }
+
+        Table& table = this->tables[connection.tableId];
+        if(!table.game)
+        {
+            sendLine(fd, "ERR WaitingForPlayers");
+            return;
+        }
+
+        if(command == "STATE")
+        {
+            const Game& game = *table.game;
+            std::string state = "OK STATE " + gamePhaseToString(game.getPhase()) + " " + std::to_string(game.getCurrentSeat());
+            for(const Player* player: game.getPlayers())
+            {
+                state += " " + std::to_string(player->getMyPoints()) + ":" + std::to_string(player->getNumOfResources());
+            }
+            sendLine(fd, state);
+            return;
+        }
+
+        Action action;
+        if(!parseAction(line.c_str(), connection.seat, action))
+        {
+            sendLine(fd, "ERR " + actionStatusToString(ActionStatus::MalformedAction));
+            return;
+        }
+        handleAction(connection, action);
+    }
+
+    void GameServer::handleJoin(Connection& connection, const std::string& name)
+    {
+        if(connection.tableId >= 0)
+        {
+            sendLine(connection.fd, "ERR AlreadySeated");
+            return;
+        }
+
+        if(this->openTableId < 0)
+        {
+            this->openTableId = this->nextTableId++;
+            Table table;
+            table.id = this->openTableId;
+            this->tables.emplace(table.id, std::move(table));
+        }
+
+        Table& table = this->tables[this->openTableId];
+        connection.tableId = table.id;
+        connection.seat = table.seatFds.size();
+        table.seatFds.push_back(connection.fd);
+        table.names.push_back(name.empty() ? "Player " + std::to_string(connection.seat + 1) : name);
+        sendLine(connection.fd, "OK SEAT " + std::to_string(table.id) + " " + std::to_string(connection.seat));
+
+        if(table.seatFds.size() + this->bots.size() == this->seatsPerTable)
+        {
+            unsigned seed = this->baseSeed + static_cast<unsigned>(table.id);
+            table.agents.resize(table.seatFds.size());
+            for(const AgentFactory& bot: this->bots)
+            {
+                table.seatFds.push_back(-1);
+                table.names.push_back(bot.name);
+                table.agents.push_back(bot.makeAgent());
+            }
+            table.game.reset(new Game(table.names, seed));
+            table.channel.reset(new DecisionChannel());
+            table.task.reset(new TurnTask(playGame(*table.game, *table.channel)));
+            table.task->start();
+            try
+            {
+                table.task->rethrowIfFailed();
+            }
+            catch(const std::exception& e)
+            {
+                closeTable(table.id, e.what());
+                return;
+            }
+            table.feed.reset(new SpectatorFeed(*table.game));
+            for(int watcherFd: table.watcherFds)
+            {
+                const std::string& keyframe = table.feed->getKeyframe();
+                queueOutput(watcherFd, keyframe.data(), keyframe.size());
+            }
+            for(size_t seat = 0; seat < table.agents.size(); ++seat)
+            {
+                if(table.agents[seat]) table.agents[seat]->startGame(*table.game, seat, seed);
+            }
+            this->openTableId = -1;
+            broadcastEvent(table, makeAction(ActionOpcode::Start, 0, table.id));
+            announceTurn(table);
+            try
+            {
+                playBots(table);
+            }
+            catch(const std::exception& e)
+            {
+                closeTable(table.id, e.what());
+            }
+        }
+    }
+
+    void GameServer::handleWatch(Connection& connection, const std::string& args)
+    {
+        if(connection.tableId >= 0)
+        {
+            sendLine(connection.fd, "ERR AlreadySeated");
+            return;
+        }
+        auto tableIt = this->tables.find(std::atoi(args.c_str()));
+        if(args.empty() || tableIt == this->tables.end())
+        {
+            sendLine(connection.fd, "ERR NoSuchTable");
+            return;
+        }
+
+        Table& table = tableIt->second;
+        sendLine(connection.fd, "OK WATCH " + std::to_string(table.id));
+        connection.tableId = table.id;
+        connection.watching = true;
+        table.watcherFds.push_back(connection.fd);
+        if(table.feed)
+        {
+            const std::string& keyframe = table.feed->getKeyframe();
+            queueOutput(connection.fd, keyframe.data(), keyframe.size());
+        }
+    }
+
+    // One delta for all the watchers, the same bytes queued on every one
+    void GameServer::publish(Table& table)
+    {
+        if(!table.feed || !table.feed->update(*table.game)) return;
+        const std::string& delta = table.feed->getDelta();
+        for(int watcherFd: table.watcherFds)
+        {
+            queueOutput(watcherFd, delta.data(), delta.size());
+        }
+    }
+
+    void GameServer::announceTurn(const Table& table)
+    {
+        const Game& game = *table.game;
+        if(game.getPhase() == GamePhase::Finished)
+        {
+            broadcastEvent(table, makeAction(ActionOpcode::Winner, game.getWinner()));
+            return;
+        }
+        broadcastEvent(table, makeAction(ActionOpcode::Turn, game.getCurrentSeat(), static_cast<int>(game.getPhase())));
+    }
+
+    // Same path for text and binary clients - the action always plays the connection's own seat
+    void GameServer::handleAction(Connection& connection, Action action)
+    {
+        auto tableIt = this->tables.find(connection.tableId);
+        if(tableIt == this->tables.end() || !tableIt->second.game)
+        {
+            reply(connection, ActionStatus::WrongPhase);
+            return;
+        }
+
+        Table& table = tableIt->second;
+        action.seat = static_cast<uint8_t>(connection.seat);
+        try
+        {
+            if(playAction(table, action, &connection) != ActionStatus::Ok) return;
+            answerOffer(table, action);
+            playBots(table);
+        }
+        catch(const std::exception& e)
+        {
+            closeTable(table.id, e.what()); // the connection is closed with it
+        }
+    }
+
+    // Apply the action of a seat and broadcast what it did, with the new turn or phase.
+    // The connection that sent the action gets its answer first.
+    ActionStatus GameServer::playAction(Table& table, Action action, Connection* sender)
+    {
+        Game& game = *table.game;
+        size_t turnBefore = game.getCurrentSeat();
+        GamePhase phaseBefore = game.getPhase();
+        size_t numOfFills = game.getTradeBook().getNumOfFills();
+
+        ActionStatus status = applyAction(table, action);
+        if(sender != nullptr) reply(*sender, status);
+        if(status != ActionStatus::Ok) return status;
+        publish(table);
+
+        const TradeBook& tradeBook = game.getTradeBook();
+        if(tradeBook.getNumOfFills() > numOfFills)
+        {
+            const TradeFill& fill = tradeBook.getLastFill();
+            Action traded = makeAction(ActionOpcode::Traded, fill.maker, static_cast<int>(fill.taker));
+            traded.resources = toTradeResources(fill.makerGives, fill.takerGives);
+            broadcastEvent(table, traded);
+        }
+        else if(action.opcode == ActionOpcode::PostTrade)
+        {
+            // the offer rests in the book - everybody learns its id
+            Action offered = makeAction(ActionOpcode::Offered, action.seat, tradeBook.getOffers().back().id);
+            offered.resources = action.resources;
+            broadcastEvent(table, offered);
+        }
+        else
+        {
+            if(action.opcode == ActionOpcode::RollDice) action.target = static_cast<uint16_t>(game.getLastRoll());
+            broadcastEvent(table, action);
+        }
+
+        if(game.getCurrentSeat() != turnBefore || game.getPhase() != phaseBefore)
+        {
+            announceTurn(table);
+        }
+        return ActionStatus::Ok;
+    }
+
+    // The bots take a new offer resting in the book as soon as one of them accepts it
+    void GameServer::answerOffer(Table& table, const Action& action)
+    {
+        if(action.opcode != ActionOpcode::PostTrade) return;
+        const TradeBook& tradeBook = table.game->getTradeBook();
+        const TradeOffer* offer = tradeBook.find(tradeBook.getNextOfferId() - 1);
+        if(offer == nullptr) return;
+        std::vector<Agent*> seatAgents;
+        for(const std::unique_ptr<Agent>& agent: table.agents) seatAgents.push_back(agent.get());
+        int taker = findTradeTaker(*table.game, *offer, seatAgents);
+        if(taker >= 0) playAction(table, makeAction(ActionOpcode::AcceptTrade, taker, offer->id));
+    }
+
+    // Play the bot seats for as long as the game asks one of them. A bot whose action is refused (or
+    // that gives up) plays the fallback of the phase instead, so the table goes on for the people at it.
+    void GameServer::playBots(Table& table)
+    {
+        while(table.channel->isWaiting())
+        {
+            size_t seat = table.channel->getRequest().seat;
+            Agent* agent = seat < table.agents.size() ? table.agents[seat].get() : nullptr;
+            if(agent == nullptr) return;
+
+            Action action = agent->decide(*table.game, seat);
+            action.seat = static_cast<uint8_t>(seat);
+            if(playAction(table, action) == ActionStatus::Ok)
+            {
+                answerOffer(table, action);
+                continue;
+            }
+            if(playAction(table, fallbackAction(table, seat)) != ActionStatus::Ok) return;
+        }
+    }
+
+    // The largest piles for a discard, the end of the turn in the main phase (so a refused bot can't
+    // trade back and forth) and the first legal action otherwise - None when there is none
+    Action GameServer::fallbackAction(const Table& table, size_t seat)
+    {
+        const Game& game = *table.game;
+        if(game.getPhase() == GamePhase::Discard)
+        {
+            Action discard = makeAction(ActionOpcode::Discard, seat);
+            discard.resources = GreedyDiscardPolicy().chooseDiscard(game.getPlayers()[seat]->getResourceVector(),
+                                                                     game.getPendingDiscard(seat));
+            return discard;
+        }
+        if(game.getPhase() == GamePhase::Main) return makeAction(ActionOpcode::EndTurn, seat);
+
+        const std::vector<Action>& legal = this->legalActions.collect(game, seat);
+        return legal.empty() ? makeAction(ActionOpcode::None, seat) : legal.front();
+    }
+
+    ActionStatus GameServer::applyAction(Table& table, const Action& action)
+    {
+        ActionStatus status = validateAction(action, table.game->getNumOfSeats());
+        if(status != ActionStatus::Ok) return status;
+        if(!table.channel->isWaiting()) return ActionStatus::GameOver;
+
+        DecisionKind kind = table.channel->getRequest().kind;
+        size_t seat = action.seat;
+        int row = -1, col = -1, toRow = -1, toCol = -1;
+        switch(action.opcode)
+        {
+            case ActionOpcode::RollDice:
+            case ActionOpcode::EndTurn:
+            case ActionOpcode::BuyDevelopmentCard:
+            {
+                TurnAction turnAction = (action.opcode == ActionOpcode::RollDice) ? TurnAction::RollDice
+                                      : (action.opcode == ActionOpcode::EndTurn) ? TurnAction::EndTurn : TurnAction::BuyDevelopmentCard;
+                return (kind == DecisionKind::Turn) ? submit(table, makeDecision(seat, turnAction)) : ActionStatus::WrongPhase;
+            }
+            case ActionOpcode::BuildSettlement:
+            case ActionOpcode::BuildCity:
+            {
+                decodeVertex(action.target, row, col);
+                Decision placement = makeDecision(seat, TurnAction::Place, row, col);
+                bool isCity = action.opcode == ActionOpcode::BuildCity;
+                if(kind == DecisionKind::SetupSettlement && !isCity) return submit(table, placement);
+                return submitPlacement(table, seat, isCity ? TurnAction::BuildCity : TurnAction::BuildSettlement,
+                                       DecisionKind::SettlementPlacement, placement);
+            }
+            case ActionOpcode::BuildRoad:
+            {
+                decodeEdge(action.target, row, col, toRow, toCol);
+                Decision placement = makeDecision(seat, TurnAction::Place, row, col, toRow, toCol);
+                if(kind == DecisionKind::SetupRoad) return submit(table, placement);
+                return submitPlacement(table, seat, TurnAction::BuildRoad, DecisionKind::RoadPlacement, placement);
+            }
+            case ActionOpcode::PlayKnight:
+                return (kind == DecisionKind::Turn) ? submit(table, makeDecision(seat, TurnAction::PlayKnight)) : ActionStatus::WrongPhase;
+            case ActionOpcode::MoveRobber:
+            {
+                Decision decision = makeDecision(seat, TurnAction::MoveRobber, robberTileOf(action), robberVictimOf(action));
+                return (kind == DecisionKind::RobberPlacement) ? submit(table, decision) : ActionStatus::WrongPhase;
+            }
+            case ActionOpcode::Discard:
+            {
+                Decision decision = makeDecision(seat, TurnAction::Discard);
+                decision.amounts = action.resources;
+                return (kind == DecisionKind::Discard) ? submit(table, decision) : ActionStatus::WrongPhase;
+            }
+            // Trades don't walk the turn menu - any seat may trade with the current one while it decides
+            case ActionOpcode::PostTrade:
+            {
+                ResourceVector give, want;
+                splitTradeResources(action.resources, give, want);
+                return table.game->postTrade(seat, give, want, static_cast<int>(action.target) - 1);
+            }
+            case ActionOpcode::AcceptTrade:
+                return table.game->acceptTrade(seat, action.target);
+            case ActionOpcode::CancelTrade:
+                return table.game->cancelTrade(seat, action.target);
+            case ActionOpcode::BankTrade:
+            {
+                ResourceVector give, want;
+                splitTradeResources(action.resources, give, want);
+                return table.game->bankTrade(seat, give, want);
+            }
+            // Progress cards are played while the seat decides its turn, like the trades
+            case ActionOpcode::PlayMonopoly:
+                if(kind != DecisionKind::Turn) return ActionStatus::WrongPhase;
+                return table.game->playMonopoly(seat, static_cast<TileType>(action.target));
+            case ActionOpcode::PlayYearOfPlenty:
+                if(kind != DecisionKind::Turn) return ActionStatus::WrongPhase;
+                return table.game->playYearOfPlenty(seat, action.resources);
+            case ActionOpcode::PlayRoadBuilding:
+                if(kind != DecisionKind::Turn) return ActionStatus::WrongPhase;
+                return table.game->playRoadBuilding(seat);
+            default:
+                return ActionStatus::MalformedAction;
+        }
+    }
+
+    // Throws what escaped the game's coroutine, the entry points close the table
+    ActionStatus GameServer::submit(Table& table, const Decision& decision)
+    {
+        table.channel->respond(decision);
+        table.task->rethrowIfFailed();
+        return table.channel->getLastStatus();
+    }
+
+    // A one line build request walks the turn menu: pick the build, answer the placement,
+    // and cancel back to the menu when the placement is rejected
+    ActionStatus GameServer::submitPlacement(Table& table, size_t seat, TurnAction menuAction,
+                                             DecisionKind placementKind, const Decision& placement)
+    {
+        DecisionChannel& channel = *table.channel;
+        if(channel.getRequest().kind != DecisionKind::Turn) return ActionStatus::WrongPhase;
+
+        ActionStatus status = submit(table, makeDecision(seat, menuAction));
+        if(status != ActionStatus::Ok || !channel.isWaiting() || channel.getRequest().kind != placementKind)
+        {
+            return status;
+        }
+
+        status = submit(table, placement);
+        if(status != ActionStatus::Ok)
+        {
+            submit(table, makeDecision(seat, TurnAction::Cancel));
+        }
+        return status;
+    }
+}
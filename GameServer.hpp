@@ -0,0 +1,123 @@
+#ifndef GAMESERVER_HPP
+#define GAMESERVER_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Action.hpp"
+#include "Agent.hpp"
+#include "Game.hpp"
+#include "LegalActionList.hpp"
+#include "SpectatorFeed.hpp"
+#include "TurnEngine.hpp"
+
+namespace catan_game {
+
+    // Hosts many games over a Unix domain socket.
+    // A single thread runs an epoll loop over non-blocking sockets, every connection is mapped
+    // to a seat of a table and every table owns its own Game (the per-game state machine).
+    // The table's turn coroutine waits on its DecisionChannel, a request resumes it in place.
+    //
+    // Line protocol (client -> server):
+    //   JOIN <name> | ROLL | SETTLE <row> <col> | CITY <row> <col>
+    //   ROAD <fromRow> <fromCol> <toRow> <toCol> | BUY | DISCARD <tree> <clay> <crop> <wool> <iron>
+    //   OFFER <toSeat|-1> <tree> <clay> <crop> <wool> <iron> (given positive, wanted negative)
+    //   ACCEPT <offerId> | CANCEL <offerId> | BANK <tree> <clay> <crop> <wool> <iron>
+    //   KNIGHT | ROBBER <tileIndex> <victimSeat|-1> | MONOPOLY <resource> | PLENTY <tree> <clay> <crop> <wool> <iron>
+    //   END | STATE | BINARY | WATCH <tableId>
+    // Every request is answered with "OK ..." or "ERR <reason>", game events are broadcast to the table.
+    // After BINARY the connection speaks fixed ACTION_WIRE_SIZE frames (see Action.hpp) both ways:
+    // actions in, a Result frame per action and the event frames out.
+    // After "OK WATCH" the connection is a spectator of the table: it gets the SpectatorFeed messages,
+    // a keyframe then a delta per action (a keyframe when the game starts after it subscribed), and
+    // whatever it sends is ignored.
+    // Bot seats are the last seats of every table, the table starts when people fill the others. Bots play
+    // right after the action that asks them, through the same path and broadcasts as the connections,
+    // and answer the offers resting in the book. A bot whose action is refused plays a legal one instead.
+    // A player leaving a running game leaves the seat to a built-in bot.
+    class GameServer {
+    private:
+        struct Connection {
+            int fd;
+            std::string inBuffer;
+            std::string outBuffer;
+            int tableId;
+            size_t seat;
+            bool wantsWrite;
+            bool binary;
+            bool watching;
+        };
+
+        struct Table {
+            int id;
+            std::unique_ptr<Game> game;
+            std::unique_ptr<DecisionChannel> channel;
+            std::unique_ptr<TurnTask> task;
+            std::vector<int> seatFds;     // -1 for a bot seat, a bot plays the seat of a connection that closed
+            std::vector<std::string> names;
+            std::vector<std::unique_ptr<Agent>> agents; // nullptr for the seats of connections
+            std::unique_ptr<SpectatorFeed> feed;
+            std::vector<int> watcherFds;
+        };
+
+        std::string socketPath;
+        size_t seatsPerTable;
+        unsigned baseSeed;
+        std::vector<AgentFactory> bots;
+        int listenFd;
+        int epollFd;
+        bool running;
+        int openTableId;
+        int nextTableId;
+        std::unordered_map<int, Connection> connections;
+        std::unordered_map<int, Table> tables;
+        LegalActionList legalActions;
+
+        void acceptConnections();
+        void readConnection(int fd);
+        void flushConnection(int fd);
+        void closeConnection(int fd);
+        void closeTable(int tableId, const std::string& reason);
+        void updateInterest(Connection& connection);
+        void queueOutput(int fd, const char* data, size_t size);
+        void sendLine(int fd, const std::string& line);
+        void sendEvent(int fd, const Action& event);
+        void broadcastEvent(const Table& table, const Action& event);
+        void reply(Connection& connection, ActionStatus status);
+        void handleLine(int fd, const std::string& line);
+        void handleJoin(Connection& connection, const std::string& name);
+        void handleWatch(Connection& connection, const std::string& args);
+        void publish(Table& table);
+        void handleAction(Connection& connection, Action action);
+        ActionStatus playAction(Table& table, Action action, Connection* sender = nullptr);
+        void playBots(Table& table);
+        Action fallbackAction(const Table& table, size_t seat);
+        void answerOffer(Table& table, const Action& action);
+        ActionStatus applyAction(Table& table, const Action& action);
+        void announceTurn(const Table& table);
+        ActionStatus submit(Table& table, const Decision& decision);
+        ActionStatus submitPlacement(Table& table, size_t seat, TurnAction menuAction,
+                                     DecisionKind placementKind, const Decision& placement);
+
+    public:
+        // The bots take the last bots.size() seats of every table, at least one seat is left for people
+        GameServer(const std::string& path, size_t seats, unsigned seed, std::vector<AgentFactory> seatBots = {});
+        ~GameServer();
+
+        GameServer(const GameServer&) = delete;
+        GameServer& operator=(const GameServer&) = delete;
+
+        // Process the ready sockets once, waiting at most timeoutMs
+        void pollOnce(int timeoutMs);
+
+        // Serve until stop() is called
+        void run();
+        void stop();
+
+        size_t getNumOfTables() const;
+        size_t getNumOfConnections() const;
+    };
+}
+
+#endif
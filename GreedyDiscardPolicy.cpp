@@ -0,0 +1,23 @@
+#include "GreedyDiscardPolicy.hpp"
+
+namespace catan_game
+{
+
+    ResourceVector GreedyDiscardPolicy::chooseDiscard(const ResourceVector& hand, int numOfCards)
+    {
+        ResourceVector left = hand;
+        ResourceVector discard = makeResourceVector(0, 0, 0, 0, 0);
+        for(int card = 0; card < numOfCards; ++card)
+        {
+            int largest = 0;
+            for(int type = 1; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(left[type] > left[largest]) largest = type;
+            }
+            if(left[largest] == 0) break;
+            --left[largest];
+            ++discard[largest];
+        }
+        return discard;
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef GREEDYDISCARDPOLICY_HPP
+#define GREEDYDISCARDPOLICY_HPP
+
+#include "DiscardPolicy.hpp"
+
+namespace catan_game
+{
+    // Gives back from the largest piles first, so the hand stays as varied as possible
+    class GreedyDiscardPolicy : public DiscardPolicy {
+    public:
+        ResourceVector chooseDiscard(const ResourceVector& hand, int numOfCards) override;
+    };
+}
+#endif
@@ -0,0 +1,23 @@
+#ifndef HARBOR_HPP
+#define HARBOR_HPP
+
+namespace catan_game {
+    class Vertex;
+    enum class TileType;
+
+    constexpr int BANK_TRADE_RATE = 4;
+    constexpr int GENERIC_HARBOR_RATE = 3;
+    constexpr int RESOURCE_HARBOR_RATE = 2;
+    constexpr int NUM_HARBORS = 9;
+
+    // A harbor on two neighbour coastal vertices - 3:1 for any resource when generic,
+    // otherwise 2:1 for its own resource
+    struct Harbor {
+        Vertex* first;
+        Vertex* second;
+        bool isGeneric;
+        TileType resource;
+    };
+}
+
+#endif
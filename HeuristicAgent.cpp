@@ -0,0 +1,424 @@
+#include <algorithm>
+#include "HeuristicAgent.hpp"
+
+namespace catan_game
+{
+    // Tree, Clay, Crop, Wool, Iron
+    static const ResourceVector ROAD_COST = makeResourceVector(1, 1, 0, 0, 0);
+    static const ResourceVector SETTLEMENT_COST = makeResourceVector(1, 1, 1, 1, 0);
+    static const ResourceVector CITY_COST = makeResourceVector(0, 0, 2, 0, 3);
+    static const ResourceVector DEVELOPMENT_CARD_COST = makeResourceVector(0, 0, 1, 1, 1);
+
+    HeuristicAgent::HeuristicAgent() :
+                    spots(),
+                    actionsThisTurn(0),
+                    isCardPlayChecked(false),
+                    canPlayCard(false)
+    {
+    }
+
+    void HeuristicAgent::startGame(const Game& game, size_t seat, unsigned seed)
+    {
+        this->actionsThisTurn = 0;
+        this->isCardPlayChecked = false;
+    }
+
+    bool HeuristicAgent::isLegal(const Game& game, const Action& action) const
+    {
+        ActionStatus status;
+        game.validate(std::span<const Action>(&action, 1), std::span<ActionStatus>(&status, 1));
+        return status == ActionStatus::Ok;
+    }
+
+    // Yield of a vertex for the seat - a resource its buildings don't produce yet counts half again
+    static int spotValue(const Vertex* vertex, const ResourceVector& income)
+    {
+        const ResourceVector& yield = vertex->getYield();
+        int value = 0;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            value += yield[type] * (income[type] == 0 ? 3 : 2);
+        }
+        return value;
+    }
+
+    static Action vertexAction(ActionOpcode opcode, size_t seat, const Vertex* vertex)
+    {
+        return makeAction(opcode, seat, encodeVertex(vertex->getRow(), vertex->getColumn()));
+    }
+
+    static Action roadAction(size_t seat, const Edge* edge)
+    {
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        return makeAction(ActionOpcode::BuildRoad, seat, encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn()));
+    }
+
+    // What the road leads to - the better of its open ends
+    static int roadValue(const Board& board, const Edge* edge, const ResourceVector& income)
+    {
+        const Vertex* ends[2] = {edge->getVertices().first, edge->getVertices().second};
+        int value = 0;
+        for(const Vertex* end: ends)
+        {
+            if(board.getOpenVertices().test(board.getCell(end->getRow(), end->getColumn())))
+            {
+                value = std::max(value, spotValue(end, income));
+            }
+        }
+        return value;
+    }
+
+    // The costs missing from the hand, 0 for what it covers
+    static ResourceVector missingFor(const ResourceVector& hand, const ResourceVector& cost)
+    {
+        ResourceVector missing = makeResourceVector(0, 0, 0, 0, 0);
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            missing[type] = std::max(0, cost[type] - hand[type]);
+        }
+        return missing;
+    }
+
+    // City while a settlement is left to upgrade, then a settlement on an open spot, a road to find one,
+    // and development cards once the board is full
+    const ResourceVector& HeuristicAgent::nextBuildCost(const Game& game, size_t seat)
+    {
+        const Player* player = game.getPlayers()[seat];
+        size_t numOfCities = 0;
+        for(const Vertex* vertex: player->getMyBuildings())
+        {
+            if(vertex->isCity()) ++numOfCities;
+        }
+        size_t numOfSettlements = player->getMyBuildings().size() - numOfCities;
+        if(numOfSettlements > 0 && numOfCities < MAX_CITIES) return CITY_COST;
+        if(numOfSettlements < MAX_SETTLEMENTS)
+        {
+            game.getBoard().getSettlementSpots(player, this->spots);
+            if(this->spots.any()) return SETTLEMENT_COST;
+            if(player->getMyRoads().size() < MAX_ROADS && game.getBoard().getRoadSpots(player).any()) return ROAD_COST;
+        }
+        return DEVELOPMENT_CARD_COST;
+    }
+
+    Action HeuristicAgent::chooseSetupSettlement(const Game& game, size_t seat) const
+    {
+        const Board& board = game.getBoard();
+        const ResourceVector& income = game.getPlayers()[seat]->getExpectedIncome();
+        const BoardMask& open = board.getOpenVertices();
+        const Vertex* best = nullptr;
+        int bestValue = -1;
+        for(size_t cell = open.findNext(0); cell < open.size(); cell = open.findNext(cell + 1))
+        {
+            const Vertex* vertex = board.getVertexOfCell(cell);
+            int value = spotValue(vertex, income);
+            if(value > bestValue)
+            {
+                best = vertex;
+                bestValue = value;
+            }
+        }
+        return best == nullptr ? makeAction(ActionOpcode::None, seat) : vertexAction(ActionOpcode::BuildSettlement, seat, best);
+    }
+
+    // The road of the settlement just placed toward the best spot left open
+    Action HeuristicAgent::chooseSetupRoad(const Game& game, size_t seat) const
+    {
+        const Board& board = game.getBoard();
+        const Player* player = game.getPlayers()[seat];
+        const BoardMask& roads = board.getRoadSpots(player);
+        Action best = makeAction(ActionOpcode::None, seat);
+        int bestValue = -1;
+        for(size_t slot = roads.findNext(0); slot < roads.size(); slot = roads.findNext(slot + 1))
+        {
+            const Edge* edge = board.getEdgeOfSlot(slot);
+            int value = roadValue(board, edge, player->getExpectedIncome());
+            Action road = roadAction(seat, edge);
+            if(value > bestValue && isLegal(game, road))
+            {
+                best = road;
+                bestValue = value;
+            }
+        }
+        return best;
+    }
+
+    bool HeuristicAgent::robberBlocksSeat(const Game& game, size_t seat) const
+    {
+        const Tile* robber = game.getBoard().getRobberTile();
+        if(robber == nullptr) return false;
+        for(const Vertex* vertex: robber->getVertices())
+        {
+            if(vertex->getOwner() == game.getPlayers()[seat]) return true;
+        }
+        return false;
+    }
+
+    // The tile where the others' buildings lose the most pips, none of the seat's own. The victim is
+    // the seat on it holding the most cards.
+    Action HeuristicAgent::chooseRobber(const Game& game, size_t seat) const
+    {
+        const Board& board = game.getBoard();
+        const std::vector<Player*>& players = game.getPlayers();
+        const Tile* best = nullptr;
+        int bestValue = -1;
+        for(const Tile* tile: board.getTiles())
+        {
+            if(tile->getIndex() == board.getRobberTileIndex()) continue;
+            int pips = tile->getType() == TileType::Sand ? 0 : diceWays(tile->getValue());
+            int value = 0;
+            for(const Vertex* vertex: tile->getVertices())
+            {
+                const Player* owner = vertex->getOwner();
+                if(owner == nullptr) continue;
+                if(owner == players[seat])
+                {
+                    value = -1;
+                    break;
+                }
+                value += pips * (vertex->isCity() ? 2 : 1);
+            }
+            if(value > bestValue)
+            {
+                best = tile;
+                bestValue = value;
+            }
+        }
+
+        if(best != nullptr)
+        {
+            int victim = -1, victimCards = 0;
+            for(const Vertex* vertex: best->getVertices())
+            {
+                const Player* owner = vertex->getOwner();
+                if(owner == nullptr || owner->getNumOfResources() <= victimCards) continue;
+                for(size_t other = 0; other < players.size(); ++other)
+                {
+                    if(players[other] == owner) victim = static_cast<int>(other);
+                }
+                victimCards = owner->getNumOfResources();
+            }
+            Action move = makeAction(ActionOpcode::MoveRobber, seat, robberTarget(best->getIndex(), victim));
+            if(isLegal(game, move)) return move;
+        }
+
+        // every tile touches the seat - the first legal move
+        for(int tile = 0; tile < static_cast<int>(board.getTiles().size()); ++tile)
+        {
+            for(int victim = -1; victim < static_cast<int>(players.size()); ++victim)
+            {
+                Action move = makeAction(ActionOpcode::MoveRobber, seat, robberTarget(tile, victim));
+                if(isLegal(game, move)) return move;
+            }
+        }
+        return makeAction(ActionOpcode::None, seat);
+    }
+
+    // The spots are the ones nextBuildCost just refreshed
+    Action HeuristicAgent::chooseBuild(const Game& game, size_t seat, const ResourceVector& hand, const ResourceVector& cost)
+    {
+        const Board& board = game.getBoard();
+        const Player* player = game.getPlayers()[seat];
+        const ResourceVector& income = player->getExpectedIncome();
+
+        if(hand.covers(CITY_COST))
+        {
+            const Vertex* best = nullptr;
+            for(const Vertex* vertex: player->getMyBuildings())
+            {
+                if(!vertex->isCity() && (best == nullptr || vertex->getYield().total() > best->getYield().total())) best = vertex;
+            }
+            if(best != nullptr)
+            {
+                Action city = vertexAction(ActionOpcode::BuildCity, seat, best);
+                if(isLegal(game, city)) return city;
+            }
+        }
+
+        if(hand.covers(SETTLEMENT_COST) && this->spots.any())
+        {
+            const Vertex* best = nullptr;
+            int bestValue = -1;
+            for(size_t cell = this->spots.findNext(0); cell < this->spots.size(); cell = this->spots.findNext(cell + 1))
+            {
+                const Vertex* vertex = board.getVertexOfCell(cell);
+                int value = spotValue(vertex, income);
+                if(value > bestValue)
+                {
+                    best = vertex;
+                    bestValue = value;
+                }
+            }
+            Action settlement = vertexAction(ActionOpcode::BuildSettlement, seat, best);
+            if(isLegal(game, settlement)) return settlement;
+        }
+
+        if(game.getFreeRoads() > 0 || (hand.covers(ROAD_COST) && &cost == &ROAD_COST))
+        {
+            const BoardMask& roads = board.getRoadSpots(player);
+            const Edge* best = nullptr;
+            int bestValue = -1;
+            for(size_t slot = roads.findNext(0); slot < roads.size(); slot = roads.findNext(slot + 1))
+            {
+                const Edge* edge = board.getEdgeOfSlot(slot);
+                int value = roadValue(board, edge, income);
+                if(value > bestValue)
+                {
+                    best = edge;
+                    bestValue = value;
+                }
+            }
+            if(best != nullptr)
+            {
+                Action road = roadAction(seat, best);
+                if(isLegal(game, road)) return road;
+            }
+        }
+
+        Action card = chooseCard(game, seat, hand, cost);
+        if(card.opcode != ActionOpcode::None) return card;
+
+        Action buy = makeAction(ActionOpcode::BuyDevelopmentCard, seat);
+        if(&cost == &DEVELOPMENT_CARD_COST && hand.covers(DEVELOPMENT_CARD_COST) && isLegal(game, buy)) return buy;
+        return makeAction(ActionOpcode::None, seat);
+    }
+
+    // A monopoly once the others hold a few of a resource, a year of plenty any time, a road building when
+    // a road is the next build. Whether the seat holds an unplayed card is asked of the game once a turn
+    // and again after a card changes hands.
+    Action HeuristicAgent::chooseCard(const Game& game, size_t seat, const ResourceVector& hand, const ResourceVector& cost)
+    {
+        if(!this->isCardPlayChecked)
+        {
+            Action plenty = makeAction(ActionOpcode::PlayYearOfPlenty, seat);
+            plenty.resources[0] = YEAR_OF_PLENTY_CARDS;
+            this->canPlayCard = isLegal(game, makeAction(ActionOpcode::PlayMonopoly, seat)) || isLegal(game, plenty)
+                             || isLegal(game, makeAction(ActionOpcode::PlayRoadBuilding, seat));
+            this->isCardPlayChecked = true;
+        }
+        if(!this->canPlayCard) return makeAction(ActionOpcode::None, seat);
+
+        Action monopoly = makeAction(ActionOpcode::PlayMonopoly, seat, static_cast<int>(chooseMonopoly(game, seat)));
+        int othersHold = 0;
+        for(size_t other = 0; other < game.getNumOfSeats(); ++other)
+        {
+            if(other != seat) othersHold += game.getPlayers()[other]->getResourceVector()[static_cast<int>(monopoly.target)];
+        }
+        Action plenty = makeAction(ActionOpcode::PlayYearOfPlenty, seat);
+        plenty.resources = yearOfPlentyFor(hand, cost);
+        Action chosen = makeAction(ActionOpcode::None, seat);
+        Action roadBuilding = makeAction(ActionOpcode::PlayRoadBuilding, seat);
+        if(othersHold >= 3 && isLegal(game, monopoly)) chosen = monopoly;
+        else if(isLegal(game, plenty)) chosen = plenty;
+        else if(&cost == &ROAD_COST && isLegal(game, roadBuilding)) chosen = roadBuilding;
+        this->isCardPlayChecked = chosen.opcode == ActionOpcode::None;
+        this->canPlayCard = false;
+        return chosen;
+    }
+
+    // One card the next build lacks, paid with the resource the seat has most to spare of
+    Action HeuristicAgent::chooseBankTrade(const Game& game, size_t seat, const ResourceVector& hand, const ResourceVector& cost) const
+    {
+        const Player* player = game.getPlayers()[seat];
+        ResourceVector missing = missingFor(hand, cost);
+        int want = -1, give = -1, bestSpare = 0;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(missing[type] > 0 && (want < 0 || missing[type] > missing[want])) want = type;
+            int spare = hand[type] - cost[type] - player->getTradeRate(static_cast<TileType>(type));
+            if(spare >= 0 && (give < 0 || spare > bestSpare))
+            {
+                give = type;
+                bestSpare = spare;
+            }
+        }
+        if(want < 0 || give < 0) return makeAction(ActionOpcode::None, seat);
+
+        Action trade = makeAction(ActionOpcode::BankTrade, seat);
+        trade.resources[give] = player->getTradeRate(static_cast<TileType>(give));
+        trade.resources[want] = -1;
+        return isLegal(game, trade) ? trade : makeAction(ActionOpcode::None, seat);
+    }
+
+    Action HeuristicAgent::choosePlacement(const Game& game, size_t seat)
+    {
+        return game.getPhase() == GamePhase::SetupSettlement ? chooseSetupSettlement(game, seat) : chooseSetupRoad(game, seat);
+    }
+
+    Action HeuristicAgent::chooseAction(const Game& game, size_t seat)
+    {
+        switch(game.getPhase())
+        {
+            case GamePhase::SetupSettlement:
+            case GamePhase::SetupRoad:
+                return choosePlacement(game, seat);
+            case GamePhase::Roll:
+            {
+                Action knight = makeAction(ActionOpcode::PlayKnight, seat);
+                this->isCardPlayChecked = false; // a new turn, with the cards bought in the last one
+                if(robberBlocksSeat(game, seat) && isLegal(game, knight)) return knight;
+                return makeAction(ActionOpcode::RollDice, seat);
+            }
+            case GamePhase::MoveRobber:
+                return chooseRobber(game, seat);
+            case GamePhase::Main:
+            {
+                Action action = makeAction(ActionOpcode::None, seat);
+                if(this->actionsThisTurn < MAX_ACTIONS_PER_TURN)
+                {
+                    ResourceVector hand = game.getPlayers()[seat]->getResourceVector();
+                    const ResourceVector& cost = nextBuildCost(game, seat);
+                    action = chooseBuild(game, seat, hand, cost);
+                    if(action.opcode == ActionOpcode::None) action = chooseBankTrade(game, seat, hand, cost);
+                }
+                if(action.opcode == ActionOpcode::None)
+                {
+                    this->actionsThisTurn = 0;
+                    return makeAction(ActionOpcode::EndTurn, seat);
+                }
+                ++this->actionsThisTurn;
+                return action;
+            }
+            default:
+                return makeAction(ActionOpcode::None, seat);
+        }
+    }
+
+    bool HeuristicAgent::acceptTrade(const Game& game, size_t seat, const TradeOffer& offer)
+    {
+        ResourceVector hand = game.getPlayers()[seat]->getResourceVector();
+        const ResourceVector& cost = nextBuildCost(game, seat);
+        ResourceVector missing = missingFor(hand, cost);
+        bool bringsMissing = false;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(offer.want[type] > std::max(0, hand[type] - cost[type])) return false;
+            if(offer.give[type] > 0 && missing[type] > 0) bringsMissing = true;
+        }
+        return bringsMissing && offer.give.total() >= offer.want.total();
+    }
+
+    ResourceVector HeuristicAgent::chooseYearOfPlenty(const Game& game, size_t seat)
+    {
+        return yearOfPlentyFor(game.getPlayers()[seat]->getResourceVector(), nextBuildCost(game, seat));
+    }
+
+    ResourceVector HeuristicAgent::yearOfPlentyFor(const ResourceVector& hand, const ResourceVector& cost) const
+    {
+        ResourceVector missing = missingFor(hand, cost);
+        ResourceVector after = hand;
+        ResourceVector taken = makeResourceVector(0, 0, 0, 0, 0);
+        for(int card = 0; card < YEAR_OF_PLENTY_CARDS; ++card)
+        {
+            int pick = 0;
+            for(int type = 1; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(missing[type] > missing[pick] || (missing[type] == missing[pick] && after[type] < after[pick])) pick = type;
+            }
+            if(missing[pick] > 0) --missing[pick];
+            ++after[pick];
+            ++taken[pick];
+        }
+        return taken;
+    }
+}
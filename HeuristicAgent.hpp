@@ -0,0 +1,49 @@
+#ifndef HEURISTICAGENT_HPP
+#define HEURISTICAGENT_HPP
+
+#include <cstddef>
+#include "Agent.hpp"
+#include "BoardMask.hpp"
+
+namespace catan_game
+{
+    // Deterministic rule based agent - the baseline of the benchmarks and a rollout policy for search.
+    // Spots are worth their vertex yield, resources the seat earns nothing of weigh more. The turn climbs
+    // a fixed ladder: city, settlement, road when no spot is open, monopoly, year of plenty and
+    // development card, then one bank trade toward the next build, then the end of the turn.
+    // The robber goes where it blocks the most of the others' income. Decisions read the board's masks,
+    // the vertex yields and the seat's expected income and don't allocate once the first one sized the scratch.
+    class HeuristicAgent : public Agent {
+    private:
+        BoardMask spots;  // the seat's settlement spots, refreshed by nextBuildCost
+        size_t actionsThisTurn;
+        bool isCardPlayChecked; // whether a monopoly or year of plenty can be played, asked once a turn
+        bool canPlayCard;
+
+        bool isLegal(const Game& game, const Action& action) const;
+        const ResourceVector& nextBuildCost(const Game& game, size_t seat);
+        Action chooseSetupSettlement(const Game& game, size_t seat) const;
+        Action chooseSetupRoad(const Game& game, size_t seat) const;
+        Action chooseRobber(const Game& game, size_t seat) const;
+        Action chooseBuild(const Game& game, size_t seat, const ResourceVector& hand, const ResourceVector& cost);
+        Action chooseCard(const Game& game, size_t seat, const ResourceVector& hand, const ResourceVector& cost);
+        Action chooseBankTrade(const Game& game, size_t seat, const ResourceVector& hand, const ResourceVector& cost) const;
+        bool robberBlocksSeat(const Game& game, size_t seat) const;
+        ResourceVector yearOfPlentyFor(const ResourceVector& hand, const ResourceVector& cost) const;
+
+    public:
+        static constexpr size_t MAX_ACTIONS_PER_TURN = 12;
+
+        HeuristicAgent();
+        void startGame(const Game& game, size_t seat, unsigned seed) override;
+        Action choosePlacement(const Game& game, size_t seat) override;
+        Action chooseAction(const Game& game, size_t seat) override;
+
+        // Takes an offer that pays only from what the next build doesn't need and brings what it lacks
+        bool acceptTrade(const Game& game, size_t seat, const TradeOffer& offer) override;
+
+        // What the next build lacks first, then what the seat has least of
+        ResourceVector chooseYearOfPlenty(const Game& game, size_t seat) override;
+    };
+}
+#endif
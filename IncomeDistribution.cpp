@@ -0,0 +1,131 @@
+#include <algorithm>
+#include "IncomeDistribution.hpp"
+
+namespace catan_game {
+
+    IncomeDistribution::IncomeDistribution(const RollIncome& income, int numOfRolls, const ResourceVector& amountsCap) :
+                    cap(amountsCap),
+                    strides(),
+                    probabilities()
+    {
+        int numOfCells = 1;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            this->cap[type] = std::max(this->cap[type], 0);
+            this->strides[type] = numOfCells;
+            numOfCells *= this->cap[type] + 1;
+        }
+
+        // Where every cell goes on every roll, computed once for all the rolls
+        std::vector<std::pair<int, int>> moves; // (roll, cell after the roll) for every cell in order
+        for(int cell = 0; cell < numOfCells; ++cell)
+        {
+            for(int roll = MIN_DICE_ROLL; roll <= MAX_DICE_ROLL; ++roll)
+            {
+                int next = 0;
+                for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+                {
+                    int amount = (cell / this->strides[type]) % (this->cap[type] + 1);
+                    next += std::min(amount + income[roll][type], this->cap[type]) * this->strides[type];
+                }
+                moves.emplace_back(roll, next);
+            }
+        }
+
+        this->probabilities.assign(numOfCells, 0.0);
+        this->probabilities[0] = 1.0;
+        std::vector<double> next(numOfCells);
+        constexpr int NUM_OF_SUMS = MAX_DICE_ROLL - MIN_DICE_ROLL + 1;
+        for(int rollAtIndex = 0; rollAtIndex < numOfRolls; ++rollAtIndex)
+        {
+            std::fill(next.begin(), next.end(), 0.0);
+            for(int cell = 0; cell < numOfCells; ++cell)
+            {
+                double probability = this->probabilities[cell];
+                if(probability == 0.0) continue;
+                for(int sum = 0; sum < NUM_OF_SUMS; ++sum)
+                {
+                    const std::pair<int, int>& move = moves[cell * NUM_OF_SUMS + sum];
+                    next[move.second] += probability * diceWays(move.first) / DICE_OUTCOMES;
+                }
+            }
+            this->probabilities.swap(next);
+        }
+    }
+
+    // Every building on a producing tile collects one card, a city two
+    RollIncome IncomeDistribution::rollIncome(const Board& board, const Player& player)
+    {
+        RollIncome income;
+        for(int roll = 0; roll <= MAX_DICE_ROLL; ++roll)
+        {
+            income[roll] = makeResourceVector(0, 0, 0, 0, 0);
+            for(const Tile* tile: board.getProducingTiles(roll))
+            {
+                for(const Vertex* vertex: tile->getVertices())
+                {
+                    if(vertex->getOwner() == &player) income[roll][tile->getType()] += vertex->isCity() ? 2 : 1;
+                }
+            }
+        }
+        return income;
+    }
+
+    ResourceVector IncomeDistribution::maxIncome(const RollIncome& income, int numOfRolls)
+    {
+        ResourceVector most = makeResourceVector(0, 0, 0, 0, 0);
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            for(const ResourceVector& amounts: income)
+            {
+                most[type] = std::max(most[type], amounts[type] * numOfRolls);
+            }
+        }
+        return most;
+    }
+
+    int IncomeDistribution::cellOf(const ResourceVector& amounts) const
+    {
+        int cell = 0;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(amounts[type] < 0 || amounts[type] > this->cap[type]) return -1;
+            cell += amounts[type] * this->strides[type];
+        }
+        return cell;
+    }
+
+    double IncomeDistribution::probabilityOf(const ResourceVector& amounts) const
+    {
+        int cell = cellOf(amounts);
+        return (cell < 0) ? 0.0 : this->probabilities[cell];
+    }
+
+    double IncomeDistribution::probabilityOfAtLeast(const ResourceVector& amounts) const
+    {
+        if(cellOf(amounts) < 0) return 0.0;
+        double sum = 0.0;
+        for(size_t cell = 0; cell < this->probabilities.size(); ++cell)
+        {
+            bool isEnough = true;
+            for(int type = 0; type < NUM_RESOURCE_TYPES && isEnough; ++type)
+            {
+                isEnough = static_cast<int>(cell / this->strides[type]) % (this->cap[type] + 1) >= amounts[type];
+            }
+            if(isEnough) sum += this->probabilities[cell];
+        }
+        return sum;
+    }
+
+    const ResourceVector& IncomeDistribution::getCap() const
+    {
+        return this->cap;
+    }
+
+    double IncomeDistribution::chanceToAfford(const Board& board, const Player& player, const ResourceVector& cost, int numOfRolls)
+    {
+        ResourceVector missing = cost - player.getResourceVector();
+        IncomeDistribution distribution(rollIncome(board, player), numOfRolls, missing);
+        return distribution.probabilityOfAtLeast(distribution.getCap());
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef INCOMEDISTRIBUTION_HPP
+#define INCOMEDISTRIBUTION_HPP
+
+#include <array>
+#include <vector>
+#include "Board.hpp"
+#include "Player.hpp"
+#include "Resources.hpp"
+
+namespace catan_game {
+
+    // What one player collects on every dice sum, index 2..12 (the robber's tile gives nothing)
+    using RollIncome = std::array<ResourceVector, MAX_DICE_ROLL + 1>;
+
+    // Exact distribution of the resources a player collects over the next rolls, from the 2d6 odds.
+    // Every amount is counted up to its cap and saturates there, so asking "at least the cap"
+    // keeps the table at (cap + 1) cells per resource however many rolls are played.
+    // A 7 collects nothing - the robber and the discards are not modelled.
+    class IncomeDistribution {
+    private:
+        ResourceVector cap;
+        std::array<int, NUM_RESOURCE_TYPES> strides; // index of a cell = sum of amount * stride
+        std::vector<double> probabilities;
+
+        int cellOf(const ResourceVector& amounts) const;
+
+    public:
+        IncomeDistribution(const RollIncome& income, int numOfRolls, const ResourceVector& amountsCap);
+
+        static RollIncome rollIncome(const Board& board, const Player& player);
+
+        // Cap that never saturates - the most the rolls can give of every resource
+        static ResourceVector maxIncome(const RollIncome& income, int numOfRolls);
+
+        // Probability to collect exactly the amounts (an amount at its cap means "at least")
+        double probabilityOf(const ResourceVector& amounts) const;
+
+        // Probability to collect at least the amounts, every amount at most its cap
+        double probabilityOfAtLeast(const ResourceVector& amounts) const;
+
+        const ResourceVector& getCap() const;
+
+        // How likely the player can pay the cost after the rolls, counting what it holds already
+        static double chanceToAfford(const Board& board, const Player& player, const ResourceVector& cost, int numOfRolls);
+    };
+}
+
+#endif
@@ -9,7 +9,7 @@ namespace catan_game
         points = 0;
     }
 
-    std::string KnightCard::getName() const {
+    std::string_view KnightCard::getName() const {
         return this->cardName;
     }
     
@@ -12,7 +12,7 @@ namespace catan_game
         int points;
     public:
         KnightCard();
-        std::string getName() const override;
+        std::string_view getName() const override;
         int getPoints() const override;
     };
 }
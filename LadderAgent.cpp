@@ -0,0 +1,188 @@
+#include "LadderAgent.hpp"
+#include "HeuristicAgent.hpp"
+
+namespace catan_game
+{
+
+    LadderAgent::LadderAgent(const std::vector<LadderRung>& rungs) :
+                    ladder(rungs),
+                    rng(),
+                    actionsThisTurn(0)
+    {
+    }
+
+    // The seats' choices get their own stream of the seed, apart from the board and the dice
+    void LadderAgent::startGame(const Game& game, size_t seat, unsigned seed)
+    {
+        std::seed_seq sequence{seed, 0x73u, static_cast<unsigned>(seat)};
+        this->rng.seed(sequence);
+        this->actionsThisTurn = 0;
+    }
+
+    static Action roadAction(size_t seat, const Edge* edge)
+    {
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        return makeAction(ActionOpcode::BuildRoad, seat, encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn()));
+    }
+
+    static void addVertexActions(const Board& board, const BoardMask& mask, ActionOpcode opcode, size_t seat,
+                                 std::vector<Action>& rung)
+    {
+        for(size_t cell = mask.findNext(0); cell < mask.size(); cell = mask.findNext(cell + 1))
+        {
+            const Vertex* vertex = board.getVertexOfCell(cell);
+            rung.push_back(makeAction(opcode, seat, encodeVertex(vertex->getRow(), vertex->getColumn())));
+        }
+    }
+
+    static void addRoadActions(const Board& board, const BoardMask& mask, size_t seat, std::vector<Action>& rung)
+    {
+        for(size_t slot = mask.findNext(0); slot < mask.size(); slot = mask.findNext(slot + 1))
+        {
+            rung.push_back(roadAction(seat, board.getEdgeOfSlot(slot)));
+        }
+    }
+
+    static void addBankTrade(const Player* player, size_t seat, std::vector<Action>& rung)
+    {
+        ResourceVector hand = player->getResourceVector();
+        int give = -1, want = 0;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            int surplus = hand[type] - player->getTradeRate(static_cast<TileType>(type));
+            if(surplus >= 0 && (give < 0 || surplus > hand[give] - player->getTradeRate(static_cast<TileType>(give)))) give = type;
+            if(hand[type] < hand[want]) want = type;
+        }
+        if(give < 0 || give == want) return;
+        Action trade = makeAction(ActionOpcode::BankTrade, seat);
+        trade.resources[give] = player->getTradeRate(static_cast<TileType>(give));
+        trade.resources[want] = -1;
+        rung.push_back(trade);
+    }
+
+    // The candidates of a rung for the game's phase - false past the last rung
+    bool LadderAgent::fillRung(const Game& game, size_t seat, size_t rungIndex)
+    {
+        const Board& board = game.getBoard();
+        const Player* player = game.getPlayers()[seat];
+        this->rung.clear();
+        switch(game.getPhase())
+        {
+            case GamePhase::SetupSettlement:
+                if(rungIndex > 0) return false;
+                addVertexActions(board, board.getOpenVertices(), ActionOpcode::BuildSettlement, seat, this->rung);
+                return true;
+            case GamePhase::SetupRoad:
+                if(rungIndex > 0) return false;
+                addRoadActions(board, board.getRoadSpots(player), seat, this->rung);
+                return true;
+            case GamePhase::Roll:
+                if(rungIndex > 0) return false;
+                this->rung.push_back(makeAction(ActionOpcode::RollDice, seat));
+                return true;
+            case GamePhase::MoveRobber:
+                if(rungIndex > 0) return false;
+                for(int tile = 0; tile < static_cast<int>(board.getTiles().size()); ++tile)
+                {
+                    for(int victim = -1; victim < static_cast<int>(game.getNumOfSeats()); ++victim)
+                    {
+                        this->rung.push_back(makeAction(ActionOpcode::MoveRobber, seat, robberTarget(tile, victim)));
+                    }
+                }
+                return true;
+            case GamePhase::Main:
+                if(this->actionsThisTurn >= MAX_ACTIONS_PER_TURN) rungIndex = this->ladder.size();
+                if(rungIndex == this->ladder.size())
+                {
+                    this->rung.push_back(makeAction(ActionOpcode::EndTurn, seat));
+                    return true;
+                }
+                if(rungIndex > this->ladder.size()) return false;
+                switch(this->ladder[rungIndex])
+                {
+                    case LadderRung::City:
+                        for(const Vertex* vertex: player->getMyBuildings())
+                        {
+                            this->rung.push_back(makeAction(ActionOpcode::BuildCity, seat, encodeVertex(vertex->getRow(), vertex->getColumn())));
+                        }
+                        break;
+                    case LadderRung::Settlement:
+                        board.getSettlementSpots(player, this->spots);
+                        addVertexActions(board, this->spots, ActionOpcode::BuildSettlement, seat, this->rung);
+                        break;
+                    case LadderRung::DevelopmentCard:
+                        this->rung.push_back(makeAction(ActionOpcode::BuyDevelopmentCard, seat));
+                        break;
+                    case LadderRung::Road:
+                        addRoadActions(board, board.getRoadSpots(player), seat, this->rung);
+                        break;
+                    case LadderRung::BankTrade:
+                        addBankTrade(player, seat, this->rung);
+                        break;
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // The setup is the single rung of its phase
+    Action LadderAgent::choosePlacement(const Game& game, size_t seat)
+    {
+        return chooseAction(game, seat);
+    }
+
+    Action LadderAgent::chooseAction(const Game& game, size_t seat)
+    {
+        this->legal.clear();
+        for(size_t rungIndex = 0; this->legal.empty() && fillRung(game, seat, rungIndex); ++rungIndex)
+        {
+            this->statuses.resize(this->rung.size());
+            game.validate(this->rung, this->statuses);
+            for(size_t index = 0; index < this->rung.size(); ++index)
+            {
+                if(this->statuses[index] == ActionStatus::Ok) this->legal.push_back(this->rung[index]);
+            }
+        }
+        if(this->legal.empty()) return makeAction(ActionOpcode::None, seat);
+
+        Action action = this->legal[this->rng() % this->legal.size()];
+        if(action.opcode == ActionOpcode::EndTurn) this->actionsThisTurn = 0;
+        else if(game.getPhase() == GamePhase::Main) ++this->actionsThisTurn;
+        return action;
+    }
+
+    std::unique_ptr<Agent> makeBuiltinAgent(const std::string& name)
+    {
+        if(name == "builder")
+        {
+            return std::make_unique<LadderAgent>(std::vector<LadderRung>{LadderRung::City, LadderRung::Settlement,
+                LadderRung::DevelopmentCard, LadderRung::Road, LadderRung::BankTrade});
+        }
+        if(name == "expander")
+        {
+            return std::make_unique<LadderAgent>(std::vector<LadderRung>{LadderRung::Settlement, LadderRung::Road,
+                LadderRung::City, LadderRung::BankTrade, LadderRung::DevelopmentCard});
+        }
+        if(name == "carder")
+        {
+            return std::make_unique<LadderAgent>(std::vector<LadderRung>{LadderRung::DevelopmentCard, LadderRung::City,
+                LadderRung::Settlement, LadderRung::BankTrade, LadderRung::Road});
+        }
+        if(name == "heuristic")
+        {
+            return std::make_unique<HeuristicAgent>();
+        }
+        if(name == "passive")
+        {
+            return std::make_unique<LadderAgent>(std::vector<LadderRung>{LadderRung::City, LadderRung::Settlement});
+        }
+        return nullptr;
+    }
+
+    std::vector<std::string> builtinAgentNames()
+    {
+        return {"builder", "expander", "carder", "heuristic", "passive"};
+    }
+}
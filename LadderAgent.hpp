@@ -0,0 +1,52 @@
+#ifndef LADDERAGENT_HPP
+#define LADDERAGENT_HPP
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Agent.hpp"
+
+namespace catan_game
+{
+    // What a rung of the ladder tries in the main phase
+    enum class LadderRung {
+        City,
+        Settlement,
+        DevelopmentCard,
+        Road,
+        BankTrade   // the most plentiful resource the seat can pay for the one it has least of
+    };
+
+    // Scripted agent - takes a random legal action of the first rung of its ladder that has one and ends
+    // the turn when none has. The setup, the roll and the robber are one rung each. The choices are drawn
+    // from a generator seeded with the game seed and the seat.
+    class LadderAgent : public Agent {
+    private:
+        std::vector<LadderRung> ladder;
+        std::minstd_rand rng;
+        size_t actionsThisTurn;
+        // scratch reused by every decision
+        std::vector<Action> rung;
+        std::vector<ActionStatus> statuses;
+        std::vector<Action> legal;
+        BoardMask spots;
+
+        bool fillRung(const Game& game, size_t seat, size_t rungIndex);
+
+    public:
+        static constexpr size_t MAX_ACTIONS_PER_TURN = 12; // past it the seat ends its turn, trades can't go around forever
+
+        explicit LadderAgent(const std::vector<LadderRung>& rungs);
+        void startGame(const Game& game, size_t seat, unsigned seed) override;
+        Action choosePlacement(const Game& game, size_t seat) override;
+        Action chooseAction(const Game& game, size_t seat) override;
+    };
+
+    // The built-in scripted agents by name - builder (cities first), expander (settlements and roads first),
+    // carder (development cards first), heuristic (the rule based HeuristicAgent) and passive (buildings only).
+    // nullptr for an unknown name.
+    std::unique_ptr<Agent> makeBuiltinAgent(const std::string& name);
+    std::vector<std::string> builtinAgentNames();
+}
+#endif
@@ -8,7 +8,7 @@ namespace catan_game
         points = 2;
     }
 
-    std::string LargestArmyCard::getName() const
+    std::string_view LargestArmyCard::getName() const
     {
         return "Largest Army";
     }
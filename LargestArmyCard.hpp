@@ -9,7 +9,7 @@ namespace catan_game
         int points;
     public:
         LargestArmyCard();
-        std::string getName() const override;
+        std::string_view getName() const override;
         int getPoints() const override;
     };
 }
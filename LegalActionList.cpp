@@ -0,0 +1,116 @@
+#include "LegalActionList.hpp"
+
+namespace catan_game
+{
+
+    void LegalActionList::addVertices(const Game& game, const BoardMask& mask, ActionOpcode opcode, size_t seat)
+    {
+        const Board& board = game.getBoard();
+        for(size_t cell = mask.findNext(0); cell < mask.size(); cell = mask.findNext(cell + 1))
+        {
+            const Vertex* vertex = board.getVertexOfCell(cell);
+            this->candidates.push_back(makeAction(opcode, seat, encodeVertex(vertex->getRow(), vertex->getColumn())));
+        }
+    }
+
+    void LegalActionList::addRoads(const Game& game, const BoardMask& mask, size_t seat)
+    {
+        const Board& board = game.getBoard();
+        for(size_t slot = mask.findNext(0); slot < mask.size(); slot = mask.findNext(slot + 1))
+        {
+            const Edge* edge = board.getEdgeOfSlot(slot);
+            const Vertex* from = edge->getVertices().first;
+            const Vertex* to = edge->getVertices().second;
+            this->candidates.push_back(makeAction(ActionOpcode::BuildRoad, seat,
+                                                  encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn())));
+        }
+    }
+
+    void LegalActionList::addMainActions(const Game& game, size_t seat)
+    {
+        const Board& board = game.getBoard();
+        const Player* player = game.getPlayers()[seat];
+        for(const Vertex* vertex: player->getMyBuildings())
+        {
+            this->candidates.push_back(makeAction(ActionOpcode::BuildCity, seat, encodeVertex(vertex->getRow(), vertex->getColumn())));
+        }
+        board.getSettlementSpots(player, this->spots);
+        addVertices(game, this->spots, ActionOpcode::BuildSettlement, seat);
+        addRoads(game, board.getRoadSpots(player), seat);
+        this->candidates.push_back(makeAction(ActionOpcode::BuyDevelopmentCard, seat));
+        this->candidates.push_back(makeAction(ActionOpcode::PlayKnight, seat));
+        this->candidates.push_back(makeAction(ActionOpcode::PlayMonopoly, seat));
+        this->candidates.push_back(makeAction(ActionOpcode::PlayRoadBuilding, seat));
+
+        // checked with a choice of two of the first resource, the frame itself goes out empty
+        Action plenty = makeAction(ActionOpcode::PlayYearOfPlenty, seat);
+        plenty.resources[0] = YEAR_OF_PLENTY_CARDS;
+        this->candidates.push_back(plenty);
+
+        for(int give = 0; give < NUM_RESOURCE_TYPES; ++give)
+        {
+            for(int want = 0; want < NUM_RESOURCE_TYPES; ++want)
+            {
+                if(give == want) continue;
+                Action bank = makeAction(ActionOpcode::BankTrade, seat);
+                bank.resources[give] = player->getTradeRate(static_cast<TileType>(give));
+                bank.resources[want] = -1;
+                this->candidates.push_back(bank);
+                Action offer = makeAction(ActionOpcode::PostTrade, seat);
+                offer.resources[give] = 1;
+                offer.resources[want] = -1;
+                this->candidates.push_back(offer);
+            }
+        }
+        for(const TradeOffer& offer: game.getTradeBook().getOffers())
+        {
+            this->candidates.push_back(makeAction(ActionOpcode::AcceptTrade, seat, offer.id));
+            this->candidates.push_back(makeAction(ActionOpcode::CancelTrade, seat, offer.id));
+        }
+        this->candidates.push_back(makeAction(ActionOpcode::EndTurn, seat));
+    }
+
+    const std::vector<Action>& LegalActionList::collect(const Game& game, size_t seat)
+    {
+        const Board& board = game.getBoard();
+        this->candidates.clear();
+        switch(game.getPhase())
+        {
+            case GamePhase::SetupSettlement:
+                addVertices(game, board.getOpenVertices(), ActionOpcode::BuildSettlement, seat);
+                break;
+            case GamePhase::SetupRoad:
+                addRoads(game, board.getRoadSpots(game.getPlayers()[seat]), seat);
+                break;
+            case GamePhase::Roll:
+                this->candidates.push_back(makeAction(ActionOpcode::RollDice, seat));
+                this->candidates.push_back(makeAction(ActionOpcode::PlayKnight, seat));
+                break;
+            case GamePhase::MoveRobber:
+                for(int tile = 0; tile < static_cast<int>(board.getTiles().size()); ++tile)
+                {
+                    for(int victim = -1; victim < static_cast<int>(game.getNumOfSeats()); ++victim)
+                    {
+                        this->candidates.push_back(makeAction(ActionOpcode::MoveRobber, seat, robberTarget(tile, victim)));
+                    }
+                }
+                break;
+            case GamePhase::Main:
+                addMainActions(game, seat);
+                break;
+            default:
+                break;
+        }
+
+        this->statuses.resize(this->candidates.size());
+        game.validate(this->candidates, this->statuses);
+        this->legal.clear();
+        for(size_t index = 0; index < this->candidates.size(); ++index)
+        {
+            if(this->statuses[index] != ActionStatus::Ok) continue;
+            this->legal.push_back(this->candidates[index]);
+            if(this->legal.back().opcode == ActionOpcode::PlayYearOfPlenty) this->legal.back().resources = makeResourceVector(0, 0, 0, 0, 0);
+        }
+        return this->legal;
+    }
+}
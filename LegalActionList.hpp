@@ -0,0 +1,31 @@
+#ifndef LEGALACTIONLIST_HPP
+#define LEGALACTIONLIST_HPP
+
+#include <cstddef>
+#include <vector>
+#include "Action.hpp"
+#include "BoardMask.hpp"
+#include "Game.hpp"
+
+namespace catan_game
+{
+    // Every action a seat can take now, checked by the game's validate - what a plugin agent picks from.
+    // The main phase offers the builds, the cards, bank trades at the seat's rates, one for one offers
+    // to everybody, taking or cancelling the resting offers and the end of the turn. The card frames
+    // carry no choice, Agent::decide completes them. The buffers are reused from one call to the next.
+    class LegalActionList {
+    private:
+        std::vector<Action> candidates;
+        std::vector<ActionStatus> statuses;
+        std::vector<Action> legal;
+        BoardMask spots;
+
+        void addVertices(const Game& game, const BoardMask& mask, ActionOpcode opcode, size_t seat);
+        void addRoads(const Game& game, const BoardMask& mask, size_t seat);
+        void addMainActions(const Game& game, size_t seat);
+
+    public:
+        const std::vector<Action>& collect(const Game& game, size_t seat);
+    };
+}
+#endif
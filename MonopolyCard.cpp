@@ -8,7 +8,7 @@ namespace catan_game
         points = 0;
     }
 
-    std::string MonopolyCard::getName() const {
+    std::string_view MonopolyCard::getName() const {
         return "Monopoly";
     }
 
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include "PlacementOptimizer.hpp"
+
+namespace catan_game {
+
+    constexpr double NEW_RESOURCE_WEIGHT = 3.0; // per resource the seat doesn't produce yet, in dice ways
+    constexpr double BLOCKING_WEIGHT = 0.25;    // of the yield of every free spot the settlement takes away
+    constexpr double HARBOR_BONUS = 1.0;
+    constexpr double ROAD_WEIGHT = 0.5;         // of the best spot at the end of the road
+
+    // What a settlement at the vertex is worth to the player, the resources weighted by their scarcity
+    static double scoreSettlement(const Board& board, const Vertex* vertex, const Player* player,
+                                  const std::array<double, NUM_RESOURCE_TYPES>& scarcity)
+    {
+        const ResourceVector& yield = vertex->getYield();
+        const ResourceVector& income = player->getExpectedIncome();
+        double score = 0;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            score += yield[type] * scarcity[type];
+            if(yield[type] > 0 && income[type] == 0) score += NEW_RESOURCE_WEIGHT;
+        }
+
+        // the free neighbours can't be settled by anybody once this one is
+        for(const Vertex* neighbor: vertex->getMyVertexNeighbors())
+        {
+            if(board.canPlaceSettlement(neighbor->getRow(), neighbor->getColumn(), player, false))
+            {
+                score += BLOCKING_WEIGHT * neighbor->getYield().total();
+            }
+        }
+
+        if(vertex->getHarbor() != nullptr) score += HARBOR_BONUS;
+        return score;
+    }
+
+    // The best spot two steps away, reachable by the next road - the settlement blocks the road's own end
+    static double scoreRoad(const Board& board, const Vertex* from, const Vertex* to, const Player* player)
+    {
+        int best = 0;
+        for(const Vertex* next: to->getMyVertexNeighbors())
+        {
+            if(next != from && board.canPlaceSettlement(next->getRow(), next->getColumn(), player, false))
+            {
+                best = std::max(best, next->getYield().total());
+            }
+        }
+        return ROAD_WEIGHT * best;
+    }
+
+    std::vector<PlacementSuggestion> PlacementOptimizer::suggest(const Game& game, size_t seat, size_t maxSuggestions,
+                                                                 std::chrono::microseconds budget) const
+    {
+        auto deadline = std::chrono::steady_clock::now() + budget;
+        const Board& board = game.getBoard();
+        const Player* player = game.getPlayers().at(seat);
+
+        // A resource is worth the average production over its own - the rarest one counts the most
+        std::array<double, NUM_RESOURCE_TYPES> scarcity;
+        ResourceVector boardYield = makeResourceVector(0, 0, 0, 0, 0);
+        for(const Tile* tile: board.getTiles())
+        {
+            if(tile->getType() != TileType::Sand) boardYield[tile->getType()] += diceWays(tile->getValue());
+        }
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            scarcity[type] = boardYield[type] > 0 ? static_cast<double>(boardYield.total()) / (NUM_RESOURCE_TYPES * boardYield[type]) : 0;
+        }
+
+        // the setup spots are the board's open vertices, up to 3 roads leave each one
+        const BoardMask& open = board.getOpenVertices();
+        std::vector<PlacementSuggestion> suggestions;
+        suggestions.reserve(3 * open.count());
+        for(size_t cell = open.findNext(0); cell < open.size(); cell = open.findNext(cell + 1))
+        {
+            if(std::chrono::steady_clock::now() > deadline) break;
+
+            const Vertex* vertex = board.getVertexOfCell(cell);
+            double settlementScore = scoreSettlement(board, vertex, player, scarcity);
+            for(const Vertex* to: vertex->getMyVertexNeighbors())
+            {
+                const Edge* edge = board.findEdge(vertex->getRow(), vertex->getColumn(), to->getRow(), to->getColumn());
+                if(edge == nullptr || edge->hasRoad()) continue;
+                suggestions.push_back({vertex->getRow(), vertex->getColumn(), to->getRow(), to->getColumn(),
+                                       settlementScore + scoreRoad(board, vertex, to, player)});
+            }
+        }
+
+        // the coordinates break ties, so equal scores always rank the same way
+        auto isBetter = [](const PlacementSuggestion& first, const PlacementSuggestion& second)
+        {
+            if(first.score != second.score) return first.score > second.score;
+            if(first.row != second.row) return first.row < second.row;
+            if(first.col != second.col) return first.col < second.col;
+            if(first.toRow != second.toRow) return first.toRow < second.toRow;
+            return first.toCol < second.toCol;
+        };
+        size_t numOfSuggestions = std::min(maxSuggestions, suggestions.size());
+        std::partial_sort(suggestions.begin(), suggestions.begin() + numOfSuggestions, suggestions.end(), isBetter);
+        suggestions.resize(numOfSuggestions);
+        return suggestions;
+    }
+}
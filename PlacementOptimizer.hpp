@@ -0,0 +1,32 @@
+#ifndef PLACEMENTOPTIMIZER_HPP
+#define PLACEMENTOPTIMIZER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "Game.hpp"
+
+namespace catan_game {
+
+    // A settlement and the road leaving it, as placed in one step of the setup draft
+    struct PlacementSuggestion {
+        int row;
+        int col;
+        int toRow;
+        int toCol;
+        double score;
+    };
+
+    // Scores every legal settlement + road pair of the setup draft for a seat.
+    // A pair is worth its expected yield (scarce resources weigh more), the resources it adds
+    // to the seat's income, the yield it denies the other seats and the best spot its road leads to.
+    // A board has a few dozen open vertices, so the pairs are scored on the calling thread.
+    class PlacementOptimizer {
+    public:
+        // Best pairs first, at most maxSuggestions. Settlements not scored when the budget runs out are left out.
+        std::vector<PlacementSuggestion> suggest(const Game& game, size_t seat, size_t maxSuggestions,
+                                                 std::chrono::microseconds budget) const;
+    };
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include "Tile.hpp"
 #include "Player.hpp"
 #include "LargestArmyCard.hpp"
+#include "GreedyDiscardPolicy.hpp"
 
 namespace catan_game {
     // Constructor to initialize the username
@@ -23,25 +24,20 @@ namespace catan_game {
         this->myResources[TileType::Wool] = 0;
         this->myResources[TileType::Iron] = 0;
         this->myPoints = 0;
+        this->myTradeRates.fill(BANK_TRADE_RATE);
+        this->myExpectedIncome = makeResourceVector(0, 0, 0, 0, 0);
+        this->myRoads.reserve(MAX_ROADS);
+        this->myBuildings.reserve(MAX_SETTLEMENTS + MAX_CITIES); // a city keeps the vertex of its settlement
+        this->myCards.reserve(MAX_HELD_CARDS);
     }
 
-    // Destructor to free the memory
+    // Destructor - the development cards belong to the game, the Largest Army card to the player
     Player::~Player() 
     {
-        for (auto* card : this->myCards) {
-            if(card != nullptr)
-            {
-                if(card->getName() == "Largest Army")
-                {
-                    delete card;
-                    card = nullptr;
-                }
-            }
-        }
     }
 
     // Method to get the player's username
-    std::string Player::getUsername() const 
+    const std::string& Player::getUsername() const 
     {
         return this->username;
     }
@@ -118,6 +114,8 @@ namespace catan_game {
             ver->setSettlement();
             this->myBuildings.push_back(ver);
             this->myPoints += 1;
+            this->myExpectedIncome += ver->getYield();
+            if(ver->getHarbor() != nullptr) applyHarbor(*ver->getHarbor());
             return true;
         }
         else
@@ -130,6 +128,7 @@ namespace catan_game {
                     this->removeResources(TileType::Crop, 2);
                     this->removeResources(TileType::Iron, 3);
                     this->myPoints += 1;
+                    this->myExpectedIncome += ver->getYield(); // the second card of the city
                     return true;
                 }
             }
@@ -145,6 +144,8 @@ namespace catan_game {
                     this->removeResources(TileType::Wool, 1);
                     this->removeResources(TileType::Crop, 1);
                     this->myPoints += 1;
+                    this->myExpectedIncome += ver->getYield();
+                    if(ver->getHarbor() != nullptr) applyHarbor(*ver->getHarbor());
                     return true;
                 }
             }
@@ -152,11 +153,108 @@ namespace catan_game {
         return false;
     }
 
+    void Player::undoRoad(Edge* road)
+    {
+        auto it = std::find(this->myRoads.begin(), this->myRoads.end(), road);
+        if(it == this->myRoads.end()) return;
+        this->myRoads.erase(it);
+        road->setRoad(nullptr);
+    }
+
+    // A city gives back its second card of income, a settlement its vertex - the harbors of
+    // the remaining buildings decide the trade rates again
+    void Player::undoBuilding(Vertex* building, bool isCity)
+    {
+        auto it = std::find(this->myBuildings.begin(), this->myBuildings.end(), building);
+        if(it == this->myBuildings.end()) return;
+
+        this->myPoints -= 1;
+        this->myExpectedIncome -= building->getYield();
+        if(isCity)
+        {
+            building->removeCity();
+            return;
+        }
+
+        this->myBuildings.erase(it);
+        building->removeBuilding();
+        this->myTradeRates.fill(BANK_TRADE_RATE);
+        for(const Vertex* vertex: this->myBuildings)
+        {
+            if(vertex->getHarbor() != nullptr) applyHarbor(*vertex->getHarbor());
+        }
+    }
+
+    void Player::undoDevelopmentCard()
+    {
+        if(this->myCards.empty()) return;
+        if(this->myCards.back()->getName() == "Largest Army")
+        {
+            this->myPoints -= this->myCards.back()->getPoints();
+            this->myCards.pop_back();
+        }
+        if(this->myCards.empty()) return;
+        this->myPoints -= this->myCards.back()->getPoints();
+        this->myCards.pop_back();
+    }
+
     void Player::addResources(TileType type, int amount)
     {
         this->myResources[type] += amount;
     }
 
+    const ResourceVector& Player::getExpectedIncome() const
+    {
+        return this->myExpectedIncome;
+    }
+
+    void Player::addExpectedIncome(const ResourceVector& amounts)
+    {
+        this->myExpectedIncome += amounts;
+    }
+
+    void Player::applyHarbor(const Harbor& harbor)
+    {
+        if(harbor.isGeneric)
+        {
+            for(int& rate: this->myTradeRates)
+            {
+                rate = std::min(rate, GENERIC_HARBOR_RATE);
+            }
+            return;
+        }
+        this->myTradeRates[static_cast<int>(harbor.resource)] = RESOURCE_HARBOR_RATE;
+    }
+
+    int Player::getTradeRate(TileType type) const
+    {
+        return this->myTradeRates[static_cast<int>(type)];
+    }
+
+    const std::array<int, NUM_RESOURCE_TYPES>& Player::getTradeRates() const
+    {
+        return this->myTradeRates;
+    }
+
+    ResourceVector Player::getResourceVector() const
+    {
+        ResourceVector resources = makeResourceVector(0, 0, 0, 0, 0);
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            auto it = this->myResources.find(static_cast<TileType>(type));
+            if(it != this->myResources.end()) resources[type] = it->second;
+        }
+        return resources;
+    }
+
+    void Player::addResources(const ResourceVector& amounts)
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(amounts[type] != 0) this->myResources[static_cast<TileType>(type)] += amounts[type];
+        }
+    }
+
     bool Player::removeResourceForDevCard()
     {
         if(this->hasResourcesForDevelopmentCard())
@@ -183,9 +281,8 @@ namespace catan_game {
             }
 
             if (counter == 3) {
-                LargestArmyCard* largestArmy = new LargestArmyCard(); // Dynamically allocate
-                this->myCards.push_back(largestArmy);
-                this->myPoints += largestArmy->getPoints();
+                this->myCards.push_back(&this->myLargestArmy);
+                this->myPoints += this->myLargestArmy.getPoints();
             }
         }
 
@@ -204,7 +301,6 @@ namespace catan_game {
 
             if (itSpecial != this->myCards.end()) {
                 this->myPoints -= (*itSpecial)->getPoints(); // Deduct points
-                delete *itSpecial; // Free the memory
                 this->myCards.erase(itSpecial); // Remove card from the list
             }
         }
@@ -230,58 +326,20 @@ namespace catan_game {
         }
     }
 
-    void Player::sevenPenalty()
+    // The policy picks the cards, they leave the hand in one vector subtraction.
+    // A choice that doesn't fit the hand is replaced by the greedy one, so the penalty is always paid.
+    ResourceVector Player::sevenPenalty(DiscardPolicy& policy)
     {
-        int numOfResources = this->getNumOfResources();
-        int numOfResourcesToRemove = numOfResources / 2;
-        for(;;)
+        ResourceVector hand = this->getResourceVector();
+        int numOfResourcesToRemove = hand.total() / 2;
+        ResourceVector discard = policy.chooseDiscard(hand, numOfResourcesToRemove);
+        if(!isValidDiscard(hand, discard, numOfResourcesToRemove))
         {
-            if(numOfResourcesToRemove == 0)
-            {
-                break;
-            }
-
-            this->printMyResources();
-            std::cout << "You have " << numOfResourcesToRemove << " resources to remove\n";
-            std::cout << "Enter the resource you want to remove: ";
-            std::string type;
-            std::cin >> type;
-            std::cout << "Enter the amount of resources you want to remove: ";
-            int amount;
-            TileType tileType;
-
-            try{
-                std::cin >> amount;
-                
-                if(type == "Tree"){
-                    tileType = TileType::Tree;
-                }else if(type == "Clay"){
-                    tileType = TileType::Clay;
-                }else if(type == "Crop"){
-                    tileType = TileType::Crop; 
-                }else if(type == "Wool"){
-                    tileType = TileType::Wool;
-                }else if(type == "Iron"){
-                    tileType = TileType::Iron;
-                }else{
-                    throw std::invalid_argument("Invalid resource type");
-                }
-            }
-            catch(const std::invalid_argument& e)
-            {
-                continue;
-            }
-
-            if(this->myResources[tileType] - amount >= 0 && numOfResourcesToRemove - amount >= 0)
-            {
-                this->removeResources(tileType, amount);
-                numOfResourcesToRemove -= amount;
-            }
-            else
-            {
-                std::cout << "You don't have enough resources of this type\n";
-            }
+            GreedyDiscardPolicy greedy;
+            discard = greedy.chooseDiscard(hand, numOfResourcesToRemove);
         }
+        this->addResources(-discard);
+        return discard;
     }
 
     // Method to check if the player has enough resources to build a road
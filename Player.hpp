@@ -4,12 +4,24 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <array>
 #include "Edge.hpp"
 #include "Vertex.hpp"
 #include "Tile.hpp"
 #include "Card.hpp"
+#include "LargestArmyCard.hpp"
+#include "Resources.hpp"
+#include "Harbor.hpp"
+#include "DiscardPolicy.hpp"
 
 namespace catan_game {
+    // The pieces of a player - Game refuses a build past them and the roads and buildings vectors
+    // are reserved for them, so building never allocates during the game
+    constexpr size_t MAX_ROADS = 15;
+    constexpr size_t MAX_SETTLEMENTS = 5;
+    constexpr size_t MAX_CITIES = 4;
+    constexpr size_t MAX_HELD_CARDS = 17; // the 16 development cards of the deck and the Largest Army card
+
     class Edge;
     class Vertex;
     class Tile;
@@ -24,7 +36,13 @@ namespace catan_game {
         std::vector<Vertex*> myBuildings;
         std::unordered_map<TileType, int> myResources;
         std::vector<Card*> myCards;
+        LargestArmyCard myLargestArmy; // in myCards while the player holds it
         int myPoints;
+        std::array<int, NUM_RESOURCE_TYPES> myTradeRates; // bank rate per resource, lowered by harbors
+        ResourceVector myExpectedIncome; // sum of the yields of the buildings, a city counts twice
+
+        // lower the trade rates by the harbor of a new settlement
+        void applyHarbor(const Harbor& harbor);
 
 
 
@@ -36,7 +54,7 @@ namespace catan_game {
         ~Player();
 
         // Method to get the player's username
-        std::string getUsername() const;
+        const std::string& getUsername() const;
 
         // return vector of all player roads
         const std::vector<Edge*>& getMyRoads() const;
@@ -62,9 +80,30 @@ namespace catan_game {
         //add pointer tovector buildings, building is vertex of player
         bool addBuilding(Vertex* building, bool isCity, bool isStartGame);
 
+        //take back the last road or building, the resources are the caller's - used to undo actions
+        void undoRoad(Edge* road);
+        void undoBuilding(Vertex* building, bool isCity);
+
+        //take back the last development card and the largest army card it brought
+        void undoDevelopmentCard();
+
         //add resources to player
         void addResources(TileType type, int amount);
 
+        //resources as one vector (Tree, Clay, Crop, Wool, Iron)
+        ResourceVector getResourceVector() const;
+
+        //add every amount of the vector at once, negative amounts remove - used to settle trades
+        void addResources(const ResourceVector& amounts);
+
+        //how many of the resource the bank takes for one resource - 4, or 3/2 with a harbor
+        int getTradeRate(TileType type) const;
+        const std::array<int, NUM_RESOURCE_TYPES>& getTradeRates() const;
+
+        //expected income per roll in 36ths of a card - kept up to date by the buildings and the robber
+        const ResourceVector& getExpectedIncome() const;
+        void addExpectedIncome(const ResourceVector& amounts);
+
         //add development card to player
         const std::vector<Card*>& addDevelopmentCard(Card* card);
 
@@ -77,8 +116,9 @@ namespace catan_game {
         //remove development card to player
         const std::vector<Card*>& removeDevelopmentCard(Card* card);
         
-        //If player rolled the sum of 7 in the dice, all player with more then 7 resources will lose half of their resources
-        void sevenPenalty();
+        //If player rolled the sum of 7 in the dice, all player with more then 7 resources will lose half of their resources.
+        //The policy chooses which ones, the discarded amounts are returned
+        ResourceVector sevenPenalty(DiscardPolicy& policy);
 
         //roll 2 dices and return the sum of the result
         size_t rollDice();
@@ -0,0 +1,186 @@
+#include <cstring>
+#include <stdexcept>
+#include "PluginAgent.hpp"
+
+namespace catan_game
+{
+    static_assert(CATAN_ACTION_SIZE == ACTION_WIRE_SIZE && CATAN_OP_MOVE_ROBBER == static_cast<int>(ActionOpcode::MoveRobber) &&
+                  CATAN_OP_PLAY_YEAR_OF_PLENTY == static_cast<int>(ActionOpcode::PlayYearOfPlenty) &&
+                  CATAN_OP_PLAY_ROAD_BUILDING == static_cast<int>(ActionOpcode::PlayRoadBuilding) &&
+                  CATAN_PHASE_FINISHED == static_cast<int>(GamePhase::Finished), "The plugin ABI follows the protocol");
+
+    PluginAgent::PluginAgent(std::shared_ptr<const AgentPlugin> agentPlugin) :
+                    plugin(std::move(agentPlugin)),
+                    state(nullptr),
+                    view(),
+                    legalActions(),
+                    offered(),
+                    frames()
+    {
+    }
+
+    PluginAgent::~PluginAgent()
+    {
+        if(this->state != nullptr) api().destroy(this->state);
+    }
+
+    const CatanAgentApi& PluginAgent::api() const
+    {
+        return this->plugin->getApi();
+    }
+
+    static ResourceVector fromBytes(const int8_t* amounts)
+    {
+        return makeResourceVector(amounts[0], amounts[1], amounts[2], amounts[3], amounts[4]);
+    }
+
+    static void toBytes(const ResourceVector& amounts, int8_t* out)
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            out[type] = static_cast<int8_t>(amounts[type]);
+        }
+    }
+
+    void PluginAgent::startGame(const Game& game, size_t seat, unsigned seed)
+    {
+        const Board& board = game.getBoard();
+        size_t numOfCells = static_cast<size_t>(board.getNumOfRows() * board.getNumOfCols());
+        if(game.getNumOfSeats() > CATAN_MAX_SEATS || board.getTiles().size() > CATAN_NUM_TILES || numOfCells > CATAN_NUM_VERTEX_IDS)
+        {
+            throw std::invalid_argument("The game doesn't fit the view of agent plugins");
+        }
+        if(this->state != nullptr) api().destroy(this->state);
+        this->state = api().create(static_cast<uint32_t>(seat), seed);
+    }
+
+    // Everything a seat may know - the hands of the others are public in this engine, like their points
+    void PluginAgent::fillView(const Game& game, size_t seat)
+    {
+        const Board& board = game.getBoard();
+        const std::vector<Player*>& players = game.getPlayers();
+        std::memset(&this->view, 0, sizeof(this->view));
+        this->view.abiVersion = CATAN_AGENT_ABI_VERSION;
+        this->view.viewSize = sizeof(CatanGameView);
+        this->view.numOfSeats = static_cast<uint8_t>(game.getNumOfSeats());
+        this->view.seat = static_cast<uint8_t>(seat);
+        this->view.currentSeat = static_cast<uint8_t>(game.getCurrentSeat());
+        this->view.phase = static_cast<uint8_t>(game.getPhase());
+        this->view.lastRoll = static_cast<int8_t>(game.getLastRoll());
+        this->view.winner = static_cast<int8_t>(game.getWinner());
+        this->view.robberTile = static_cast<uint8_t>(board.getRobberTileIndex());
+
+        for(size_t other = 0; other < players.size(); ++other)
+        {
+            this->view.points[other] = static_cast<int16_t>(players[other]->getMyPoints());
+            ResourceVector hand = players[other]->getResourceVector();
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                this->view.hands[other][type] = static_cast<int16_t>(hand[type]);
+            }
+            this->view.developmentCards[other] = static_cast<int16_t>(players[other]->getMyDevelopmentCards().size());
+        }
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            this->view.tradeRates[type] = static_cast<uint8_t>(players[seat]->getTradeRate(static_cast<TileType>(type)));
+        }
+
+        const std::pmr::vector<Tile*>& tiles = board.getTiles();
+        for(size_t tile = 0; tile < tiles.size(); ++tile)
+        {
+            this->view.tileTypes[tile] = static_cast<uint8_t>(tiles[tile]->getType());
+            this->view.tileNumbers[tile] = tiles[tile]->getType() == TileType::Sand ? 0 : static_cast<uint8_t>(tiles[tile]->getValue());
+        }
+
+        auto seatOf = [&players](const Player* owner) -> uint8_t {
+            for(size_t other = 0; other < players.size(); ++other)
+            {
+                if(players[other] == owner) return static_cast<uint8_t>(other + 1);
+            }
+            return 0;
+        };
+        for(size_t other = 0; other < players.size(); ++other)
+        {
+            for(const Vertex* vertex: players[other]->getMyBuildings())
+            {
+                size_t cell = board.getCell(vertex->getRow(), vertex->getColumn());
+                this->view.vertexOwners[cell] = static_cast<uint8_t>(other + 1);
+                this->view.vertexCities[cell] = vertex->isCity() ? 1 : 0;
+            }
+        }
+        for(const Edge* edge: board.getEdges())
+        {
+            if(edge->getRoadOwner() != nullptr) this->view.roadOwners[board.getEdgeSlot(edge)] = seatOf(edge->getRoadOwner());
+        }
+    }
+
+    // The plugin's pick among the legal frames, a None action when it gives up or nothing is legal
+    Action PluginAgent::chooseLegal(const Game& game, size_t seat, bool placement)
+    {
+        // a plugin of minor version 0 never heard of the road building frame
+        bool knowsRoadBuilding = CATAN_AGENT_ABI_MINOR_OF(api().abiVersion) >= 1;
+        this->offered.clear();
+        for(const Action& action: this->legalActions.collect(game, seat))
+        {
+            if(knowsRoadBuilding || action.opcode != ActionOpcode::PlayRoadBuilding) this->offered.push_back(action);
+        }
+        if(this->offered.empty() || this->state == nullptr) return makeAction(ActionOpcode::None, seat);
+
+        this->frames.resize(this->offered.size() * ACTION_WIRE_SIZE);
+        for(size_t index = 0; index < this->offered.size(); ++index)
+        {
+            encodeAction(this->offered[index], this->frames.data() + index * ACTION_WIRE_SIZE);
+        }
+        fillView(game, seat);
+        auto choose = placement ? api().choosePlacement : api().chooseAction;
+        int32_t chosen = choose(this->state, &this->view, this->frames.data(), static_cast<uint32_t>(this->offered.size()));
+        if(chosen < 0 || static_cast<size_t>(chosen) >= this->offered.size()) return makeAction(ActionOpcode::None, seat);
+        return this->offered[chosen];
+    }
+
+    Action PluginAgent::choosePlacement(const Game& game, size_t seat)
+    {
+        return chooseLegal(game, seat, true);
+    }
+
+    Action PluginAgent::chooseAction(const Game& game, size_t seat)
+    {
+        return chooseLegal(game, seat, false);
+    }
+
+    ResourceVector PluginAgent::chooseDiscard(const Game& game, size_t seat, int numOfCards)
+    {
+        if(api().chooseDiscard == nullptr || this->state == nullptr) return Agent::chooseDiscard(game, seat, numOfCards);
+        fillView(game, seat);
+        int8_t discard[CATAN_NUM_RESOURCES] = {};
+        api().chooseDiscard(this->state, &this->view, numOfCards, discard);
+        return fromBytes(discard);
+    }
+
+    bool PluginAgent::acceptTrade(const Game& game, size_t seat, const TradeOffer& offer)
+    {
+        if(api().acceptTrade == nullptr || this->state == nullptr) return Agent::acceptTrade(game, seat, offer);
+        fillView(game, seat);
+        int8_t give[CATAN_NUM_RESOURCES], want[CATAN_NUM_RESOURCES];
+        toBytes(offer.give, give);
+        toBytes(offer.want, want);
+        return api().acceptTrade(this->state, &this->view, static_cast<uint32_t>(offer.seat), give, want) != 0;
+    }
+
+    TileType PluginAgent::chooseMonopoly(const Game& game, size_t seat)
+    {
+        if(api().chooseMonopoly == nullptr || this->state == nullptr) return Agent::chooseMonopoly(game, seat);
+        fillView(game, seat);
+        int32_t type = api().chooseMonopoly(this->state, &this->view);
+        return type >= 0 && type < NUM_RESOURCE_TYPES ? static_cast<TileType>(type) : Agent::chooseMonopoly(game, seat);
+    }
+
+    ResourceVector PluginAgent::chooseYearOfPlenty(const Game& game, size_t seat)
+    {
+        if(api().chooseYearOfPlenty == nullptr || this->state == nullptr) return Agent::chooseYearOfPlenty(game, seat);
+        fillView(game, seat);
+        int8_t taken[CATAN_NUM_RESOURCES] = {};
+        api().chooseYearOfPlenty(this->state, &this->view, taken);
+        return fromBytes(taken);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef PLUGINAGENT_HPP
+#define PLUGINAGENT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Agent.hpp"
+#include "AgentPlugin.hpp"
+#include "AgentPluginApi.h"
+#include "LegalActionList.hpp"
+
+namespace catan_game
+{
+    // Plays a seat through the C callbacks of a plugin - the game is handed over as a CatanGameView and
+    // the plugin picks from the frames of the legal actions. Callbacks the plugin leaves null fall back
+    // to the Agent defaults. Only the standard board fits the view.
+    class PluginAgent : public Agent {
+    private:
+        std::shared_ptr<const AgentPlugin> plugin;
+        void* state;  // the plugin's agent, made by create for the game
+        CatanGameView view;
+        LegalActionList legalActions;
+        std::vector<Action> offered; // the legal actions the plugin's version knows, in the frames' order
+        std::vector<uint8_t> frames;
+
+        const CatanAgentApi& api() const;
+        void fillView(const Game& game, size_t seat);
+        Action chooseLegal(const Game& game, size_t seat, bool placement);
+
+    public:
+        explicit PluginAgent(std::shared_ptr<const AgentPlugin> agentPlugin);
+        ~PluginAgent() override;
+        PluginAgent(const PluginAgent&) = delete;
+        PluginAgent& operator=(const PluginAgent&) = delete;
+
+        // Throws std::invalid_argument for a board the view can't hold
+        void startGame(const Game& game, size_t seat, unsigned seed) override;
+        Action choosePlacement(const Game& game, size_t seat) override;
+        Action chooseAction(const Game& game, size_t seat) override;
+        ResourceVector chooseDiscard(const Game& game, size_t seat, int numOfCards) override;
+        bool acceptTrade(const Game& game, size_t seat, const TradeOffer& offer) override;
+        TileType chooseMonopoly(const Game& game, size_t seat) override;
+        ResourceVector chooseYearOfPlenty(const Game& game, size_t seat) override;
+    };
+}
+#endif
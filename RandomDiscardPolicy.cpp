@@ -0,0 +1,22 @@
+#include "RandomDiscardPolicy.hpp"
+
+namespace catan_game
+{
+
+    RandomDiscardPolicy::RandomDiscardPolicy(unsigned seed) : rng(seed) {}
+
+    // Every card is drawn from what is left of the hand
+    ResourceVector RandomDiscardPolicy::chooseDiscard(const ResourceVector& hand, int numOfCards)
+    {
+        ResourceVector left = hand;
+        ResourceVector discard = makeResourceVector(0, 0, 0, 0, 0);
+        for(int card = 0; card < numOfCards && left.total() > 0; ++card)
+        {
+            std::uniform_int_distribution<int> draw(0, left.total() - 1);
+            int type = resourceOfCard(left, draw(this->rng));
+            --left[type];
+            ++discard[type];
+        }
+        return discard;
+    }
+}
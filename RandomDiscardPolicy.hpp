@@ -0,0 +1,17 @@
+#ifndef RANDOMDISCARDPOLICY_HPP
+#define RANDOMDISCARDPOLICY_HPP
+
+#include <random>
+#include "DiscardPolicy.hpp"
+
+namespace catan_game
+{
+    // Gives back uniform random cards of the hand, reproducible from the seed
+    class RandomDiscardPolicy : public DiscardPolicy {
+        std::mt19937 rng;
+    public:
+        explicit RandomDiscardPolicy(unsigned seed);
+        ResourceVector chooseDiscard(const ResourceVector& hand, int numOfCards) override;
+    };
+}
+#endif
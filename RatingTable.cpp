@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cmath>
+#include "RatingTable.hpp"
+
+namespace catan_game {
+
+    constexpr int FIT_ITERATIONS = 200;
+    constexpr double FIT_TOLERANCE = 1e-9;
+    constexpr double ELO_PER_NATURAL_LOG = 400.0 / 2.302585092994046; // 400 / ln 10
+    constexpr double CONFIDENCE_Z = 1.96;
+
+    RatingTable::RatingTable(size_t entrants) :
+                    numOfEntrants(entrants),
+                    pairWins(entrants * entrants, 0.0),
+                    numOfGames(entrants, 0),
+                    numOfWins(entrants, 0),
+                    totalGames(0)
+    {
+    }
+
+    void RatingTable::addGame(std::span<const size_t> seatEntrants, int winnerSeat, int forfeitSeat)
+    {
+        for(size_t seat = 0; seat < seatEntrants.size(); ++seat)
+        {
+            ++this->numOfGames[seatEntrants[seat]];
+            for(size_t other = 0; other < seatEntrants.size(); ++other)
+            {
+                if(other == seat || seatEntrants[other] == seatEntrants[seat]) continue;
+                double share = 0.5;
+                if(winnerSeat >= 0) share = (static_cast<int>(seat) == winnerSeat) ? 1.0 : 0.0;
+                else if(static_cast<int>(seat) == forfeitSeat) share = 0.0;
+                else if(static_cast<int>(other) == forfeitSeat) share = 1.0;
+                this->pairWins[seatEntrants[seat] * this->numOfEntrants + seatEntrants[other]] += share;
+            }
+        }
+        if(winnerSeat >= 0) ++this->numOfWins[seatEntrants[winnerSeat]];
+        ++this->totalGames;
+    }
+
+    size_t RatingTable::getNumOfEntrants() const
+    {
+        return this->numOfEntrants;
+    }
+
+    size_t RatingTable::getTotalGames() const
+    {
+        return this->totalGames;
+    }
+
+    // Minorization-maximization of the Bradley-Terry strengths: strength_i = wins_i / sum_j games_ij / (strength_i + strength_j),
+    // scaled to a geometric mean of 1 after every step. The margin comes from the curvature of the fit at its optimum.
+    std::vector<EntrantRating> RatingTable::compute() const
+    {
+        size_t entrants = this->numOfEntrants;
+        std::vector<double> strength(entrants, 1.0);
+        std::vector<double> next(entrants, 1.0);
+        for(int iteration = 0; iteration < FIT_ITERATIONS; ++iteration)
+        {
+            double change = 0, logSum = 0;
+            for(size_t entrant = 0; entrant < entrants; ++entrant)
+            {
+                double wins = 1.0; // the virtual win, its loss is in the denominator
+                double denominator = 2.0 / (strength[entrant] + 1.0);
+                for(size_t other = 0; other < entrants; ++other)
+                {
+                    double games = this->pairWins[entrant * entrants + other] + this->pairWins[other * entrants + entrant];
+                    wins += this->pairWins[entrant * entrants + other];
+                    if(games > 0) denominator += games / (strength[entrant] + strength[other]);
+                }
+                next[entrant] = wins / denominator;
+                logSum += std::log(next[entrant]);
+            }
+            double scale = std::exp(-logSum / static_cast<double>(entrants));
+            for(size_t entrant = 0; entrant < entrants; ++entrant)
+            {
+                next[entrant] *= scale;
+                change = std::max(change, std::fabs(std::log(next[entrant] / strength[entrant])));
+            }
+            strength.swap(next);
+            if(change < FIT_TOLERANCE) break;
+        }
+
+        std::vector<EntrantRating> ratings(entrants);
+        for(size_t entrant = 0; entrant < entrants; ++entrant)
+        {
+            double information = 2.0 * strength[entrant] / ((strength[entrant] + 1.0) * (strength[entrant] + 1.0));
+            for(size_t other = 0; other < entrants; ++other)
+            {
+                double games = this->pairWins[entrant * entrants + other] + this->pairWins[other * entrants + entrant];
+                double sum = strength[entrant] + strength[other];
+                if(games > 0) information += games * strength[entrant] * strength[other] / (sum * sum);
+            }
+            ratings[entrant] = {ELO_PER_NATURAL_LOG * std::log(strength[entrant]),
+                                CONFIDENCE_Z * ELO_PER_NATURAL_LOG / std::sqrt(information),
+                                this->numOfGames[entrant], this->numOfWins[entrant]};
+        }
+        return ratings;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef RATINGTABLE_HPP
+#define RATINGTABLE_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace catan_game {
+
+    struct EntrantRating {
+        double elo;     // the average entrant is 0
+        double margin;  // half the 95% confidence interval, in Elo points
+        size_t games;
+        size_t wins;
+    };
+
+    // Ratings of the entrants of a tournament from the games they played. A game of many seats counts as
+    // its winner beating each other seat, a forfeit as the seat that gave up losing to each other seat (who
+    // draw among themselves) and a game the turn limit stopped as a draw between every pair. The ratings are
+    // the Bradley-Terry fit of all the pairs on the Elo scale, so they don't depend on the order the games
+    // finished in. Every entrant starts with a virtual win and loss against the average, which keeps
+    // an entrant that won all or none of its games finite.
+    class RatingTable {
+    private:
+        size_t numOfEntrants;
+        std::vector<double> pairWins;   // [winner * entrants + loser], a draw is half a win each way
+        std::vector<size_t> numOfGames;
+        std::vector<size_t> numOfWins;
+        size_t totalGames;
+
+    public:
+        explicit RatingTable(size_t entrants);
+
+        // One game - seatEntrants[seat] is the entrant of the seat, winnerSeat -1 when nobody won and
+        // forfeitSeat the seat whose agent gave up the game, -1 when none did
+        void addGame(std::span<const size_t> seatEntrants, int winnerSeat, int forfeitSeat = -1);
+
+        size_t getNumOfEntrants() const;
+        size_t getTotalGames() const;
+
+        // ratings[i] rates entrant i
+        std::vector<EntrantRating> compute() const;
+    };
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "Resources.hpp"
+#include "Tile.hpp"
+
+namespace catan_game {
+
+    int& ResourceVector::operator[](TileType type)
+    {
+        return this->amounts[static_cast<int>(type)];
+    }
+
+    int ResourceVector::operator[](TileType type) const
+    {
+        return this->amounts[static_cast<int>(type)];
+    }
+
+    int& ResourceVector::operator[](int type)
+    {
+        return this->amounts[type];
+    }
+
+    int ResourceVector::operator[](int type) const
+    {
+        return this->amounts[type];
+    }
+
+    int ResourceVector::total() const
+    {
+        int sum = 0;
+        for(int amount: this->amounts)
+        {
+            sum += amount;
+        }
+        return sum;
+    }
+
+    bool ResourceVector::covers(const ResourceVector& other) const
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(this->amounts[type] < other.amounts[type]) return false;
+        }
+        return true;
+    }
+
+    bool ResourceVector::isNonNegative() const
+    {
+        for(int amount: this->amounts)
+        {
+            if(amount < 0) return false;
+        }
+        return true;
+    }
+
+    bool ResourceVector::isZero() const
+    {
+        for(int amount: this->amounts)
+        {
+            if(amount != 0) return false;
+        }
+        return true;
+    }
+
+    ResourceVector& ResourceVector::operator+=(const ResourceVector& other)
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            this->amounts[type] += other.amounts[type];
+        }
+        return *this;
+    }
+
+    ResourceVector& ResourceVector::operator-=(const ResourceVector& other)
+    {
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            this->amounts[type] -= other.amounts[type];
+        }
+        return *this;
+    }
+
+    ResourceVector ResourceVector::operator+(const ResourceVector& other) const
+    {
+        ResourceVector result = *this;
+        result += other;
+        return result;
+    }
+
+    ResourceVector ResourceVector::operator-(const ResourceVector& other) const
+    {
+        ResourceVector result = *this;
+        result -= other;
+        return result;
+    }
+
+    ResourceVector ResourceVector::operator-() const
+    {
+        ResourceVector result = *this;
+        for(int& amount: result.amounts)
+        {
+            amount = -amount;
+        }
+        return result;
+    }
+
+    bool ResourceVector::operator==(const ResourceVector& other) const
+    {
+        return this->amounts == other.amounts;
+    }
+
+    bool ResourceVector::operator!=(const ResourceVector& other) const
+    {
+        return !(*this == other);
+    }
+
+    ResourceVector makeResourceVector(int tree, int clay, int crop, int wool, int iron)
+    {
+        return ResourceVector{{tree, clay, crop, wool, iron}};
+    }
+
+    bool isValidDiscard(const ResourceVector& hand, const ResourceVector& discard, int numOfCards)
+    {
+        return discard.isNonNegative() && hand.covers(discard) && discard.total() == numOfCards;
+    }
+
+    int resourceOfCard(const ResourceVector& hand, int card)
+    {
+        if(card < 0) return -1;
+        for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+        {
+            if(card < hand[type]) return type;
+            card -= hand[type];
+        }
+        return -1;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef RESOURCES_HPP
+#define RESOURCES_HPP
+
+#include <array>
+
+namespace catan_game {
+    enum class TileType;
+
+    constexpr int NUM_RESOURCE_TYPES = 5;
+
+    // Amount of every resource (Tree, Clay, Crop, Wool, Iron - the TileType order).
+    // Used for costs, discards and trades so a whole exchange is one vector operation.
+    struct ResourceVector {
+        std::array<int, NUM_RESOURCE_TYPES> amounts;
+
+        int& operator[](TileType type);
+        int operator[](TileType type) const;
+        int& operator[](int type);
+        int operator[](int type) const;
+
+        // sum of all the amounts
+        int total() const;
+
+        // true when every amount is at least the other one's
+        bool covers(const ResourceVector& other) const;
+
+        bool isNonNegative() const;
+        bool isZero() const;
+
+        ResourceVector& operator+=(const ResourceVector& other);
+        ResourceVector& operator-=(const ResourceVector& other);
+        ResourceVector operator+(const ResourceVector& other) const;
+        ResourceVector operator-(const ResourceVector& other) const;
+        ResourceVector operator-() const;
+        bool operator==(const ResourceVector& other) const;
+        bool operator!=(const ResourceVector& other) const;
+    };
+
+    ResourceVector makeResourceVector(int tree, int clay, int crop, int wool, int iron);
+
+    // true when the discard takes exactly numOfCards cards the hand holds - a constant time check
+    bool isValidDiscard(const ResourceVector& hand, const ResourceVector& discard, int numOfCards);
+
+    // Type of the card-th resource (0 based) when the hand is laid out type by type, -1 past the end.
+    // A uniform card in [0, total) is a uniform random resource of the hand - used by the robber.
+    int resourceOfCard(const ResourceVector& hand, int card);
+}
+
+#endif
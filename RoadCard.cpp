@@ -9,7 +9,7 @@ namespace catan_game
     }
 
 
-    std::string RoadCard::getName() const {
+    std::string_view RoadCard::getName() const {
         return "Road Building";
     }
     int RoadCard::getPoints() const
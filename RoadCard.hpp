@@ -11,7 +11,7 @@ namespace catan_game
         int points;
     public:
         RoadCard();
-        std::string getName() const override;
+        std::string_view getName() const override;
         int getPoints() const override;
     };
 }
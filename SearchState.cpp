@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <unordered_map>
+#include "SearchState.hpp"
+
+namespace catan_game {
+
+    // The prices of Player::hasResourcesFor... as vectors (Tree, Clay, Crop, Wool, Iron)
+    static const ResourceVector ROAD_COST = makeResourceVector(1, 1, 0, 0, 0);
+    static const ResourceVector SETTLEMENT_COST = makeResourceVector(1, 1, 1, 1, 0);
+    static const ResourceVector CITY_COST = makeResourceVector(0, 0, 2, 0, 3);
+
+    constexpr double POINT_SCORE = 1000.0;
+    constexpr double INCOME_SCORE = 10.0; // per dice way of expected income
+    constexpr double CARD_SCORE = 1.0;
+
+    enum PieceIndex { ROADS, SETTLEMENTS, CITIES };
+
+    SearchState SearchState::fromGame(const Game& game)
+    {
+        const Board& board = game.getBoard();
+        const std::vector<Player*>& players = game.getPlayers();
+        auto topology = std::make_shared<SearchTopology>();
+        topology->vertexOfId.assign(NUM_MATRIX_ROWS * NUM_MATRIX_COLS, -1);
+        topology->edgeOfId.assign(2 * NUM_MATRIX_ROWS * NUM_MATRIX_COLS, -1);
+
+        std::unordered_map<const Vertex*, int> vertexIndex;
+        std::unordered_map<const Player*, int> seatOf;
+        for(size_t seat = 0; seat < players.size(); ++seat)
+        {
+            seatOf[players[seat]] = static_cast<int>(seat);
+        }
+
+        SearchState state;
+        for(int row = 0; row < board.getNumOfRows(); ++row)
+        {
+            for(int col = 0; col < board.getNumOfCols(); ++col)
+            {
+                const Vertex* vertex = board.getVertex(row, col);
+                if(vertex == nullptr) continue;
+                int index = static_cast<int>(topology->vertexIds.size());
+                vertexIndex[vertex] = index;
+                topology->vertexIds.push_back(encodeVertex(row, col));
+                topology->vertexYields.push_back(vertex->getYield());
+                const Harbor* harbor = vertex->getHarbor();
+                topology->vertexHarbors.push_back(harbor == nullptr ? -1 : harbor->isGeneric ? NUM_RESOURCE_TYPES : static_cast<int>(harbor->resource));
+                if(topology->vertexIds.back() >= 0) topology->vertexOfId[topology->vertexIds.back()] = index;
+                state.vertexOwners.push_back(vertex->getOwner() ? static_cast<int8_t>(seatOf[vertex->getOwner()]) : -1);
+                state.vertexCities.push_back(vertex->isCity());
+            }
+        }
+        topology->vertexNeighbors.resize(topology->vertexIds.size());
+        topology->vertexEdges.resize(topology->vertexIds.size());
+
+        for(const Edge* edge: board.getEdges())
+        {
+            int index = static_cast<int>(topology->edgeIds.size());
+            const Vertex* first = edge->getVertices().first;
+            const Vertex* second = edge->getVertices().second;
+            int from = vertexIndex[first], to = vertexIndex[second];
+            topology->edgeIds.push_back(encodeEdge(first->getRow(), first->getColumn(), second->getRow(), second->getColumn()));
+            topology->edgeEnds.push_back({from, to});
+            if(topology->edgeIds.back() >= 0) topology->edgeOfId[topology->edgeIds.back()] = index;
+            topology->vertexNeighbors[from].push_back(to);
+            topology->vertexNeighbors[to].push_back(from);
+            topology->vertexEdges[from].push_back(index);
+            topology->vertexEdges[to].push_back(index);
+            state.edgeOwners.push_back(edge->getRoadOwner() ? static_cast<int8_t>(seatOf[edge->getRoadOwner()]) : -1);
+        }
+
+        for(const Tile* tile: board.getTiles())
+        {
+            int index = static_cast<int>(topology->tileTypes.size());
+            topology->tileTypes.push_back(tile->getType());
+            topology->tileVertices.emplace_back();
+            for(const Vertex* vertex: tile->getVertices())
+            {
+                topology->tileVertices.back().push_back(vertexIndex[vertex]);
+            }
+            for(int roll = MIN_DICE_ROLL; roll <= MAX_DICE_ROLL; ++roll)
+            {
+                const std::pmr::vector<Tile*>& producing = board.getProducingTiles(roll);
+                if(std::find(producing.begin(), producing.end(), tile) != producing.end()) topology->rollTiles[roll].push_back(index);
+            }
+        }
+
+        for(const Player* player: players)
+        {
+            state.hands.push_back(player->getResourceVector());
+            state.points.push_back(player->getMyPoints());
+            state.tradeRates.push_back(player->getTradeRates());
+            std::array<size_t, 3> pieces = {player->getMyRoads().size(), 0, 0};
+            for(const Vertex* vertex: player->getMyBuildings())
+            {
+                ++pieces[vertex->isCity() ? CITIES : SETTLEMENTS];
+            }
+            state.pieces.push_back(pieces);
+        }
+        state.topology = topology;
+        state.currentSeat = game.getCurrentSeat();
+        state.hasRolled = game.getPhase() != GamePhase::Roll;
+        state.winner = game.getWinner();
+        return state;
+    }
+
+    size_t SearchState::getNumOfSeats() const
+    {
+        return this->hands.size();
+    }
+
+    size_t SearchState::getCurrentSeat() const
+    {
+        return this->currentSeat;
+    }
+
+    int SearchState::getWinner() const
+    {
+        return this->winner;
+    }
+
+    int SearchState::getPoints(size_t seat) const
+    {
+        return this->points[seat];
+    }
+
+    const ResourceVector& SearchState::getHand(size_t seat) const
+    {
+        return this->hands[seat];
+    }
+
+    bool SearchState::isChanceNode() const
+    {
+        return this->winner < 0 && !this->hasRolled;
+    }
+
+    // Like Board::canPlaceSettlement - free and no neighbour settled, the seat's roads don't have to reach it
+    bool SearchState::canSettle(int vertex) const
+    {
+        if(this->vertexOwners[vertex] >= 0) return false;
+        for(int neighbor: this->topology->vertexNeighbors[vertex])
+        {
+            if(this->vertexOwners[neighbor] >= 0) return false;
+        }
+        return true;
+    }
+
+    // Like Board::canPlaceRoad - free and touching a building or a road of the seat
+    bool SearchState::canRoad(size_t seat, int edge) const
+    {
+        if(this->edgeOwners[edge] >= 0) return false;
+        for(int vertex: this->topology->edgeEnds[edge])
+        {
+            if(this->vertexOwners[vertex] == static_cast<int8_t>(seat)) return true;
+            if(this->vertexOwners[vertex] >= 0) continue; // an opponent's settlement cuts the road
+            for(int other: this->topology->vertexEdges[vertex])
+            {
+                if(this->edgeOwners[other] == static_cast<int8_t>(seat)) return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Action> SearchState::legalMoves() const
+    {
+        std::vector<Action> moves;
+        if(this->winner >= 0) return moves;
+
+        size_t seat = this->currentSeat;
+        if(!this->hasRolled)
+        {
+            moves.push_back(makeAction(ActionOpcode::RollDice, seat));
+            return moves;
+        }
+
+        const ResourceVector& hand = this->hands[seat];
+        const SearchTopology& board = *this->topology;
+        const std::array<size_t, 3>& pieces = this->pieces[seat];
+        bool canBuildCity = hand.covers(CITY_COST) && pieces[CITIES] < MAX_CITIES;
+        bool canBuildSettlement = hand.covers(SETTLEMENT_COST) && pieces[SETTLEMENTS] < MAX_SETTLEMENTS;
+        for(size_t vertex = 0; vertex < board.vertexIds.size(); ++vertex)
+        {
+            if(canBuildCity && this->vertexOwners[vertex] == static_cast<int8_t>(seat) && !this->vertexCities[vertex])
+            {
+                moves.push_back(makeAction(ActionOpcode::BuildCity, seat, board.vertexIds[vertex]));
+            }
+            if(canBuildSettlement && canSettle(static_cast<int>(vertex)))
+            {
+                moves.push_back(makeAction(ActionOpcode::BuildSettlement, seat, board.vertexIds[vertex]));
+            }
+        }
+        if(hand.covers(ROAD_COST) && pieces[ROADS] < MAX_ROADS)
+        {
+            for(size_t edge = 0; edge < board.edgeIds.size(); ++edge)
+            {
+                if(canRoad(seat, static_cast<int>(edge))) moves.push_back(makeAction(ActionOpcode::BuildRoad, seat, board.edgeIds[edge]));
+            }
+        }
+        for(int give = 0; give < NUM_RESOURCE_TYPES; ++give)
+        {
+            if(hand[give] < this->tradeRates[seat][give]) continue;
+            for(int want = 0; want < NUM_RESOURCE_TYPES; ++want)
+            {
+                if(want == give) continue;
+                Action trade = makeAction(ActionOpcode::BankTrade, seat);
+                trade.resources[give] = this->tradeRates[seat][give];
+                trade.resources[want] = -1;
+                moves.push_back(trade);
+            }
+        }
+        moves.push_back(makeAction(ActionOpcode::EndTurn, seat));
+        return moves;
+    }
+
+    // Like Player::applyHarbor - a generic harbor gives 3:1 on everything, a resource harbor 2:1 on its resource
+    static void lowerTradeRates(std::array<int, NUM_RESOURCE_TYPES>& rates, int harbor)
+    {
+        if(harbor < 0) return;
+        if(harbor == NUM_RESOURCE_TYPES)
+        {
+            for(int& rate: rates) rate = std::min(rate, GENERIC_HARBOR_RATE);
+            return;
+        }
+        rates[harbor] = RESOURCE_HARBOR_RATE;
+    }
+
+    void SearchState::checkWinner(size_t seat)
+    {
+        if(this->points[seat] >= WINNING_POINTS) this->winner = static_cast<int>(seat);
+    }
+
+    void SearchState::apply(const Action& move)
+    {
+        size_t seat = this->currentSeat;
+        ResourceVector& hand = this->hands[seat];
+        switch(move.opcode)
+        {
+            case ActionOpcode::BuildSettlement:
+            {
+                int vertex = this->topology->vertexOfId[move.target];
+                this->vertexOwners[vertex] = static_cast<int8_t>(seat);
+                hand -= SETTLEMENT_COST;
+                ++this->pieces[seat][SETTLEMENTS];
+                lowerTradeRates(this->tradeRates[seat], this->topology->vertexHarbors[vertex]);
+                ++this->points[seat];
+                checkWinner(seat);
+                break;
+            }
+            case ActionOpcode::BuildCity:
+                this->vertexCities[this->topology->vertexOfId[move.target]] = true;
+                hand -= CITY_COST;
+                --this->pieces[seat][SETTLEMENTS];
+                ++this->pieces[seat][CITIES];
+                ++this->points[seat];
+                checkWinner(seat);
+                break;
+            case ActionOpcode::BuildRoad:
+                this->edgeOwners[this->topology->edgeOfId[move.target]] = static_cast<int8_t>(seat);
+                hand -= ROAD_COST;
+                ++this->pieces[seat][ROADS];
+                break;
+            case ActionOpcode::BankTrade:
+                hand -= move.resources; // the given amounts are positive, the wanted one negative
+                break;
+            case ActionOpcode::EndTurn:
+                this->currentSeat = (seat + 1) % this->hands.size();
+                this->hasRolled = false;
+                break;
+            default:
+                break;
+        }
+    }
+
+    void SearchState::applyRoll(int diceRoll)
+    {
+        this->hasRolled = true;
+        if(diceRoll < MIN_DICE_ROLL || diceRoll > MAX_DICE_ROLL) return;
+        for(int tile: this->topology->rollTiles[diceRoll])
+        {
+            TileType type = this->topology->tileTypes[tile];
+            for(int vertex: this->topology->tileVertices[tile])
+            {
+                int8_t owner = this->vertexOwners[vertex];
+                if(owner >= 0) this->hands[owner][type] += this->vertexCities[vertex] ? 2 : 1;
+            }
+        }
+    }
+
+    double SearchState::evaluate(size_t seat) const
+    {
+        int income = 0;
+        for(size_t vertex = 0; vertex < this->vertexOwners.size(); ++vertex)
+        {
+            if(this->vertexOwners[vertex] != static_cast<int8_t>(seat)) continue;
+            income += this->topology->vertexYields[vertex].total() * (this->vertexCities[vertex] ? 2 : 1);
+        }
+        return POINT_SCORE * this->points[seat] + INCOME_SCORE * income + CARD_SCORE * this->hands[seat].total();
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SEARCHSTATE_HPP
+#define SEARCHSTATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Action.hpp"
+#include "Game.hpp"
+#include "Resources.hpp"
+
+namespace catan_game {
+
+    // The fixed part of a board - adjacency, tiles and yields by dense index, shared by every copy of a state
+    struct SearchTopology {
+        std::vector<int> vertexIds;                   // protocol vertex id of every dense vertex
+        std::vector<std::vector<int>> vertexNeighbors;
+        std::vector<std::vector<int>> vertexEdges;
+        std::vector<ResourceVector> vertexYields;     // dice ways out of 36, as on the board when copied
+        std::vector<int> vertexHarbors;               // resource of the vertex's harbor, NUM_RESOURCE_TYPES when generic, -1 none
+        std::vector<int> edgeIds;                     // protocol edge id of every dense edge
+        std::vector<std::array<int, 2>> edgeEnds;
+        std::array<std::vector<int>, MAX_DICE_ROLL + 1> rollTiles; // tiles producing on every roll, without the robber's
+        std::vector<TileType> tileTypes;
+        std::vector<std::vector<int>> tileVertices;
+        std::vector<int> vertexOfId;                  // protocol id to dense index, -1 when not a vertex
+        std::vector<int> edgeOfId;
+    };
+
+    // Copyable value snapshot of a game in its turns, for searches that try moves without touching the game.
+    // Moves are the engine's Actions: roll, end turn, the three builds and bank trades at the seat's rates,
+    // legal exactly when Game::validate takes them - the same placement rules, piece limits and harbors.
+    // A roll of 7 collects nothing - the robber, discards, development cards and player trades are not modelled.
+    class SearchState {
+    private:
+        std::shared_ptr<const SearchTopology> topology;
+        std::vector<int8_t> vertexOwners; // seat, -1 free
+        std::vector<bool> vertexCities;
+        std::vector<int8_t> edgeOwners;
+        std::vector<ResourceVector> hands;
+        std::vector<int> points;
+        std::vector<std::array<size_t, 3>> pieces; // roads, settlements and cities on the board, by seat
+        std::vector<std::array<int, NUM_RESOURCE_TYPES>> tradeRates;
+        size_t currentSeat;
+        bool hasRolled;
+        int winner;
+
+        bool canSettle(int vertex) const;
+        bool canRoad(size_t seat, int edge) const;
+        void checkWinner(size_t seat);
+
+    public:
+        static constexpr int WINNING_POINTS = Game::WINNING_POINTS;
+
+        // Snapshot of a game in its Roll or Main phase
+        static SearchState fromGame(const Game& game);
+
+        size_t getNumOfSeats() const;
+        size_t getCurrentSeat() const;
+        int getWinner() const;
+        int getPoints(size_t seat) const;
+        const ResourceVector& getHand(size_t seat) const;
+
+        // true while the current seat has to roll - the node is a chance node of the dice
+        bool isChanceNode() const;
+
+        // Every move of the current seat, empty once somebody won
+        std::vector<Action> legalMoves() const;
+
+        // Play a legal move of the current seat, the roll is given as its dice sum
+        void apply(const Action& move);
+        void applyRoll(int diceRoll);
+
+        // Cheap score of the seat - points first, then the expected income and the hand
+        double evaluate(size_t seat) const;
+    };
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "SimulationRunner.hpp"
+#include "Action.hpp"
+#include "LadderAgent.hpp"
+
+namespace catan_game {
+
+    // Every seat at the end of the turn
+    static void addTurnRows(const Game& game, unsigned seed, size_t turn, int roll, std::vector<TurnStatsRow>& rows)
+    {
+        const std::vector<Player*>& players = game.getPlayers();
+        for(size_t seat = 0; seat < players.size(); ++seat)
+        {
+            const Player* player = players[seat];
+            TurnStatsRow row{};
+            row.seed = seed;
+            row.turn = static_cast<uint16_t>(turn);
+            row.seat = static_cast<uint8_t>(seat);
+            row.roll = static_cast<uint8_t>(roll);
+            row.points = static_cast<uint8_t>(player->getMyPoints());
+            ResourceVector hand = player->getResourceVector();
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                row.resources[type] = static_cast<uint16_t>(hand[type]);
+            }
+            for(const Vertex* vertex: player->getMyBuildings())
+            {
+                if(vertex->isCity()) ++row.cities;
+                else ++row.settlements;
+            }
+            row.roads = static_cast<uint8_t>(player->getMyRoads().size());
+            row.developmentCards = static_cast<uint8_t>(player->getMyDevelopmentCards().size());
+            rows.push_back(row);
+        }
+    }
+
+    SimulationRunner::SimulationRunner(size_t seats, size_t turnLimit, std::vector<AgentFactory> seatBots) :
+                    numOfSeats(seats),
+                    maxTurns(turnLimit),
+                    bots(std::move(seatBots))
+    {
+    }
+
+    SimulatedGame SimulationRunner::play(unsigned seed) const
+    {
+        std::vector<std::unique_ptr<Agent>> agents;
+        std::vector<Agent*> seats;
+        for(size_t seat = 0; seat < this->numOfSeats; ++seat)
+        {
+            agents.push_back(this->bots.empty() ? makeBuiltinAgent("builder") : this->bots[seat % this->bots.size()].makeAgent());
+            seats.push_back(agents.back().get());
+        }
+        return play(seed, seats);
+    }
+
+    SimulatedGame SimulationRunner::play(unsigned seed, std::span<Agent* const> agents) const
+    {
+        if(agents.size() != this->numOfSeats)
+        {
+            throw std::invalid_argument("Every seat needs an agent");
+        }
+        std::vector<std::string> names;
+        for(size_t seat = 0; seat < this->numOfSeats; ++seat)
+        {
+            names.push_back("Bot " + std::to_string(seat + 1));
+        }
+        Game game(names, seed);
+        for(size_t seat = 0; seat < this->numOfSeats; ++seat)
+        {
+            agents[seat]->startGame(game, seat, seed);
+        }
+
+        SimulatedGame result{seed, -1, -1, {}};
+        result.turnHashes.reserve(this->maxTurns + 1);
+        result.turnRows.reserve((this->maxTurns + 1) * this->numOfSeats);
+        UndoRecord record;
+        int turnRoll = 0; // 0 until the current seat rolls - a seat may end its turn without rolling
+        while(game.getPhase() != GamePhase::Finished && result.turnHashes.size() < this->maxTurns)
+        {
+            // the seats answer a 7 with Discard actions, so the discards are in the action stream too
+            size_t seat = game.getCurrentSeat();
+            while(game.getPhase() == GamePhase::Discard && game.getPendingDiscard(seat) == 0) seat = (seat + 1) % this->numOfSeats;
+            Action action = agents[seat]->decide(game, seat);
+            if(action.opcode == ActionOpcode::None || game.apply(action, record) != ActionStatus::Ok)
+            {
+                result.forfeitSeat = static_cast<int>(seat);
+                break;
+            }
+            if(action.opcode == ActionOpcode::RollDice)
+            {
+                turnRoll = game.getLastRoll();
+                action.target = static_cast<uint16_t>(turnRoll);
+            }
+            result.actions.push_back(action);
+            if(action.opcode == ActionOpcode::PostTrade)
+            {
+                // an offer that didn't fill at once rests in the book, the other seats answer it now
+                const TradeOffer* offer = game.getTradeBook().find(game.getTradeBook().getNextOfferId() - 1);
+                int taker = offer == nullptr ? -1 : findTradeTaker(game, *offer, agents);
+                Action accept = makeAction(ActionOpcode::AcceptTrade, taker, taker >= 0 ? offer->id : 0);
+                if(taker >= 0 && game.apply(accept, record) == ActionStatus::Ok) result.actions.push_back(accept);
+            }
+            if(action.opcode == ActionOpcode::EndTurn)
+            {
+                addTurnRows(game, seed, result.turnHashes.size(), turnRoll, result.turnRows);
+                result.turnHashes.push_back(game.stateHash());
+                turnRoll = 0;
+            }
+        }
+        if(game.getPhase() == GamePhase::Finished)
+        {
+            addTurnRows(game, seed, result.turnHashes.size(), turnRoll, result.turnRows);
+            result.turnHashes.push_back(game.stateHash()); // the winning turn
+        }
+        result.winner = game.getWinner();
+        for(const Player* player: game.getPlayers())
+        {
+            result.points.push_back(player->getMyPoints());
+        }
+        return result;
+    }
+
+    std::vector<SimulatedGame> SimulationRunner::playAll(std::span<const unsigned> seeds, unsigned numOfThreads,
+                                                         GameArchiveWriter* archive, TurnStatsWriter* turnStats) const
+    {
+        if(numOfThreads == 0) numOfThreads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<SimulatedGame> games(seeds.size());
+        std::atomic<size_t> nextGame{0};
+        auto worker = [this, &seeds, &games, &nextGame, archive, turnStats]() {
+            for(size_t index = nextGame++; index < seeds.size(); index = nextGame++)
+            {
+                games[index] = play(seeds[index]);
+                if(archive != nullptr)
+                {
+                    archive->append(toArchived(games[index]), games[index].actions);
+                    games[index].actions = std::vector<Action>();
+                }
+                if(turnStats != nullptr)
+                {
+                    turnStats->append(games[index].turnRows);
+                    games[index].turnRows = std::vector<TurnStatsRow>();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for(unsigned thread = 1; thread < numOfThreads; ++thread)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(std::thread& thread: threads)
+        {
+            thread.join();
+        }
+        return games;
+    }
+
+    ArchivedGame SimulationRunner::toArchived(const SimulatedGame& game)
+    {
+        ArchivedGame archived{};
+        archived.seed = game.seed;
+        archived.finalHash = game.turnHashes.empty() ? 0 : game.turnHashes.back();
+        archived.numOfTurns = static_cast<uint16_t>(game.turnHashes.size());
+        archived.winner = static_cast<int8_t>(game.winner);
+        archived.numOfSeats = static_cast<uint8_t>(game.points.size());
+        for(size_t seat = 0; seat < game.points.size() && seat < ARCHIVE_MAX_SEATS; ++seat)
+        {
+            archived.points[seat] = static_cast<uint8_t>(game.points[seat]);
+        }
+        return archived;
+    }
+
+    std::vector<DeterminismMismatch> SimulationRunner::verifyDeterminism(std::span<const unsigned> seeds) const
+    {
+        std::vector<SimulatedGame> firstPlays(seeds.size());
+        std::vector<SimulatedGame> secondPlays(seeds.size());
+        std::thread forward([this, &seeds, &firstPlays]() {
+            for(size_t index = 0; index < seeds.size(); ++index)
+            {
+                firstPlays[index] = play(seeds[index]);
+            }
+        });
+        std::thread backward([this, &seeds, &secondPlays]() {
+            for(size_t index = seeds.size(); index-- > 0;)
+            {
+                secondPlays[index] = play(seeds[index]);
+            }
+        });
+        forward.join();
+        backward.join();
+
+        std::vector<DeterminismMismatch> mismatches;
+        for(size_t index = 0; index < seeds.size(); ++index)
+        {
+            const std::vector<uint64_t>& first = firstPlays[index].turnHashes;
+            const std::vector<uint64_t>& second = secondPlays[index].turnHashes;
+            size_t turn = 0;
+            while(turn < first.size() && turn < second.size() && first[turn] == second[turn]) ++turn;
+            if(turn == first.size() && turn == second.size()) continue;
+            mismatches.push_back({seeds[index], turn,
+                                  turn < first.size() ? first[turn] : 0,
+                                  turn < second.size() ? second[turn] : 0});
+        }
+        return mismatches;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef SIMULATIONRUNNER_HPP
+#define SIMULATIONRUNNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Action.hpp"
+#include "Game.hpp"
+#include "Agent.hpp"
+#include "GameArchive.hpp"
+#include "TurnStats.hpp"
+
+namespace catan_game {
+
+    // A game played by the runner - the state hash after every finished turn, every applied action,
+    // a RollDice with the dice sum in its target, and every seat's row at the end of every turn
+    struct SimulatedGame {
+        unsigned seed;
+        int winner;                      // -1 when the turn limit stopped the game or a seat forfeited it
+        int forfeitSeat;                 // the seat whose agent gave up or played an illegal action, -1 when none did
+        std::vector<uint64_t> turnHashes;
+        std::vector<int> points;         // of every seat at the end
+        std::vector<Action> actions;
+        std::vector<TurnStatsRow> turnRows;
+    };
+
+    // First turn where two plays of the same seed went apart
+    struct DeterminismMismatch {
+        unsigned seed;
+        size_t turn;        // index into the turn hashes - the length of the shorter play when one stopped early
+        uint64_t firstHash; // 0 when that play has no such turn
+        uint64_t secondHash;
+    };
+
+    // Plays seeded games between agents, every seat discards and answers the others' offers through its
+    // agent, and every decision is an action of the game's stream. The game and the agents are seeded with
+    // the game seed only, so a seed plays the same game on any thread, in any order.
+    class SimulationRunner {
+    private:
+        size_t numOfSeats;
+        size_t maxTurns;
+        std::vector<AgentFactory> bots;
+
+    public:
+        // bots play the seats in turn, the builder ladder agent plays them all when there is none
+        explicit SimulationRunner(size_t seats = 3, size_t turnLimit = 400, std::vector<AgentFactory> seatBots = {});
+
+        // Every seat played by a new agent of its bot
+        SimulatedGame play(unsigned seed) const;
+
+        // agents[seat] plays the seat, agents aren't shared with another game running at the same time
+        SimulatedGame play(unsigned seed, std::span<Agent* const> agents) const;
+
+        // Every seed played once, the games shared between the threads - 0 threads uses every core.
+        // games[i] is the game of seeds[i]. With an archive every game is appended to it as it finishes,
+        // in the order they finish, and its actions aren't kept in games. Turn statistics take the turn rows
+        // of every game the same way.
+        std::vector<SimulatedGame> playAll(std::span<const unsigned> seeds, unsigned numOfThreads = 0,
+                                           GameArchiveWriter* archive = nullptr, TurnStatsWriter* turnStats = nullptr) const;
+
+        // The archive record of a game - the offset and the number of actions are the writer's
+        static ArchivedGame toArchived(const SimulatedGame& game);
+
+        // Play every seed twice at once, on two threads going through the seeds in opposite orders,
+        // and compare the hash of every turn. Empty when each seed repeated its game bit for bit.
+        std::vector<DeterminismMismatch> verifyDeterminism(std::span<const unsigned> seeds) const;
+    };
+}
+
+#endif
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include "SpectatorFeed.hpp"
+
+namespace catan_game {
+
+    constexpr size_t SPECTATOR_HEADER_SIZE = 8;
+
+    // Record tags and their fields, ids and counts little endian
+    enum class SpectatorRecord : uint8_t {
+        Seats = 1,   // u8 seats, u8 tiles, u16 vertex cells, u16 road slots - first in a keyframe
+        Tile,        // u8 tile, u8 type, u8 number - keyframe only
+        Vertex,      // u16 cell, u8 value
+        Road,        // u16 slot, u8 value
+        Hand,        // u8 seat, u8 resource, u16 count
+        Points,      // u8 seat, u8 points
+        Cards,       // u8 seat, u8 development cards
+        Turn,        // u8 seat, u8 phase, u8 roll, i8 winner
+        Robber       // u8 tile
+    };
+
+    static void putByte(std::string& out, uint8_t value)
+    {
+        out.push_back(static_cast<char>(value));
+    }
+
+    static void putShort(std::string& out, uint16_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xff));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    static void startMessage(std::string& out, SpectatorMessage kind, uint32_t sequence)
+    {
+        out.clear();
+        putByte(out, static_cast<uint8_t>(kind));
+        putByte(out, 0);
+        putShort(out, 0); // the size, once the records are in
+        for(int byte = 0; byte < 4; ++byte)
+        {
+            putByte(out, static_cast<uint8_t>(sequence >> (8 * byte)));
+        }
+    }
+
+    static void endMessage(std::string& out)
+    {
+        uint16_t size = static_cast<uint16_t>(out.size() - SPECTATOR_HEADER_SIZE);
+        out[2] = static_cast<char>(size & 0xff);
+        out[3] = static_cast<char>(size >> 8);
+    }
+
+    // The records of every value of to that differs from from - all of them against an empty state
+    static void putChanges(std::string& out, const SpectatorState& from, const SpectatorState& to)
+    {
+        for(size_t cell = 0; cell < to.vertices.size(); ++cell)
+        {
+            if(cell < from.vertices.size() && from.vertices[cell] == to.vertices[cell]) continue;
+            if(cell >= from.vertices.size() && to.vertices[cell] == 0) continue;
+            putByte(out, static_cast<uint8_t>(SpectatorRecord::Vertex));
+            putShort(out, static_cast<uint16_t>(cell));
+            putByte(out, to.vertices[cell]);
+        }
+        for(size_t slot = 0; slot < to.roads.size(); ++slot)
+        {
+            if(slot < from.roads.size() && from.roads[slot] == to.roads[slot]) continue;
+            if(slot >= from.roads.size() && to.roads[slot] == 0) continue;
+            putByte(out, static_cast<uint8_t>(SpectatorRecord::Road));
+            putShort(out, static_cast<uint16_t>(slot));
+            putByte(out, to.roads[slot]);
+        }
+        for(size_t seat = 0; seat < to.points.size(); ++seat)
+        {
+            bool isNew = seat >= from.points.size();
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                if(!isNew && from.hands[seat][type] == to.hands[seat][type]) continue;
+                putByte(out, static_cast<uint8_t>(SpectatorRecord::Hand));
+                putByte(out, static_cast<uint8_t>(seat));
+                putByte(out, static_cast<uint8_t>(type));
+                putShort(out, to.hands[seat][type]);
+            }
+            if(isNew || from.points[seat] != to.points[seat])
+            {
+                putByte(out, static_cast<uint8_t>(SpectatorRecord::Points));
+                putByte(out, static_cast<uint8_t>(seat));
+                putByte(out, to.points[seat]);
+            }
+            if(isNew || from.developmentCards[seat] != to.developmentCards[seat])
+            {
+                putByte(out, static_cast<uint8_t>(SpectatorRecord::Cards));
+                putByte(out, static_cast<uint8_t>(seat));
+                putByte(out, to.developmentCards[seat]);
+            }
+        }
+        if(from.points.empty() || from.currentSeat != to.currentSeat || from.phase != to.phase
+            || from.lastRoll != to.lastRoll || from.winner != to.winner)
+        {
+            putByte(out, static_cast<uint8_t>(SpectatorRecord::Turn));
+            putByte(out, to.currentSeat);
+            putByte(out, to.phase);
+            putByte(out, to.lastRoll);
+            putByte(out, static_cast<uint8_t>(to.winner));
+        }
+        if(from.points.empty() || from.robberTile != to.robberTile)
+        {
+            putByte(out, static_cast<uint8_t>(SpectatorRecord::Robber));
+            putByte(out, to.robberTile);
+        }
+    }
+
+    SpectatorFeed::SpectatorFeed(const Game& game) :
+                    published(),
+                    current(),
+                    delta(),
+                    keyframe(),
+                    isKeyframeStale(true)
+    {
+        capture(game, this->published);
+        this->current = this->published;
+    }
+
+    // Overwrites every value, so the vectors keep their memory from one action to the next
+    void SpectatorFeed::capture(const Game& game, SpectatorState& state) const
+    {
+        const Board& board = game.getBoard();
+        const std::vector<Player*>& players = game.getPlayers();
+        const std::pmr::vector<Tile*>& tiles = board.getTiles();
+        size_t numOfCells = static_cast<size_t>(board.getNumOfRows() * board.getNumOfCols());
+
+        state.tiles.resize(tiles.size());
+        for(size_t tile = 0; tile < tiles.size(); ++tile)
+        {
+            state.tiles[tile][0] = static_cast<uint8_t>(tiles[tile]->getType());
+            state.tiles[tile][1] = tiles[tile]->getType() == TileType::Sand ? 0 : static_cast<uint8_t>(tiles[tile]->getValue());
+        }
+        state.vertices.assign(numOfCells, 0);
+        state.roads.assign(2 * numOfCells, 0);
+        state.hands.resize(players.size());
+        state.points.resize(players.size());
+        state.developmentCards.resize(players.size());
+        for(size_t seat = 0; seat < players.size(); ++seat)
+        {
+            const Player* player = players[seat];
+            for(const Vertex* vertex: player->getMyBuildings())
+            {
+                state.vertices[board.getCell(vertex->getRow(), vertex->getColumn())] =
+                    static_cast<uint8_t>((seat + 1) | (vertex->isCity() ? 0x80 : 0));
+            }
+            for(const Edge* edge: player->getMyRoads())
+            {
+                state.roads[board.getEdgeSlot(edge)] = static_cast<uint8_t>(seat + 1);
+            }
+            ResourceVector hand = player->getResourceVector();
+            for(int type = 0; type < NUM_RESOURCE_TYPES; ++type)
+            {
+                state.hands[seat][type] = static_cast<uint16_t>(hand[type]);
+            }
+            state.points[seat] = static_cast<uint8_t>(player->getMyPoints());
+            state.developmentCards[seat] = static_cast<uint8_t>(player->getMyDevelopmentCards().size());
+        }
+        state.currentSeat = static_cast<uint8_t>(game.getCurrentSeat());
+        state.phase = static_cast<uint8_t>(game.getPhase());
+        state.lastRoll = static_cast<uint8_t>(game.getLastRoll());
+        state.winner = static_cast<int8_t>(game.getWinner());
+        state.robberTile = board.getRobberTileIndex() < 0 ? 0xff : static_cast<uint8_t>(board.getRobberTileIndex());
+    }
+
+    bool SpectatorFeed::update(const Game& game)
+    {
+        capture(game, this->current);
+        this->current.sequence = this->published.sequence + 1;
+        startMessage(this->delta, SpectatorMessage::Delta, this->current.sequence);
+        putChanges(this->delta, this->published, this->current);
+        if(this->delta.size() == SPECTATOR_HEADER_SIZE) return false;
+
+        endMessage(this->delta);
+        std::swap(this->published, this->current);
+        this->isKeyframeStale = true;
+        return true;
+    }
+
+    const std::string& SpectatorFeed::getDelta() const
+    {
+        return this->delta;
+    }
+
+    const std::string& SpectatorFeed::getKeyframe()
+    {
+        if(!this->isKeyframeStale) return this->keyframe;
+
+        const SpectatorState& state = this->published;
+        startMessage(this->keyframe, SpectatorMessage::Keyframe, state.sequence);
+        putByte(this->keyframe, static_cast<uint8_t>(SpectatorRecord::Seats));
+        putByte(this->keyframe, static_cast<uint8_t>(state.points.size()));
+        putByte(this->keyframe, static_cast<uint8_t>(state.tiles.size()));
+        putShort(this->keyframe, static_cast<uint16_t>(state.vertices.size()));
+        putShort(this->keyframe, static_cast<uint16_t>(state.roads.size()));
+        for(size_t tile = 0; tile < state.tiles.size(); ++tile)
+        {
+            putByte(this->keyframe, static_cast<uint8_t>(SpectatorRecord::Tile));
+            putByte(this->keyframe, static_cast<uint8_t>(tile));
+            putByte(this->keyframe, state.tiles[tile][0]);
+            putByte(this->keyframe, state.tiles[tile][1]);
+        }
+        putChanges(this->keyframe, SpectatorState(), state);
+        endMessage(this->keyframe);
+        this->isKeyframeStale = false;
+        return this->keyframe;
+    }
+
+    uint32_t SpectatorFeed::getSequence() const
+    {
+        return this->published.sequence;
+    }
+
+    bool applySpectatorMessage(std::string_view message, SpectatorState& state)
+    {
+        if(message.size() < SPECTATOR_HEADER_SIZE) return false;
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(message.data());
+        auto getShort = [&data](size_t offset) {
+            return static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+        };
+        SpectatorMessage kind = static_cast<SpectatorMessage>(data[0]);
+        size_t size = getShort(2);
+        uint32_t sequence = data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<uint32_t>(data[7]) << 24);
+        if(message.size() != SPECTATOR_HEADER_SIZE + size) return false;
+        if(kind == SpectatorMessage::Delta && sequence != state.sequence + 1) return false;
+        if(kind != SpectatorMessage::Delta && kind != SpectatorMessage::Keyframe) return false;
+
+        static constexpr std::array<size_t, 10> FIELD_SIZES = {0, 6, 3, 3, 3, 4, 2, 2, 4, 1};
+        size_t end = message.size();
+        for(size_t offset = SPECTATOR_HEADER_SIZE; offset < end;)
+        {
+            uint8_t tag = data[offset++];
+            if(tag == 0 || tag >= FIELD_SIZES.size() || offset + FIELD_SIZES[tag] > end) return false;
+            const uint8_t* field = data + offset;
+            offset += FIELD_SIZES[tag];
+            size_t seat = field[0];
+            switch(static_cast<SpectatorRecord>(tag))
+            {
+                case SpectatorRecord::Seats:
+                    if(kind != SpectatorMessage::Keyframe) return false;
+                    state = SpectatorState();
+                    state.hands.resize(field[0]);
+                    state.points.resize(field[0]);
+                    state.developmentCards.resize(field[0]);
+                    state.tiles.resize(field[1]);
+                    state.vertices.resize(getShort(offset - 4));
+                    state.roads.resize(getShort(offset - 2));
+                    break;
+                case SpectatorRecord::Tile:
+                    if(field[0] >= state.tiles.size()) return false;
+                    state.tiles[field[0]] = {field[1], field[2]};
+                    break;
+                case SpectatorRecord::Vertex:
+                case SpectatorRecord::Road:
+                {
+                    std::vector<uint8_t>& values = (tag == static_cast<uint8_t>(SpectatorRecord::Vertex)) ? state.vertices : state.roads;
+                    size_t id = getShort(offset - 3);
+                    if(id >= values.size()) return false;
+                    values[id] = field[2];
+                    break;
+                }
+                case SpectatorRecord::Hand:
+                    if(seat >= state.hands.size() || field[1] >= NUM_RESOURCE_TYPES) return false;
+                    state.hands[seat][field[1]] = getShort(offset - 2);
+                    break;
+                case SpectatorRecord::Points:
+                case SpectatorRecord::Cards:
+                {
+                    std::vector<uint8_t>& values = (tag == static_cast<uint8_t>(SpectatorRecord::Points)) ? state.points : state.developmentCards;
+                    if(seat >= values.size()) return false;
+                    values[seat] = field[1];
+                    break;
+                }
+                case SpectatorRecord::Turn:
+                    state.currentSeat = field[0];
+                    state.phase = field[1];
+                    state.lastRoll = field[2];
+                    state.winner = static_cast<int8_t>(field[3]);
+                    break;
+                case SpectatorRecord::Robber:
+                    state.robberTile = field[0];
+                    break;
+            }
+        }
+        state.sequence = sequence;
+        return true;
+    }
+}
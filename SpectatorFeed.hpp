@@ -0,0 +1,70 @@
+#ifndef SPECTATORFEED_HPP
+#define SPECTATORFEED_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Game.hpp"
+
+namespace catan_game {
+
+    // What a spectator sees of a game - the board, every seat's hand, points and cards, and the turn
+    struct SpectatorState {
+        std::vector<std::array<uint8_t, 2>> tiles;  // type and number, 0 the desert's number
+        std::vector<uint8_t> vertices;              // by getCell - 0 free, otherwise seat + 1, + 0x80 for a city
+        std::vector<uint8_t> roads;                 // by getEdgeSlot - 0 free, otherwise seat + 1
+        std::vector<std::array<uint16_t, NUM_RESOURCE_TYPES>> hands;
+        std::vector<uint8_t> points;
+        std::vector<uint8_t> developmentCards;
+        uint8_t currentSeat = 0;
+        uint8_t phase = 0;
+        uint8_t lastRoll = 0;
+        int8_t winner = -1;
+        uint8_t robberTile = 0xff;                  // 0xff while the robber is off the board
+        uint32_t sequence = 0;                      // of the last message applied
+
+        bool operator==(const SpectatorState& other) const = default;
+    };
+
+    // Message kinds of the spectator stream
+    enum class SpectatorMessage : uint8_t {
+        Keyframe = 'K', // the whole state, what a new watcher gets first
+        Delta = 'D'     // what one action changed, the sequence one past the message before
+    };
+
+    // Publishes a game to its watchers. A message is an 8 byte header - the kind, a reserved byte, the
+    // little endian byte size of the records and the sequence - and the records, each a tag and its
+    // fields (see SpectatorFeed.cpp). A keyframe holds every record of the state, a delta the ones whose
+    // value changed. Both are encoded once per action whatever the number of watchers, who all get the
+    // same bytes.
+    class SpectatorFeed {
+    private:
+        SpectatorState published;
+        SpectatorState current;
+        std::string delta;
+        std::string keyframe;
+        bool isKeyframeStale;
+
+        void capture(const Game& game, SpectatorState& state) const;
+
+    public:
+        explicit SpectatorFeed(const Game& game);
+
+        // After every action - encodes the delta from the state published before, false when nothing a
+        // spectator sees changed (and the sequence stays)
+        bool update(const Game& game);
+
+        const std::string& getDelta() const;
+        const std::string& getKeyframe(); // encoded at most once per sequence
+        uint32_t getSequence() const;
+    };
+
+    // The watcher's side - applies one message to the state, false when it is malformed or a delta
+    // doesn't follow the state's sequence
+    bool applySpectatorMessage(std::string_view message, SpectatorState& state);
+}
+
+#endif
@@ -4,11 +4,14 @@
 #include "Tile.hpp"
 
 using std::string;
-static int tilesIndex = 0;
 
 namespace catan_game {
 
-    Tile::Tile(TileType typeName) : type(typeName), index(tilesIndex++), value(-1) {}
+    // A tile has 6 vertices, reserved at once so the arena is not left with the smaller copies
+    Tile::Tile(TileType typeName, int tileIndex, const allocator_type& allocator) : type(typeName), index(tileIndex), value(-1), myVertices(allocator)
+    {
+        myVertices.reserve(6);
+    }
 
     int Tile::getIndex() const { return this->index; }
 
@@ -17,7 +20,7 @@ namespace catan_game {
         return this->type;
     }
 
-    const std::vector<Vertex *>& Tile::getVertices() const
+    const std::pmr::vector<Vertex *>& Tile::getVertices() const
     {
         return this->myVertices;
     }
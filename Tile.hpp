@@ -1,6 +1,7 @@
 
 #ifndef TILE_HPP
 #define TILE_HPP
+#include <memory_resource>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -16,14 +17,17 @@ namespace catan_game {
             TileType type;
             int index;
             int value;
-            std::vector<Vertex*> myVertices;
+            std::pmr::vector<Vertex*> myVertices;
 
         public:
-            Tile(TileType type);
+            using allocator_type = std::pmr::polymorphic_allocator<>;
+
+            // The index is the tile's position in its board's tiles
+            Tile(TileType type, int tileIndex, const allocator_type& allocator = {});
             int getIndex() const;
             int getValue() const;
             TileType getType() const;
-            const std::vector<Vertex*>& getVertices() const;
+            const std::pmr::vector<Vertex*>& getVertices() const;
             void setValue(int value);
             void setVertex(Vertex* vertex);
             void sendResources();
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include "Tournament.hpp"
+#include "SimulationRunner.hpp"
+
+namespace catan_game {
+
+    Tournament::Tournament(const std::vector<AgentFactory>& players, const TournamentOptions& tournamentOptions) :
+                    entrants(players),
+                    options(tournamentOptions),
+                    ratings(players.size()),
+                    ratingsMutex(),
+                    numOfUnfinished(0),
+                    numOfForfeits(0)
+    {
+        if(this->options.seatsPerGame < 2 || this->entrants.size() < this->options.seatsPerGame)
+        {
+            throw std::invalid_argument("A tournament needs at least as many entrants as the seats of a game, and 2 seats");
+        }
+        if(this->options.numOfThreads == 0)
+        {
+            this->options.numOfThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    // Every group of seatsPerGame entrants, in lexicographic order
+    std::vector<std::vector<size_t>> Tournament::roundRobinGroups() const
+    {
+        std::vector<std::vector<size_t>> groups;
+        size_t size = this->options.seatsPerGame;
+        std::vector<size_t> group(size);
+        std::iota(group.begin(), group.end(), 0);
+        while(true)
+        {
+            groups.push_back(group);
+            size_t position = size;
+            while(position > 0 && group[position - 1] == this->entrants.size() - size + position - 1) --position;
+            if(position == 0) break;
+            ++group[position - 1];
+            for(size_t index = position; index < size; ++index) group[index] = group[index - 1] + 1;
+        }
+        return groups;
+    }
+
+    // The entrants by rating, cut into groups from the top. When they don't divide evenly the last group
+    // is the bottom seatsPerGame entrants, so a few of them play the round twice.
+    std::vector<std::vector<size_t>> Tournament::swissGroups() const
+    {
+        std::vector<EntrantRating> current = this->ratings.compute();
+        std::vector<size_t> order(this->entrants.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&current](size_t first, size_t second) {
+            return current[first].elo > current[second].elo;
+        });
+
+        std::vector<std::vector<size_t>> groups;
+        size_t size = this->options.seatsPerGame;
+        for(size_t start = 0; start < order.size(); start += size)
+        {
+            size_t first = std::min(start, order.size() - size);
+            groups.emplace_back(order.begin() + first, order.begin() + first + size);
+        }
+        return groups;
+    }
+
+    // One game for every rotation of the seats of every group, all on the seed
+    void Tournament::scheduleGroups(const std::vector<std::vector<size_t>>& groups, unsigned seed,
+                                    std::vector<ScheduledGame>& games) const
+    {
+        for(const std::vector<size_t>& group: groups)
+        {
+            for(size_t rotation = 0; rotation < group.size(); ++rotation)
+            {
+                ScheduledGame game{std::vector<size_t>(group.size()), seed};
+                for(size_t seat = 0; seat < group.size(); ++seat)
+                {
+                    game.seatEntrants[seat] = group[(seat + rotation) % group.size()];
+                }
+                games.push_back(game);
+            }
+        }
+    }
+
+    // The worker threads take the next game until none is left - a game is the unit of work,
+    // so the pool stays busy to the end of the list
+    void Tournament::playGames(const std::vector<ScheduledGame>& games, const ProgressCallback& onProgress)
+    {
+        SimulationRunner runner(this->options.seatsPerGame, this->options.turnLimit);
+        std::atomic<size_t> nextGame{0};
+        auto worker = [this, &games, &onProgress, &runner, &nextGame]() {
+            std::vector<std::unique_ptr<Agent>> agents(this->options.seatsPerGame);
+            std::vector<Agent*> seats(this->options.seatsPerGame);
+            for(size_t index = nextGame++; index < games.size(); index = nextGame++)
+            {
+                const ScheduledGame& scheduled = games[index];
+                for(size_t seat = 0; seat < seats.size(); ++seat)
+                {
+                    agents[seat] = this->entrants[scheduled.seatEntrants[seat]].makeAgent();
+                    seats[seat] = agents[seat].get();
+                }
+                SimulatedGame played = runner.play(scheduled.seed, seats);
+
+                std::lock_guard<std::mutex> lock(this->ratingsMutex);
+                this->ratings.addGame(scheduled.seatEntrants, played.winner, played.forfeitSeat);
+                if(played.forfeitSeat >= 0) ++this->numOfForfeits;
+                else if(played.winner < 0) ++this->numOfUnfinished;
+                if(onProgress && this->options.reportEvery > 0 && this->ratings.getTotalGames() % this->options.reportEvery == 0)
+                {
+                    onProgress(this->ratings);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for(unsigned thread = 1; thread < this->options.numOfThreads; ++thread)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(std::thread& thread: threads)
+        {
+            thread.join();
+        }
+    }
+
+    void Tournament::run(const ProgressCallback& onProgress)
+    {
+        if(this->options.pairing == PairingMode::RoundRobin)
+        {
+            std::vector<std::vector<size_t>> groups = roundRobinGroups();
+            std::vector<ScheduledGame> games;
+            for(size_t round = 0; round < this->options.rounds; ++round)
+            {
+                scheduleGroups(groups, this->options.firstSeed + static_cast<unsigned>(round), games);
+            }
+            playGames(games, onProgress);
+            return;
+        }
+
+        for(size_t round = 0; round < this->options.rounds; ++round)
+        {
+            std::vector<ScheduledGame> games;
+            scheduleGroups(swissGroups(), this->options.firstSeed + static_cast<unsigned>(round), games);
+            playGames(games, onProgress);
+        }
+    }
+
+    const std::vector<AgentFactory>& Tournament::getEntrants() const
+    {
+        return this->entrants;
+    }
+
+    const RatingTable& Tournament::getRatings() const
+    {
+        return this->ratings;
+    }
+
+    size_t Tournament::getNumOfUnfinished() const
+    {
+        return this->numOfUnfinished;
+    }
+
+    size_t Tournament::getNumOfForfeits() const
+    {
+        return this->numOfForfeits;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "Agent.hpp"
+#include "RatingTable.hpp"
+
+namespace catan_game {
+
+    enum class PairingMode {
+        RoundRobin, // every round seats every group of entrants once
+        Swiss       // every round groups entrants of close ratings, by the ratings of the rounds before
+    };
+
+    struct TournamentOptions {
+        size_t seatsPerGame = 3;
+        PairingMode pairing = PairingMode::RoundRobin;
+        size_t rounds = 1;
+        unsigned firstSeed = 0;
+        unsigned numOfThreads = 0;  // 0 uses every core
+        size_t turnLimit = 400;
+        size_t reportEvery = 0;     // games between progress reports, 0 reports nothing before the end
+    };
+
+    // Plays the entrants against each other on a pool of threads - every game gets its own agents from
+    // the entrants' factories. A group of entrants plays one game for
+    // every rotation of the seats, and every game of a round is played on the round's seed, so each entrant
+    // gets every seat of the same boards and dice. Round robin rounds don't depend on each other and are
+    // queued at once, a Swiss round waits for the ratings of the one before.
+    class Tournament {
+    public:
+        // Called with the ratings so far, from the thread that finished the game - one call at a time
+        using ProgressCallback = std::function<void(const RatingTable& ratings)>;
+
+    private:
+        struct ScheduledGame {
+            std::vector<size_t> seatEntrants;
+            unsigned seed;
+        };
+
+        std::vector<AgentFactory> entrants;
+        TournamentOptions options;
+        RatingTable ratings;
+        std::mutex ratingsMutex;
+        size_t numOfUnfinished;
+        size_t numOfForfeits;
+
+        std::vector<std::vector<size_t>> roundRobinGroups() const;
+        std::vector<std::vector<size_t>> swissGroups() const;
+        void scheduleGroups(const std::vector<std::vector<size_t>>& groups, unsigned seed, std::vector<ScheduledGame>& games) const;
+        void playGames(const std::vector<ScheduledGame>& games, const ProgressCallback& onProgress);
+
+    public:
+        Tournament(const std::vector<AgentFactory>& players, const TournamentOptions& tournamentOptions);
+
+        void run(const ProgressCallback& onProgress = {});
+
+        const std::vector<AgentFactory>& getEntrants() const;
+        const RatingTable& getRatings() const;
+        size_t getNumOfUnfinished() const; // games the turn limit stopped
+        size_t getNumOfForfeits() const;   // games a seat gave up
+    };
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include "TradeBook.hpp"
+
+namespace catan_game {
+
+    // Reserved up front - clearOffers keeps the capacity and the fills are a ring, so the turns don't allocate
+    TradeBook::TradeBook() : offers(), fills(), numOfFills(0), nextOfferId(1)
+    {
+        this->offers.reserve(RESERVED_OFFERS);
+    }
+
+    bool TradeBook::isCompatible(const TradeOffer& resting, const TradeOffer& incoming)
+    {
+        if(resting.seat == incoming.seat) return false;
+        if(resting.toSeat >= 0 && static_cast<size_t>(resting.toSeat) != incoming.seat) return false;
+        if(incoming.toSeat >= 0 && static_cast<size_t>(incoming.toSeat) != resting.seat) return false;
+        return incoming.give.covers(resting.want) && resting.give.covers(incoming.want);
+    }
+
+    int TradeBook::findMatch(const TradeOffer& incoming, size_t first) const
+    {
+        for(size_t index = first; index < this->offers.size(); ++index)
+        {
+            if(isCompatible(this->offers[index], incoming)) return static_cast<int>(index);
+        }
+        return -1;
+    }
+
+    int TradeBook::add(TradeOffer offer)
+    {
+        offer.id = this->nextOfferId++;
+        this->offers.push_back(offer);
+        return offer.id;
+    }
+
+    const TradeOffer* TradeBook::find(int id) const
+    {
+        auto it = std::find_if(this->offers.begin(), this->offers.end(), [id](const TradeOffer& offer) { return offer.id == id; });
+        return (it != this->offers.end()) ? &(*it) : nullptr;
+    }
+
+    bool TradeBook::remove(int id)
+    {
+        auto it = std::find_if(this->offers.begin(), this->offers.end(), [id](const TradeOffer& offer) { return offer.id == id; });
+        if(it == this->offers.end()) return false;
+        this->offers.erase(it);
+        return true;
+    }
+
+    void TradeBook::addFill(const TradeFill& fill)
+    {
+        this->fills[this->numOfFills % TRADE_FILL_HISTORY] = fill;
+        ++this->numOfFills;
+    }
+
+    void TradeBook::clearOffers()
+    {
+        this->offers.clear();
+    }
+
+    int TradeBook::getNextOfferId() const
+    {
+        return this->nextOfferId;
+    }
+
+    void TradeBook::rollback(const std::vector<TradeOffer>& savedOffers, size_t numOfFills, int savedNextOfferId, const TradeFill& overwrittenFill)
+    {
+        this->offers.assign(savedOffers.begin(), savedOffers.end());
+        if(this->numOfFills > numOfFills)
+        {
+            this->fills[numOfFills % TRADE_FILL_HISTORY] = overwrittenFill;
+            this->numOfFills = numOfFills;
+        }
+        this->nextOfferId = savedNextOfferId;
+    }
+
+    const std::vector<TradeOffer>& TradeBook::getOffers() const
+    {
+        return this->offers;
+    }
+
+    size_t TradeBook::getNumOfFills() const
+    {
+        return this->numOfFills;
+    }
+
+    const TradeFill& TradeBook::getFill(size_t index) const
+    {
+        return this->fills[index % TRADE_FILL_HISTORY];
+    }
+
+    const TradeFill& TradeBook::getLastFill() const
+    {
+        return getFill(this->numOfFills - 1);
+    }
+
+    const TradeFill& TradeBook::getOverwrittenFill() const
+    {
+        return this->fills[this->numOfFills % TRADE_FILL_HISTORY];
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef TRADEBOOK_HPP
+#define TRADEBOOK_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "Resources.hpp"
+
+namespace catan_game {
+
+    // One resting offer - the seat gives `give` and wants `want` in return
+    struct TradeOffer {
+        int id;
+        size_t seat;
+        int toSeat;     // the only seat that may take it, -1 when it is open to everybody
+        int counterTo;  // id of the offer it counters, -1 for a new offer
+        ResourceVector give;
+        ResourceVector want;
+    };
+
+    // A settled trade, always on the terms of the offer that was resting in the book
+    struct TradeFill {
+        int offerId;
+        size_t maker;
+        size_t taker;
+        ResourceVector makerGives;
+        ResourceVector takerGives;
+    };
+
+    // Fills the book remembers - a game settles far fewer, older ones are overwritten
+    constexpr size_t TRADE_FILL_HISTORY = 256;
+
+    // The open offers of one game in arrival order, and the trades settled from them.
+    // The book only matches offers - checking and moving the players resources is the game's job.
+    class TradeBook {
+    private:
+        static constexpr size_t RESERVED_OFFERS = 16;  // resting offers of one turn
+
+        std::vector<TradeOffer> offers;
+        std::array<TradeFill, TRADE_FILL_HISTORY> fills;  // a ring of the latest fills, fill i at i % TRADE_FILL_HISTORY
+        size_t numOfFills;
+        int nextOfferId;
+
+    public:
+        TradeBook();
+
+        // true when the incoming offer can take the resting one on the resting terms:
+        // different seats, allowed by both targets, and each gives at least what the other wants
+        static bool isCompatible(const TradeOffer& resting, const TradeOffer& incoming);
+
+        // Index of the earliest resting offer (from index `first`) compatible with the incoming one, -1 when none
+        int findMatch(const TradeOffer& incoming, size_t first = 0) const;
+
+        // Rest the offer in the book, returns its new id
+        int add(TradeOffer offer);
+        const TradeOffer* find(int id) const;
+        bool remove(int id);
+        void addFill(const TradeFill& fill);
+
+        // Offers live for one turn, the latest fills are kept as the game's trade history
+        void clearOffers();
+
+        const std::vector<TradeOffer>& getOffers() const;
+        size_t getNumOfFills() const;          // every trade settled in the game
+        const TradeFill& getFill(size_t index) const; // one of the latest TRADE_FILL_HISTORY, index < getNumOfFills()
+        const TradeFill& getLastFill() const;
+        const TradeFill& getOverwrittenFill() const;  // the ring slot the next fill writes over
+        int getNextOfferId() const;
+
+        // Back to a state saved before an action - the offers are copied back, the fill since forgotten
+        // and its ring slot given back what it overwrote (an action settles one fill at most)
+        void rollback(const std::vector<TradeOffer>& savedOffers, size_t numOfFills, int savedNextOfferId, const TradeFill& overwrittenFill);
+    };
+}
+
+#endif
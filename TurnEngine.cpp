@@ -0,0 +1,377 @@
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "TurnEngine.hpp"
+
+namespace catan_game {
+
+    Decision makeDecision(size_t seat, TurnAction action, int row, int col, int toRow, int toCol)
+    {
+        return Decision{seat, action, row, col, toRow, toCol, {0, 0, 0, 0, 0}};
+    }
+
+    FramePool::FramePool() : freeFrames{} {}
+
+    FramePool::~FramePool()
+    {
+        for(void* frame: this->freeFrames)
+        {
+            while(frame != nullptr)
+            {
+                void* next = *static_cast<void**>(frame);
+                ::operator delete(frame);
+                frame = next;
+            }
+        }
+    }
+
+    void* FramePool::allocate(size_t size)
+    {
+        size_t sizeClass = (size - 1) / SIZE_CLASS;
+        if(sizeClass >= NUM_SIZE_CLASSES) return ::operator new(size);
+
+        void* frame = this->freeFrames[sizeClass];
+        if(frame == nullptr) return ::operator new((sizeClass + 1) * SIZE_CLASS);
+        this->freeFrames[sizeClass] = *static_cast<void**>(frame);
+        return frame;
+    }
+
+    void FramePool::deallocate(void* frame, size_t size)
+    {
+        size_t sizeClass = (size - 1) / SIZE_CLASS;
+        if(sizeClass >= NUM_SIZE_CLASSES)
+        {
+            ::operator delete(frame);
+            return;
+        }
+        *static_cast<void**>(frame) = this->freeFrames[sizeClass];
+        this->freeFrames[sizeClass] = frame;
+    }
+
+    // The pool of a frame is kept in front of it, the delete of the frame only gets its size
+    constexpr size_t FRAME_HEADER_SIZE = alignof(std::max_align_t);
+
+    void* TurnTask::promise_type::allocateFrame(FramePool* pool, size_t size)
+    {
+        size_t total = size + FRAME_HEADER_SIZE;
+        void* block = (pool != nullptr) ? pool->allocate(total) : ::operator new(total);
+        *static_cast<FramePool**>(block) = pool;
+        return static_cast<char*>(block) + FRAME_HEADER_SIZE;
+    }
+
+    void* TurnTask::promise_type::operator new(size_t size)
+    {
+        return allocateFrame(nullptr, size);
+    }
+
+    void* TurnTask::promise_type::operator new(size_t size, DecisionChannel& channel)
+    {
+        return allocateFrame(&channel.getFramePool(), size);
+    }
+
+    void* TurnTask::promise_type::operator new(size_t size, Game&, DecisionChannel& channel)
+    {
+        return allocateFrame(&channel.getFramePool(), size);
+    }
+
+    void* TurnTask::promise_type::operator new(size_t size, Game&, DecisionChannel& channel, size_t)
+    {
+        return allocateFrame(&channel.getFramePool(), size);
+    }
+
+    void* TurnTask::promise_type::operator new(size_t size, Game&, DecisionChannel& channel, size_t, bool)
+    {
+        return allocateFrame(&channel.getFramePool(), size);
+    }
+
+    void TurnTask::promise_type::operator delete(void* frame, size_t size)
+    {
+        void* block = static_cast<char*>(frame) - FRAME_HEADER_SIZE;
+        FramePool* pool = *static_cast<FramePool**>(block);
+        if(pool != nullptr) pool->deallocate(block, size + FRAME_HEADER_SIZE);
+        else ::operator delete(block);
+    }
+
+    TurnTask TurnTask::promise_type::get_return_object()
+    {
+        return TurnTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    TurnTask::TurnTask(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {}
+
+    TurnTask::TurnTask(TurnTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    TurnTask& TurnTask::operator=(TurnTask&& other) noexcept
+    {
+        if(this != &other)
+        {
+            if(this->handle) this->handle.destroy();
+            this->handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    TurnTask::~TurnTask()
+    {
+        if(this->handle) this->handle.destroy();
+    }
+
+    void TurnTask::start()
+    {
+        this->handle.resume();
+    }
+
+    bool TurnTask::isDone() const
+    {
+        return !this->handle || this->handle.done();
+    }
+
+    void TurnTask::rethrowIfFailed() const
+    {
+        if(isDone() && this->handle && this->handle.promise().exception)
+        {
+            std::rethrow_exception(this->handle.promise().exception);
+        }
+    }
+
+    // Awaiting a sub flow starts it right away, it resumes the awaiting flow when it ends
+    std::coroutine_handle<> TurnTask::await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        this->handle.promise().continuation = awaiting;
+        return this->handle;
+    }
+
+    void TurnTask::await_resume()
+    {
+        if(this->handle.promise().exception)
+        {
+            std::rethrow_exception(this->handle.promise().exception);
+        }
+    }
+
+    DecisionChannel::DecisionChannel() :
+                    request{DecisionKind::Turn, 0},
+                    decision(makeDecision(0, TurnAction::Cancel)),
+                    lastStatus(ActionStatus::Ok),
+                    waiting(nullptr),
+                    framePool() {}
+
+    DecisionChannel::Awaiter DecisionChannel::ask(DecisionKind kind, size_t seat)
+    {
+        this->request = DecisionRequest{kind, seat};
+        return Awaiter{*this};
+    }
+
+    void DecisionChannel::report(ActionStatus status)
+    {
+        this->lastStatus = status;
+    }
+
+    bool DecisionChannel::isWaiting() const
+    {
+        return this->waiting != nullptr;
+    }
+
+    const DecisionRequest& DecisionChannel::getRequest() const
+    {
+        return this->request;
+    }
+
+    ActionStatus DecisionChannel::getLastStatus() const
+    {
+        return this->lastStatus;
+    }
+
+    void DecisionChannel::respond(const Decision& answer)
+    {
+        if(this->waiting == nullptr)
+        {
+            this->lastStatus = ActionStatus::GameOver;
+            return;
+        }
+        std::coroutine_handle<> handle = std::exchange(this->waiting, nullptr);
+        this->decision = answer;
+        this->lastStatus = ActionStatus::Ok;
+        handle.resume();
+    }
+
+    FramePool& DecisionChannel::getFramePool()
+    {
+        return this->framePool;
+    }
+
+    TurnTask playGame(Game& game, DecisionChannel& channel)
+    {
+        co_await playSetup(game, channel);
+        while(game.getPhase() != GamePhase::Finished)
+        {
+            co_await playTurn(game, channel);
+        }
+    }
+
+    TurnTask playSetup(Game& game, DecisionChannel& channel)
+    {
+        while(game.getPhase() == GamePhase::SetupSettlement || game.getPhase() == GamePhase::SetupRoad)
+        {
+            bool isSettlement = game.getPhase() == GamePhase::SetupSettlement;
+            Decision decision = co_await channel.ask(isSettlement ? DecisionKind::SetupSettlement : DecisionKind::SetupRoad,
+                                                     game.getCurrentSeat());
+            if(decision.action != TurnAction::Place)
+            {
+                channel.report(ActionStatus::WrongPhase);
+            }
+            else if(isSettlement)
+            {
+                channel.report(game.placeSettlement(decision.seat, decision.row, decision.col));
+            }
+            else
+            {
+                channel.report(game.placeRoad(decision.seat, decision.row, decision.col, decision.toRow, decision.toCol));
+            }
+        }
+    }
+
+    // One turn of the current seat, ends when the seat ends its turn or the game is over
+    TurnTask playTurn(Game& game, DecisionChannel& channel)
+    {
+        size_t seat = game.getCurrentSeat();
+        for(;;)
+        {
+            Decision decision = co_await channel.ask(DecisionKind::Turn, seat);
+            if(decision.seat != seat)
+            {
+                channel.report(ActionStatus::NotYourTurn);
+                continue;
+            }
+
+            switch(decision.action)
+            {
+                case TurnAction::EndTurn:
+                    channel.report(game.endTurn(seat));
+                    if(channel.getLastStatus() == ActionStatus::Ok) co_return;
+                    break;
+
+                case TurnAction::RollDice:
+                    channel.report(game.rollDice(seat));
+                    if(game.getPhase() == GamePhase::Discard)
+                    {
+                        co_await discardFlow(game, channel);
+                    }
+                    if(game.getPhase() == GamePhase::MoveRobber)
+                    {
+                        co_await robberFlow(game, channel, seat);
+                    }
+                    break;
+                case TurnAction::PlayKnight:
+                    channel.report(game.playKnight(seat));
+                    if(game.getPhase() == GamePhase::MoveRobber)
+                    {
+                        co_await robberFlow(game, channel, seat);
+                    }
+                    break;
+
+                case TurnAction::BuildRoad:
+                    co_await buildRoadFlow(game, channel, seat);
+                    break;
+
+                case TurnAction::BuildSettlement:
+                case TurnAction::BuildCity:
+                    co_await buildSettlementCityFlow(game, channel, seat, decision.action == TurnAction::BuildCity);
+                    break;
+
+                case TurnAction::BuyDevelopmentCard:
+                    channel.report(game.buyDevelopmentCard(seat));
+                    break;
+
+                default:
+                    channel.report(ActionStatus::WrongPhase);
+                    break;
+            }
+
+            if(game.getPhase() == GamePhase::Finished) co_return;
+        }
+    }
+
+    // Ask for road coordinates until a road is placed or the seat cancels
+    TurnTask buildRoadFlow(Game& game, DecisionChannel& channel, size_t seat)
+    {
+        if(game.getPhase() != GamePhase::Main)
+        {
+            channel.report(ActionStatus::WrongPhase);
+            co_return;
+        }
+        if(game.getFreeRoads() == 0 && !game.getPlayers()[seat]->hasResourcesForRoad())
+        {
+            channel.report(ActionStatus::NotEnoughResources);
+            co_return;
+        }
+
+        for(;;)
+        {
+            Decision decision = co_await channel.ask(DecisionKind::RoadPlacement, seat);
+            if(decision.action == TurnAction::Cancel) co_return;
+
+            channel.report(game.placeRoad(seat, decision.row, decision.col, decision.toRow, decision.toCol));
+            if(channel.getLastStatus() == ActionStatus::Ok) co_return;
+        }
+    }
+
+    // Ask for the settlement (or city) vertex until it is built or the seat cancels
+    TurnTask buildSettlementCityFlow(Game& game, DecisionChannel& channel, size_t seat, bool isCity)
+    {
+        if(game.getPhase() != GamePhase::Main)
+        {
+            channel.report(ActionStatus::WrongPhase);
+            co_return;
+        }
+        Player* player = game.getPlayers()[seat];
+        if(isCity ? !player->hasResourcesForCity() : !player->hasResourcesForSettlement())
+        {
+            channel.report(ActionStatus::NotEnoughResources);
+            co_return;
+        }
+
+        for(;;)
+        {
+            Decision decision = co_await channel.ask(DecisionKind::SettlementPlacement, seat);
+            if(decision.action == TurnAction::Cancel) co_return;
+
+            channel.report(isCity ? game.placeCity(seat, decision.row, decision.col)
+                                  : game.placeSettlement(seat, decision.row, decision.col));
+            if(channel.getLastStatus() == ActionStatus::Ok) co_return;
+        }
+    }
+
+    // After a 7 - every seat with a pending penalty discards, in whatever order they answer
+    TurnTask discardFlow(Game& game, DecisionChannel& channel)
+    {
+        while(game.getPhase() == GamePhase::Discard)
+        {
+            size_t nextSeat = 0;
+            while(game.getPendingDiscard(nextSeat) == 0) ++nextSeat;
+
+            Decision decision = co_await channel.ask(DecisionKind::Discard, nextSeat);
+            if(decision.action != TurnAction::Discard)
+            {
+                channel.report(ActionStatus::WrongPhase);
+                continue;
+            }
+            channel.report(game.discard(decision.seat, decision.amounts));
+        }
+    }
+
+    // After a 7 or a knight - the seat must move the robber, there is no cancel
+    TurnTask robberFlow(Game& game, DecisionChannel& channel, size_t seat)
+    {
+        while(game.getPhase() == GamePhase::MoveRobber)
+        {
+            Decision decision = co_await channel.ask(DecisionKind::RobberPlacement, seat);
+            if(decision.action != TurnAction::MoveRobber)
+            {
+                channel.report(ActionStatus::WrongPhase);
+                continue;
+            }
+            channel.report(game.moveRobber(decision.seat, decision.row, decision.col));
+        }
+    }
+}
@@ -0,0 +1,182 @@
+#ifndef TURNENGINE_HPP
+#define TURNENGINE_HPP
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include "Game.hpp"
+
+namespace catan_game {
+
+    // What the engine is waiting for
+    enum class DecisionKind {
+        SetupSettlement,
+        SetupRoad,
+        Turn,
+        RoadPlacement,
+        SettlementPlacement,
+        Discard,
+        RobberPlacement
+    };
+
+    // Action chosen by a seat - the turn menu entries plus the placement answers
+    enum class TurnAction {
+        EndTurn,
+        RollDice,
+        BuildRoad,
+        BuildSettlement,
+        BuildCity,
+        BuyDevelopmentCard,
+        PlayKnight,
+        Place,
+        Discard,
+        MoveRobber,
+        Cancel
+    };
+
+    struct DecisionRequest {
+        DecisionKind kind;
+        size_t seat;
+    };
+
+    // The answer of a seat to a request. Coordinates are used by placements (row is the tile
+    // index and col the victim seat of a robber move), amounts (Tree, Clay, Crop, Wool, Iron) by discards.
+    struct Decision {
+        size_t seat;
+        TurnAction action;
+        int row;
+        int col;
+        int toRow;
+        int toCol;
+        ResourceVector amounts;
+    };
+
+    Decision makeDecision(size_t seat, TurnAction action, int row = -1, int col = -1, int toRow = -1, int toCol = -1);
+
+    // Recycles the coroutine frames of one game. Every turn starts the same few flows again, so once
+    // each frame size has been seen the frames come off the free lists instead of the heap.
+    // A game's flows run on one thread, and the pool must outlive the frames it gave out.
+    class FramePool {
+    private:
+        static constexpr size_t SIZE_CLASS = 64;
+        static constexpr size_t NUM_SIZE_CLASSES = 32; // larger frames go to the heap every time
+
+        std::array<void*, NUM_SIZE_CLASSES> freeFrames; // a free frame holds the next one of its class
+
+    public:
+        FramePool();
+        ~FramePool();
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        void* allocate(size_t size);
+        void deallocate(void* frame, size_t size);
+    };
+
+    class DecisionChannel;
+
+    // Coroutine of the turn logic, lazily started and awaitable from another TurnTask
+    class TurnTask {
+    public:
+        struct promise_type {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+
+            // The frame of a flow comes from the FramePool of its DecisionChannel parameter,
+            // a flow without one allocates from the heap
+            static void* operator new(size_t size);
+            static void* operator new(size_t size, DecisionChannel& channel);
+            static void* operator new(size_t size, Game& game, DecisionChannel& channel);
+            static void* operator new(size_t size, Game& game, DecisionChannel& channel, size_t seat);
+            static void* operator new(size_t size, Game& game, DecisionChannel& channel, size_t seat, bool isCity);
+            static void operator delete(void* frame, size_t size);
+            static void* allocateFrame(FramePool* pool, size_t size);
+
+            TurnTask get_return_object();
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            // Resume whoever awaited this task, the top level task just stays suspended at the end
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+
+        explicit TurnTask(std::coroutine_handle<promise_type> coroutine);
+        TurnTask(TurnTask&& other) noexcept;
+        TurnTask& operator=(TurnTask&& other) noexcept;
+        TurnTask(const TurnTask&) = delete;
+        TurnTask& operator=(const TurnTask&) = delete;
+        ~TurnTask();
+
+        // Run the task until it waits for its first decision
+        void start();
+        bool isDone() const;
+
+        // Throw what escaped the coroutine of a task that ended - its driver calls this after every
+        // resume, a sub flow's exception reaches the top level task through await_resume
+        void rethrowIfFailed() const;
+
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept;
+        void await_resume();
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    // Mailbox between one game's coroutine and its driver (terminal, socket or bot).
+    // The coroutine co_awaits ask(), the driver reads getRequest() and answers with respond(),
+    // which runs the rules synchronously until the next request - no thread waits for input.
+    class DecisionChannel {
+    private:
+        DecisionRequest request;
+        Decision decision;
+        ActionStatus lastStatus;
+        std::coroutine_handle<> waiting;
+        FramePool framePool; // of the flows asking on this channel
+
+    public:
+        struct Awaiter {
+            DecisionChannel& channel;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) noexcept { channel.waiting = handle; }
+            Decision await_resume() const noexcept { return channel.decision; }
+        };
+
+        DecisionChannel();
+
+        Awaiter ask(DecisionKind kind, size_t seat);
+        void report(ActionStatus status);
+
+        bool isWaiting() const;
+        const DecisionRequest& getRequest() const;
+        ActionStatus getLastStatus() const;
+
+        // Hand the decision to the waiting coroutine and resume it
+        void respond(const Decision& answer);
+
+        FramePool& getFramePool();
+    };
+
+    // Whole game - setup snake draft then turns until somebody wins
+    TurnTask playGame(Game& game, DecisionChannel& channel);
+    TurnTask playSetup(Game& game, DecisionChannel& channel);
+    TurnTask playTurn(Game& game, DecisionChannel& channel);
+    TurnTask buildRoadFlow(Game& game, DecisionChannel& channel, size_t seat);
+    TurnTask buildSettlementCityFlow(Game& game, DecisionChannel& channel, size_t seat, bool isCity);
+    TurnTask discardFlow(Game& game, DecisionChannel& channel);
+    TurnTask robberFlow(Game& game, DecisionChannel& channel, size_t seat);
+}
+
+#endif
@@ -0,0 +1,241 @@
+#include <cstring>
+#include <stdexcept>
+#include "TurnStats.hpp"
+
+namespace catan_game {
+
+    constexpr char TURN_STATS_MAGIC[8] = {'C', 'A', 'T', 'A', 'N', 'C', 'O', 'L'};
+    constexpr uint32_t TURN_STATS_VERSION = 1;
+    constexpr size_t COLUMN_NAME_SIZE = 16;
+
+    struct ColumnInfo {
+        const char* name;
+        size_t width;
+    };
+
+    static constexpr std::array<ColumnInfo, NUM_TURN_COLUMNS> COLUMNS = {{
+        {"seed", 4}, {"turn", 2}, {"seat", 1}, {"roll", 1}, {"points", 1},
+        {"tree", 2}, {"clay", 2}, {"crop", 2}, {"wool", 2}, {"iron", 2},
+        {"settlements", 1}, {"cities", 1}, {"roads", 1}, {"developmentCards", 1}
+    }};
+
+    std::string turnColumnName(TurnColumn column)
+    {
+        return COLUMNS[static_cast<size_t>(column)].name;
+    }
+
+    size_t turnColumnWidth(TurnColumn column)
+    {
+        return COLUMNS[static_cast<size_t>(column)].width;
+    }
+
+    static void putValue(std::vector<uint8_t>& out, uint32_t value, size_t width)
+    {
+        for(size_t byte = 0; byte < width; ++byte)
+        {
+            out.push_back(static_cast<uint8_t>(value >> (8 * byte)));
+        }
+    }
+
+    static uint32_t getValue(const uint8_t* in, size_t width)
+    {
+        uint32_t value = 0;
+        for(size_t byte = 0; byte < width; ++byte)
+        {
+            value |= static_cast<uint32_t>(in[byte]) << (8 * byte);
+        }
+        return value;
+    }
+
+    // 7 bits a byte, the high bit set on all but the last
+    static void putVarint(std::vector<uint8_t>& out, uint32_t value)
+    {
+        while(value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static size_t varintSize(uint32_t value)
+    {
+        size_t size = 1;
+        for(; value >= 0x80; value >>= 7) ++size;
+        return size;
+    }
+
+    static size_t runLengthSize(const std::vector<uint32_t>& values, size_t width)
+    {
+        size_t size = 0;
+        for(size_t index = 0; index < values.size();)
+        {
+            size_t end = index;
+            while(end < values.size() && values[end] == values[index]) ++end;
+            size += varintSize(static_cast<uint32_t>(end - index)) + width;
+            index = end;
+        }
+        return size;
+    }
+
+    TurnStatsWriter::TurnStatsWriter(const std::string& path, bool compressColumns, size_t rowsPerChunk) :
+                    file(path, std::ios::binary | std::ios::trunc),
+                    compress(compressColumns),
+                    chunkRows(rowsPerChunk == 0 ? DEFAULT_CHUNK_ROWS : rowsPerChunk),
+                    columns(),
+                    encoded(),
+                    appendMutex(),
+                    numOfRows(0)
+    {
+        if(!this->file)
+        {
+            throw std::runtime_error("Can't create turn statistics " + path);
+        }
+        std::vector<uint8_t> header(TURN_STATS_MAGIC, TURN_STATS_MAGIC + sizeof(TURN_STATS_MAGIC));
+        putValue(header, TURN_STATS_VERSION, 4);
+        putValue(header, NUM_TURN_COLUMNS, 4);
+        for(const ColumnInfo& column: COLUMNS)
+        {
+            char name[COLUMN_NAME_SIZE] = {};
+            std::strncpy(name, column.name, COLUMN_NAME_SIZE - 1);
+            header.insert(header.end(), name, name + COLUMN_NAME_SIZE);
+            putValue(header, static_cast<uint32_t>(column.width), 4);
+        }
+        this->file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        for(std::vector<uint32_t>& column: this->columns)
+        {
+            column.reserve(this->chunkRows);
+        }
+    }
+
+    TurnStatsWriter::~TurnStatsWriter()
+    {
+        flush();
+    }
+
+    void TurnStatsWriter::append(std::span<const TurnStatsRow> rows)
+    {
+        std::lock_guard<std::mutex> lock(this->appendMutex);
+        for(const TurnStatsRow& row: rows)
+        {
+            std::array<uint32_t, NUM_TURN_COLUMNS> values = {
+                row.seed, row.turn, row.seat, row.roll, row.points,
+                row.resources[0], row.resources[1], row.resources[2], row.resources[3], row.resources[4],
+                row.settlements, row.cities, row.roads, row.developmentCards
+            };
+            for(size_t column = 0; column < NUM_TURN_COLUMNS; ++column)
+            {
+                this->columns[column].push_back(values[column]);
+            }
+            if(this->columns[0].size() == this->chunkRows) writeChunk();
+        }
+        this->numOfRows += rows.size();
+    }
+
+    void TurnStatsWriter::flush()
+    {
+        std::lock_guard<std::mutex> lock(this->appendMutex);
+        if(!this->columns[0].empty()) writeChunk();
+        this->file.flush();
+    }
+
+    size_t TurnStatsWriter::getNumOfRows() const
+    {
+        return this->numOfRows;
+    }
+
+    // The chunk's directory first, so a reader can skip the columns it doesn't need
+    void TurnStatsWriter::writeChunk()
+    {
+        std::array<ColumnEncoding, NUM_TURN_COLUMNS> encodings;
+        std::vector<uint8_t> directory;
+        putValue(directory, static_cast<uint32_t>(this->columns[0].size()), 4);
+        this->encoded.clear();
+        for(size_t column = 0; column < NUM_TURN_COLUMNS; ++column)
+        {
+            const std::vector<uint32_t>& values = this->columns[column];
+            size_t width = COLUMNS[column].width;
+            size_t start = this->encoded.size();
+            encodings[column] = (this->compress && runLengthSize(values, width) < values.size() * width)
+                                ? ColumnEncoding::RunLength : ColumnEncoding::Raw;
+            if(encodings[column] == ColumnEncoding::Raw)
+            {
+                for(uint32_t value: values) putValue(this->encoded, value, width);
+            }
+            else
+            {
+                for(size_t index = 0; index < values.size();)
+                {
+                    size_t end = index;
+                    while(end < values.size() && values[end] == values[index]) ++end;
+                    putVarint(this->encoded, static_cast<uint32_t>(end - index));
+                    putValue(this->encoded, values[index], width);
+                    index = end;
+                }
+            }
+            directory.push_back(static_cast<uint8_t>(encodings[column]));
+            putValue(directory, static_cast<uint32_t>(this->encoded.size() - start), 4);
+        }
+        this->file.write(reinterpret_cast<const char*>(directory.data()), static_cast<std::streamsize>(directory.size()));
+        this->file.write(reinterpret_cast<const char*>(this->encoded.data()), static_cast<std::streamsize>(this->encoded.size()));
+        for(std::vector<uint32_t>& column: this->columns)
+        {
+            column.clear();
+        }
+    }
+
+    TurnStatsReader::TurnStatsReader(const std::string& path) :
+                    file(path, std::ios::binary),
+                    encoded()
+    {
+        uint8_t header[sizeof(TURN_STATS_MAGIC) + 8];
+        if(!this->file.read(reinterpret_cast<char*>(header), sizeof(header))
+            || std::memcmp(header, TURN_STATS_MAGIC, sizeof(TURN_STATS_MAGIC)) != 0
+            || getValue(header + 8, 4) != TURN_STATS_VERSION || getValue(header + 12, 4) != NUM_TURN_COLUMNS)
+        {
+            throw std::runtime_error(path + " is not a turn statistics file of version " + std::to_string(TURN_STATS_VERSION));
+        }
+        this->file.seekg(static_cast<std::streamoff>(NUM_TURN_COLUMNS * (COLUMN_NAME_SIZE + 4)), std::ios::cur);
+    }
+
+    bool TurnStatsReader::readChunk(std::array<std::vector<uint32_t>, NUM_TURN_COLUMNS>& columns)
+    {
+        uint8_t directory[4 + NUM_TURN_COLUMNS * 5];
+        if(!this->file.read(reinterpret_cast<char*>(directory), sizeof(directory))) return false;
+        size_t numOfRows = getValue(directory, 4);
+        for(size_t column = 0; column < NUM_TURN_COLUMNS; ++column)
+        {
+            ColumnEncoding encoding = static_cast<ColumnEncoding>(directory[4 + column * 5]);
+            size_t size = getValue(directory + 4 + column * 5 + 1, 4);
+            size_t width = COLUMNS[column].width;
+            this->encoded.resize(size);
+            if(!this->file.read(reinterpret_cast<char*>(this->encoded.data()), static_cast<std::streamsize>(size))) return false;
+
+            std::vector<uint32_t>& values = columns[column];
+            values.clear();
+            values.reserve(numOfRows);
+            if(encoding == ColumnEncoding::Raw)
+            {
+                for(size_t offset = 0; offset + width <= size; offset += width) values.push_back(getValue(&this->encoded[offset], width));
+            }
+            else
+            {
+                for(size_t offset = 0; offset < size;)
+                {
+                    uint32_t run = 0;
+                    for(int shift = 0; offset < size && shift < 32; shift += 7)
+                    {
+                        uint8_t byte = this->encoded[offset++];
+                        run |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                        if((byte & 0x80) == 0) break;
+                    }
+                    if(offset + width > size || run > numOfRows - values.size()) return false;
+                    values.insert(values.end(), run, getValue(&this->encoded[offset], width));
+                    offset += width;
+                }
+            }
+            if(values.size() != numOfRows) return false;
+        }
+        return true;
+    }
+}
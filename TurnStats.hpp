@@ -0,0 +1,91 @@
+#ifndef TURNSTATS_HPP
+#define TURNSTATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+#include "Resources.hpp"
+
+namespace catan_game {
+
+    // One seat at the end of one turn - what the balance statistics are made of
+    struct TurnStatsRow {
+        uint32_t seed;
+        uint16_t turn;          // 0 is the first turn after the setup
+        uint8_t seat;
+        uint8_t roll;           // the dice sum of the turn, the same on every seat's row
+        uint8_t points;
+        std::array<uint16_t, NUM_RESOURCE_TYPES> resources;
+        uint8_t settlements;
+        uint8_t cities;
+        uint8_t roads;
+        uint8_t developmentCards; // held, played knights included
+    };
+
+    // Columns of the file, in file order
+    enum class TurnColumn {
+        Seed, Turn, Seat, Roll, Points,
+        Tree, Clay, Crop, Wool, Iron,
+        Settlements, Cities, Roads, DevelopmentCards,
+        Count
+    };
+    constexpr size_t NUM_TURN_COLUMNS = static_cast<size_t>(TurnColumn::Count);
+
+    // Encoding of a column in a chunk
+    enum class ColumnEncoding : uint8_t {
+        Raw,       // the values back to back, little endian, the column's width each
+        RunLength  // (varint run, value) pairs - the seed, the turn and the roll repeat over the seats of a turn
+    };
+
+    // Writes turn rows as columns - a header naming the columns and their widths, then chunks of up to
+    // chunkRows rows. A chunk is its row count, the encoding and byte size of every column and the columns
+    // themselves, each a contiguous typed array. With compression a column is run length encoded when that
+    // is smaller. append may be called from many threads, the rows of one call stay together.
+    class TurnStatsWriter {
+    private:
+        std::ofstream file;
+        bool compress;
+        size_t chunkRows;
+        std::array<std::vector<uint32_t>, NUM_TURN_COLUMNS> columns;
+        std::vector<uint8_t> encoded;
+        std::mutex appendMutex;
+        size_t numOfRows;
+
+        void writeChunk();
+
+    public:
+        static constexpr size_t DEFAULT_CHUNK_ROWS = 65536;
+
+        // Throws std::runtime_error when the file can't be created
+        TurnStatsWriter(const std::string& path, bool compressColumns = true, size_t rowsPerChunk = DEFAULT_CHUNK_ROWS);
+        ~TurnStatsWriter(); // writes the last chunk
+
+        void append(std::span<const TurnStatsRow> rows);
+        void flush();  // ends the current chunk early
+        size_t getNumOfRows() const;
+    };
+
+    // Reads a turn statistics file a chunk at a time, every column widened to 32 bits
+    class TurnStatsReader {
+    private:
+        std::ifstream file;
+        std::vector<uint8_t> encoded;
+
+    public:
+        // Throws std::runtime_error when the file can't be opened or isn't a turn statistics file of this version
+        explicit TurnStatsReader(const std::string& path);
+
+        // The next chunk, columns[c] holding column c - false at the end of the file or on a torn chunk
+        bool readChunk(std::array<std::vector<uint32_t>, NUM_TURN_COLUMNS>& columns);
+    };
+
+    std::string turnColumnName(TurnColumn column);
+    size_t turnColumnWidth(TurnColumn column); // bytes of a value in the file
+}
+
+#endif
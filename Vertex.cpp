@@ -5,15 +5,16 @@
 
 namespace catan_game {
     // Constructor to initialize the vertex
-    // Constructor to initialize the vertex
-    Vertex::Vertex(int rowCoord, int columnCoord) : 
+    Vertex::Vertex(int rowCoord, int columnCoord, const allocator_type& allocator) : 
                     owner(nullptr),
                     settled(false),
                     city(false),
                     row(rowCoord),
                     col(columnCoord),
-                    mySurroundingEdges(),
-                    myVertexNeighbors() {}
+                    harbor(nullptr),
+                    yield(makeResourceVector(0, 0, 0, 0, 0)),
+                    mySurroundingEdges(allocator),
+                    myVertexNeighbors(allocator) {}
                     
     // Get the x coordinate of the vertex
     int Vertex::getRow() const{
@@ -32,17 +33,39 @@ namespace catan_game {
     }
 
     // Get the surrounding edges of the vertex
-    const std::vector<Edge*>& Vertex::getMySurroundingEdges() const
+    const std::pmr::vector<Edge*>& Vertex::getMySurroundingEdges() const
     {
         return this->mySurroundingEdges;
     }
 
     // Get the neighbors of the vertex
-    const std::vector<Vertex*>& Vertex::getMyVertexNeighbors() const
+    const std::pmr::vector<Vertex*>& Vertex::getMyVertexNeighbors() const
     {
         return this->myVertexNeighbors;
     }
     
+    // Get the harbor of the vertex
+    const Harbor* Vertex::getHarbor() const
+    {
+        return this->harbor;
+    }
+
+    // Set the harbor of the vertex
+    void Vertex::setHarbor(const Harbor* vertexHarbor)
+    {
+        this->harbor = vertexHarbor;
+    }
+
+    const ResourceVector& Vertex::getYield() const
+    {
+        return this->yield;
+    }
+
+    void Vertex::addYield(const ResourceVector& amounts)
+    {
+        this->yield += amounts;
+    }
+
     // Check if the vertex is settled
     bool Vertex::isSettled() const
     {
@@ -94,6 +117,18 @@ namespace catan_game {
         this->city = true;
     }
 
+    void Vertex::removeBuilding()
+    {
+        this->owner = nullptr;
+        this->settled = false;
+        this->city = false;
+    }
+
+    void Vertex::removeCity()
+    {
+        this->city = false;
+    }
+
     // add resources to the player
     void Vertex::addResources(const TileType& tileType)
     {
@@ -112,12 +147,12 @@ namespace catan_game {
 
     void Vertex::setMyEdges(std::vector<Edge*>& mySurrounding)
     {
-        this->mySurroundingEdges = mySurrounding;
+        this->mySurroundingEdges.assign(mySurrounding.begin(), mySurrounding.end());
     }
 
     void Vertex::setMyVertexNeighbors(std::vector<Vertex *> &neighbors)
     {
-        this->myVertexNeighbors = neighbors;
+        this->myVertexNeighbors.assign(neighbors.begin(), neighbors.end());
     }
 
     bool Vertex::operator==(const Vertex &other) const
@@ -5,9 +5,12 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include "Edge.hpp"
 #include "Player.hpp"
 #include "Tile.hpp"
+#include "Harbor.hpp"
+#include "Resources.hpp"
 
 namespace catan_game {
     class Edge;
@@ -21,13 +24,17 @@ namespace catan_game {
         bool city;
         int row;
         int col;
+        const Harbor* harbor;
+        ResourceVector yield; // dice ways (out of 36) the adjacent tiles produce every resource
 
-        std::vector<Edge*> mySurroundingEdges;
-        std::vector<Vertex*> myVertexNeighbors;
+        std::pmr::vector<Edge*> mySurroundingEdges;
+        std::pmr::vector<Vertex*> myVertexNeighbors;
 
     public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
         // Constructor to initialize the vertex
-        Vertex(int rowCoord, int columnCoord);
+        Vertex(int rowCoord, int columnCoord, const allocator_type& allocator = {});
 
         // Get the x coordinate of the vertex
         int getRow() const;
@@ -39,10 +46,22 @@ namespace catan_game {
         Player* getOwner() const;
 
         // Get the neighbors of the vertex
-        const std::vector<Vertex*>& getMyVertexNeighbors() const;
+        const std::pmr::vector<Vertex*>& getMyVertexNeighbors() const;
 
         // Get the surround edges of the vertex
-        const std::vector<Edge*>& getMySurroundingEdges() const;
+        const std::pmr::vector<Edge*>& getMySurroundingEdges() const;
+
+        // Harbor of the vertex, nullptr when it has none
+        const Harbor* getHarbor() const;
+
+        // Attach the harbor to the vertex
+        void setHarbor(const Harbor* vertexHarbor);
+
+        // Expected income of a settlement here, in 36ths of a card per roll
+        const ResourceVector& getYield() const;
+
+        // Change the yield when an adjacent tile starts or stops producing
+        void addYield(const ResourceVector& amounts);
 
         // Check if the vertex is buildable
         bool isSettlementBuildable(bool isCity) const;
@@ -68,6 +87,10 @@ namespace catan_game {
         // Set the city status of the vertex
         void setCity();
 
+        // Take the building back - the vertex is free again, or the city is a settlement again
+        void removeBuilding();
+        void removeCity();
+
         // Add the resources to the player
         void addResources(const TileType& tileType);
 
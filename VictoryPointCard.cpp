@@ -6,7 +6,7 @@ namespace catan_game
         points = 1;
     }
 
-    std::string VictoryPointCard::getName() const
+    std::string_view VictoryPointCard::getName() const
     {
         return "Victory Point"; 
     }
@@ -8,7 +8,7 @@ namespace catan_game
         points = 0;
     }
 
-    std::string YearOfPlentyCard::getName() const 
+    std::string_view YearOfPlentyCard::getName() const 
     {
         return "Year of Plenty";
     }
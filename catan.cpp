@@ -24,6 +24,8 @@
 #include "YearOfPlentyCard.hpp"
 #include "RoadCard.hpp"
 #include "MonopolyCard.hpp"
+#include "Game.hpp"
+#include "TurnEngine.hpp"
 
 #ifdef _WIN32
     #define CLEAR "cls"
@@ -45,252 +47,182 @@ using catan_game::VictoryPointCard;
 using catan_game::YearOfPlentyCard;
 using catan_game::RoadCard;
 using catan_game::MonopolyCard;
+using catan_game::Game;
+using catan_game::GamePhase;
+using catan_game::ActionStatus;
+using catan_game::DecisionChannel;
+using catan_game::DecisionKind;
+using catan_game::DecisionRequest;
+using catan_game::Decision;
+using catan_game::TurnAction;
+using catan_game::TurnTask;
+using catan_game::ResourceVector;
 using std::vector;
 
-Board *board = catan_game::Board::getBoardInstance(); // Create a board
-vector<Player*> players;  // Create a vector of players
-vector<Card*> deckCards; // Create a vector of development cards
-vector<Card*> usedCards; // Create a vector of used development cards
-void initPlayers();
-void initPlayersSettlements();
-void initPlayersRoads();
-void initCardsDeck();
-
-void playerOptions(Player* player);
-bool buildSettlementCityOption(Player* player);
-void buildRoadOption(Player *player);
-bool cardsOptions(Player *player);
-void openTrade(Player *player);
-void yearOfPlentyCardOptions(Player *player);
-
-Card* drawCard(Player* player);
-bool tryBuildSettelment(Player *player, bool isCity, bool startGame);
-bool tryBuildRoad(Player *player, bool startGame);
-bool playRoadBuildingCard(Player* player);
-bool playMonopolyCard(Player* player);
-
-void startGame();
-bool isGameOver();
+Board *board = nullptr; // The board of the game, owned by the game
+vector<Player*> players;  // The players in play order, owned by the game
+std::vector<std::string> initPlayers();
+
+// Terminal driver of the turn engine - reads the answer of the seat the engine is waiting for
+bool readTerminalDecision(Game& game, const DecisionRequest& request, Decision& decision);
+bool readTurnDecision(Game& game, size_t seat, Decision& decision);
+bool readPlacement(const DecisionRequest& request, Decision& decision);
+bool readDiscard(Game& game, size_t seat, Decision& decision);
+bool readRobber(Game& game, size_t seat, Decision& decision);
+bool readInt(int& value);
+void printDecisionResult(Game& game, const DecisionRequest& request, const Decision& decision, ActionStatus status, size_t numOfCards);
+bool checkGameTask(const TurnTask& task);
+
+bool cardsOptions(Game& game, size_t seat);
+bool readResource(TileType& type);
+void openTrade(Game& game, size_t seat);
+void bankTrade(Game& game, size_t seat);
+bool readResourceVector(ResourceVector& amounts);
+std::string resourcesText(const ResourceVector& amounts);
 
 void printCurrentGameData();
 void printMyGameData(Player* player);
 
-void deletePlayers();
-void deleteCards();
-
 int main() {
     
-    initPlayers(); // Create the players
-    printCurrentGameData(); // print the board and the players
-    initPlayersSettlements(); // ask for the first settlements from the players
-    initPlayersSettlements();
-    initPlayersRoads(); // ask for the first roads from the players
-    initPlayersRoads();
-    
-
-    initCardsDeck(); // initialize the development cards
-    board->sendStartingResources(); // send the resources to the players according to the first settlements
+    std::vector<std::string> names = initPlayers(); // Get the players names in play order
+    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+    Game game(names, seed);
+    board = &game.getBoard();
+    players = game.getPlayers();
     printCurrentGameData(); // print the board and the players
-    startGame(); // start the game, end if someone wins
-
-    deletePlayers(); // free the players
-    deleteCards(); // free the development cards
-    delete board; // delete the board
 
-    return 0;
-}
-
-void initPlayers() {
-    
-    std::cout<<"Note! empty name inserted, player will be assign with default name! "<<std::endl;
-    std::string playerOneName;
-    std::cout<<"Enter Player 1 name: ";
-    std::cin>> playerOneName;
+    // The whole game - setup and turns - runs as a coroutine waiting for the terminal decisions
+    DecisionChannel channel;
+    TurnTask gameTask = catan_game::playGame(game, channel);
+    gameTask.start();
+    if(!checkGameTask(gameTask)) return 1;
 
-    if(playerOneName.empty())
+    size_t turnSeat = game.getNumOfSeats();
+    while(channel.isWaiting())
     {
-        playerOneName = "Player 1";
-    }
-
-    Player* playerOne = new Player(playerOneName);
-    size_t oneRoll = playerOne->rollDice();
-    std::cout<<"Player 1 rolled: "<<oneRoll<<std::endl;
+        DecisionRequest request = channel.getRequest();
+        if(request.kind == DecisionKind::Turn && request.seat != turnSeat)
+        {
+            turnSeat = request.seat;
+            system(CLEAR);
+            board->printBoard();
+            printMyGameData(players[turnSeat]);
+        }
 
-    std::string playerTwoName;
-    std::cout<<"Enter Player 2 name: ";
-    std::cin>>playerTwoName;
+        Decision decision;
+        if(!readTerminalDecision(game, request, decision))
+        {
+            std::cout<<"\nInput closed, leaving the game"<<std::endl;
+            return 0;
+        }
 
-    if(playerTwoName.empty() || playerTwoName.compare(playerOneName) == 0)
-    {
-        playerTwoName = "Player 2";
+        size_t numOfCards = players[decision.seat]->getMyDevelopmentCards().size();
+        channel.respond(decision);
+        if(!checkGameTask(gameTask)) return 1;
+        printDecisionResult(game, request, decision, channel.getLastStatus(), numOfCards);
     }
 
-    Player* playerTwo = new Player(playerTwoName);
-    size_t twoRoll = playerTwo->rollDice();
-    std::cout<<"Player 2 rolled: "<<twoRoll<<std::endl;
-    
-    std::string playerThreeName;
-    std::cout<<"Enter Player 3 name: ";
-    std::cin>>playerThreeName;
-
-    if(playerThreeName.empty() || playerThreeName.compare(playerOneName) == 0 || playerThreeName.compare(playerTwoName) == 0)
+    if(game.getWinner() >= 0)
     {
-        playerThreeName = "Player 3";
+        std::cout<<players[game.getWinner()]->getUsername()<<" wins!"<<std::endl;
     }
+    return 0;
+}
 
-    Player* playerThree = new Player(playerThreeName);
-    size_t threeRoll = playerThree->rollDice();
-    std::cout<<"Player 3 rolled: "<<threeRoll<<std::endl;
-
-    if(oneRoll >= twoRoll && oneRoll >= threeRoll)
+// Report what escaped the game's coroutine, false when the game can't go on
+bool checkGameTask(const TurnTask& task)
+{
+    try
     {
-        players.push_back(playerOne);
-        if(twoRoll >= threeRoll)
-        {
-            players.push_back(playerTwo);
-            players.push_back(playerThree);
-        }
-        else
-        {
-            players.push_back(playerThree);
-            players.push_back(playerTwo);
-        }
+        task.rethrowIfFailed();
     }
-    else if(twoRoll >= oneRoll && twoRoll >= threeRoll)
+    catch(const std::exception& e)
     {
-        players.push_back(playerTwo);
-        if(oneRoll >= threeRoll)
-        {
-            players.push_back(playerOne);
-            players.push_back(playerThree);
-        }
-        else
-        {
-            players.push_back(playerThree);
-            players.push_back(playerOne);
-        }
+        std::cerr<<"The game stopped: "<<e.what()<<std::endl;
+        return false;
     }
-    else
+    return true;
+}
+
+// Read the players names and order them by a dice roll, the highest roll plays first
+std::vector<std::string> initPlayers() {
+    
+    std::cout<<"Note! empty name inserted, player will be assign with default name! "<<std::endl;
+    std::vector<std::string> names;
+    std::vector<size_t> rolls;
+    for(int index = 1; index <= 3; ++index)
     {
-        players.push_back(playerThree);
-        if(oneRoll >= twoRoll)
-        {
-            players.push_back(playerOne);
-            players.push_back(playerTwo);
-        }
-        else
+        std::string playerName;
+        std::cout<<"Enter Player "<<index<<" name: ";
+        std::cin>>playerName;
+
+        if(playerName.empty() || std::find(names.begin(), names.end(), playerName) != names.end())
         {
-            players.push_back(playerTwo);
-            players.push_back(playerOne);
+            playerName = "Player " + std::to_string(index);
         }
+
+        Player player(playerName);
+        size_t roll = player.rollDice();
+        std::cout<<"Player "<<index<<" rolled: "<<roll<<std::endl;
+        names.push_back(playerName);
+        rolls.push_back(roll);
     }
 
+    std::vector<size_t> order = {0, 1, 2};
+    std::stable_sort(order.begin(), order.end(), [&rolls](size_t first, size_t second) { return rolls[first] > rolls[second]; });
+
+    std::vector<std::string> orderedNames;
     std::cout<<"Play order: "<<std::endl;
-    for(Player* player: players)
+    for(size_t index: order)
     {
-        std::cout<<player->getUsername()<<", ";
+        orderedNames.push_back(names[index]);
+        std::cout<<names[index]<<", ";
     }
     std::cout<<std::endl;
+    return orderedNames;
 }
 
-void initPlayersSettlements()
+// read a number, a bad token is skipped and reported as -1, false only when the input is closed
+bool readInt(int& value)
 {
-    for(Player* player: players){
-        for(;;)
-        {
-            if(tryBuildSettelment(player, false, true))
-            {
-                break;
-            }else{
-                std::cout<<"Invalid settlement, try again"<<std::endl;
-            }
-        }
+    if(std::cin>>value)
+    {
+        return true;
     }
-}
-
-void initPlayersRoads()
-{
-    for(Player* player: players)
+    if(std::cin.eof())
     {
-        for(;;)
-        {
-            if(tryBuildRoad(player, true))
-            {
-                break;
-            }else{
-                std::cout<<"Invalid road, try again"<<std::endl;
-            }
-        }
+        return false;
     }
+    std::cin.clear();
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::cout<<"Invalid input"<<std::endl;
+    value = -1;
+    return true;
 }
 
-void initCardsDeck()
+bool readTerminalDecision(Game& game, const DecisionRequest& request, Decision& decision)
 {
-    // Add 3 Knight cards
-    for (int index = 0; index < 3; ++index) {
-        deckCards.push_back(new KnightCard());
-    }
-    // Add 4 Victory Point cards
-    for (int index = 0; index < 4; ++index) {
-        deckCards.push_back(new VictoryPointCard());
-    }
-    // Add 3 each of Year Of Plenty, Road Building, and Monopoly cards
-    for (int index = 0; index < 3; ++index) { // Assuming 3 can be adjustem
-        deckCards.push_back(new YearOfPlentyCard());
-        deckCards.push_back(new RoadCard());
-        deckCards.push_back(new MonopolyCard());
-    }
-
-    // Shuffle the deck
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::shuffle(deckCards.begin(), deckCards.end(), std::default_random_engine(seed));
-}
-
-Card* drawCard(Player* player) {
-    if (deckCards.empty()) return nullptr;
-    if(!(player->removeResourceForDevCard())) return nullptr;
-    Card* card = deckCards.back();
-    deckCards.pop_back();
-    usedCards.push_back(card);
-    return card;
-}
+    switch(request.kind)
+    {
+        case DecisionKind::Turn:
+            return readTurnDecision(game, request.seat, decision);
 
-void printMyGameData(Player* player)
-{
-    std::cout<<*player<<std::endl;
-}
+        case DecisionKind::Discard:
+            return readDiscard(game, request.seat, decision);
 
-void printCurrentGameData()
-{
-    board->printBoard();
-    for(Player* player: players)
-    {
-        std::cout<<*player<<std::endl;
-    }
-}
+        case DecisionKind::RobberPlacement:
+            return readRobber(game, request.seat, decision);
 
-void startGame()
-{
-    for(;;)
-    {
-        for(Player* player: players)
-        {
-            playerOptions(player);
-            if(isGameOver()) 
-            {
-                return;
-            }
-        }
+        default:
+            return readPlacement(request, decision);
     }
 }
 
-void playerOptions(Player* player)
+// The turn menu - options 5-7 are handled here in the terminal, the rest is answered to the engine
+bool readTurnDecision(Game& game, size_t seat, Decision& decision)
 {
-
-    bool hasRolled = false;
-    system(CLEAR);
-    board->printBoard();
-    printMyGameData(player);
+    Player* player = players[seat];
     for(;;){
         std::cout<<player->getUsername()<<" Turn's"<<std::endl;
         std::cout<<"Options:"<<std::endl;
@@ -302,116 +234,62 @@ void playerOptions(Player* player)
         std::cout<<"5. Play Development Card"<<std::endl;
         std::cout<<"6. Trade"<<std::endl;
         std::cout<<"7. Print Map and My Current Game-Data"<<std::endl;
-        std::vector<Card*> playerCards, removedCards;
-        size_t diff;
+        std::cout<<"8. Play Knight Card"<<std::endl;
+        std::cout<<"Choice: ";
         int choice;
-        try
-        {
-            std::cout<<"Choice: ";
-            std::cin>>choice;
-            std::cout<<std::endl;
-        }
-        catch(std::invalid_argument& e)
-        {
-            std::cout<<"Invalid input"<<std::endl;
-            continue;
-        }
+        if(!readInt(choice)) return false;
+        std::cout<<std::endl;
 
         switch(choice)
         {
             case 0:
-                return;
+                decision = catan_game::makeDecision(seat, TurnAction::EndTurn);
+                return true;
 
             case 1:
-                if(!hasRolled)
-                {
-                    size_t diceSumResult = player->rollDice();
-                    hasRolled = true;
-                    std::cout<<"***** Rolled: "<<diceSumResult<<" *****\n"<<std::endl;
-                    if(diceSumResult == 7)
-                    {
-                        for(Player* player: players)
-                        {
-                            if(player->getNumOfResources() >= 7)
-                            {
-                                player->sevenPenalty();
-                            }
-                        }
-
-                    }
-                    else 
-                        board->distrbuteResources(diceSumResult);
-                }
-                else 
-                    std::cout<<"Already rolled the dice"<<std::endl;
-                break;
+                decision = catan_game::makeDecision(seat, TurnAction::RollDice);
+                return true;
 
             case 2:
-                if(player->hasResourcesForRoad()) 
-                    buildRoadOption(player);
-                else 
-                    std::cout<<"Not enough resources to build road"<<std::endl;
-                break;
+                decision = catan_game::makeDecision(seat, TurnAction::BuildRoad);
+                return true;
 
             case 3:
-                if(buildSettlementCityOption(player))
+                std::cout<<"Settlement Options:"<<std::endl;
+                std::cout<<"1. Place Settlement"<<std::endl;
+                std::cout<<"2. Place City"<<std::endl;
+                std::cout<<"3. Cancel"<<std::endl;
+                if(!readInt(choice)) return false;
+                if(choice == 1 || choice == 2)
                 {
-                    std::cout<<"Build Succefully"<<std::endl;
+                    decision = catan_game::makeDecision(seat, choice == 1 ? TurnAction::BuildSettlement : TurnAction::BuildCity);
+                    return true;
                 }
                 break;
 
             case 4:
-                //implement player methods
-                if(player->hasResourcesForDevelopmentCard())
-                {
-                    Card* card = drawCard(player);
-                    if(card == nullptr)
-                    {
-                        std::cout<<"No more cards in the deck"<<std::endl;
-                        break;
-                    }
-                    else
-                    {
-                        
-                        diff = player->getMyDevelopmentCards().size();
-                        playerCards = player->addDevelopmentCard(card);
-                        if(playerCards.size() == diff)
-                        {
-                            throw std::invalid_argument("Error in adding card to player - card not added");
-
-                        }else if(playerCards.size() - diff > 1)
-                        {
-                            for(Card* card: playerCards)
-                            {
-                                if(card->getName().compare("Largest Army") == 0)
-                                {
-                                    std::cout<<"\n**** Development Card: "<<card->getName()<<" ****"<<std::endl;
-                                    std::cout<<"\n**** Congratulation you have gained the Largest Army Card ****\n"<<std::endl;
-                                }
-                            }
-                        }else{
-                            std::cout<<"\n**** Development Card: "<<card->getName()<<" ****"<<std::endl;
-                        }
-                    }
-                }
-                else
-                    std::cout<<"Not enough resources to buy development card"<<std::endl;
-                break;
+                decision = catan_game::makeDecision(seat, TurnAction::BuyDevelopmentCard);
+                return true;
 
             case 5:
                 if(player->getMyDevelopmentCards().empty())
                 {
                     std::cout<<"No development cards to play"<<std::endl;
-                    break;
                 }
-                else
+                else if(!cardsOptions(game, seat))
                 {
-                    if(cardsOptions(player)) return;
+                    return false;
                 }
                 break;
 
             case 6:
-                openTrade(player);
+                std::cout<<"Trade Options:"<<std::endl;
+                std::cout<<"1. Trade with the players"<<std::endl;
+                std::cout<<"2. Trade with the bank"<<std::endl;
+                std::cout<<"3. Cancel"<<std::endl;
+                if(!readInt(choice)) return false;
+                if(choice == 1) openTrade(game, seat);
+                else if(choice == 2) bankTrade(game, seat);
                 break;
 
             case 7:
@@ -419,6 +297,9 @@ void playerOptions(Player* player)
                 printMyGameData(player);
                 break;
 
+            case 8:
+                decision = catan_game::makeDecision(seat, TurnAction::PlayKnight);
+                return true;
 
             default:
                 break;
@@ -426,311 +307,177 @@ void playerOptions(Player* player)
     }
 }
 
-void buildRoadOption(Player *player)
+// Coordinates of a settlement or road, a road placement during the turn can be cancelled
+bool readPlacement(const DecisionRequest& request, Decision& decision)
 {
-    for(;;)
+    Player* player = players[request.seat];
+    std::cout<<"\n"<<player->getUsername()<<" Turn's"<<std::endl;
+    decision = catan_game::makeDecision(request.seat, TurnAction::Place);
+
+    if(request.kind == DecisionKind::RoadPlacement || request.kind == DecisionKind::SettlementPlacement)
     {
-        std::cout<<"Road Options:"<<std::endl;
-        std::cout<<"1. Place Road"<<std::endl;
+        std::cout<<(request.kind == DecisionKind::RoadPlacement ? "Road Options:" : "Settlement Options:")<<std::endl;
+        std::cout<<"1. Place"<<std::endl;
         std::cout<<"2. Cancel"<<std::endl;
-        
         int choice;
-        try
-        {
-            std::cin>>choice;
-        }
-        catch(std::invalid_argument& e)
+        if(!readInt(choice)) return false;
+        if(choice != 1)
         {
-            std::cout<<"Invalid input"<<std::endl;
-            continue;
+            decision.action = TurnAction::Cancel;
+            return true;
         }
+    }
 
-        switch(choice)
-        {
-            case 1:
-                if(tryBuildRoad(player, false)) return;
-                break;
-
-            case 2:
-                return;
-
-            default:
-                break;
-        }
+    if(request.kind == DecisionKind::SetupSettlement || request.kind == DecisionKind::SettlementPlacement)
+    {
+        std::cout<<"Enter row: ";
+        if(!readInt(decision.row)) return false;
+        std::cout<<"Enter col: ";
+        return readInt(decision.col);
     }
-}
 
-bool tryBuildRoad(Player *player, bool freeFromResource)
-{
-    std::string fromRowStr, fromColStr, toRowStr, toColStr;
-    std::cout<<"\n"<<player->getUsername()<<" Turn's"<<std::endl;
     std::cout<<"From row: ";
-    std::cin>>fromRowStr;
+    if(!readInt(decision.row)) return false;
     std::cout<<"From column: ";
-    std::cin>>fromColStr;
+    if(!readInt(decision.col)) return false;
     std::cout<<"To row: ";
-    std::cin>>toRowStr;
+    if(!readInt(decision.toRow)) return false;
     std::cout<<"To column: ";
-    std::cin>>toColStr;
-
-    // try to parse to int
-    int fromRow, fromCol, toRow, toCol;
-    try{
-        fromRow = std::stoi(fromRowStr);
-        fromCol = std::stoi(fromColStr);
-        toRow = std::stoi(toRowStr);
-        toCol = std::stoi(toColStr);
-    }catch(std::invalid_argument& e){
-        std::cout<<"Invalid input"<<std::endl;
-        return false;
-    }
+    return readInt(decision.toCol);
+}
 
-    // check if the vertex is buildable
-    Edge* edge = board->placeRoad(fromRow,fromCol,toRow, toCol, player, freeFromResource);
-    if(edge != nullptr)
-    {
-        printCurrentGameData();
-        std::cout<<player->getUsername()<<": Road placed in: "<<*edge<<std::endl;
-        return true;
+// Ask the seat which resources to give back after a 7, until the whole penalty is chosen
+bool readDiscard(Game& game, size_t seat, Decision& decision)
+{
+    Player* player = players[seat];
+    int numOfResourcesToRemove = game.getPendingDiscard(seat);
+    decision = catan_game::makeDecision(seat, TurnAction::Discard);
+    while(numOfResourcesToRemove > 0)
+    {
+        player->printMyResources();
+        std::cout << player->getUsername() << ", you have " << numOfResourcesToRemove << " resources to remove\n";
+        std::cout << "Enter the resource you want to remove: ";
+        std::string type;
+        if(!(std::cin >> type)) return false;
+        std::cout << "Enter the amount of resources you want to remove: ";
+        int amount;
+        if(!readInt(amount)) return false;
+
+        TileType tileType = catan_game::stringToTileType(type);
+        int index = static_cast<int>(tileType);
+        if(tileType == TileType::Sand || amount <= 0 || amount > numOfResourcesToRemove
+            || decision.amounts[index] + amount > player->getMyResources().at(tileType))
+        {
+            std::cout << "You don't have enough resources of this type\n";
+            continue;
+        }
+        decision.amounts[index] += amount;
+        numOfResourcesToRemove -= amount;
     }
-
-    return false;
+    return true;
 }
 
-bool playRoadBuildingCard(Player* player)
+// The robber must move to another tile, the victim is asked only when somebody there can be robbed
+bool readRobber(Game& game, size_t seat, Decision& decision)
 {
-    std::cout<<"**** Note! Once you start building you cant cancel ****"<<std::endl;
-    std::cout<<"**** Note! You will have 3 chances to place your roads! ****"<<std::endl;
-    std::cout<<"1. Start Build"<<std::endl;
-    std::cout<<"2. Cancel"<<std::endl;
-    std::cout<<"Enter your choice: ";
-    int choice;
-    try
+    std::cout<<"\n"<<players[seat]->getUsername()<<", move the robber"<<std::endl;
+    const std::pmr::vector<Tile*>& tiles = board->getTiles();
+    for(size_t index = 0; index < tiles.size(); ++index)
     {
-        std::cin>>choice;
-    }
-    catch(std::invalid_argument& e)
-    {
-        std::cout<<"Invalid input"<<std::endl;
-        return false;
+        std::cout<<index<<". "<<catan_game::tileTypeToString(tiles[index]->getType())<<" "<<tiles[index]->getValue()
+                 <<(static_cast<int>(index) == board->getRobberTileIndex() ? " (robber)" : "")<<std::endl;
     }
-    
-    int count = 0;
-    for(;;)
+    decision = catan_game::makeDecision(seat, TurnAction::MoveRobber);
+    std::cout<<"Enter tile: ";
+    if(!readInt(decision.row)) return false;
+
+    bool hasVictims = false;
+    for(size_t other = 0; other < players.size() && decision.row >= 0 && decision.row < static_cast<int>(tiles.size()); ++other)
     {
-        switch(choice)
+        if(other == seat || players[other]->getNumOfResources() == 0) continue;
+        for(const Vertex* vertex: tiles[decision.row]->getVertices())
         {
-            case 1:
-                if(tryBuildRoad(player, true))
-                {
-                    board->printBoard();
-                    count++;
-                    if(count == 2) return true;
-                }
+            if(vertex->getOwner() == players[other])
+            {
+                std::cout<<other<<". rob "<<players[other]->getUsername()<<std::endl;
+                hasVictims = true;
                 break;
-
-            case 2:
-                return false;
-
-            default:
-                return false;
+            }
         }
     }
-    return false;
+    if(!hasVictims) return true;
+    std::cout<<"Enter player: ";
+    return readInt(decision.col);
 }
 
-bool playMonopolyCard(Player* player)
+void printDecisionResult(Game& game, const DecisionRequest& request, const Decision& decision, ActionStatus status, size_t numOfCards)
 {
-    for(;;)
+    Player* player = players[decision.seat];
+    if(status != ActionStatus::Ok)
     {
-        std::cout<<"Monopoly Card Options:"<<std::endl;
-        std::cout<<"1. Ask for Resource"<<std::endl;
-        std::cout<<"2. Ask for Card"<<std::endl;
-        std::cout<<"3. Cancel"<<std::endl;
-        std::cout<<"Invalid argument will lead to lost of the card"<<std::endl;
-        std::cout<<"Note! If the other player does not have the resource or the card you want, you will get nothing"<<std::endl;
-        std::vector<Card*> addedCards, removedCards;
-        std::string demand;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        int choice;
-        try
-        {
-            std::cin>>choice;
-        }
-        catch(std::invalid_argument& e)
-        {
-            std::cout<<"Invalid input"<<std::endl;
-            continue;
-        }
+        std::cout<<"Invalid move: "<<catan_game::actionStatusToString(status)<<", try again"<<std::endl;
+        return;
+    }
 
-        TileType type;
-        std::unordered_map<TileType,int> resource;
-        switch(choice)
-        {
-            case 1:
-                std::cout<<"Enter the Resource you want to ask for: ";
-                std::cout<<"Resources Options: Tree, Clay, Crop, Wool, Iron"<<std::endl;
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                
-                std::cin>>demand;
-                type = catan_game::stringToTileType(demand);
-                for(Player* otherPlayer: players)
-                {
-                    if(player != otherPlayer){
-                        resource = otherPlayer->getMyResources();
-                        if(resource[type] > 0)
-                        {
-                            player->addResources(type ,1);
-                            otherPlayer->removeResources(type,1);
-                        }else{
-                            std::cout<<"\n"<<otherPlayer->getUsername()<<" Does not habe the Resource you asked for"<<std::endl;
-                        }
-                    }
-                }
-                return true;
+    switch(decision.action)
+    {
+        case TurnAction::RollDice:
+            std::cout<<"***** Rolled: "<<game.getLastRoll()<<" *****\n"<<std::endl;
+            break;
 
-            case 2:
-                std::cout<<"Enter the Card you want to ask for: ";
-                std::cout<<"Cards Options: Year of Plenty, Road Building, Monopoly, Knight"<<std::endl;
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        case TurnAction::MoveRobber:
+            std::cout<<player->getUsername()<<": Robber moved"<<std::endl;
+            break;
 
-                std::cin>>demand;
-                for(Player* otherPlayer: players)
-                {
-                    if(player != otherPlayer){
-                        for(auto card : otherPlayer->getMyDevelopmentCards())
-                        {
-                            if(card->getName().compare(demand) == 0)
-                            {
-                                removedCards = otherPlayer->removeDevelopmentCard(card);
-                                if(removedCards.empty())
-                                {
-                                    throw std::invalid_argument("Error in removing card from player - card not removed");
-                                }else if(removedCards.size() > 1){
-                                    for(Card* card: removedCards)
-                                    {
-                                        if(card->getName().compare("Largest Army") == 0)
-                                        {
-                                            std::cout<<"\n**** "<<otherPlayer->getUsername()<<" has lost the Largest Army Card ****\n"<<std::endl;
-                                        }
-                                    }
-                                }
-
-                                addedCards = player->addDevelopmentCard(card);
-                                if(addedCards.size() > 1)
-                                {
-                                    for(Card* card: addedCards)
-                                    {
-                                        if(card->getName().compare("Largest Army") == 0)
-                                        {
-                                            usedCards.push_back(card);
-                                            std::cout<<"\n**** Congratulation you have gained the Largest Army Card ****\n"<<std::endl;
-                                        }
-                                    }
-                                }
-                                
-                            }else{
-                                std::cout<<"\n"<<otherPlayer->getUsername()<<" Does not have the Card you asked for"<<std::endl;
-                            }
-                        }
-                    }
-                }
-                return true;
+        case TurnAction::BuyDevelopmentCard:
+            for(size_t index = numOfCards; index < player->getMyDevelopmentCards().size(); ++index)
+            {
+                std::cout<<"\n**** Development Card: "<<player->getMyDevelopmentCards()[index]->getName()<<" ****"<<std::endl;
+            }
+            break;
 
-            case 3:
-                return false;
-            
-            default:
-                    break;
-        }
+        case TurnAction::Place:
+            if(request.kind == DecisionKind::SetupRoad || request.kind == DecisionKind::RoadPlacement)
+            {
+                std::cout<<player->getUsername()<<": Road placed"<<std::endl;
+            }
+            else
+            {
+                std::cout<<player->getUsername()<<": Build Succefully in ("<<decision.row<<","<<decision.col<<")"<<std::endl;
+            }
+            break;
+
+        default:
+            break;
     }
-    return false;
 }
 
-bool buildSettlementCityOption(Player *player)
+void printMyGameData(Player* player)
 {
-    for(;;){
-        std::cout<<"Settlement Options:"<<std::endl;
-        std::cout<<"1. Place Settlement"<<std::endl;
-        std::cout<<"2. Place City"<<std::endl;
-        std::cout<<"3. Cancel"<<std::endl;
-        int choice;
-        try
-        {
-            std::cin>>choice;
-        }
-        catch(std::invalid_argument& e)
-        {
-            std::cout<<"Invalid input"<<std::endl;
-            continue;
-        }
-
-        switch(choice)
-        {
-            case 1:
-                if(player->hasResourcesForSettlement())
-                {   
-                    if(tryBuildSettelment(player, false, false)) 
-                    {
-                        return true;
-                    }
-                }
-
-                std::cout<<"Not enough resources to build settlement"<<std::endl;
-                break;
-
-            case 2:
-                if(player->hasResourcesForCity())
-                {
-                    if(tryBuildSettelment(player, true, false))
-                    {
-                        return true;
-                    }
-                }
-                std::cout<<"Not enough resources to build city"<<std::endl;
-                break;
-
-            case 3:
-                return false;
-
-            default:
-                break;
-        }
-    }
-    return false;
+    std::cout<<*player<<std::endl;
 }
 
-bool tryBuildSettelment(Player* player, bool isCity, bool startGame)
+void printCurrentGameData()
 {
-    std::string rowStr, colStr;
-    std::cout<<"Enter row: ";
-    std::cin>>rowStr;
-    std::cout<<"Enter col: ";
-    std::cin>>colStr;
-
-    // try to parse to int
-    int row, col;
-    try{
-        row = std::stoi(rowStr);
-        col = std::stoi(colStr);
-    }catch(std::invalid_argument& e){
-        std::cout<<"Invalid input"<<std::endl;
-        return false;
+    board->printBoard();
+    std::cout<<"Harbors: ";
+    for(const catan_game::Harbor& harbor: board->getHarbors())
+    {
+        std::cout<<(harbor.isGeneric ? std::string("3:1") : "2:1 " + catan_game::tileTypeToString(harbor.resource))
+                 <<" "<<*harbor.first<<"-"<<*harbor.second<<", ";
     }
-
-    // check if the vertex is buildable
-    Vertex* ver = board->placeSettlement(row, col, player, isCity, startGame);
-    if(ver != nullptr)
+    std::cout<<std::endl;
+    for(Player* player: players)
     {
-        std::cout<<player->getUsername()<<": Settlement placed in: "<<*ver<<std::endl;
-        return true;
+        std::cout<<*player<<std::endl;
     }
-    return false;
 }
 
-bool cardsOptions(Player *player)
+// Play a progress card through the game's rules, the knight is option 8 of the turn menu.
+// The cards don't end the turn, false only when the input is closed.
+bool cardsOptions(Game& game, size_t seat)
 {
-
+    Player* player = players[seat];
     std::cout<<"Development Cards Options:"<<std::endl;
     player->printMyCards();
     std::cout<<"1. Play Road Building Card"<<std::endl;
@@ -739,271 +486,224 @@ bool cardsOptions(Player *player)
     std::cout<<"4. Cancel"<<std::endl;
 
     int choice;
-    try
-    {
-        std::cin>>choice;
-    }
-    catch(std::invalid_argument& e)
-    {
-        std::cout<<"Invalid input"<<std::endl;
-        return false;
-    }
+    if(!readInt(choice)) return false;
 
+    ActionStatus status = ActionStatus::Ok;
+    TileType type;
     switch(choice)
     {
         case 1:
-            for(auto playerCard: player->getMyDevelopmentCards())
+            status = game.playRoadBuilding(seat);
+            if(status == ActionStatus::Ok)
             {
-                if(playerCard->getName().compare("Road Building") == 0)
-                {
-                    if(playRoadBuildingCard(player))
-                    {
-                        player->removeDevelopmentCard(playerCard);
-                        return true; // road building card get 2 roads and finish its turn
-                    }
-                    break;
-                }
+                std::cout<<"Your next "<<game.getFreeRoads()<<" roads of this turn are free, build them with option 2"<<std::endl;
             }
-            std::cout<<"No Road Building Card"<<std::endl;
             break;
 
         case 2:
-            for(auto playerCard: player->getMyDevelopmentCards())
+        {
+            ResourceVector taken = catan_game::makeResourceVector(0, 0, 0, 0, 0);
+            std::cout<<"Choose two resources to take: Clay, Tree, Wool, Crop, Iron"<<std::endl;
+            for(int card = 0; card < catan_game::YEAR_OF_PLENTY_CARDS; ++card)
             {
-                if(playerCard->getName().compare("Year of Plenty") == 0)
-                {                   
-                    yearOfPlentyCardOptions(player);
-                    player->removeDevelopmentCard(playerCard);
-                    return false; // year of plenty get resources and continue its turn
-                }
-                break;
+                std::cout<<"Enter resource "<<card + 1<<": ";
+                if(!readResource(type)) return !std::cin.eof();
+                ++taken[type];
+            }
+            status = game.playYearOfPlenty(seat, taken);
+            if(status == ActionStatus::Ok)
+            {
+                std::cout<<resourcesText(taken)<<" added successfully"<<std::endl;
             }
-
-            std::cout<<"No Year of Plenty Card"<<std::endl;
             break;
+        }
 
         case 3:
-            for(auto playerCard: player->getMyDevelopmentCards())
+        {
+            std::cout<<"Enter the Resource you want to ask for: ";
+            std::cout<<"Resources Options: Tree, Clay, Crop, Wool, Iron"<<std::endl;
+            if(!readResource(type)) return !std::cin.eof();
+            int before = player->getResourceVector()[type];
+            status = game.playMonopoly(seat, type);
+            if(status == ActionStatus::Ok)
             {
-                if(playerCard->getName().compare("Monopoly") == 0)
-                {
-                    playMonopolyCard(player);
-                    player->removeDevelopmentCard(playerCard);
-                    return true; // Monopoly get resource or card from player and finish its turn
-                }
+                std::cout<<"You took "<<player->getResourceVector()[type] - before<<" "<<catan_game::tileTypeToString(type)<<std::endl;
             }
-            std::cout<<"No Monopoly Card"<<std::endl;
             break;
-
-        case 4:
-            return false;
+        }
 
         default:
-            break;
-    }
-    return false;
-}
-
-
-void openTrade(Player* player)
-{
-    std::cout<<"Trade:"<<std::endl;
-    std::cout<<"**** Note! You can only offer or demand one resource at a time ****"<<std::endl;
-    std::cout<<"**** Note! Invalid input will lead to cancel the trade ****"<<std::endl;
-    std::string offer, demand, trade;
-    int numResOffer, numResDemand, accept;
-    std::unordered_map<TileType, int> playerRes, otherRes;
-
-    std::cout<<"\nEnter the Resource you want to offer: ";
-    std::cout<<"Resources Options: Tree, Clay, Crop, Wool, Iron"<<std::endl;
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    std::cin>>offer;
-    std::cout<<"Enter amount: ";
-    try
-    {
-        std::cin>>numResOffer;
-    }
-    catch(const std::exception& e)
-    {
-        std::cout<<"Invalid number"<<std::endl;
-        return;
+            return true;
     }
 
-    TileType typeOffer = catan_game::stringToTileType(offer);
-    if(typeOffer == TileType::Sand)
+    if(status != ActionStatus::Ok)
     {
-        std::cout<<"Invalid Resource Offer"<<std::endl;
-        return;
+        std::cout<<"Card rejected: "<<catan_game::actionStatusToString(status)<<std::endl;
     }
+    return true;
+}
 
-    std::cout<<"Enter the Resource you want to demand: ";
-    std::cout<<"Resources Options: Tree, Clay, Crop, Wool, Iron"<<std::endl;
-    std::cin>>demand;
-    std::cout<<"Enter amount: ";
+// Read the name of a resource, false when the name isn't one or the input is closed
+bool readResource(TileType& type)
+{
+    std::string name;
+    if(!(std::cin>>name)) return false;
     try
     {
-        std::cin>>numResDemand;
+        type = catan_game::stringToTileType(name);
     }
-    catch(const std::exception& e)
+    catch(const std::invalid_argument& e)
     {
-        std::cout<<"Invalid number"<<std::endl;
-        return;
+        type = TileType::Sand;
     }
-
-    TileType typeDemand = catan_game::stringToTileType(demand);
-    if(TileType::Sand == typeDemand)
+    if(type == TileType::Sand)
     {
-        std::cout<<"Invalid Resource Demand"<<std::endl;
-        return;
+        std::cout<<"Invalid resource type"<<std::endl;
+        return false;
     }
+    return true;
+}
 
-    else if(numResDemand <= 0 || numResOffer <= 0)
-    {
-        std::cout<<"Invalid Number of resources"<<std::endl;
-        return;
-    }
 
-    playerRes = player->getMyResources();
+// Post an offer to the game's trade book, every other player in turn may take it or counter it
+void openTrade(Game& game, size_t seat)
+{
+    Player* player = players[seat];
+    std::cout<<"Trade:"<<std::endl;
+    std::cout<<"**** Note! Invalid input will lead to cancel the trade ****"<<std::endl;
+    ResourceVector give = catan_game::makeResourceVector(0, 0, 0, 0, 0);
+    ResourceVector want = give;
+
+    std::cout<<"\nEnter the amounts you offer (Tree Clay Crop Wool Iron): ";
+    if(!readResourceVector(give)) return;
+    std::cout<<"Enter the amounts you demand (Tree Clay Crop Wool Iron): ";
+    if(!readResourceVector(want)) return;
 
-    auto itPlayer = playerRes.find(typeOffer);
-    if(itPlayer == playerRes.end())
+    const catan_game::TradeBook& tradeBook = game.getTradeBook();
+    size_t numOfFills = tradeBook.getNumOfFills();
+    ActionStatus status = game.postTrade(seat, give, want);
+    if(status != ActionStatus::Ok)
     {
-            std::cout<<"Invalid Resource Demand"<<std::endl;
-            return;
+        std::cout<<"Trade rejected: "<<catan_game::actionStatusToString(status)<<std::endl;
+        return;
     }
-    if(itPlayer->second < numResOffer)
+    if(tradeBook.getNumOfFills() > numOfFills)
     {
-        std::cout<<"Not enough resources to offer"<<std::endl;
+        std::cout<<"Trade Succeeded"<<std::endl;
         return;
     }
 
-    std::cout<<"\n****Offer: "<<numResOffer<<" "<<offer<<" For: "<<numResDemand<<" "<<demand<<"****"<<std::endl;
-    for(Player* otherPlayer: players)
+    int offerId = tradeBook.getOffers().back().id;
+    std::cout<<"\n****Offer: "<<resourcesText(give)<<" For: "<<resourcesText(want)<<"****"<<std::endl;
+    for(size_t other = 0; other < players.size(); ++other)
     {
-        otherRes = otherPlayer->getMyResources();
-        auto itOther = otherRes.find(typeDemand);
-        if(itOther == otherRes.end())
-        {
-            std::cout<<"Invalid Resource Demand"<<std::endl;
-            return;
-        }
-        if(itOther->second < numResDemand)
+        if(other == seat) continue;
+
+        std::cout<<"Hey, "<<players[other]->getUsername()<<" Trade request arrived from "<<player->getUsername()<<std::endl;
+        std::cout<<"1. Accept"<<std::endl;
+        std::cout<<"2. Counter offer"<<std::endl;
+        std::cout<<"Anything else to pass: ";
+        int choice;
+        if(!readInt(choice)) return;
+
+        if(choice == 1)
         {
-            continue;
+            status = game.acceptTrade(other, offerId);
+            if(status == ActionStatus::Ok)
+            {
+                std::cout<<"Trade Succeeded"<<std::endl;
+                return;
+            }
+            std::cout<<"Trade rejected: "<<catan_game::actionStatusToString(status)<<std::endl;
         }
-        if(!(otherPlayer == player))
+        else if(choice == 2)
         {
-            std::cout<<"Hey, "<<otherPlayer->getUsername()<<" Trade request arrived from"<<player->getUsername()<<" To accept the offer enter '1' or anything else to cancel: ";
-            try
+            ResourceVector counterGive = catan_game::makeResourceVector(0, 0, 0, 0, 0);
+            ResourceVector counterWant = counterGive;
+            std::cout<<"Enter the amounts you offer (Tree Clay Crop Wool Iron): ";
+            if(!readResourceVector(counterGive)) return;
+            std::cout<<"Enter the amounts you demand (Tree Clay Crop Wool Iron): ";
+            if(!readResourceVector(counterWant)) return;
+
+            numOfFills = tradeBook.getNumOfFills();
+            status = game.postTrade(other, counterGive, counterWant, -1, offerId);
+            if(status != ActionStatus::Ok)
             {
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                std::cin>>accept;
+                std::cout<<"Counter offer rejected: "<<catan_game::actionStatusToString(status)<<std::endl;
+                continue;
             }
-            catch(const std::exception& e)
+            if(tradeBook.getNumOfFills() > numOfFills)
             {
-                std::cout<<"Invalid number"<<std::endl;
-                continue;
+                std::cout<<"Trade Succeeded"<<std::endl; // the counter offer covered the original one
+                return;
             }
 
-            if(accept == 1)
+            int counterId = tradeBook.getOffers().back().id;
+            std::cout<<player->getUsername()<<", counter offer: "<<resourcesText(counterGive)<<" For: "<<resourcesText(counterWant)<<std::endl;
+            std::cout<<"To accept the counter offer enter '1' or anything else to decline: ";
+            if(!readInt(choice)) return;
+            if(choice == 1 && game.acceptTrade(seat, counterId) == ActionStatus::Ok)
             {
-                std::cout<<"Test offer: "<<tileTypeToString(typeOffer)<<" Test Demand: "<<tileTypeToString(typeDemand)<<" Test num Offer: "<<numResOffer<<" Test num Demand: "<<numResDemand<<std::endl;
-                otherPlayer->addResources(typeOffer, numResOffer);
-                player->addResources(typeDemand, numResDemand);
-                player->removeResources(typeOffer, numResOffer);
-                otherPlayer->removeResources(typeDemand, numResDemand);
-                
                 std::cout<<"Trade Succeeded"<<std::endl;
+                game.cancelTrade(seat, offerId);
                 return;
             }
+            game.cancelTrade(other, counterId);
         }
-        std::cout<<"Player has not accepted or dont have the resources you demand!"<<std::endl;
-            
     }
 
-   std::cout<<"\n Other Players might not have the resources you asked for.\n"<<std::endl;
+    std::cout<<"\nNobody took the offer.\n"<<std::endl;
+    game.cancelTrade(seat, offerId);
 }
 
-void yearOfPlentyCardOptions(Player *player)
+// Trade with the bank at the player's rates (4:1, or 3:1/2:1 with a harbor)
+void bankTrade(Game& game, size_t seat)
 {
-    for(;;)
+    Player* player = players[seat];
+    std::cout<<"Bank Trade, your rates:";
+    for(int type = 0; type < catan_game::NUM_RESOURCE_TYPES; ++type)
     {
-        std::cout << "Choose two resources to take: Clay, Tree, Wool, Crop, Iron\n";
-        std::string resource1;
-        std::string resource2;
-        std::cout<<"Enter the first resource: ";
-        std::cin >> resource1;
-        std::cout<<"Enter the second resource: ";
-        std::cin >> resource2;
-        TileType type1;
-        TileType type2;
-        try
-        {
-            type1 = catan_game::stringToTileType(resource1); 
-            type2 = catan_game::stringToTileType(resource2);
-            if(type1 == TileType::Sand || type2 == TileType::Sand)
-            {
-                throw std::invalid_argument("Invalid resource type.");
-            }
-        }
-        catch(const std::invalid_argument& e)
-        {
-            std::cout << "Invalid resource type." << std::endl;
-            continue;
-        }
-        
-        player->addResources(type1, 1);
-        player->addResources(type2, 1);
-        std::cout<<resource1<<", "<<resource2<<" added successfully.\n";
-        break;
+        std::cout<<" "<<catan_game::tileTypeToString(static_cast<TileType>(type))<<" "<<player->getTradeRate(static_cast<TileType>(type))<<":1";
     }
-}
+    std::cout<<std::endl;
 
-bool isGameOver()
-{
-    //Todo: implement counter for the players that have 10 points - 
-    //consider: buildings, longest road, largest army, etc.
-    for(Player* player: players)
+    ResourceVector give = catan_game::makeResourceVector(0, 0, 0, 0, 0);
+    ResourceVector want = give;
+    std::cout<<"Enter the amounts you give (Tree Clay Crop Wool Iron): ";
+    if(!readResourceVector(give)) return;
+    std::cout<<"Enter the amounts you get (Tree Clay Crop Wool Iron): ";
+    if(!readResourceVector(want)) return;
+
+    ActionStatus status = game.bankTrade(seat, give, want);
+    if(status == ActionStatus::Ok)
     {
-        if(player->getMyPoints() >= 10)
-        {
-            std::cout<<player->getUsername()<<" wins!"<<std::endl;
-            return true;
-        }
+        std::cout<<"Trade Succeeded"<<std::endl;
+        return;
     }
-    return false;
+    std::cout<<"Trade rejected: "<<catan_game::actionStatusToString(status)<<std::endl;
 }
 
-// Free the players
-void deletePlayers()
+// read the 5 amounts of a resource vector, false when the input is closed
+bool readResourceVector(ResourceVector& amounts)
 {
-    for(Player* player: players)
+    for(int type = 0; type < catan_game::NUM_RESOURCE_TYPES; ++type)
     {
-        if(player != nullptr){
-            delete player;
-            player = nullptr;
-        }
+        if(!readInt(amounts[type])) return false;
     }
+    return true;
 }
 
-// Free the development cards
-void deleteCards()
+// e.g. "2 Tree 1 Iron"
+std::string resourcesText(const ResourceVector& amounts)
 {
-    for(Card* deckCard: deckCards)
-    {
-        if(deckCard != nullptr)
-        {
-            delete deckCard;
-            deckCard = nullptr;
-        }
-    }
-
-    for(Card* usedCard: usedCards)
+    std::string text;
+    for(int type = 0; type < catan_game::NUM_RESOURCE_TYPES; ++type)
     {
-        if(usedCard != nullptr){
-            delete usedCard;
-            usedCard = nullptr;
-        }
+        if(amounts[type] == 0) continue;
+        if(!text.empty()) text += " ";
+        text += std::to_string(amounts[type]) + " " + catan_game::tileTypeToString(static_cast<TileType>(type));
     }
+    return text;
 }
-#endif
\ No newline at end of file
+
+#endif
@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Action.hpp"
+#include "GameArchive.hpp"
+
+using catan_game::Action;
+using catan_game::ArchivedGame;
+using catan_game::GameArchiveReader;
+
+// Usage: catan_archive <path> [--seed S]
+// Scans an archive of finished games in place - the games, the wins of every seat, the average length
+// and how many games ended in every bucket of turns.
+// --seed prints the actions of the first game of the seed.
+int main(int argc, char* argv[])
+{
+    if(argc != 2 && !(argc == 4 && std::strcmp(argv[2], "--seed") == 0))
+    {
+        std::cerr<<"Usage: "<<argv[0]<<" <path> [--seed S]"<<std::endl;
+        return 1;
+    }
+
+    try
+    {
+        GameArchiveReader archive(argv[1]);
+        if(argc == 4)
+        {
+            const ArchivedGame* game = archive.findSeed(static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)));
+            if(game == nullptr)
+            {
+                std::cerr<<"No game of seed "<<argv[3]<<std::endl;
+                return 1;
+            }
+            Action action;
+            for(size_t index = 0; archive.getAction(*game, index, action); ++index)
+            {
+                std::cout<<static_cast<int>(action.seat)<<" "<<catan_game::actionToString(action)<<std::endl;
+            }
+            std::cout<<"Winner "<<static_cast<int>(game->winner)<<" after "<<game->numOfTurns<<" turns"<<std::endl;
+            return 0;
+        }
+
+        size_t numOfTurns = 0, numOfActions = 0;
+        for(const ArchivedGame& game: archive.getGames())
+        {
+            numOfTurns += game.numOfTurns;
+            numOfActions += game.numOfActions;
+        }
+        std::cout<<archive.size()<<" games, "<<numOfActions<<" actions"<<std::endl;
+        for(int seat = 0; seat < static_cast<int>(catan_game::ARCHIVE_MAX_SEATS); ++seat)
+        {
+            size_t wins = archive.getGamesWonBy(seat).size();
+            if(wins > 0) std::cout<<"Seat "<<seat<<" won "<<wins<<std::endl;
+        }
+        if(archive.size() > 0) std::cout<<"Unfinished "<<archive.getGamesWonBy(-1).size()<<", turns per game "<<numOfTurns / archive.size()<<std::endl;
+        for(size_t bucket = 0; bucket < catan_game::ARCHIVE_NUM_TURN_BUCKETS; ++bucket)
+        {
+            size_t games = archive.getGamesOfTurnBucket(bucket).size();
+            if(games > 0) std::cout<<"Turns from "<<bucket * catan_game::ARCHIVE_TURN_BUCKET_WIDTH<<": "<<games<<std::endl;
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr<<e.what()<<std::endl;
+        return 1;
+    }
+    return 0;
+}
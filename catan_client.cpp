@@ -0,0 +1,241 @@
+// Test client for catan_server - replays a scripted game against the server.
+//
+// Script format, one action per line (empty lines and lines starting with '#' are ignored):
+//   <seat> <command ...>        e.g. "0 SETTLE 0 2" or "1 ROLL"
+// Every seat of the script gets its own connection and is joined first. With a games count
+// bigger than 1 the same script is replayed on that many tables at once, interleaving the actions.
+// With -b the actions are sent as binary frames (STATE lines are skipped, it has no frame).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Action.hpp"
+
+using namespace catan_game;
+
+struct ScriptLine {
+    size_t seat;
+    std::string command;
+};
+
+struct ServerConnection {
+    int fd;
+    std::string buffer;
+};
+
+static int connectTo(const std::string& path)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        if(fd >= 0) ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendLine(ServerConnection& connection, const std::string& line)
+{
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while(sent < data.size())
+    {
+        ssize_t numOfBytes = ::send(connection.fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if(numOfBytes <= 0) return false;
+        sent += static_cast<size_t>(numOfBytes);
+    }
+    return true;
+}
+
+// Read lines until the reply of the request ("OK..." or "ERR..."), events before it are skipped
+static bool readReply(ServerConnection& connection, std::string& reply, bool verbose)
+{
+    for(;;)
+    {
+        size_t end = connection.buffer.find('\n');
+        if(end != std::string::npos)
+        {
+            std::string line = connection.buffer.substr(0, end);
+            connection.buffer.erase(0, end + 1);
+            if(line.compare(0, 2, "OK") == 0 || line.compare(0, 3, "ERR") == 0)
+            {
+                reply = line;
+                return true;
+            }
+            if(verbose) std::cout<<"  event: "<<line<<std::endl;
+            continue;
+        }
+
+        char chunk[4096];
+        ssize_t numOfBytes = ::read(connection.fd, chunk, sizeof(chunk));
+        if(numOfBytes <= 0) return false;
+        connection.buffer.append(chunk, static_cast<size_t>(numOfBytes));
+    }
+}
+
+static bool sendFrame(ServerConnection& connection, const Action& action)
+{
+    uint8_t frame[ACTION_WIRE_SIZE];
+    encodeAction(action, frame);
+    return ::send(connection.fd, frame, ACTION_WIRE_SIZE, MSG_NOSIGNAL) == static_cast<ssize_t>(ACTION_WIRE_SIZE);
+}
+
+// Read frames until the Result frame of the request, event frames before it are skipped
+static bool readResult(ServerConnection& connection, std::string& reply, bool verbose)
+{
+    for(;;)
+    {
+        while(connection.buffer.size() >= ACTION_WIRE_SIZE)
+        {
+            Action action;
+            bool isDecoded = decodeAction(reinterpret_cast<const uint8_t*>(connection.buffer.data()), action);
+            connection.buffer.erase(0, ACTION_WIRE_SIZE);
+            if(!isDecoded) continue;
+            if(action.opcode == ActionOpcode::Result)
+            {
+                ActionStatus status = static_cast<ActionStatus>(action.target);
+                reply = (status == ActionStatus::Ok) ? std::string("OK") : "ERR " + actionStatusToString(status);
+                return true;
+            }
+            if(verbose) std::cout<<"  event: "<<actionToString(action)<<std::endl;
+        }
+
+        char chunk[4096];
+        ssize_t numOfBytes = ::read(connection.fd, chunk, sizeof(chunk));
+        if(numOfBytes <= 0) return false;
+        connection.buffer.append(chunk, static_cast<size_t>(numOfBytes));
+    }
+}
+
+static bool loadScript(const std::string& fileName, std::vector<ScriptLine>& script, size_t& numOfSeats)
+{
+    std::ifstream file(fileName);
+    if(!file) return false;
+
+    std::string line;
+    numOfSeats = 0;
+    while(std::getline(file, line))
+    {
+        if(line.empty() || line[0] == '#') continue;
+        std::istringstream lineStream(line);
+        ScriptLine scriptLine;
+        if(!(lineStream >> scriptLine.seat)) continue;
+        std::getline(lineStream >> std::ws, scriptLine.command);
+        numOfSeats = std::max(numOfSeats, scriptLine.seat + 1);
+        script.push_back(scriptLine);
+    }
+    return true;
+}
+
+// Usage: catan_client <socket path> <script> [games] [-v] [-b]
+int main(int argc, char* argv[])
+{
+    if(argc < 3)
+    {
+        std::cerr<<"Usage: "<<argv[0]<<" <socket path> <script> [games] [-v] [-b]"<<std::endl;
+        return 1;
+    }
+
+    std::string socketPath = argv[1];
+    size_t numOfGames = (argc > 3) ? static_cast<size_t>(std::atoi(argv[3])) : 1;
+    bool verbose = false;
+    bool binary = false;
+    for(int arg = 4; arg < argc; ++arg)
+    {
+        if(std::string(argv[arg]) == "-v") verbose = true;
+        if(std::string(argv[arg]) == "-b") binary = true;
+    }
+
+    std::vector<ScriptLine> script;
+    size_t numOfSeats = 0;
+    if(!loadScript(argv[2], script, numOfSeats) || numOfSeats == 0)
+    {
+        std::cerr<<"Cannot read script "<<argv[2]<<std::endl;
+        return 1;
+    }
+
+    // Tables are filled in join order, so every game joins all of its seats before the next one
+    std::vector<std::vector<ServerConnection>> games(numOfGames);
+    std::string reply;
+    for(size_t game = 0; game < numOfGames; ++game)
+    {
+        for(size_t seat = 0; seat < numOfSeats; ++seat)
+        {
+            ServerConnection connection{connectTo(socketPath), std::string()};
+            if(connection.fd < 0)
+            {
+                std::cerr<<"Cannot connect to "<<socketPath<<std::endl;
+                return 1;
+            }
+            games[game].push_back(connection);
+            if(!sendLine(games[game].back(), "JOIN Seat" + std::to_string(seat)) || !readReply(games[game].back(), reply, verbose))
+            {
+                std::cerr<<"Join failed"<<std::endl;
+                return 1;
+            }
+            if(binary && (!sendLine(games[game].back(), "BINARY") || !readReply(games[game].back(), reply, verbose)))
+            {
+                std::cerr<<"Binary mode failed"<<std::endl;
+                return 1;
+            }
+        }
+    }
+
+    size_t numOfErrors = 0;
+    size_t numOfActions = 0;
+    double totalMicros = 0, maxMicros = 0;
+    for(const ScriptLine& line: script)
+    {
+        Action action;
+        if(binary && !parseAction(line.command.c_str(), line.seat, action)) continue;
+
+        for(size_t game = 0; game < numOfGames; ++game)
+        {
+            ServerConnection& connection = games[game][line.seat];
+            auto start = std::chrono::steady_clock::now();
+            bool isAnswered = binary ? sendFrame(connection, action) && readResult(connection, reply, verbose)
+                                     : sendLine(connection, line.command) && readReply(connection, reply, verbose);
+            if(!isAnswered)
+            {
+                std::cerr<<"Connection lost"<<std::endl;
+                return 1;
+            }
+            double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            totalMicros += micros;
+            ++numOfActions;
+            maxMicros = std::max(maxMicros, micros);
+
+            if(reply.compare(0, 3, "ERR") == 0) ++numOfErrors;
+            if(verbose || (numOfGames == 1 && reply.compare(0, 3, "ERR") == 0))
+            {
+                std::cout<<"game "<<game<<" seat "<<line.seat<<" "<<line.command<<" -> "<<reply<<std::endl;
+            }
+        }
+    }
+
+    for(auto& game: games)
+    {
+        for(ServerConnection& connection: game)
+        {
+            ::close(connection.fd);
+        }
+    }
+
+    std::cout<<"Replayed "<<numOfActions<<" actions on "<<numOfGames<<" tables, "<<numOfErrors<<" rejected"<<std::endl;
+    std::cout<<"Latency avg "<<(numOfActions ? totalMicros / numOfActions : 0)<<"us, max "<<maxMicros<<"us"<<std::endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+/* Example agent plugin - plays random legal actions, builds before anything else and ends its turn after
+ * a few other actions. Build with: gcc -std=c11 -Wall -O2 -fPIC -shared -o catan_random_agent.so catan_random_agent.c */
+
+#include <stdlib.h>
+#include "AgentPluginApi.h"
+
+#define MAX_OTHER_ACTIONS_PER_TURN 4
+
+typedef struct RandomAgent {
+    uint32_t state;
+    uint32_t otherActions;
+} RandomAgent;
+
+static uint32_t nextRandom(RandomAgent* agent)
+{
+    /* xorshift32 */
+    uint32_t x = agent->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    agent->state = x;
+    return x;
+}
+
+static void* create(uint32_t seat, uint32_t seed)
+{
+    RandomAgent* agent = calloc(1, sizeof(RandomAgent));
+    if(agent == NULL) return NULL;
+    agent->state = (seed * 2654435761u) ^ (seat + 1) * 40503u;
+    if(agent->state == 0) agent->state = 1;
+    return agent;
+}
+
+static void destroy(void* agent)
+{
+    free(agent);
+}
+
+static int isBuild(uint8_t opcode)
+{
+    return opcode == CATAN_OP_BUILD_CITY || opcode == CATAN_OP_BUILD_SETTLEMENT || opcode == CATAN_OP_BUILD_ROAD;
+}
+
+/* A random frame among those whose opcode passes the filter, -1 when none does */
+static int32_t pickRandom(RandomAgent* agent, const uint8_t* frames, uint32_t numOfLegal, int (*accept)(uint8_t))
+{
+    uint32_t count = 0;
+    for(uint32_t index = 0; index < numOfLegal; ++index)
+    {
+        if(accept(frames[index * CATAN_ACTION_SIZE])) ++count;
+    }
+    if(count == 0) return -1;
+    uint32_t chosen = nextRandom(agent) % count;
+    for(uint32_t index = 0; index < numOfLegal; ++index)
+    {
+        if(accept(frames[index * CATAN_ACTION_SIZE]) && chosen-- == 0) return (int32_t)index;
+    }
+    return -1;
+}
+
+static int isAny(uint8_t opcode)
+{
+    return 1;
+}
+
+static int isOther(uint8_t opcode)
+{
+    return opcode != CATAN_OP_END_TURN && opcode != CATAN_OP_POST_TRADE && opcode != CATAN_OP_CANCEL_TRADE && !isBuild(opcode);
+}
+
+static int isEndTurn(uint8_t opcode)
+{
+    return opcode == CATAN_OP_END_TURN;
+}
+
+static int32_t choosePlacement(void* agent, const CatanGameView* view, const uint8_t* legalFrames, uint32_t numOfLegal)
+{
+    return pickRandom(agent, legalFrames, numOfLegal, isAny);
+}
+
+static int32_t chooseAction(void* opaque, const CatanGameView* view, const uint8_t* legalFrames, uint32_t numOfLegal)
+{
+    RandomAgent* agent = opaque;
+    if(view->phase != CATAN_PHASE_MAIN) return pickRandom(agent, legalFrames, numOfLegal, isAny);
+
+    int32_t chosen = pickRandom(agent, legalFrames, numOfLegal, isBuild);
+    if(chosen < 0 && agent->otherActions < MAX_OTHER_ACTIONS_PER_TURN)
+    {
+        chosen = pickRandom(agent, legalFrames, numOfLegal, isOther);
+        if(chosen >= 0) ++agent->otherActions;
+    }
+    if(chosen < 0)
+    {
+        chosen = pickRandom(agent, legalFrames, numOfLegal, isEndTurn);
+        agent->otherActions = 0;
+    }
+    return chosen;
+}
+
+/* One card at a time from a random non empty pile */
+static void chooseDiscard(void* agent, const CatanGameView* view, int32_t numOfCards, int8_t discard[CATAN_NUM_RESOURCES])
+{
+    int16_t hand[CATAN_NUM_RESOURCES];
+    int type, total = 0;
+    for(type = 0; type < CATAN_NUM_RESOURCES; ++type)
+    {
+        hand[type] = view->hands[view->seat][type];
+        total += hand[type];
+    }
+    if(numOfCards > total) numOfCards = total;
+    while(numOfCards > 0)
+    {
+        type = nextRandom(agent) % CATAN_NUM_RESOURCES;
+        if(hand[type] == 0) continue;
+        --hand[type];
+        ++discard[type];
+        --numOfCards;
+    }
+}
+
+/* Takes any trade that leaves it with more cards than it gives */
+static int32_t acceptTrade(void* agent, const CatanGameView* view, uint32_t fromSeat,
+                           const int8_t give[CATAN_NUM_RESOURCES], const int8_t want[CATAN_NUM_RESOURCES])
+{
+    int got = 0, paid = 0, type;
+    for(type = 0; type < CATAN_NUM_RESOURCES; ++type)
+    {
+        got += give[type];
+        paid += want[type];
+    }
+    return got > paid;
+}
+
+static int32_t chooseMonopoly(void* agent, const CatanGameView* view)
+{
+    return (int32_t)(nextRandom(agent) % CATAN_NUM_RESOURCES);
+}
+
+static void chooseYearOfPlenty(void* agent, const CatanGameView* view, int8_t taken[CATAN_NUM_RESOURCES])
+{
+    ++taken[nextRandom(agent) % CATAN_NUM_RESOURCES];
+    ++taken[nextRandom(agent) % CATAN_NUM_RESOURCES];
+}
+
+static const CatanAgentApi api = {
+    CATAN_AGENT_ABI_VERSION,
+    sizeof(CatanAgentApi),
+    "random",
+    create,
+    destroy,
+    choosePlacement,
+    chooseAction,
+    chooseDiscard,
+    acceptTrade,
+    chooseMonopoly,
+    chooseYearOfPlenty
+};
+
+const CatanAgentApi* catan_agent_api(void)
+{
+    return &api;
+}
@@ -0,0 +1,56 @@
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AgentPlugin.hpp"
+#include "GameServer.hpp"
+
+using catan_game::GameServer;
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void onStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+// Usage: catan_server <socket path> [seats per table] [seed] [bot ...]
+// Every bot (a built-in name or the path of an agent plugin .so) takes one of the last seats of every table.
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr<<"Usage: "<<argv[0]<<" <socket path> [seats per table] [seed] [bot ...]"<<std::endl;
+        return 1;
+    }
+
+    std::string socketPath = argv[1];
+    size_t seatsPerTable = (argc > 2) ? static_cast<size_t>(std::atoi(argv[2])) : 3;
+    unsigned seed = (argc > 3) ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    try
+    {
+        std::vector<catan_game::AgentFactory> bots;
+        for(int index = 4; index < argc; ++index)
+        {
+            bots.push_back(catan_game::makeAgentFactory(argv[index]));
+        }
+        GameServer server(socketPath, seatsPerTable, seed, bots);
+        std::cout<<"Serving Catan tables of "<<seatsPerTable<<" on "<<socketPath<<std::endl;
+        while(!stopRequested)
+        {
+            server.pollOnce(100);
+        }
+        std::cout<<"Server stopped, open tables: "<<server.getNumOfTables()<<std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr<<"Server error: "<<e.what()<<std::endl;
+        return 1;
+    }
+    return 0;
+}
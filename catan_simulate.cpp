@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "AgentPlugin.hpp"
+#include "GameArchive.hpp"
+#include "SimulationRunner.hpp"
+#include "TurnStats.hpp"
+
+using catan_game::DeterminismMismatch;
+using catan_game::SimulatedGame;
+using catan_game::SimulationRunner;
+
+// Usage: catan_simulate <games> [first seed] [seats] [--verify] [--archive path] [--turn-stats path] [--bot name|plugin.so ...]
+// Plays the seeds first seed .. first seed + games - 1 on every core and counts the wins of each seat.
+// The --bot agents play the seats in turn, the builder plays them all by default. --archive appends
+// the games to the archive at the path (see catan_archive). --turn-stats writes every seat's points,
+// hand, buildings, roads and cards and the dice at the end of every turn as a columnar file (see TurnStats.hpp).
+// --verify plays every seed twice on two threads in opposite orders and reports the first turn
+// where the two plays of a seed went apart.
+int main(int argc, char* argv[])
+{
+    bool verify = false;
+    const char* archivePath = nullptr;
+    const char* turnStatsPath = nullptr;
+    std::vector<const char*> arguments;
+    std::vector<catan_game::AgentFactory> bots;
+    for(int index = 1; index < argc; ++index)
+    {
+        if(std::strcmp(argv[index], "--verify") == 0) verify = true;
+        else if(std::strcmp(argv[index], "--archive") == 0 && index + 1 < argc) archivePath = argv[++index];
+        else if(std::strcmp(argv[index], "--turn-stats") == 0 && index + 1 < argc) turnStatsPath = argv[++index];
+        else if(std::strcmp(argv[index], "--bot") == 0 && index + 1 < argc)
+        {
+            try
+            {
+                bots.push_back(catan_game::makeAgentFactory(argv[++index]));
+            }
+            catch(const std::exception& e)
+            {
+                std::cerr<<e.what()<<std::endl;
+                return 1;
+            }
+        }
+        else arguments.push_back(argv[index]);
+    }
+    if(arguments.empty())
+    {
+        std::cerr<<"Usage: "<<argv[0]<<" <games> [first seed] [seats] [--verify] [--archive path] [--turn-stats path] [--bot name|plugin.so ...]"<<std::endl;
+        return 1;
+    }
+
+    size_t numOfGames = static_cast<size_t>(std::strtoul(arguments[0], nullptr, 10));
+    unsigned firstSeed = (arguments.size() > 1) ? static_cast<unsigned>(std::strtoul(arguments[1], nullptr, 10)) : 0;
+    size_t numOfSeats = (arguments.size() > 2) ? static_cast<size_t>(std::atoi(arguments[2])) : 3;
+    if(numOfSeats == 0)
+    {
+        std::cerr<<"A game needs at least one seat"<<std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned> seeds(numOfGames);
+    std::iota(seeds.begin(), seeds.end(), firstSeed);
+    SimulationRunner runner(numOfSeats, 400, bots);
+
+    if(verify)
+    {
+        std::vector<DeterminismMismatch> mismatches = runner.verifyDeterminism(seeds);
+        for(const DeterminismMismatch& mismatch: mismatches)
+        {
+            std::cout<<"Seed "<<mismatch.seed<<" diverged at turn "<<mismatch.turn<<": "
+                     <<std::hex<<mismatch.firstHash<<" != "<<mismatch.secondHash<<std::dec<<std::endl;
+        }
+        std::cout<<(numOfGames - mismatches.size())<<" of "<<numOfGames<<" seeds replayed identically"<<std::endl;
+        return mismatches.empty() ? 0 : 2;
+    }
+
+    std::unique_ptr<catan_game::GameArchiveWriter> archive;
+    std::unique_ptr<catan_game::TurnStatsWriter> turnStats;
+    try
+    {
+        if(archivePath != nullptr) archive = std::make_unique<catan_game::GameArchiveWriter>(archivePath);
+        if(turnStatsPath != nullptr) turnStats = std::make_unique<catan_game::TurnStatsWriter>(turnStatsPath);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr<<e.what()<<std::endl;
+        return 1;
+    }
+    std::vector<SimulatedGame> games = runner.playAll(seeds, 0, archive.get(), turnStats.get());
+    std::vector<size_t> wins(numOfSeats, 0);
+    size_t unfinished = 0, forfeits = 0, numOfTurns = 0;
+    for(const SimulatedGame& game: games)
+    {
+        if(game.winner >= 0) ++wins[game.winner];
+        else if(game.forfeitSeat >= 0) ++forfeits;
+        else ++unfinished;
+        numOfTurns += game.turnHashes.size();
+    }
+    for(size_t seat = 0; seat < numOfSeats; ++seat)
+    {
+        std::cout<<"Seat "<<seat<<" won "<<wins[seat]<<std::endl;
+    }
+    std::cout<<"Unfinished "<<unfinished<<", forfeits "<<forfeits<<", turns "<<numOfTurns<<std::endl;
+    return 0;
+}
@@ -1,7 +1,19 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <map>
+#include <new>
+#include <stdexcept>
 #include <string>
 #include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #include "doctest.h"
 #include "Player.hpp"
@@ -15,6 +27,27 @@
 #include "Edge.hpp"
 #include "Vertex.hpp"
 #include "Card.hpp"
+#include "Game.hpp"
+#include "TurnEngine.hpp"
+#include "Action.hpp"
+#include "Resources.hpp"
+#include "GreedyDiscardPolicy.hpp"
+#include "RandomDiscardPolicy.hpp"
+#include "PlacementOptimizer.hpp"
+#include "IncomeDistribution.hpp"
+#include "SearchState.hpp"
+#include "ExpectimaxSearch.hpp"
+#include "SimulationRunner.hpp"
+#include "LadderAgent.hpp"
+#include "RatingTable.hpp"
+#include "Tournament.hpp"
+#include "AgentPlugin.hpp"
+#include "LegalActionList.hpp"
+#include "HeuristicAgent.hpp"
+#include "GameArchive.hpp"
+#include "SpectatorFeed.hpp"
+#include "GameServer.hpp"
+#include "TurnStats.hpp"
 
 using catan_game::Vertex;
 using catan_game::Edge;
@@ -34,6 +67,18 @@ using std::string;
 
 using namespace catan_game;
 
+// Every heap allocation of the test binary is counted, the zero allocation tests look at a window of the count
+static std::atomic<size_t> numOfAllocations{0};
+
+void* operator new(size_t size) {
+    ++numOfAllocations;
+    if(void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
 // Player basic functionalities
 TEST_CASE("Player initialization") {
     Player player("TestPlayer");
@@ -105,9 +150,16 @@ TEST_CASE("Player seven penalty") {
     Player player("TestPlayer");
     player.addResources(TileType::Tree, 10);
     player.addResources(TileType::Clay, 5);
-    player.sevenPenalty();
-    auto resources = player.getMyResources();
+    GreedyDiscardPolicy greedy;
+    CHECK(player.sevenPenalty(greedy) == makeResourceVector(6, 1, 0, 0, 0)); // the largest pile first
     CHECK(player.getNumOfResources() == 8);
+
+    RandomDiscardPolicy random(3);
+    ResourceVector discarded = player.sevenPenalty(random);
+    CHECK(discarded.total() == 4);
+    CHECK(discarded.isNonNegative());
+    CHECK(player.getNumOfResources() == 4);
+    CHECK(player.getResourceVector().isNonNegative());
 }
 
 TEST_CASE("Player equality operator") {
@@ -240,9 +292,9 @@ TEST_CASE("Edge neighbors") {
 
 // Board basic functionalities
 TEST_CASE("Board placing settlement") {
-    Board* board = Board::getBoardInstance();
+    Board board; // own board - the tests must not share placements
     Player player("TestPlayer");
-    Vertex* vertex = board->placeSettlement(2, 9, &player, false, true);
+    Vertex* vertex = board.placeSettlement(2, 9, &player, false, true);
     CHECK(vertex != nullptr);
     CHECK(vertex->getOwner() == &player);
     CHECK(vertex->isSettled() == true);
@@ -250,25 +302,25 @@ TEST_CASE("Board placing settlement") {
 }
 
 TEST_CASE("Board placing road") {
-    Board* board = Board::getBoardInstance();
+    Board board;
     Player player("TestPlayer");
-    board->placeSettlement(0, 3, &player, false, true);
-    board->placeSettlement(1, 4, &player, false, true);
-    Edge* edge = board->placeRoad(0, 3, 0, 4, &player, true);
+    board.placeSettlement(0, 3, &player, false, true);
+    board.placeSettlement(1, 4, &player, false, true);
+    Edge* edge = board.placeRoad(0, 3, 0, 4, &player, true);
     CHECK(edge != nullptr);
     CHECK(edge->getRoadOwner() == &player);
     CHECK(edge->hasRoad() == true);
 }
 
 TEST_CASE("Board resource distribution") {
-    Board* board = Board::getBoardInstance();
+    Board board;
     Player player1("Player1");
     Player player2("Player2");
     Player player3("Player3");
-    Vertex* vertex1 = board->placeSettlement(1, 1, &player1, false, true);
-    Vertex* vertex2 = board->placeSettlement(2, 2, &player2, false, true);
-    Vertex* vertex3 = board->placeSettlement(3, 3, &player3, false, true);
-    board->sendStartingResources();
+    Vertex* vertex1 = board.placeSettlement(1, 1, &player1, false, true);
+    Vertex* vertex2 = board.placeSettlement(2, 2, &player2, false, true);
+    Vertex* vertex3 = board.placeSettlement(3, 3, &player3, false, true);
+    board.sendStartingResources();
     CHECK(vertex1->getOwner()->getNumOfResources() > 0);
     CHECK(vertex2->getOwner()->getNumOfResources() > 0);
     CHECK(vertex3->getOwner()->getNumOfResources() > 0);
@@ -407,3 +459,1930 @@ TEST_CASE("Card largest army - 3 knight cards add and then remove 1") {
     CHECK(player->getMyPoints() == 2);  // No points for Knights
     delete player;
 }
+
+// Game state machine - the non interactive rules used by the server
+TEST_CASE("Game setup is a snake draft of settlement and road") {
+    Game game({"Player1", "Player2", "Player3"}, 1);
+    CHECK(game.getPhase() == GamePhase::SetupSettlement);
+    CHECK(game.getCurrentSeat() == 0);
+    CHECK(game.placeSettlement(1, 0, 4) == ActionStatus::NotYourTurn);
+    CHECK(game.placeSettlement(0, 0, 2) == ActionStatus::Ok);
+    CHECK(game.getPhase() == GamePhase::SetupRoad);
+    CHECK(game.placeRoad(0, 0, 4, 0, 5) == ActionStatus::IllegalPlacement); // must leave the new settlement
+    CHECK(game.placeRoad(0, 0, 2, 0, 3) == ActionStatus::Ok);
+    CHECK(game.placeSettlement(1, 0, 4) == ActionStatus::Ok);
+    CHECK(game.placeRoad(1, 0, 4, 0, 5) == ActionStatus::Ok);
+    CHECK(game.placeSettlement(2, 0, 6) == ActionStatus::Ok);
+    CHECK(game.placeRoad(2, 0, 6, 0, 7) == ActionStatus::Ok);
+    CHECK(game.getCurrentSeat() == 2); // last seat places twice in a row
+    CHECK(game.placeSettlement(2, 0, 7) == ActionStatus::IllegalPlacement); // distance rule
+    CHECK(game.placeSettlement(2, 2, 2) == ActionStatus::Ok);
+    CHECK(game.placeRoad(2, 2, 2, 2, 3) == ActionStatus::Ok);
+    CHECK(game.placeSettlement(1, 2, 5) == ActionStatus::Ok);
+    CHECK(game.placeRoad(1, 2, 5, 2, 6) == ActionStatus::Ok);
+    CHECK(game.placeSettlement(0, 2, 8) == ActionStatus::Ok);
+    CHECK(game.placeRoad(0, 2, 8, 2, 9) == ActionStatus::Ok);
+    CHECK(game.getPhase() == GamePhase::Roll);
+    CHECK(game.getCurrentSeat() == 0);
+    for(Player* player: game.getPlayers()) {
+        CHECK(player->getMyPoints() == 2);
+    }
+}
+
+// Move the robber to the first tile (and victim) the game accepts
+static void moveRobberAnywhere(Game& game, size_t seat) {
+    for(int tile = 0; tile < static_cast<int>(game.getBoard().getTiles().size()); ++tile) {
+        for(int victim = -1; victim < static_cast<int>(game.getNumOfSeats()); ++victim) {
+            if(game.moveRobber(seat, tile, victim) == ActionStatus::Ok) return;
+        }
+    }
+}
+
+// Setup of two seats used by the search, mask and steady state tests
+static void setupTwoSeats(Game& game) {
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(1, 0, 6);
+    game.placeRoad(1, 0, 6, 0, 7);
+    game.placeSettlement(1, 2, 2);
+    game.placeRoad(1, 2, 2, 2, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+}
+
+// One turn of the steady state - roll, rob, play a development card, build what the hand pays for, buy
+// a card, trade with the bank and the next seat, end. Nothing that scores is built or bought past 6 points,
+// so nobody reaches 10 and the game goes on, while the roads run into the seat's supply.
+static void playSteadyTurn(Game& game) {
+    constexpr int MAX_STEADY_POINTS = 6;
+    size_t seat = game.getCurrentSeat();
+    Player* player = game.getPlayers()[seat];
+    game.rollDice(seat);
+    if(game.getPhase() == GamePhase::MoveRobber) moveRobberAnywhere(game, seat);
+    if(game.playKnight(seat) == ActionStatus::Ok) moveRobberAnywhere(game, seat);
+    else if(game.playMonopoly(seat, TileType::Crop) != ActionStatus::Ok) game.playYearOfPlenty(seat, makeResourceVector(0, 0, 1, 1, 0));
+
+    for(const Vertex* vertex: player->getMyBuildings()) {
+        if(!vertex->isCity() && player->getMyPoints() <= MAX_STEADY_POINTS) game.placeCity(seat, vertex->getRow(), vertex->getColumn());
+    }
+    for(const Edge* edge: game.getBoard().getEdges()) {
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        if(player->getMyPoints() <= MAX_STEADY_POINTS) game.placeSettlement(seat, from->getRow(), from->getColumn());
+        if(player->getMyPoints() <= MAX_STEADY_POINTS) game.placeSettlement(seat, to->getRow(), to->getColumn());
+        game.placeRoad(seat, from->getRow(), from->getColumn(), to->getRow(), to->getColumn());
+    }
+    if(player->getMyPoints() <= MAX_STEADY_POINTS) game.buyDevelopmentCard(seat);
+
+    ResourceVector hand = player->getResourceVector();
+    int most = 0, least = 0;
+    for(int type = 1; type < catan_game::NUM_RESOURCE_TYPES; ++type) {
+        if(hand[type] > hand[most]) most = type;
+        if(hand[type] < hand[least]) least = type;
+    }
+    if(most == least) {
+        game.endTurn(seat);
+        return;
+    }
+    ResourceVector give = makeResourceVector(0, 0, 0, 0, 0);
+    ResourceVector want = give;
+    give[most] = player->getTradeRate(static_cast<TileType>(most));
+    want[least] = 1;
+    game.bankTrade(seat, give, want);
+
+    give[most] = 1;
+    size_t other = (seat + 1) % game.getNumOfSeats();
+    if(game.postTrade(seat, give, want, static_cast<int>(other)) == ActionStatus::Ok && !game.getTradeBook().getOffers().empty()) {
+        game.acceptTrade(other, game.getTradeBook().getOffers().back().id);
+    }
+    game.endTurn(seat);
+}
+
+TEST_CASE("Game turn order and phases") {
+    Game game({"Player1", "Player2"}, 7);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(1, 0, 6);
+    game.placeRoad(1, 0, 6, 0, 7);
+    game.placeSettlement(1, 2, 2);
+    game.placeRoad(1, 2, 2, 2, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    CHECK(game.rollDice(1) == ActionStatus::NotYourTurn);
+    CHECK(game.placeRoad(0, 0, 3, 0, 4) == ActionStatus::WrongPhase); // must roll before building
+    for(int turn = 0; turn < 20; ++turn) {
+        size_t seat = game.getCurrentSeat();
+        CHECK(game.rollDice(seat) == ActionStatus::Ok);
+        CHECK(game.getLastRoll() >= 2);
+        CHECK(game.getLastRoll() <= 12);
+        for(size_t other = 0; other < game.getNumOfSeats(); ++other) {
+            int toDiscard = game.getPendingDiscard(other);
+            if(toDiscard == 0) continue;
+            ResourceVector amounts = makeResourceVector(0, 0, 0, 0, 0);
+            for(int type = 0; type < 5 && toDiscard > 0; ++type) {
+                int held = game.getPlayers()[other]->getMyResources().at(static_cast<TileType>(type));
+                amounts[type] = std::min(held, toDiscard);
+                toDiscard -= amounts[type];
+            }
+            CHECK(game.discard(other, amounts) == ActionStatus::Ok);
+        }
+        if(game.getLastRoll() == 7) {
+            CHECK(game.getPhase() == GamePhase::MoveRobber);
+            CHECK(game.endTurn(seat) == ActionStatus::WrongPhase);
+            moveRobberAnywhere(game, seat);
+        }
+        CHECK(game.getPhase() == GamePhase::Main);
+        CHECK(game.endTurn(seat) == ActionStatus::Ok);
+        CHECK(game.getCurrentSeat() == (seat + 1) % 2);
+    }
+}
+
+TEST_CASE("Game refuses pieces past the seat's supply") {
+    Game game({"Player1", "Player2"}, 3);
+    setupTwoSeats(game);
+    Player* player = game.getPlayers()[0];
+    game.rollDice(0);
+    if(game.getPhase() == GamePhase::MoveRobber) moveRobberAnywhere(game, 0);
+    player->addResources(makeResourceVector(40, 40, 40, 40, 40));
+
+    // roads, then settlements, then cities - 9 points at most, the game goes on
+    std::map<ActionStatus, int> refused;
+    for(int pass = 0; pass < 3; ++pass) {
+        for(const Edge* edge: game.getBoard().getEdges()) {
+            const Vertex* from = edge->getVertices().first;
+            const Vertex* to = edge->getVertices().second;
+            ++refused[game.placeRoad(0, from->getRow(), from->getColumn(), to->getRow(), to->getColumn())];
+        }
+    }
+    for(int row = 0; row < game.getBoard().getNumOfRows(); ++row) {
+        for(int col = 0; col < game.getBoard().getNumOfCols(); ++col) {
+            if(game.getBoard().isOnBoard(row, col)) ++refused[game.placeSettlement(0, row, col)];
+        }
+    }
+    std::vector<const Vertex*> buildings(player->getMyBuildings().begin(), player->getMyBuildings().end());
+    for(const Vertex* vertex: buildings) ++refused[game.placeCity(0, vertex->getRow(), vertex->getColumn())];
+
+    CHECK(player->getMyRoads().size() == catan_game::MAX_ROADS);
+    CHECK(player->getMyBuildings().size() == catan_game::MAX_SETTLEMENTS);
+    CHECK(player->getMyPoints() == 9);
+    CHECK(refused[ActionStatus::NoPiecesLeft] > 0);
+    CHECK(game.getPhase() == GamePhase::Main);
+    CHECK(game.placeCity(0, buildings.back()->getRow(), buildings.back()->getColumn()) == ActionStatus::NoPiecesLeft);
+}
+
+TEST_CASE("Game discard must match the penalty") {
+    Game game({"Player1"}, 3);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    Player* player = game.getPlayers()[0];
+    player->addResources(TileType::Tree, 10);
+    while(game.getLastRoll() != 7) {
+        CHECK(game.rollDice(0) == ActionStatus::Ok);
+        if(game.getLastRoll() != 7) game.endTurn(0);
+    }
+    CHECK(game.getPhase() == GamePhase::Discard);
+    int toDiscard = game.getPendingDiscard(0);
+    CHECK(toDiscard == player->getNumOfResources() / 2);
+    CHECK(game.endTurn(0) == ActionStatus::WrongPhase);
+    CHECK(game.discard(0, {toDiscard - 1, 0, 0, 0, 0}) == ActionStatus::InvalidDiscard);
+    CHECK(game.discard(0, {0, 0, 0, 0, 100}) == ActionStatus::InvalidDiscard);
+    int before = player->getNumOfResources();
+    CHECK(game.discard(0, {toDiscard, 0, 0, 0, 0}) == ActionStatus::Ok);
+    CHECK(player->getNumOfResources() == before - toDiscard);
+    CHECK(game.getPhase() == GamePhase::MoveRobber);
+}
+
+TEST_CASE("Game discard policy decides without asking") {
+    Game game({"Player1"}, 3);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(0, &greedy);
+    Player* player = game.getPlayers()[0];
+    player->addResources(TileType::Tree, 10);
+    while(game.getLastRoll() != 7) {
+        int before = player->getNumOfResources();
+        CHECK(game.rollDice(0) == ActionStatus::Ok);
+        if(game.getLastRoll() == 7) {
+            CHECK(player->getNumOfResources() == before - before / 2);
+        }
+        else {
+            game.endTurn(0);
+        }
+    }
+    CHECK(game.getPendingDiscard(0) == 0);
+    CHECK(game.getPhase() == GamePhase::MoveRobber);
+}
+
+// Coroutine turn engine - driven here like a bot would drive it
+TEST_CASE("Turn engine coroutine waits for decisions") {
+    Game game({"Player1", "Player2"}, 11);
+    DecisionChannel channel;
+    TurnTask task = playGame(game, channel);
+    task.start();
+    CHECK(channel.isWaiting());
+    CHECK(channel.getRequest().kind == DecisionKind::SetupSettlement);
+    CHECK(channel.getRequest().seat == 0);
+
+    channel.respond(makeDecision(0, TurnAction::Place, 0, 2));
+    CHECK(channel.getLastStatus() == ActionStatus::Ok);
+    CHECK(channel.getRequest().kind == DecisionKind::SetupRoad);
+    channel.respond(makeDecision(0, TurnAction::Place, 0, 2, 0, 3));
+    channel.respond(makeDecision(1, TurnAction::Place, 0, 3)); // distance rule
+    CHECK(channel.getLastStatus() == ActionStatus::IllegalPlacement);
+    CHECK(channel.getRequest().kind == DecisionKind::SetupSettlement);
+    channel.respond(makeDecision(1, TurnAction::Place, 0, 6));
+    channel.respond(makeDecision(1, TurnAction::Place, 0, 6, 0, 7));
+    channel.respond(makeDecision(1, TurnAction::Place, 2, 2));
+    channel.respond(makeDecision(1, TurnAction::Place, 2, 2, 2, 3));
+    channel.respond(makeDecision(0, TurnAction::Place, 2, 8));
+    channel.respond(makeDecision(0, TurnAction::Place, 2, 8, 2, 9));
+
+    CHECK(channel.getRequest().kind == DecisionKind::Turn);
+    CHECK(channel.getRequest().seat == 0);
+    channel.respond(makeDecision(1, TurnAction::RollDice));
+    CHECK(channel.getLastStatus() == ActionStatus::NotYourTurn);
+    channel.respond(makeDecision(0, TurnAction::RollDice));
+    CHECK(channel.getLastStatus() == ActionStatus::Ok);
+    while(channel.getRequest().kind == DecisionKind::Discard) {
+        size_t seat = channel.getRequest().seat;
+        Decision decision = makeDecision(seat, TurnAction::Discard);
+        int toDiscard = game.getPendingDiscard(seat);
+        for(int type = 0; type < 5; ++type) {
+            int held = game.getPlayers()[seat]->getMyResources().at(static_cast<TileType>(type));
+            decision.amounts[type] = std::min(held, toDiscard);
+            toDiscard -= decision.amounts[type];
+        }
+        channel.respond(decision);
+        CHECK(channel.getLastStatus() == ActionStatus::Ok);
+    }
+    for(int tile = 0; channel.getRequest().kind == DecisionKind::RobberPlacement; ++tile) {
+        channel.respond(makeDecision(0, TurnAction::MoveRobber, tile, -1));
+    }
+
+    // Road flow - the nested coroutine asks for coordinates until cancelled
+    game.getPlayers()[0]->addResources(TileType::Tree, 1);
+    game.getPlayers()[0]->addResources(TileType::Clay, 1);
+    channel.respond(makeDecision(0, TurnAction::BuildRoad));
+    CHECK(channel.getRequest().kind == DecisionKind::RoadPlacement);
+    channel.respond(makeDecision(0, TurnAction::Place, 4, 4, 4, 5));
+    CHECK(channel.getLastStatus() == ActionStatus::IllegalPlacement);
+    CHECK(channel.getRequest().kind == DecisionKind::RoadPlacement);
+    channel.respond(makeDecision(0, TurnAction::Cancel));
+    CHECK(channel.getRequest().kind == DecisionKind::Turn);
+    channel.respond(makeDecision(0, TurnAction::BuildRoad));
+    channel.respond(makeDecision(0, TurnAction::Place, 0, 3, 0, 4));
+    CHECK(channel.getLastStatus() == ActionStatus::Ok);
+    CHECK(game.getPlayers()[0]->getMyRoads().size() == 3);
+
+    channel.respond(makeDecision(0, TurnAction::EndTurn));
+    CHECK(channel.getRequest().kind == DecisionKind::Turn);
+    CHECK(channel.getRequest().seat == 1);
+    CHECK_FALSE(task.isDone());
+}
+
+// A flow that breaks after its first decision, awaited like a sub flow of the game
+static TurnTask brokenFlow(DecisionChannel& channel) {
+    co_await channel.ask(DecisionKind::Turn, 0);
+    throw std::logic_error("broken flow");
+}
+
+static TurnTask awaitBrokenFlow(DecisionChannel& channel) {
+    co_await brokenFlow(channel);
+    channel.report(ActionStatus::Ok); // never reached
+}
+
+TEST_CASE("Turn engine hands an escaped exception to its driver") {
+    DecisionChannel channel;
+    TurnTask task = awaitBrokenFlow(channel);
+    task.start();
+    CHECK(channel.isWaiting());
+    CHECK_NOTHROW(task.rethrowIfFailed());
+    channel.respond(makeDecision(0, TurnAction::EndTurn));
+    CHECK(task.isDone());
+    CHECK_FALSE(channel.isWaiting());
+    CHECK_THROWS_AS(task.rethrowIfFailed(), std::logic_error);
+}
+
+TEST_CASE("Resource vector arithmetic") {
+    ResourceVector hand = makeResourceVector(2, 1, 0, 3, 1);
+    ResourceVector road = makeResourceVector(1, 1, 0, 0, 0);
+
+    CHECK(hand.total() == 7);
+    CHECK(hand.covers(road));
+    CHECK_FALSE(road.covers(hand));
+    CHECK((hand - road) == makeResourceVector(1, 0, 0, 3, 1));
+    CHECK((hand - road + road) == hand);
+    CHECK_FALSE((road - hand).isNonNegative());
+    CHECK((-road)[TileType::Clay] == -1);
+}
+
+TEST_CASE("Action vertex and edge ids") {
+    int row, col, toRow, toCol;
+    CHECK(encodeVertex(0, 2) == 2);
+    CHECK(encodeVertex(0, 0) == -1); // corner outside the board
+    CHECK(decodeVertex(encodeVertex(3, 7), row, col));
+    CHECK((row == 3 && col == 7));
+
+    int edgeId = encodeEdge(0, 3, 0, 2);
+    CHECK(edgeId == encodeEdge(0, 2, 0, 3));
+    CHECK(decodeEdge(edgeId, row, col, toRow, toCol));
+    CHECK((row == 0 && col == 2 && toRow == 0 && toCol == 3));
+
+    CHECK(encodeEdge(0, 2, 1, 2) == 2 * encodeVertex(0, 2) + 1);
+    CHECK(encodeEdge(0, 3, 1, 3) == -1); // no vertical edge down from an odd vertex
+    CHECK(encodeEdge(0, 2, 0, 4) == -1);
+
+    // every edge of the board has an id that decodes back to it
+    Board board;
+    for(const Edge* edge: board.getEdges())
+    {
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        int id = encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn());
+        CHECK(decodeEdge(id, row, col, toRow, toCol));
+    }
+}
+
+TEST_CASE("Action encode and decode round trip") {
+    Action action;
+    REQUIRE(parseAction("ROAD 0 2 0 3", 1, action));
+    CHECK(action.opcode == ActionOpcode::BuildRoad);
+    CHECK(actionToString(action) == "ROAD 0 2 0 3");
+
+    REQUIRE(parseAction("DISCARD 1 0 2 0 1", 2, action));
+    uint8_t frame[ACTION_WIRE_SIZE];
+    encodeAction(action, frame);
+    Action decoded;
+    REQUIRE(decodeAction(frame, decoded));
+    CHECK(decoded.opcode == ActionOpcode::Discard);
+    CHECK(decoded.seat == 2);
+    CHECK(decoded.resources == makeResourceVector(1, 0, 2, 0, 1));
+    CHECK(validateAction(decoded, 3) == ActionStatus::Ok);
+    CHECK(validateAction(decoded, 2) == ActionStatus::MalformedAction);
+
+    REQUIRE(parseAction("ROBBER 4 1", 0, action));
+    CHECK(robberTileOf(action) == 4);
+    CHECK(robberVictimOf(action) == 1);
+    CHECK(actionToString(action) == "ROBBER 4 1");
+    CHECK(validateAction(action, 2) == ActionStatus::Ok);
+    CHECK(validateAction(action, 1) == ActionStatus::MalformedAction);
+
+    frame[0] = static_cast<uint8_t>(ActionOpcode::Count);
+    CHECK_FALSE(decodeAction(frame, decoded));
+
+    CHECK_FALSE(parseAction("SETTLE 0 0", 0, action));
+    CHECK_FALSE(parseAction("ROAD 0 2", 0, action));
+    CHECK_FALSE(parseAction("FLY", 0, action));
+    REQUIRE(parseAction("OFFER -1 2 0 0 0 -1", 0, action));
+    CHECK(action.opcode == ActionOpcode::PostTrade);
+    CHECK(validateAction(action, 3) == ActionStatus::Ok);
+    CHECK(actionToString(action) == "OFFER -1 2 0 0 0 -1");
+    REQUIRE(parseAction("OFFER 1 2 0 0 0 0", 0, action));
+    CHECK(validateAction(action, 3) == ActionStatus::MalformedAction); // wants nothing
+    CHECK(validateAction(makeAction(ActionOpcode::Result, 0), 3) == ActionStatus::MalformedAction);
+    CHECK(validateAction(makeAction(ActionOpcode::BuildCity, 0, 0), 3) == ActionStatus::MalformedAction);
+    REQUIRE(parseAction("ROADS", 1, action));
+    CHECK(action.opcode == ActionOpcode::PlayRoadBuilding);
+    CHECK(actionToString(action) == "ROADS");
+    CHECK(validateAction(action, 2) == ActionStatus::Ok);
+    CHECK(validateAction(makeAction(ActionOpcode::PlayRoadBuilding, 0, 1), 2) == ActionStatus::MalformedAction);
+}
+
+TEST_CASE("Game validates a batch of actions without changing it") {
+    Game game({"Player1", "Player2"}, 7);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(1, 0, 6);
+    game.placeRoad(1, 0, 6, 0, 7);
+    game.placeSettlement(1, 2, 2);
+    game.placeRoad(1, 2, 2, 2, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    REQUIRE(game.rollDice(0) == ActionStatus::Ok);
+    REQUIRE(game.getPhase() == GamePhase::Main);
+    Player* player = game.getPlayers()[0];
+    player->addResources(TileType::Tree, 1);
+    player->addResources(TileType::Clay, 1);
+
+    // every edge of the board as a road candidate, plus a few actions that must fail
+    std::vector<Action> actions;
+    for(const Edge* edge: game.getBoard().getEdges()) {
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        actions.push_back(makeAction(ActionOpcode::BuildRoad, 0, encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn())));
+    }
+    size_t numOfRoads = actions.size();
+    actions.push_back(makeAction(ActionOpcode::BuildRoad, 1, encodeEdge(2, 3, 2, 4)));
+    actions.push_back(makeAction(ActionOpcode::RollDice, 0));
+    actions.push_back(makeAction(ActionOpcode::Turn, 0));
+    std::vector<ActionStatus> statuses(actions.size());
+
+    int resourcesBefore = player->getNumOfResources();
+    game.validate(actions, statuses);
+    CHECK(player->getNumOfResources() == resourcesBefore);
+    CHECK(player->getMyRoads().size() == 2);
+    CHECK(statuses[numOfRoads] == ActionStatus::NotYourTurn);
+    CHECK(statuses[numOfRoads + 1] == ActionStatus::WrongPhase);
+    CHECK(statuses[numOfRoads + 2] == ActionStatus::MalformedAction);
+
+    // the free edges next to the two roads of the seat
+    size_t firstLegal = numOfRoads;
+    int numOfLegal = 0;
+    for(size_t index = 0; index < numOfRoads; ++index) {
+        if(statuses[index] != ActionStatus::Ok) continue;
+        if(numOfLegal++ == 0) firstLegal = index;
+    }
+    CHECK(numOfLegal == 6);
+
+    // and the batch agrees with applying the action
+    int row, col, toRow, toCol;
+    REQUIRE(decodeEdge(actions[firstLegal].target, row, col, toRow, toCol));
+    CHECK(game.placeRoad(0, row, col, toRow, toCol) == ActionStatus::Ok);
+    game.validate(actions, statuses);
+    CHECK(statuses[firstLegal] != ActionStatus::Ok);
+}
+
+TEST_CASE("Game trade book matches and settles offers") {
+    Game game({"Player1", "Player2", "Player3", "Player4"}, 6);
+    int settlements[4][2] = {{0, 2}, {0, 4}, {0, 6}, {2, 2}};
+    int seconds[4][2] = {{4, 3}, {2, 5}, {2, 8}, {4, 6}};
+    for(size_t seat = 0; seat < 4; ++seat) {
+        REQUIRE(game.placeSettlement(seat, settlements[seat][0], settlements[seat][1]) == ActionStatus::Ok);
+        REQUIRE(game.placeRoad(seat, settlements[seat][0], settlements[seat][1], settlements[seat][0], settlements[seat][1] + 1) == ActionStatus::Ok);
+    }
+    for(size_t seat = 4; seat-- > 0;) {
+        REQUIRE(game.placeSettlement(seat, seconds[seat][0], seconds[seat][1]) == ActionStatus::Ok);
+        REQUIRE(game.placeRoad(seat, seconds[seat][0], seconds[seat][1], seconds[seat][0], seconds[seat][1] + 1) == ActionStatus::Ok);
+    }
+    ResourceVector give = makeResourceVector(2, 0, 0, 0, 0);
+    ResourceVector want = makeResourceVector(0, 0, 0, 0, 1);
+    CHECK(game.postTrade(0, give, want) == ActionStatus::WrongPhase); // must roll first
+    REQUIRE(game.rollDice(0) == ActionStatus::Ok);
+    if(game.getPhase() == GamePhase::Discard) return; // nobody holds 7 cards after the setup
+    REQUIRE(game.getPhase() == GamePhase::Main);
+
+    const std::vector<Player*>& players = game.getPlayers();
+    for(Player* player: players) {
+        player->addResources(makeResourceVector(6, 6, 6, 6, 6));
+    }
+    ResourceVector total = makeResourceVector(0, 0, 0, 0, 0);
+    for(Player* player: players) total += player->getResourceVector();
+
+    // an open offer rests until a compatible counter offer takes it on its terms
+    CHECK(game.postTrade(0, give, want) == ActionStatus::Ok);
+    REQUIRE(game.getTradeBook().getOffers().size() == 1);
+    int offerId = game.getTradeBook().getOffers()[0].id;
+    ResourceVector before0 = players[0]->getResourceVector();
+    ResourceVector before1 = players[1]->getResourceVector();
+    CHECK(game.postTrade(1, makeResourceVector(0, 0, 0, 0, 1), makeResourceVector(1, 0, 0, 0, 0), -1, offerId) == ActionStatus::Ok);
+    CHECK(game.getTradeBook().getOffers().empty());
+    CHECK(players[0]->getResourceVector() == before0 - give + want);
+    CHECK(players[1]->getResourceVector() == before1 + give - want);
+    REQUIRE(game.getTradeBook().getNumOfFills() == 1);
+    CHECK(game.getTradeBook().getFill(0).taker == 1);
+
+    // only trades with the current seat, no giving what is wanted, no giving what is not held
+    CHECK(game.postTrade(2, give, want) == ActionStatus::NotYourTurn);
+    CHECK(game.postTrade(2, give, want, 3) == ActionStatus::NotYourTurn);
+    CHECK(game.postTrade(0, give, give) == ActionStatus::InvalidTrade);
+    CHECK(game.postTrade(0, makeResourceVector(50, 0, 0, 0, 0), want) == ActionStatus::NotEnoughResources);
+
+    // a directed offer is taken only by its seat, a batch sees the same
+    CHECK(game.postTrade(0, give, want, 2) == ActionStatus::Ok);
+    offerId = game.getTradeBook().getOffers().back().id;
+    Action actions[2] = {makeAction(ActionOpcode::AcceptTrade, 3, offerId), makeAction(ActionOpcode::AcceptTrade, 2, offerId)};
+    ActionStatus statuses[2];
+    game.validate(actions, statuses);
+    CHECK(statuses[0] == ActionStatus::InvalidTrade);
+    CHECK(statuses[1] == ActionStatus::Ok);
+    CHECK(game.acceptTrade(3, offerId) == ActionStatus::InvalidTrade);
+    CHECK(game.acceptTrade(2, offerId) == ActionStatus::Ok);
+    CHECK(game.acceptTrade(2, offerId) == ActionStatus::InvalidTrade); // already settled
+
+    ResourceVector after = makeResourceVector(0, 0, 0, 0, 0);
+    for(Player* player: players) after += player->getResourceVector();
+    CHECK(after == total);
+
+    // offers live for one turn
+    CHECK(game.postTrade(0, give, want) == ActionStatus::Ok);
+    CHECK(game.endTurn(0) == ActionStatus::Ok);
+    CHECK(game.getTradeBook().getOffers().empty());
+}
+
+TEST_CASE("Game undo of a trade gives back the fill it wrapped over") {
+    Game game({"Player1", "Player2"}, 12);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(0, &greedy);
+    game.setDiscardPolicy(1, &greedy);
+    setupTwoSeats(game);
+    REQUIRE(game.rollDice(0) == ActionStatus::Ok);
+    if(game.getPhase() == GamePhase::MoveRobber) moveRobberAnywhere(game, 0);
+    REQUIRE(game.getPhase() == GamePhase::Main);
+    game.getPlayers()[0]->addResources(makeResourceVector(0, 0, 0, 0, 300));
+    game.getPlayers()[1]->addResources(makeResourceVector(300, 0, 0, 0, 0));
+
+    // wrap the ring, every fill a different offer
+    ResourceVector give = makeResourceVector(0, 0, 0, 0, 1);
+    ResourceVector want = makeResourceVector(1, 0, 0, 0, 0);
+    for(size_t fill = 0; fill < catan_game::TRADE_FILL_HISTORY + 3; ++fill) {
+        REQUIRE(game.postTrade(0, give, want, 1) == ActionStatus::Ok);
+        REQUIRE(game.acceptTrade(1, game.getTradeBook().getOffers().back().id) == ActionStatus::Ok);
+    }
+    const catan_game::TradeBook& book = game.getTradeBook();
+    size_t numOfFills = book.getNumOfFills();
+    int oldestOfferId = book.getFill(numOfFills - catan_game::TRADE_FILL_HISTORY).offerId;
+
+    Action offer = makeAction(ActionOpcode::PostTrade, 0, 2); // directed to seat 1
+    offer.resources = give - want;
+    catan_game::UndoRecord post, accept;
+    REQUIRE(game.apply(offer, post) == ActionStatus::Ok);
+    uint64_t hash = game.stateHash();
+    REQUIRE(game.apply(makeAction(ActionOpcode::AcceptTrade, 1, book.getOffers().back().id), accept) == ActionStatus::Ok);
+    CHECK(book.getNumOfFills() == numOfFills + 1);
+    CHECK(book.getFill(numOfFills - catan_game::TRADE_FILL_HISTORY).offerId != oldestOfferId); // overwritten
+
+    game.undo(accept);
+    CHECK(game.stateHash() == hash);
+    CHECK(book.getNumOfFills() == numOfFills);
+    CHECK(book.getFill(numOfFills - catan_game::TRADE_FILL_HISTORY).offerId == oldestOfferId);
+    game.undo(post);
+    CHECK(book.getFill(numOfFills - catan_game::TRADE_FILL_HISTORY).offerId == oldestOfferId);
+}
+
+TEST_CASE("Board harbors lower the trade rates of their settlements") {
+    Board board;
+    const std::pmr::vector<Harbor>& harbors = board.getHarbors();
+    REQUIRE(harbors.size() == NUM_HARBORS);
+    int numOfGeneric = 0;
+    for(const Harbor& harbor: harbors) {
+        CHECK(harbor.first->getHarbor() == &harbor);
+        CHECK(harbor.second->getHarbor() == &harbor);
+        CHECK(board.findEdge(harbor.first->getRow(), harbor.first->getColumn(),
+                             harbor.second->getRow(), harbor.second->getColumn()) != nullptr);
+        if(harbor.isGeneric) ++numOfGeneric;
+    }
+    CHECK(numOfGeneric == 4);
+
+    Player player("TestPlayer");
+    for(int type = 0; type < NUM_RESOURCE_TYPES; ++type) {
+        CHECK(player.getTradeRate(static_cast<TileType>(type)) == BANK_TRADE_RATE);
+    }
+    const Harbor* resourceHarbor = nullptr;
+    for(const Harbor& harbor: harbors) {
+        if(!harbor.isGeneric) resourceHarbor = &harbor;
+    }
+    REQUIRE(resourceHarbor != nullptr);
+    REQUIRE(board.placeSettlement(resourceHarbor->first->getRow(), resourceHarbor->first->getColumn(), &player, false, true) != nullptr);
+    for(int type = 0; type < NUM_RESOURCE_TYPES; ++type) {
+        TileType tileType = static_cast<TileType>(type);
+        CHECK(player.getTradeRate(tileType) == (tileType == resourceHarbor->resource ? RESOURCE_HARBOR_RATE : BANK_TRADE_RATE));
+    }
+}
+
+TEST_CASE("Board is generated for any radius") {
+    for(int radius = 1; radius <= 3; ++radius) {
+        Board board(radius);
+        CHECK(board.getTiles().size() == size_t(3 * radius * radius + 3 * radius + 1));
+        CHECK(board.getEdges().size() == size_t(9 * radius * radius + 15 * radius + 6));
+        int numOfVertices = 0;
+        for(int row = 0; row < board.getNumOfRows(); ++row) {
+            for(int col = 0; col < board.getNumOfCols(); ++col) {
+                if(board.getVertex(row, col) != nullptr) ++numOfVertices;
+                CHECK(board.isOnBoard(row, col) == (board.getVertex(row, col) != nullptr));
+            }
+        }
+        CHECK(numOfVertices == 6 * radius * radius + 12 * radius + 6);
+        for(const Tile* tile: board.getTiles()) {
+            CHECK(tile->getVertices().size() == 6);
+        }
+        for(const Harbor& harbor: board.getHarbors()) {
+            CHECK(harbor.first->getHarbor() == &harbor);
+        }
+    }
+
+    // the standard board keeps the classic corners
+    CHECK(Board::isOutOfBound(0, 1));
+    CHECK_FALSE(Board::isOutOfBound(0, 2));
+    CHECK(Board::isOutOfBound(1, 0));
+    CHECK_FALSE(Board::isOutOfBound(2, 0));
+    CHECK_FALSE(Board::isOutOfBound(3, 10));
+    CHECK(Board::isOutOfBound(4, 10));
+    CHECK(Board::isOutOfBound(5, 9));
+    CHECK(Board::isOutOfBound(6, 5));
+}
+
+TEST_CASE("Board objects and their adjacency share the board arena") {
+    Board board(3);
+    std::pmr::memory_resource* arena = board.getTiles().get_allocator().resource();
+    CHECK(arena != std::pmr::get_default_resource());
+    CHECK(board.getEdges().get_allocator().resource() == arena);
+    CHECK(board.getHarbors().get_allocator().resource() == arena);
+    for(const Tile* tile: board.getTiles()) {
+        CHECK(tile->getVertices().get_allocator().resource() == arena);
+        for(const Vertex* vertex: tile->getVertices()) {
+            CHECK(vertex->getMyVertexNeighbors().get_allocator().resource() == arena);
+            CHECK(vertex->getMySurroundingEdges().get_allocator().resource() == arena);
+        }
+    }
+    for(const Edge* edge: board.getEdges()) {
+        CHECK(edge->getNeighbours().get_allocator().resource() == arena);
+    }
+}
+
+// Tiles, numbers and harbors of a board in order - equal for boards of the same layout
+static std::vector<int> boardLayout(const Board& board) {
+    std::vector<int> layout;
+    for(const Tile* tile: board.getTiles()) {
+        layout.push_back(tile->getIndex());
+        layout.push_back(static_cast<int>(tile->getType()));
+        layout.push_back(tile->getValue());
+    }
+    for(const catan_game::Harbor& harbor: board.getHarbors()) {
+        layout.push_back(harbor.first->getRow() * board.getNumOfCols() + harbor.first->getColumn());
+        layout.push_back(harbor.isGeneric ? -1 : static_cast<int>(harbor.resource));
+    }
+    return layout;
+}
+
+TEST_CASE("Board layout follows the seed only") {
+    Board first(catan_game::STANDARD_BOARD_RADIUS, 11);
+    Board second(catan_game::STANDARD_BOARD_RADIUS, 11);
+    Board other(catan_game::STANDARD_BOARD_RADIUS, 12);
+    CHECK(boardLayout(first) == boardLayout(second)); // the tile indexes start over on every board
+    CHECK(boardLayout(first) != boardLayout(other));
+    for(size_t index = 0; index < first.getTiles().size(); ++index) {
+        CHECK(first.getTiles()[index]->getIndex() == static_cast<int>(index));
+    }
+}
+
+// The road rule walked from scratch - the player's building, or its road at a vertex nobody else settled
+static bool isRoadAnchor(const Vertex* vertex, const Player* player) {
+    if(vertex->getOwner() != nullptr) return vertex->getOwner() == player;
+    for(const Edge* edge: vertex->getMySurroundingEdges()) {
+        if(edge->getRoadOwner() == player) return true;
+    }
+    return false;
+}
+
+TEST_CASE("Board masks follow the settlements and roads") {
+    Game game({"Player1", "Player2"}, 21);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(0, &greedy);
+    game.setDiscardPolicy(1, &greedy);
+    const Board& board = game.getBoard();
+    CHECK(board.getOpenVertices().count() == 54);
+    CHECK(board.getOpenVertices().test(board.getCell(0, 2)));
+    CHECK_FALSE(board.getOpenVertices().test(board.getCell(0, 0))); // corner outside the board
+
+    catan_game::BoardMask spots;
+    for(int turn = 0; turn < 60; ++turn) {
+        if(turn == 0) setupTwoSeats(game);
+        else playSteadyTurn(game);
+
+        for(size_t seat = 0; seat < game.getNumOfSeats(); ++seat) {
+            const Player* player = game.getPlayers()[seat];
+            board.getSettlementSpots(player, spots);
+            int numOfWrongCells = 0;
+            for(int row = 0; row < board.getNumOfRows(); ++row) {
+                for(int col = 0; col < board.getNumOfCols(); ++col) {
+                    const Vertex* vertex = board.getVertex(row, col);
+                    bool isOpen = vertex != nullptr && vertex->getOwner() == nullptr && vertex->isSettlementBuildable(false);
+                    bool isReached = false;
+                    if(vertex != nullptr) {
+                        for(const Edge* edge: vertex->getMySurroundingEdges()) isReached = isReached || edge->getRoadOwner() == player;
+                    }
+                    if(board.getOpenVertices().test(board.getCell(row, col)) != isOpen) ++numOfWrongCells;
+                    if(spots.test(board.getCell(row, col)) != (isOpen && isReached)) ++numOfWrongCells;
+                }
+            }
+            CHECK(numOfWrongCells == 0);
+
+            int numOfWrongEdges = 0;
+            for(const Edge* edge: board.getEdges()) {
+                bool isBuildable = !edge->hasRoad() && (isRoadAnchor(edge->getVertices().first, player) || isRoadAnchor(edge->getVertices().second, player));
+                if(board.getRoadSpots(player).test(board.getEdgeSlot(edge)) != isBuildable) ++numOfWrongEdges;
+            }
+            const catan_game::BoardMask& roadSpots = board.getRoadSpots(player);
+            for(size_t slot = roadSpots.findNext(0); slot < roadSpots.size(); slot = roadSpots.findNext(slot + 1)) {
+                if(board.getEdgeSlot(board.getEdgeOfSlot(slot)) != slot) ++numOfWrongEdges;
+            }
+            CHECK(numOfWrongEdges == 0);
+        }
+    }
+}
+
+TEST_CASE("Board opponent settlement cuts a road network") {
+    Board board;
+    Player first("Player1");
+    Player second("Player2");
+    REQUIRE(board.placeSettlement(0, 2, &first, false, true) != nullptr);
+    REQUIRE(board.placeRoad(0, 2, 0, 3, &first, true) != nullptr);
+    REQUIRE(board.placeRoad(0, 3, 0, 4, &first, true) != nullptr);
+    CHECK(board.canPlaceRoad(0, 4, 0, 5, &first));
+    CHECK(board.getRoadSpots(&first).count() == 3); // down from (0, 2) and (0, 4), right from (0, 4)
+    CHECK_FALSE(board.canPlaceRoad(0, 4, 0, 5, &second));
+
+    REQUIRE(board.placeSettlement(0, 4, &second, false, true) != nullptr);
+    CHECK_FALSE(board.canPlaceRoad(0, 4, 0, 5, &first));
+    CHECK_FALSE(board.canPlaceRoad(0, 4, 1, 4, &first));
+    CHECK(board.canPlaceRoad(0, 4, 0, 5, &second));
+    CHECK(board.getRoadSpots(&first).count() == 1);
+    CHECK(board.getRoadSpots(&second).count() == 2);
+}
+
+TEST_CASE("Board robber blocks the production of its tile") {
+    Board board;
+    REQUIRE(board.getRobberTile() != nullptr);
+    CHECK(board.getRobberTile()->getType() == TileType::Sand);
+
+    size_t numOfProducing = 0;
+    for(int roll = MIN_DICE_ROLL; roll <= MAX_DICE_ROLL; ++roll) {
+        for(const Tile* tile: board.getProducingTiles(roll)) {
+            CHECK(tile->getValue() == roll);
+        }
+        numOfProducing += board.getProducingTiles(roll).size();
+    }
+    CHECK(numOfProducing == 18);
+    CHECK(board.getProducingTiles(7).empty());
+
+    int desert = board.getRobberTileIndex();
+    int robbed = (desert == 0) ? 1 : 0;
+    Tile* tile = board.getTiles()[robbed];
+    const std::pmr::vector<Tile*>& producing = board.getProducingTiles(tile->getValue());
+    CHECK(producing.get_allocator().resource() != std::pmr::get_default_resource()); // on the board's arena
+    CHECK(board.moveRobber(robbed));
+    CHECK_FALSE(board.moveRobber(robbed));
+    CHECK_FALSE(board.moveRobber(static_cast<int>(board.getTiles().size())));
+    CHECK(std::find(producing.begin(), producing.end(), tile) == producing.end());
+    CHECK(board.moveRobber(desert));
+    CHECK(std::find(producing.begin(), producing.end(), tile) != producing.end());
+
+    ResourceVector hand = makeResourceVector(0, 2, 0, 1, 0);
+    CHECK(resourceOfCard(hand, 0) == 1);
+    CHECK(resourceOfCard(hand, 1) == 1);
+    CHECK(resourceOfCard(hand, 2) == 3);
+    CHECK(resourceOfCard(hand, 3) == -1);
+}
+
+TEST_CASE("Board vertex yields and player expected income") {
+    Board board;
+    CHECK(diceWays(2) == 1);
+    CHECK(diceWays(6) == 5);
+    CHECK(diceWays(7) == 6);
+    CHECK(diceWays(12) == 1);
+
+    // the index matches a walk over the tiles
+    for(int row = 0; row < board.getNumOfRows(); ++row) {
+        for(int col = 0; col < board.getNumOfCols(); ++col) {
+            const Vertex* vertex = board.getVertex(row, col);
+            if(vertex == nullptr) continue;
+            ResourceVector expected = makeResourceVector(0, 0, 0, 0, 0);
+            for(const Tile* tile: board.getTiles()) {
+                const std::pmr::vector<Vertex*>& vertices = tile->getVertices();
+                if(tile->getType() == TileType::Sand || tile == board.getRobberTile()) continue;
+                if(std::find(vertices.begin(), vertices.end(), vertex) != vertices.end()) expected[tile->getType()] += diceWays(tile->getValue());
+            }
+            CHECK(vertex->getYield() == expected);
+        }
+    }
+
+    Player player("TestPlayer");
+    Vertex* vertex = board.placeSettlement(2, 4, &player, false, true);
+    REQUIRE(vertex != nullptr);
+    CHECK(player.getExpectedIncome() == vertex->getYield());
+    player.addResources(TileType::Crop, 2);
+    player.addResources(TileType::Iron, 3);
+    REQUIRE(board.placeSettlement(2, 4, &player, true, false) != nullptr);
+    CHECK(player.getExpectedIncome() == vertex->getYield() + vertex->getYield());
+
+    // the robber on a tile of the city takes both of its cards out of the income
+    int robbed = -1;
+    for(size_t index = 0; index < board.getTiles().size(); ++index) {
+        const Tile* tile = board.getTiles()[index];
+        const std::pmr::vector<Vertex*>& vertices = tile->getVertices();
+        if(tile->getType() != TileType::Sand && std::find(vertices.begin(), vertices.end(), vertex) != vertices.end()) robbed = static_cast<int>(index);
+    }
+    REQUIRE(robbed >= 0);
+    const Tile* tile = board.getTiles()[robbed];
+    ResourceVector before = player.getExpectedIncome();
+    REQUIRE(board.moveRobber(robbed));
+    ResourceVector lost = makeResourceVector(0, 0, 0, 0, 0);
+    lost[tile->getType()] = 2 * diceWays(tile->getValue());
+    CHECK(player.getExpectedIncome() == before - lost);
+}
+
+TEST_CASE("Placement optimizer ranks legal setup pairs") {
+    Game game({"Player1", "Player2"}, 9);
+    PlacementOptimizer optimizer;
+    std::vector<PlacementSuggestion> suggestions = optimizer.suggest(game, 0, 10, std::chrono::milliseconds(50));
+    REQUIRE(suggestions.size() == 10);
+    for(size_t index = 0; index < suggestions.size(); ++index) {
+        const PlacementSuggestion& suggestion = suggestions[index];
+        if(index > 0) CHECK(suggestions[index - 1].score >= suggestion.score);
+        CHECK(game.getBoard().canPlaceSettlement(suggestion.row, suggestion.col, game.getPlayers()[0], false));
+        CHECK(game.getBoard().findEdge(suggestion.row, suggestion.col, suggestion.toRow, suggestion.toCol) != nullptr);
+    }
+
+    // ties rank the same way every time
+    std::vector<PlacementSuggestion> again = optimizer.suggest(game, 0, 10, std::chrono::milliseconds(50));
+    REQUIRE(again.size() == suggestions.size());
+    for(size_t index = 0; index < again.size(); ++index) {
+        CHECK(again[index].row == suggestions[index].row);
+        CHECK(again[index].col == suggestions[index].col);
+        CHECK(again[index].toCol == suggestions[index].toCol);
+    }
+
+    // the best pair is playable, and the next seat's suggestions respect the distance rule
+    const PlacementSuggestion& best = suggestions.front();
+    CHECK(game.placeSettlement(0, best.row, best.col) == ActionStatus::Ok);
+    CHECK(game.placeRoad(0, best.row, best.col, best.toRow, best.toCol) == ActionStatus::Ok);
+    for(const PlacementSuggestion& suggestion: optimizer.suggest(game, 1, 50, std::chrono::milliseconds(50))) {
+        CHECK(game.getBoard().canPlaceSettlement(suggestion.row, suggestion.col, game.getPlayers()[1], false));
+        CHECK_FALSE((suggestion.row == best.row && suggestion.col == best.col));
+    }
+}
+
+TEST_CASE("Income distribution matches every pair of rolls") {
+    Board board;
+    Player player("TestPlayer");
+    REQUIRE(board.placeSettlement(2, 4, &player, false, true) != nullptr);
+    REQUIRE(board.placeSettlement(3, 7, &player, false, true) != nullptr);
+    RollIncome income = IncomeDistribution::rollIncome(board, player);
+    CHECK(income[7].isZero());
+
+    ResourceVector cap = makeResourceVector(2, 2, 2, 2, 2);
+    IncomeDistribution distribution(income, 2, cap);
+    std::map<std::array<int, 5>, double> expected;
+    for(int first = 2; first <= 12; ++first) {
+        for(int second = 2; second <= 12; ++second) {
+            ResourceVector amounts = income[first] + income[second];
+            for(int type = 0; type < 5; ++type) amounts[type] = std::min(amounts[type], cap[type]);
+            expected[amounts.amounts] += diceWays(first) * diceWays(second) / 1296.0;
+        }
+    }
+    double total = 0;
+    for(const auto& [amounts, probability]: expected) {
+        CHECK(distribution.probabilityOf(ResourceVector{amounts}) == doctest::Approx(probability));
+        total += distribution.probabilityOf(ResourceVector{amounts});
+    }
+    CHECK(total == doctest::Approx(1.0));
+    CHECK(distribution.probabilityOfAtLeast(makeResourceVector(0, 0, 0, 0, 0)) == doctest::Approx(1.0));
+
+    // nothing missing is sure, more rolls never make a city less likely
+    CHECK(IncomeDistribution::chanceToAfford(board, player, makeResourceVector(0, 0, 0, 0, 0), 3) == doctest::Approx(1.0));
+    ResourceVector city = makeResourceVector(0, 0, 2, 0, 3);
+    double inThree = IncomeDistribution::chanceToAfford(board, player, city, 3);
+    double inTen = IncomeDistribution::chanceToAfford(board, player, city, 10);
+    CHECK(inThree >= 0.0);
+    CHECK(inTen >= inThree);
+    CHECK(inTen <= 1.0);
+}
+
+TEST_CASE("Steady state turns do not allocate") {
+    Game game({"Player1", "Player2"}, 12);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(0, &greedy);
+    game.setDiscardPolicy(1, &greedy);
+    setupTwoSeats(game);
+
+    for(int turn = 0; turn < 20; ++turn) playSteadyTurn(game); // the streams and the lazily built state settle
+    size_t numOfRoads = game.getPlayers()[0]->getMyRoads().size() + game.getPlayers()[1]->getMyRoads().size();
+    size_t numOfFills = game.getTradeBook().getNumOfFills();
+
+    size_t before = numOfAllocations;
+    for(int turn = 0; turn < 1000; ++turn) playSteadyTurn(game);
+    size_t allocated = numOfAllocations - before;
+
+    CHECK(allocated == 0);
+    CHECK(game.getPhase() != GamePhase::Finished);
+    CHECK(game.getPlayers()[0]->getMyRoads().size() + game.getPlayers()[1]->getMyRoads().size() > numOfRoads);
+    CHECK(game.getPlayers()[0]->getMyRoads().size() <= catan_game::MAX_ROADS);
+    CHECK(game.getTradeBook().getNumOfFills() > numOfFills + catan_game::TRADE_FILL_HISTORY); // the ring wrapped
+    CHECK(game.getTradeBook().getLastFill().offerId == game.getTradeBook().getNextOfferId() - 1);
+}
+
+// One answer of a steady seat to the engine - roll, move the robber on, turn settlements into cities
+// and build roads while the hand pays for them, end. Cities stop at 6 points so the game goes on.
+static void answerSteadyRequest(Game& game, DecisionChannel& channel, int& robberTile) {
+    constexpr int MAX_STEADY_POINTS = 6;
+    const DecisionRequest& request = channel.getRequest();
+    size_t seat = request.seat;
+    Player* player = game.getPlayers()[seat];
+    const Vertex* town = nullptr;
+    for(const Vertex* vertex: player->getMyBuildings()) {
+        if(!vertex->isCity() && town == nullptr) town = vertex;
+    }
+    const catan_game::BoardMask& roadSpots = game.getBoard().getRoadSpots(player);
+    size_t roadSlot = roadSpots.findNext(0);
+
+    if(request.kind == DecisionKind::RobberPlacement) {
+        robberTile = (robberTile + 1) % static_cast<int>(game.getBoard().getTiles().size());
+        channel.respond(makeDecision(seat, TurnAction::MoveRobber, robberTile, -1));
+    }
+    else if(request.kind == DecisionKind::SettlementPlacement) {
+        channel.respond(makeDecision(seat, TurnAction::Place, town->getRow(), town->getColumn()));
+    }
+    else if(request.kind == DecisionKind::RoadPlacement) {
+        const Edge* edge = game.getBoard().getEdgeOfSlot(roadSlot);
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        channel.respond(makeDecision(seat, TurnAction::Place, from->getRow(), from->getColumn(), to->getRow(), to->getColumn()));
+    }
+    else if(game.getPhase() == GamePhase::Roll) {
+        channel.respond(makeDecision(seat, TurnAction::RollDice));
+    }
+    else if(town != nullptr && player->hasResourcesForCity() && player->getMyPoints() <= MAX_STEADY_POINTS) {
+        channel.respond(makeDecision(seat, TurnAction::BuildCity));
+    }
+    else if(roadSlot < roadSpots.size() && player->hasResourcesForRoad() && player->getMyRoads().size() < catan_game::MAX_ROADS) {
+        channel.respond(makeDecision(seat, TurnAction::BuildRoad));
+    }
+    else {
+        channel.respond(makeDecision(seat, TurnAction::EndTurn));
+    }
+}
+
+TEST_CASE("Turn engine turns do not allocate once the frames are pooled") {
+    Game game({"Player1", "Player2"}, 12);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(0, &greedy);
+    game.setDiscardPolicy(1, &greedy);
+    setupTwoSeats(game);
+    DecisionChannel channel;
+    TurnTask task = playGame(game, channel);
+    task.start();
+
+    int robberTile = 0;
+    int numOfTurns = 0;
+    auto playTurns = [&](int turns) {
+        for(int turn = numOfTurns + turns; numOfTurns < turn && !task.isDone(); ) {
+            size_t seat = game.getCurrentSeat();
+            answerSteadyRequest(game, channel, robberTile);
+            if(game.getCurrentSeat() != seat) ++numOfTurns;
+        }
+    };
+    playTurns(20); // every flow has run and left its frame on the free lists
+    size_t numOfRoads = game.getPlayers()[0]->getMyRoads().size() + game.getPlayers()[1]->getMyRoads().size();
+
+    size_t before = numOfAllocations;
+    playTurns(100);
+    size_t allocated = numOfAllocations - before;
+
+    CHECK(allocated == 0);
+    CHECK(numOfTurns == 120);
+    CHECK_FALSE(task.isDone());
+    CHECK(game.getPlayers()[0]->getMyRoads().size() + game.getPlayers()[1]->getMyRoads().size() > numOfRoads);
+}
+
+// Every action a seat could send now - the game's validate picks the legal ones
+static std::vector<catan_game::Action> candidateActions(const Game& game, std::mt19937& rng) {
+    using catan_game::Action;
+    using catan_game::ActionOpcode;
+    using catan_game::makeAction;
+    std::vector<Action> actions;
+    const Board& board = game.getBoard();
+    size_t numOfSeats = game.getNumOfSeats();
+    for(size_t seat = 0; seat < numOfSeats; ++seat) {
+        for(ActionOpcode opcode: {ActionOpcode::RollDice, ActionOpcode::EndTurn, ActionOpcode::BuyDevelopmentCard, ActionOpcode::PlayKnight,
+                                  ActionOpcode::PlayRoadBuilding}) {
+            actions.push_back(makeAction(opcode, seat));
+        }
+        std::uniform_int_distribution<int> card(0, catan_game::NUM_RESOURCE_TYPES - 1);
+        actions.push_back(makeAction(ActionOpcode::PlayMonopoly, seat, card(rng)));
+        Action plenty = makeAction(ActionOpcode::PlayYearOfPlenty, seat);
+        ++plenty.resources[card(rng)];
+        ++plenty.resources[card(rng)];
+        actions.push_back(plenty);
+        for(int row = 0; row < board.getNumOfRows(); ++row) {
+            for(int col = 0; col < board.getNumOfCols(); ++col) {
+                if(!board.isOnBoard(row, col)) continue;
+                actions.push_back(makeAction(ActionOpcode::BuildSettlement, seat, catan_game::encodeVertex(row, col)));
+                actions.push_back(makeAction(ActionOpcode::BuildCity, seat, catan_game::encodeVertex(row, col)));
+            }
+        }
+        for(const Edge* edge: board.getEdges()) {
+            const Vertex* from = edge->getVertices().first;
+            const Vertex* to = edge->getVertices().second;
+            actions.push_back(makeAction(ActionOpcode::BuildRoad, seat, catan_game::encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn())));
+        }
+        if(game.getPendingDiscard(seat) > 0) {
+            Action discard = makeAction(ActionOpcode::Discard, seat);
+            discard.resources = GreedyDiscardPolicy().chooseDiscard(game.getPlayers()[seat]->getResourceVector(), game.getPendingDiscard(seat));
+            actions.push_back(discard);
+        }
+        for(int tile = 0; tile < static_cast<int>(board.getTiles().size()); ++tile) {
+            for(int victim = -1; victim < static_cast<int>(numOfSeats); ++victim) {
+                actions.push_back(makeAction(ActionOpcode::MoveRobber, seat, catan_game::robberTarget(tile, victim)));
+            }
+        }
+        std::uniform_int_distribution<int> type(0, catan_game::NUM_RESOURCE_TYPES - 1);
+        int give = type(rng), want = type(rng);
+        if(give != want) {
+            Action bank = makeAction(ActionOpcode::BankTrade, seat);
+            bank.resources[give] = game.getPlayers()[seat]->getTradeRate(static_cast<TileType>(give));
+            bank.resources[want] = -1;
+            actions.push_back(bank);
+            Action offer = makeAction(ActionOpcode::PostTrade, seat);
+            offer.resources[give] = 1;
+            offer.resources[want] = -1;
+            actions.push_back(offer);
+        }
+        for(const catan_game::TradeOffer& offer: game.getTradeBook().getOffers()) {
+            actions.push_back(makeAction(ActionOpcode::AcceptTrade, seat, offer.id));
+            actions.push_back(makeAction(ActionOpcode::CancelTrade, seat, offer.id));
+        }
+    }
+    return actions;
+}
+
+TEST_CASE("Game undo replays random actions back to the same hashes") {
+    Game game({"Player1", "Player2", "Player3"}, 17);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(2, &greedy); // the other seats send their Discard actions
+    std::mt19937 rng(2);
+
+    // Mostly the productive actions, and the card ones whenever there are, so the sequence gets through
+    // setup to cards, knights and trades
+    std::vector<catan_game::Action> applied;
+    std::vector<uint64_t> hashes;
+    std::vector<catan_game::UndoRecord> records(800);
+    uint64_t startHash = game.stateHash();
+    for(size_t step = 0; step < records.size(); ++step) {
+        std::vector<catan_game::Action> actions = candidateActions(game, rng);
+        std::vector<ActionStatus> statuses(actions.size());
+        game.validate(actions, statuses);
+        std::vector<catan_game::Action> legal;
+        for(size_t index = 0; index < actions.size(); ++index) {
+            if(statuses[index] == ActionStatus::Ok) legal.push_back(actions[index]);
+        }
+        if(legal.empty()) break;
+        std::vector<catan_game::Action> productive, cards;
+        for(const catan_game::Action& action: legal) {
+            if(action.opcode != catan_game::ActionOpcode::EndTurn) productive.push_back(action);
+            if(action.opcode == catan_game::ActionOpcode::BuyDevelopmentCard || action.opcode == catan_game::ActionOpcode::PlayKnight
+               || action.opcode == catan_game::ActionOpcode::PlayMonopoly || action.opcode == catan_game::ActionOpcode::PlayYearOfPlenty
+               || action.opcode == catan_game::ActionOpcode::PlayRoadBuilding) cards.push_back(action);
+        }
+        const std::vector<catan_game::Action>& pool = (!cards.empty() && rng() % 2 == 0) ? cards
+                                                      : (productive.empty() || rng() % 4 == 0) ? legal : productive;
+        catan_game::Action action = pool[rng() % pool.size()];
+
+        hashes.push_back(game.stateHash());
+        REQUIRE(game.apply(action, records[applied.size()]) == ActionStatus::Ok);
+        applied.push_back(action);
+    }
+    uint64_t endHash = game.stateHash();
+    CHECK(applied.size() > 100);
+    CHECK(endHash != startHash);
+
+    std::map<catan_game::ActionOpcode, int> numOfOpcodes;
+    for(const catan_game::Action& action: applied) ++numOfOpcodes[action.opcode];
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::RollDice] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::BuildRoad] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::BuyDevelopmentCard] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::PostTrade] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::PlayKnight] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::PlayMonopoly] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::PlayYearOfPlenty] > 0);
+    CHECK(numOfOpcodes[catan_game::ActionOpcode::PlayRoadBuilding] > 0);
+
+    for(size_t index = applied.size(); index-- > 0;) {
+        game.undo(records[index]);
+        CHECK(game.stateHash() == hashes[index]);
+    }
+    CHECK(game.stateHash() == startHash);
+    CHECK(game.getBoard().getOpenVertices().count() == 54); // the masks are back to an empty board
+    for(const Player* player: game.getPlayers()) CHECK(game.getBoard().getRoadSpots(player).count() == 0);
+
+    // The restored dice repeat the same game
+    for(size_t index = 0; index < applied.size(); ++index) {
+        REQUIRE(game.apply(applied[index], records[index]) == ActionStatus::Ok);
+    }
+    CHECK(game.stateHash() == endHash);
+}
+
+TEST_CASE("Search state rolls like the board") {
+    Game game({"Player1", "Player2"}, 4);
+    setupTwoSeats(game);
+    SearchState state = SearchState::fromGame(game);
+    CHECK(state.isChanceNode());
+    REQUIRE(state.legalMoves().size() == 1);
+    CHECK(state.legalMoves().front().opcode == ActionOpcode::RollDice);
+
+    for(int roll = 2; roll <= 12; ++roll) {
+        SearchState rolled = state;
+        rolled.applyRoll(roll);
+        CHECK_FALSE(rolled.isChanceNode());
+        game.getBoard().distrbuteResources(roll);
+        for(size_t seat = 0; seat < 2; ++seat) {
+            Player* player = game.getPlayers()[seat];
+            CHECK(rolled.getHand(seat) == player->getResourceVector());
+            player->addResources(state.getHand(seat) - player->getResourceVector());
+        }
+    }
+}
+
+// The state's moves of the current seat in the Main phase against what the game says of every build, end and bank trade
+static void checkSearchMovesMatchGame(const Game& game, const SearchState& state) {
+    size_t seat = game.getCurrentSeat();
+    const Board& board = game.getBoard();
+    std::vector<Action> candidates = {makeAction(ActionOpcode::RollDice, seat), makeAction(ActionOpcode::EndTurn, seat)};
+    for(int row = 0; row < board.getNumOfRows(); ++row) {
+        for(int col = 0; col < board.getNumOfCols(); ++col) {
+            if(board.getVertex(row, col) == nullptr) continue;
+            candidates.push_back(makeAction(ActionOpcode::BuildSettlement, seat, catan_game::encodeVertex(row, col)));
+            candidates.push_back(makeAction(ActionOpcode::BuildCity, seat, catan_game::encodeVertex(row, col)));
+        }
+    }
+    for(const Edge* edge: board.getEdges()) {
+        const Vertex* from = edge->getVertices().first;
+        const Vertex* to = edge->getVertices().second;
+        candidates.push_back(makeAction(ActionOpcode::BuildRoad, seat, catan_game::encodeEdge(from->getRow(), from->getColumn(), to->getRow(), to->getColumn())));
+    }
+    for(int give = 0; give < catan_game::NUM_RESOURCE_TYPES; ++give) {
+        for(int want = 0; want < catan_game::NUM_RESOURCE_TYPES; ++want) {
+            for(int rate = catan_game::RESOURCE_HARBOR_RATE; rate <= catan_game::BANK_TRADE_RATE && want != give; ++rate) {
+                Action trade = makeAction(ActionOpcode::BankTrade, seat);
+                trade.resources[give] = rate;
+                trade.resources[want] = -1;
+                candidates.push_back(trade);
+            }
+        }
+    }
+    std::vector<ActionStatus> statuses(candidates.size());
+    game.validate(candidates, statuses);
+
+    std::vector<Action> moves = state.legalMoves();
+    int numOfMismatches = 0;
+    for(size_t index = 0; index < candidates.size(); ++index) {
+        const Action& candidate = candidates[index];
+        bool isMove = std::any_of(moves.begin(), moves.end(), [&candidate](const Action& move) {
+            return move.opcode == candidate.opcode && move.target == candidate.target && move.resources == candidate.resources;
+        });
+        if(isMove != (statuses[index] == ActionStatus::Ok)) ++numOfMismatches;
+    }
+    CHECK(numOfMismatches == 0);
+}
+
+// Before the roll the state is a chance node of the dice, the seat's moves start in the Main phase
+TEST_CASE("Search state moves follow the game's rules") {
+    Game game({"Player1", "Player2"}, 12);
+    GreedyDiscardPolicy greedy;
+    game.setDiscardPolicy(0, &greedy);
+    game.setDiscardPolicy(1, &greedy);
+    setupTwoSeats(game);
+
+    int numOfHarbors = 0;
+    for(int turn = 0; turn < 60; ++turn) {
+        // a rich hand, so every build is up to the placement rules and the pieces left
+        size_t seat = game.getCurrentSeat();
+        catan_game::UndoRecord roll, settle;
+        REQUIRE(game.apply(makeAction(ActionOpcode::RollDice, seat), roll) == ActionStatus::Ok);
+        if(game.getPhase() == GamePhase::Main) {
+            game.getPlayers()[seat]->addResources(makeResourceVector(4, 4, 4, 4, 4));
+            SearchState state = SearchState::fromGame(game);
+            checkSearchMovesMatchGame(game, state);
+
+            // the state's own build keeps it in step - a settlement on a harbor lowers the rates
+            for(const catan_game::Harbor& harbor: game.getBoard().getHarbors()) {
+                Action build = makeAction(ActionOpcode::BuildSettlement, seat, catan_game::encodeVertex(harbor.first->getRow(), harbor.first->getColumn()));
+                if(game.apply(build, settle) != ActionStatus::Ok) continue;
+                state.apply(build);
+                checkSearchMovesMatchGame(game, state);
+                game.undo(settle);
+                ++numOfHarbors;
+                break;
+            }
+        }
+        game.undo(roll);
+        playSteadyTurn(game);
+    }
+    CHECK(numOfHarbors > 0);
+
+    // build roads then settlements from the state's moves until the seat runs out of pieces
+    size_t seat = game.getCurrentSeat();
+    catan_game::UndoRecord record;
+    REQUIRE(game.apply(makeAction(ActionOpcode::RollDice, seat), record) == ActionStatus::Ok);
+    if(game.getPhase() == GamePhase::MoveRobber) moveRobberAnywhere(game, seat);
+    REQUIRE(game.getPhase() == GamePhase::Main);
+    for(ActionOpcode opcode: {ActionOpcode::BuildRoad, ActionOpcode::BuildSettlement}) {
+        for(bool isBuilt = true; isBuilt && game.getPhase() == GamePhase::Main; ) {
+            game.getPlayers()[seat]->addResources(makeResourceVector(1, 1, 1, 1, 0));
+            SearchState state = SearchState::fromGame(game);
+            std::vector<Action> moves = state.legalMoves();
+            auto build = std::find_if(moves.begin(), moves.end(), [opcode](const Action& move) { return move.opcode == opcode; });
+            isBuilt = build != moves.end();
+            if(isBuilt) {
+                REQUIRE(game.apply(*build, record) == ActionStatus::Ok);
+                state.apply(*build);
+                if(game.getPhase() == GamePhase::Main) checkSearchMovesMatchGame(game, state);
+            }
+        }
+    }
+    CHECK(game.getPlayers()[seat]->getMyRoads().size() == catan_game::MAX_ROADS);
+}
+
+TEST_CASE("Expectimax finds the winning build") {
+    Game game({"Player1", "Player2"}, 6);
+    setupTwoSeats(game);
+    CHECK(game.rollDice(0) == ActionStatus::Ok);
+    for(size_t seat = 0; seat < 2; ++seat) {
+        int toDiscard = game.getPendingDiscard(seat);
+        if(toDiscard > 0) {
+            GreedyDiscardPolicy greedy;
+            game.discard(seat, greedy.chooseDiscard(game.getPlayers()[seat]->getResourceVector(), toDiscard));
+        }
+    }
+    if(game.getPhase() == GamePhase::MoveRobber) moveRobberAnywhere(game, 0);
+    REQUIRE(game.getPhase() == GamePhase::Main);
+
+    Player* player = game.getPlayers()[0];
+    std::vector<VictoryPointCard> cards(Game::WINNING_POINTS - 1 - player->getMyPoints());
+    for(VictoryPointCard& card: cards) player->addDevelopmentCard(&card);
+    player->addResources(makeResourceVector(0, 0, 2, 0, 3));
+    REQUIRE(player->getMyPoints() == Game::WINNING_POINTS - 1);
+
+    SearchState root = SearchState::fromGame(game);
+    ResourceVector handBefore = player->getResourceVector();
+    ExpectimaxSearch::Result result = ExpectimaxSearch(4).search(root, std::chrono::milliseconds(200));
+    CHECK(player->getResourceVector() == handBefore); // the game is untouched
+    CHECK(result.depth >= 1);
+    REQUIRE((result.bestMove.opcode == ActionOpcode::BuildCity || result.bestMove.opcode == ActionOpcode::BuildSettlement));
+
+    SearchState next = root;
+    next.apply(result.bestMove);
+    CHECK(next.getWinner() == 0);
+    int row, col;
+    REQUIRE(decodeVertex(result.bestMove.target, row, col));
+    ActionStatus status = (result.bestMove.opcode == ActionOpcode::BuildCity) ? game.placeCity(0, row, col) : game.placeSettlement(0, row, col);
+    CHECK(status == ActionStatus::Ok);
+    CHECK(game.getWinner() == 0);
+    for(VictoryPointCard& card: cards) player->removeDevelopmentCard(&card);
+}
+
+TEST_CASE("Game knight moves the robber and steals") {
+    Game game({"Player1", "Player2"}, 5);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(1, 0, 6);
+    game.placeRoad(1, 0, 6, 0, 7);
+    game.placeSettlement(1, 2, 2);
+    game.placeRoad(1, 2, 2, 2, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    REQUIRE(game.getPhase() == GamePhase::Roll);
+
+    CHECK(game.playKnight(0) == ActionStatus::NoCard);
+    KnightCard knight;
+    game.getPlayers()[0]->addDevelopmentCard(&knight);
+    CHECK(game.playKnight(1) == ActionStatus::NotYourTurn);
+    CHECK(game.playKnight(0) == ActionStatus::Ok);
+    CHECK(game.getPhase() == GamePhase::MoveRobber);
+    CHECK(game.rollDice(0) == ActionStatus::WrongPhase);
+    CHECK(game.moveRobber(0, game.getBoard().getRobberTileIndex()) == ActionStatus::IllegalPlacement);
+
+    // the tile of the other seat's settlement at (0, 6) - the robber must rob it
+    const Vertex* victimVertex = game.getBoard().getVertex(0, 6);
+    int tileIndex = -1;
+    for(size_t index = 0; index < game.getBoard().getTiles().size(); ++index) {
+        const std::pmr::vector<Vertex*>& vertices = game.getBoard().getTiles()[index]->getVertices();
+        if(std::find(vertices.begin(), vertices.end(), victimVertex) != vertices.end()
+            && static_cast<int>(index) != game.getBoard().getRobberTileIndex()) tileIndex = static_cast<int>(index);
+    }
+    REQUIRE(tileIndex >= 0);
+    Player* victim = game.getPlayers()[1];
+    victim->addResources(TileType::Wool, 1);
+    int thiefBefore = game.getPlayers()[0]->getNumOfResources();
+    int victimBefore = victim->getNumOfResources();
+    CHECK(game.moveRobber(0, tileIndex, -1) == ActionStatus::IllegalPlacement);
+    CHECK(game.moveRobber(0, tileIndex, 0) == ActionStatus::IllegalPlacement);
+    CHECK(game.moveRobber(0, tileIndex, 1) == ActionStatus::Ok);
+    CHECK(game.getBoard().getRobberTileIndex() == tileIndex);
+    CHECK(victim->getNumOfResources() == victimBefore - 1);
+    CHECK(game.getPlayers()[0]->getNumOfResources() == thiefBefore + 1);
+
+    // back to the roll, and the knight is spent
+    CHECK(game.getPhase() == GamePhase::Roll);
+    CHECK(game.playKnight(0) == ActionStatus::NoCard);
+    game.getPlayers()[0]->removeDevelopmentCard(&knight);
+}
+
+TEST_CASE("Game bank trade at the seat's rates") {
+    Game game({"Player1"}, 3);
+    game.placeSettlement(0, 2, 4);
+    game.placeRoad(0, 2, 4, 2, 5);
+    game.placeSettlement(0, 3, 6);
+    game.placeRoad(0, 3, 6, 3, 7);
+    REQUIRE(game.rollDice(0) == ActionStatus::Ok);
+    if(game.getPhase() != GamePhase::Main) return;
+
+    Player* player = game.getPlayers()[0];
+    player->addResources(makeResourceVector(8, 0, 0, 0, 0));
+    ResourceVector before = player->getResourceVector();
+    CHECK(game.bankTrade(0, makeResourceVector(4, 0, 0, 0, 0), makeResourceVector(0, 0, 0, 0, 1)) == ActionStatus::Ok);
+    CHECK(player->getResourceVector() == before + makeResourceVector(-4, 0, 0, 0, 1));
+    CHECK(game.bankTrade(0, makeResourceVector(3, 0, 0, 0, 0), makeResourceVector(0, 0, 0, 0, 1)) == ActionStatus::InvalidTrade);
+    CHECK(game.bankTrade(0, makeResourceVector(4, 0, 0, 0, 0), makeResourceVector(0, 1, 0, 0, 1)) == ActionStatus::InvalidTrade);
+    CHECK(game.bankTrade(0, makeResourceVector(40, 0, 0, 0, 0), makeResourceVector(0, 0, 0, 0, 10)) == ActionStatus::NotEnoughResources);
+}
+
+TEST_CASE("Game plays monopoly and year of plenty cards") {
+    Game game({"Player1", "Player2"}, 1);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(1, 0, 6);
+    game.placeRoad(1, 0, 6, 0, 7);
+    game.placeSettlement(1, 2, 2);
+    game.placeRoad(1, 2, 2, 2, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    REQUIRE(game.rollDice(0) == ActionStatus::Ok);
+    if(game.getPhase() != GamePhase::Main) return;
+
+    Player* player = game.getPlayers()[0];
+    Player* other = game.getPlayers()[1];
+    CHECK(game.playMonopoly(0, TileType::Wool) == ActionStatus::NoCard);
+    MonopolyCard monopoly;
+    YearOfPlentyCard plenty;
+    player->addDevelopmentCard(&monopoly);
+    player->addDevelopmentCard(&plenty);
+
+    // every Wool of the other seat, undone back to the same state
+    other->addResources(TileType::Wool, 3);
+    ResourceVector before = player->getResourceVector();
+    int otherWool = other->getResourceVector()[TileType::Wool];
+    uint64_t hashBefore = game.stateHash();
+    UndoRecord record;
+    CHECK(game.apply(makeAction(ActionOpcode::PlayMonopoly, 0, static_cast<int>(TileType::Wool)), record) == ActionStatus::Ok);
+    CHECK(other->getResourceVector()[TileType::Wool] == 0);
+    CHECK(player->getResourceVector()[TileType::Wool] == before[TileType::Wool] + otherWool);
+    CHECK(game.playMonopoly(0, TileType::Wool) == ActionStatus::NoCard);
+    CHECK(game.getPhase() == GamePhase::Main);
+    game.undo(record);
+    CHECK(game.stateHash() == hashBefore);
+    CHECK(other->getResourceVector()[TileType::Wool] == otherWool);
+
+    CHECK(game.playYearOfPlenty(1, makeResourceVector(1, 0, 0, 0, 1)) == ActionStatus::NotYourTurn);
+    CHECK(game.playYearOfPlenty(0, makeResourceVector(1, 0, 0, 0, 0)) == ActionStatus::MalformedAction);
+    CHECK(game.playYearOfPlenty(0, makeResourceVector(1, 0, 0, 0, 1)) == ActionStatus::Ok);
+    CHECK(player->getResourceVector() == before + makeResourceVector(1, 0, 0, 0, 1));
+    CHECK(game.playYearOfPlenty(0, makeResourceVector(1, 0, 0, 0, 1)) == ActionStatus::NoCard);
+    player->removeDevelopmentCard(&monopoly);
+    player->removeDevelopmentCard(&plenty);
+}
+
+TEST_CASE("Game road building places two roads without paying") {
+    Game game({"Player1", "Player2"}, 1);
+    game.placeSettlement(0, 0, 2);
+    game.placeRoad(0, 0, 2, 0, 3);
+    game.placeSettlement(1, 0, 6);
+    game.placeRoad(1, 0, 6, 0, 7);
+    game.placeSettlement(1, 2, 2);
+    game.placeRoad(1, 2, 2, 2, 3);
+    game.placeSettlement(0, 2, 8);
+    game.placeRoad(0, 2, 8, 2, 9);
+    REQUIRE(game.rollDice(0) == ActionStatus::Ok);
+    if(game.getPhase() != GamePhase::Main) return;
+
+    Player* player = game.getPlayers()[0];
+    player->addResources(-player->getResourceVector());
+    CHECK(game.playRoadBuilding(0) == ActionStatus::NoCard);
+    RoadCard roadBuilding;
+    player->addDevelopmentCard(&roadBuilding);
+    CHECK(game.playRoadBuilding(1) == ActionStatus::NotYourTurn);
+
+    // applied, a free road built with it, and both undone back to the same state
+    catan_game::LegalActionList legalActions;
+    const std::vector<Action>& legal = legalActions.collect(game, 0);
+    CHECK(std::count_if(legal.begin(), legal.end(), [](const Action& action) { return action.opcode == ActionOpcode::PlayRoadBuilding; }) == 1);
+    uint64_t hashBefore = game.stateHash();
+    UndoRecord cardRecord, roadRecord;
+    REQUIRE(game.apply(makeAction(ActionOpcode::PlayRoadBuilding, 0), cardRecord) == ActionStatus::Ok);
+    uint64_t hashPlayed = game.stateHash();
+    CHECK(hashPlayed != hashBefore);
+    const std::vector<Action>& free = legalActions.collect(game, 0);
+    auto road = std::find_if(free.begin(), free.end(), [](const Action& action) { return action.opcode == ActionOpcode::BuildRoad; });
+    REQUIRE(road != free.end());
+    REQUIRE(game.apply(*road, roadRecord) == ActionStatus::Ok);
+    CHECK(game.getFreeRoads() == catan_game::ROAD_BUILDING_ROADS - 1);
+    game.undo(roadRecord);
+    CHECK(game.stateHash() == hashPlayed);
+    game.undo(cardRecord);
+    CHECK(game.stateHash() == hashBefore);
+    CHECK(game.getFreeRoads() == 0);
+
+    CHECK(game.playRoadBuilding(0) == ActionStatus::Ok);
+    CHECK(game.getFreeRoads() == catan_game::ROAD_BUILDING_ROADS);
+    CHECK(game.playRoadBuilding(0) == ActionStatus::NoCard);
+
+    // any edge the seat may build on, the free roads don't touch the empty hand
+    auto buildAnyRoad = [&game]() {
+        for(const Edge* edge: game.getBoard().getEdges()) {
+            const Vertex* from = edge->getVertices().first;
+            const Vertex* to = edge->getVertices().second;
+            if(game.placeRoad(0, from->getRow(), from->getColumn(), to->getRow(), to->getColumn()) == ActionStatus::Ok) return true;
+        }
+        return false;
+    };
+    size_t roads = player->getMyRoads().size();
+    CHECK(buildAnyRoad());
+    CHECK(buildAnyRoad());
+    CHECK(player->getMyRoads().size() == roads + 2);
+    CHECK(player->getNumOfResources() == 0);
+    CHECK(game.getFreeRoads() == 0);
+    CHECK_FALSE(buildAnyRoad());
+    player->removeDevelopmentCard(&roadBuilding);
+}
+
+TEST_CASE("Agent plugin plays a seeded game through the C ABI") {
+    Game setup({"Player1", "Player2"}, 1);
+    catan_game::LegalActionList legalActions;
+    const std::vector<Action>& legal = legalActions.collect(setup, 0);
+    CHECK(legal.size() == setup.getBoard().getOpenVertices().count());
+    for(const Action& action: legal) CHECK(action.opcode == ActionOpcode::BuildSettlement);
+
+    catan_game::AgentPlugin loaded("./catan_random_agent.so");
+    CHECK(CATAN_AGENT_ABI_MAJOR_OF(loaded.getApi().abiVersion) == CATAN_AGENT_ABI_MAJOR);
+    CHECK(loaded.getApi().apiSize == sizeof(CatanAgentApi));
+    catan_game::AgentFactory plugin = catan_game::makeAgentFactory("./catan_random_agent.so");
+    CHECK(plugin.name == "random");
+    catan_game::SimulationRunner runner(2, 150, {plugin, catan_game::makeAgentFactory("builder")});
+    catan_game::SimulatedGame first = runner.play(7);
+    catan_game::SimulatedGame again = runner.play(7);
+    CHECK(first.turnHashes.size() > 10);
+    CHECK(first.turnHashes == again.turnHashes);
+
+    CHECK_THROWS_AS(catan_game::makeAgentFactory("./no_such_agent.so"), std::runtime_error);
+    CHECK_THROWS_AS(catan_game::makeAgentFactory("nobody"), std::invalid_argument);
+}
+
+TEST_CASE("Simulation replays every seed identically") {
+    catan_game::SimulationRunner runner(3, 120);
+    catan_game::SimulatedGame first = runner.play(3);
+    catan_game::SimulatedGame again = runner.play(3);
+    CHECK(first.turnHashes.size() > 10);
+    CHECK(first.turnHashes == again.turnHashes);
+    CHECK(first.winner == again.winner);
+    CHECK(runner.play(4).turnHashes != first.turnHashes);
+
+    std::vector<unsigned> seeds = {1, 2, 3, 4, 5, 6};
+    CHECK(runner.verifyDeterminism(seeds).empty());
+    std::vector<catan_game::SimulatedGame> games = runner.playAll(seeds, 3);
+    REQUIRE(games.size() == seeds.size());
+    CHECK(games[2].turnHashes == first.turnHashes);
+}
+
+TEST_CASE("Heuristic agent plays legal moves without allocating") {
+    Game game({"Player1", "Player2", "Player3"}, 11);
+    GreedyDiscardPolicy greedy;
+    catan_game::HeuristicAgent agents[3];
+    for(size_t seat = 0; seat < 3; ++seat) {
+        game.setDiscardPolicy(seat, &greedy);
+        agents[seat].startGame(game, seat, 11);
+    }
+
+    // every decision is legal, and once the first turns sized the scratch no decision allocates
+    catan_game::UndoRecord record;
+    size_t numOfTurns = 0, allocated = 0, numOfDecisions = 0;
+    while(game.getPhase() != GamePhase::Finished && numOfTurns < 300) {
+        size_t seat = game.getCurrentSeat();
+        size_t before = numOfAllocations;
+        catan_game::Action action = agents[seat].decide(game, seat);
+        if(numOfTurns >= 10) {
+            allocated += numOfAllocations - before;
+            ++numOfDecisions;
+        }
+        REQUIRE(game.apply(action, record) == ActionStatus::Ok);
+        if(action.opcode == catan_game::ActionOpcode::EndTurn) ++numOfTurns;
+    }
+    CHECK(numOfDecisions > 100);
+    CHECK(allocated == 0);
+    CHECK(game.getPhase() == GamePhase::Finished);
+
+    // the same seed plays the same game
+    catan_game::AgentFactory heuristic = catan_game::makeAgentFactory("heuristic");
+    catan_game::SimulationRunner runner(3, 300, {heuristic});
+    CHECK(runner.play(11).turnHashes == runner.play(11).turnHashes);
+}
+
+TEST_CASE("Game archive appends games and maps them back") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "catan_tests_archive";
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".actions");
+    std::filesystem::remove(path.string() + ".lookup");
+    catan_game::SimulationRunner runner(3, 150);
+    std::vector<unsigned> firstSeeds = {1, 2, 3}, laterSeeds = {4, 5};
+    {
+        catan_game::GameArchiveWriter writer(path.string());
+        runner.playAll(firstSeeds, 2, &writer);
+    }
+    {
+        catan_game::GameArchiveWriter writer(path.string()); // an existing archive is extended
+        CHECK(writer.getNumOfGames() == 3);
+        runner.playAll(laterSeeds, 1, &writer);
+        CHECK(writer.getNumOfGames() == 5);
+    }
+
+    catan_game::GameArchiveReader archive(path.string());
+    REQUIRE(archive.size() == 5);
+    for(unsigned seed = 1; seed <= 5; ++seed) {
+        const catan_game::ArchivedGame* archived = archive.findSeed(seed);
+        REQUIRE(archived != nullptr);
+        catan_game::SimulatedGame played = runner.play(seed);
+        CHECK(archived->winner == played.winner);
+        CHECK(archived->numOfTurns == played.turnHashes.size());
+        CHECK(archived->numOfSeats == 3);
+        CHECK(archived->points[0] == played.points[0]);
+        REQUIRE(archived->numOfActions == played.actions.size());
+
+        // the stream replays the game - the rolls only carry the dice sum
+        Game replay({"Bot 1", "Bot 2", "Bot 3"}, seed);
+        catan_game::UndoRecord record;
+        catan_game::Action action;
+        for(size_t index = 0; archive.getAction(*archived, index, action); ++index) {
+            CHECK(action.opcode == played.actions[index].opcode);
+            if(action.opcode == catan_game::ActionOpcode::RollDice) action.target = 0;
+            REQUIRE(replay.apply(action, record) == ActionStatus::Ok);
+        }
+        CHECK(replay.stateHash() == archived->finalHash);
+    }
+    CHECK(archive.findSeed(6) == nullptr);
+
+    // the lookup written when the writer closed buckets every game once, in the archive's order
+    CHECK(std::filesystem::exists(path.string() + ".lookup"));
+    auto checkLookup = [](const catan_game::GameArchiveReader& reader) {
+        std::span<const catan_game::ArchivedGame> games = reader.getGames();
+        size_t numOfWon = 0, numOfBucketed = 0;
+        for(int winner = -1; winner < static_cast<int>(catan_game::ARCHIVE_MAX_SEATS); ++winner) {
+            std::span<const uint32_t> won = reader.getGamesWonBy(winner);
+            CHECK(std::is_sorted(won.begin(), won.end()));
+            for(uint32_t game: won) CHECK(games[game].winner == winner);
+            numOfWon += won.size();
+        }
+        for(size_t bucket = 0; bucket < catan_game::ARCHIVE_NUM_TURN_BUCKETS; ++bucket) {
+            for(uint32_t game: reader.getGamesOfTurnBucket(bucket)) CHECK(catan_game::archiveTurnBucket(games[game].numOfTurns) == bucket);
+            numOfBucketed += reader.getGamesOfTurnBucket(bucket).size();
+        }
+        CHECK(numOfWon == games.size());
+        CHECK(numOfBucketed == games.size());
+        CHECK(reader.getGamesWonBy(-2).empty());
+        CHECK(reader.getGamesOfTurnBucket(catan_game::ARCHIVE_NUM_TURN_BUCKETS).empty());
+    };
+    checkLookup(archive);
+    CHECK(catan_game::archiveTurnBucket(catan_game::ARCHIVE_TURN_BUCKET_WIDTH) == 1);
+    CHECK(catan_game::archiveTurnBucket(60000) == catan_game::ARCHIVE_NUM_TURN_BUCKETS - 1);
+
+    // without its file, or with a stale one, the reader rebuilds the same lookup
+    std::filesystem::copy_file(path.string() + ".lookup", path.string() + ".stale");
+    {
+        catan_game::GameArchiveWriter writer(path.string());
+        runner.playAll(std::vector<unsigned>{2}, 1, &writer);
+    }
+    std::filesystem::rename(path.string() + ".stale", path.string() + ".lookup");
+    catan_game::GameArchiveReader stale(path.string());
+    REQUIRE(stale.size() == 6);
+    checkLookup(stale);
+    auto firstOfSeed = std::find_if(stale.getGames().begin(), stale.getGames().end(), [](const catan_game::ArchivedGame& game) { return game.seed == 2; });
+    CHECK(stale.findSeed(2) == &*firstOfSeed); // the first game of a repeated seed
+    std::filesystem::remove(path.string() + ".lookup");
+    catan_game::GameArchiveReader rebuilt(path.string());
+    checkLookup(rebuilt);
+    CHECK(rebuilt.findSeed(5) == &rebuilt.getGames()[4]);
+    CHECK(rebuilt.findSeed(6) == nullptr);
+
+    // a torn append past the count is not part of the archive
+    std::ofstream(path, std::ios::binary | std::ios::app) << "torn record";
+    CHECK(catan_game::GameArchiveReader(path.string()).size() == 6);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not an archive at all";
+    CHECK_THROWS_AS(catan_game::GameArchiveReader(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".actions");
+    std::filesystem::remove(path.string() + ".lookup");
+}
+
+TEST_CASE("Turn statistics are written as compressed columns") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "catan_tests_turns";
+    catan_game::SimulationRunner runner(3, 150);
+    std::vector<unsigned> seeds = {1, 2, 3};
+    std::vector<catan_game::SimulatedGame> played = runner.playAll(seeds, 1);
+    size_t numOfRows = 0;
+    for(const catan_game::SimulatedGame& game: played) {
+        CHECK(game.turnRows.size() == 3 * game.turnHashes.size());
+        numOfRows += game.turnRows.size();
+    }
+    {
+        catan_game::TurnStatsWriter writer(path.string(), true, 100); // several chunks, the last one short
+        std::vector<catan_game::SimulatedGame> games = runner.playAll(seeds, 1, nullptr, &writer);
+        CHECK(games[0].turnRows.empty());
+        CHECK(writer.getNumOfRows() == numOfRows);
+    }
+    CHECK(std::filesystem::file_size(path) < numOfRows * 22); // a raw row is 22 bytes
+
+    // one thread writes the games in seed order, row for row
+    catan_game::TurnStatsReader reader(path.string());
+    std::array<std::vector<uint32_t>, catan_game::NUM_TURN_COLUMNS> columns;
+    size_t game = 0, row = 0, numOfChunks = 0;
+    while(reader.readChunk(columns)) {
+        ++numOfChunks;
+        for(size_t index = 0; index < columns[0].size(); ++index, ++row) {
+            if(row == played[game].turnRows.size()) {
+                ++game;
+                row = 0;
+            }
+            const catan_game::TurnStatsRow& expected = played[game].turnRows[row];
+            CHECK(columns[static_cast<size_t>(catan_game::TurnColumn::Seed)][index] == expected.seed);
+            CHECK(columns[static_cast<size_t>(catan_game::TurnColumn::Seat)][index] == expected.seat);
+            CHECK(columns[static_cast<size_t>(catan_game::TurnColumn::Roll)][index] == expected.roll);
+            CHECK(columns[static_cast<size_t>(catan_game::TurnColumn::Iron)][index] == expected.resources[4]);
+            CHECK(columns[static_cast<size_t>(catan_game::TurnColumn::Roads)][index] == expected.roads);
+        }
+    }
+    CHECK(numOfChunks == (numOfRows + 99) / 100);
+    CHECK(game == 2);
+    CHECK(row == played[2].turnRows.size());
+    // the last turn's points are the game's result
+    CHECK(played[0].turnRows.back().points == played[0].points[2]);
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not turn statistics";
+    CHECK_THROWS_AS(catan_game::TurnStatsReader(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Spectator feed keyframe and deltas follow the game") {
+    Game game({"Bot 1", "Bot 2", "Bot 3"}, 4);
+    std::vector<std::unique_ptr<catan_game::Agent>> agents;
+    for(size_t seat = 0; seat < 3; ++seat) {
+        agents.push_back(catan_game::makeBuiltinAgent("builder"));
+        agents.back()->startGame(game, seat, 4);
+    }
+    catan_game::SpectatorFeed feed(game);
+    catan_game::SpectatorState watcher, lateWatcher;
+    REQUIRE(catan_game::applySpectatorMessage(feed.getKeyframe(), watcher));
+    CHECK(watcher.points.size() == 3);
+    CHECK(watcher.tiles.size() == game.getBoard().getTiles().size());
+
+    catan_game::UndoRecord record;
+    size_t numOfDeltas = 0, deltaBytes = 0;
+    for(size_t step = 0; step < 2000 && game.getPhase() != GamePhase::Finished; ++step) {
+        size_t seat = game.getCurrentSeat();
+        while(game.getPhase() == GamePhase::Discard && game.getPendingDiscard(seat) == 0) seat = (seat + 1) % 3;
+        catan_game::Action action = agents[seat]->decide(game, seat);
+        REQUIRE(game.apply(action, record) == ActionStatus::Ok);
+        if(feed.update(game)) {
+            ++numOfDeltas;
+            deltaBytes += feed.getDelta().size();
+            REQUIRE(catan_game::applySpectatorMessage(feed.getDelta(), watcher));
+            if(step >= 500) REQUIRE(catan_game::applySpectatorMessage(feed.getDelta(), lateWatcher));
+        }
+        if(step == 499) {
+            // one keyframe for every watcher joining between two actions
+            const std::string& keyframe = feed.getKeyframe();
+            CHECK(&feed.getKeyframe() == &keyframe);
+            REQUIRE(catan_game::applySpectatorMessage(keyframe, lateWatcher));
+            CHECK(lateWatcher == watcher);
+        }
+    }
+    CHECK(numOfDeltas > 100);
+    CHECK(deltaBytes / numOfDeltas < 32);
+
+    // the deltas add up to the state a new keyframe shows
+    catan_game::SpectatorState fresh;
+    REQUIRE(catan_game::applySpectatorMessage(catan_game::SpectatorFeed(game).getKeyframe(), fresh));
+    fresh.sequence = feed.getSequence();
+    CHECK(watcher == fresh);
+    CHECK(lateWatcher == fresh);
+    CHECK(watcher.winner == game.getWinner());
+
+    // a delta that skips one is refused
+    CHECK_FALSE(catan_game::applySpectatorMessage(feed.getDelta(), watcher));
+    CHECK_FALSE(catan_game::applySpectatorMessage(std::string("D\0\0"), watcher));
+}
+
+// A client of a GameServer that runs on the test's thread
+static int connectToServer(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    return fd;
+}
+
+// Sends the lines, lets the server handle them and returns everything the client got back
+static std::string exchange(catan_game::GameServer& server, int fd, const std::string& lines) {
+    if(!lines.empty()) ::send(fd, lines.data(), lines.size(), MSG_NOSIGNAL);
+    std::string received;
+    for(int round = 0; round < 20; ++round) {
+        server.pollOnce(5);
+        char buffer[4096];
+        ssize_t numOfBytes;
+        while((numOfBytes = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) received.append(buffer, numOfBytes);
+    }
+    return received;
+}
+
+// The settlement and road of the seat's setup placement on a mirror of the server's game, as request lines
+static std::string setupPlacement(Game& mirror, size_t seat) {
+    catan_game::LegalActionList legal;
+    catan_game::UndoRecord record;
+    catan_game::Action settlement = legal.collect(mirror, seat).front();
+    REQUIRE(mirror.apply(settlement, record) == ActionStatus::Ok);
+    catan_game::Action road = legal.collect(mirror, seat).front();
+    REQUIRE(mirror.apply(road, record) == ActionStatus::Ok);
+    return catan_game::actionToString(settlement) + "\n" + catan_game::actionToString(road) + "\n";
+}
+
+// Gives up every decision, as a plugin may by contract
+class GivingUpAgent : public catan_game::Agent {
+public:
+    catan_game::Action choosePlacement(const Game& game, size_t seat) override {
+        return catan_game::makeAction(catan_game::ActionOpcode::None, seat);
+    }
+    catan_game::Action chooseAction(const Game& game, size_t seat) override {
+        return catan_game::makeAction(catan_game::ActionOpcode::None, seat);
+    }
+    catan_game::ResourceVector chooseDiscard(const Game& game, size_t seat, int numOfCards) override {
+        return catan_game::makeResourceVector(0, 0, 0, 0, 0);
+    }
+};
+
+TEST_CASE("Server plays a legal fallback for a bot that gives up") {
+    std::string path = (std::filesystem::temp_directory_path() / "catan_tests_quitter.sock").string();
+    catan_game::AgentFactory quitter{"quitter", []() { return std::make_unique<GivingUpAgent>(); }};
+    catan_game::GameServer server(path, 2, 7, {quitter});
+    int fd = connectToServer(path);
+    CHECK(exchange(server, fd, "JOIN ann\n").find("TURN 0 SetupSettlement") != std::string::npos);
+
+    // the bot's two setup placements and then its turns are the fallbacks, the table never waits on it
+    Game mirror({"ann", "quitter"}, 7);
+    std::string received = exchange(server, fd, setupPlacement(mirror, 0));
+    CHECK(received.find("DID 1 SETTLE") != std::string::npos);
+    CHECK(received.find("TURN 0 SetupSettlement") != std::string::npos);
+    setupPlacement(mirror, 1); // the fallback is the first legal placement, the mirror plays it too
+    setupPlacement(mirror, 1);
+    CHECK(exchange(server, fd, setupPlacement(mirror, 0)).find("TURN 0 Roll") != std::string::npos);
+    for(int turn = 0; turn < 4; ++turn) {
+        received = exchange(server, fd, "END\n");
+        CHECK(received.find("ROLLED 1") != std::string::npos);
+        CHECK(received.find("TURN 0 Roll") != std::string::npos);
+    }
+    ::close(fd);
+    server.pollOnce(5);
+}
+
+class BrokenAgent : public GivingUpAgent {
+public:
+    catan_game::Action choosePlacement(const Game& game, size_t seat) override {
+        throw std::runtime_error("broken agent");
+    }
+};
+
+TEST_CASE("Server closes a table whose game fails") {
+    std::string path = (std::filesystem::temp_directory_path() / "catan_tests_broken.sock").string();
+    catan_game::AgentFactory broken{"broken", []() { return std::make_unique<BrokenAgent>(); }};
+    catan_game::GameServer server(path, 2, 7, {broken});
+    int fd = connectToServer(path);
+    exchange(server, fd, "JOIN ann\n");
+    REQUIRE(server.getNumOfTables() == 1);
+
+    // the bot's turn throws - the table goes with everybody at it, the server keeps serving
+    Game mirror({"ann", "broken"}, 7);
+    exchange(server, fd, setupPlacement(mirror, 0));
+    CHECK(server.getNumOfTables() == 0);
+    CHECK(server.getNumOfConnections() == 0);
+    char byte;
+    CHECK(::recv(fd, &byte, 1, MSG_DONTWAIT) == 0);
+    ::close(fd);
+
+    int again = connectToServer(path);
+    CHECK(exchange(server, again, "JOIN bob\n").find("OK SEAT") != std::string::npos);
+    ::close(again);
+    server.pollOnce(5);
+}
+
+TEST_CASE("Server hands the seat of a player who left to a bot") {
+    std::string path = (std::filesystem::temp_directory_path() / "catan_tests_left.sock").string();
+    catan_game::GameServer server(path, 2, 7);
+    int ann = connectToServer(path), bob = connectToServer(path);
+    exchange(server, ann, "JOIN ann\n");
+    CHECK(exchange(server, bob, "JOIN bob\n").find("TURN 0 SetupSettlement") != std::string::npos);
+
+    // the game now waits on bob, who leaves
+    Game mirror({"ann", "bob"}, 7);
+    CHECK(exchange(server, ann, setupPlacement(mirror, 0)).find("TURN 1 SetupSettlement") != std::string::npos);
+    ::close(bob);
+    std::string received = exchange(server, ann, "");
+    CHECK(received.find("LEFT 1") != std::string::npos);
+    CHECK(received.find("DID 1 SETTLE") != std::string::npos);
+    CHECK(received.find("TURN 0 SetupSettlement") != std::string::npos);
+    CHECK(server.getNumOfTables() == 1);
+
+    // the table closes with its last player
+    ::close(ann);
+    exchange(server, -1, "");
+    CHECK(server.getNumOfTables() == 0);
+}
+
+TEST_CASE("Rating table ranks the entrants by their wins") {
+    catan_game::RatingTable ratings(3);
+    std::vector<size_t> seats = {0, 1, 2};
+    for(int game = 0; game < 100; ++game) {
+        ratings.addGame(seats, game < 60 ? 0 : (game < 90 ? 1 : 2));
+    }
+    std::vector<catan_game::EntrantRating> first = ratings.compute();
+    CHECK(first[0].elo > first[1].elo);
+    CHECK(first[1].elo > first[2].elo);
+    CHECK(first[0].elo + first[1].elo + first[2].elo == doctest::Approx(0).epsilon(1e-6));
+    CHECK(first[0].wins == 60);
+    CHECK(first[2].games == 100);
+
+    for(int game = 0; game < 100; ++game) {
+        ratings.addGame(seats, game < 60 ? 0 : (game < 90 ? 1 : 2));
+    }
+    ratings.addGame(seats, -1); // unfinished - a game for everybody, a win for nobody
+    std::vector<catan_game::EntrantRating> second = ratings.compute();
+    CHECK(second[0].margin < first[0].margin);
+    CHECK(second[0].games == 201);
+    CHECK(second[0].wins == 120);
+    CHECK(ratings.getTotalGames() == 201);
+
+    catan_game::RatingTable unbeaten(2);
+    std::vector<size_t> pair = {1, 0};
+    for(int game = 0; game < 10; ++game) unbeaten.addGame(pair, 0);
+    std::vector<catan_game::EntrantRating> rated = unbeaten.compute();
+    CHECK(std::isfinite(rated[1].elo));
+    CHECK(rated[1].elo > 0);
+}
+
+TEST_CASE("A forfeit loses to every other seat, a turn limit stop is a draw") {
+    catan_game::AgentFactory builder = catan_game::makeAgentFactory("builder");
+    catan_game::AgentFactory quitter{"quitter", []() { return std::make_unique<GivingUpAgent>(); }};
+    catan_game::SimulatedGame forfeited = catan_game::SimulationRunner(3, 150, {builder, quitter, builder}).play(3);
+    CHECK(forfeited.winner == -1);
+    CHECK(forfeited.forfeitSeat == 1);
+    catan_game::SimulatedGame stopped = catan_game::SimulationRunner(3, 5, {builder}).play(3);
+    CHECK(stopped.winner == -1);
+    CHECK(stopped.forfeitSeat == -1);
+
+    catan_game::RatingTable ratings(3);
+    std::vector<size_t> seats = {0, 1, 2};
+    for(int game = 0; game < 20; ++game) ratings.addGame(seats, stopped.winner, stopped.forfeitSeat);
+    std::vector<catan_game::EntrantRating> drawn = ratings.compute();
+    CHECK(drawn[1].elo == doctest::Approx(0).epsilon(1e-6));
+    for(int game = 0; game < 20; ++game) ratings.addGame(seats, forfeited.winner, forfeited.forfeitSeat);
+    std::vector<catan_game::EntrantRating> rated = ratings.compute();
+    CHECK(rated[1].elo < -100);
+    CHECK(rated[0].elo == doctest::Approx(rated[2].elo));
+    CHECK(rated[1].wins == 0);
+
+    catan_game::TournamentOptions options;
+    options.turnLimit = 150;
+    options.numOfThreads = 1;
+    catan_game::Tournament tournament({builder, quitter, catan_game::makeAgentFactory("expander")}, options);
+    tournament.run();
+    CHECK(tournament.getNumOfForfeits() == 3);
+    CHECK(tournament.getNumOfUnfinished() == 0);
+    CHECK(tournament.getRatings().compute()[1].elo < tournament.getRatings().compute()[0].elo);
+}
+
+TEST_CASE("Tournament rotates the seats and rates the same on any thread count") {
+    std::vector<catan_game::AgentFactory> entrants;
+    for(std::string name: {"builder", "expander", "carder"}) {
+        entrants.push_back({name, [name]() { return catan_game::makeBuiltinAgent(name); }});
+    }
+    catan_game::TournamentOptions options;
+    options.rounds = 2;
+    options.turnLimit = 150;
+    options.numOfThreads = 1;
+    options.reportEvery = 2;
+    catan_game::Tournament single(entrants, options);
+    size_t numOfReports = 0;
+    single.run([&numOfReports](const catan_game::RatingTable&) { ++numOfReports; });
+    CHECK(single.getRatings().getTotalGames() == 6); // one group, 3 rotations, 2 rounds
+    CHECK(numOfReports == 3);
+
+    options.numOfThreads = 3;
+    catan_game::Tournament parallel(entrants, options);
+    parallel.run();
+    std::vector<catan_game::EntrantRating> first = single.getRatings().compute();
+    std::vector<catan_game::EntrantRating> second = parallel.getRatings().compute();
+    for(size_t entrant = 0; entrant < entrants.size(); ++entrant) {
+        CHECK(first[entrant].games == 6);
+        CHECK(first[entrant].elo == second[entrant].elo);
+        CHECK(first[entrant].wins == second[entrant].wins);
+    }
+
+    entrants.push_back({"passive", []() { return catan_game::makeBuiltinAgent("passive"); }});
+    options.pairing = catan_game::PairingMode::Swiss;
+    options.seatsPerGame = 2;
+    catan_game::Tournament swiss(entrants, options);
+    swiss.run();
+    CHECK(swiss.getRatings().getTotalGames() == 8); // two pairs a round, both ways
+    options.seatsPerGame = 5;
+    CHECK_THROWS_AS(catan_game::Tournament(entrants, options), std::invalid_argument);
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AgentPlugin.hpp"
+#include "LadderAgent.hpp"
+#include "Tournament.hpp"
+
+using catan_game::AgentFactory;
+using catan_game::EntrantRating;
+using catan_game::RatingTable;
+using catan_game::Tournament;
+using catan_game::TournamentOptions;
+
+static void printRatings(const std::vector<AgentFactory>& entrants, const RatingTable& ratings)
+{
+    std::vector<EntrantRating> current = ratings.compute();
+    std::vector<size_t> order(entrants.size());
+    for(size_t index = 0; index < order.size(); ++index) order[index] = index;
+    std::stable_sort(order.begin(), order.end(), [&current](size_t first, size_t second) {
+        return current[first].elo > current[second].elo;
+    });
+
+    std::cout<<"After "<<ratings.getTotalGames()<<" games"<<std::endl;
+    for(size_t index: order)
+    {
+        std::cout<<"  "<<std::left<<std::setw(12)<<entrants[index].name<<std::right<<std::fixed<<std::setprecision(0)
+                 <<std::setw(6)<<current[index].elo<<" +- "<<std::setw(4)<<current[index].margin
+                 <<"  won "<<current[index].wins<<" of "<<current[index].games<<std::endl;
+    }
+}
+
+// Usage: catan_tournament [--swiss] [--rounds N] [--seats K] [--seed S] [--threads T] [--report N] [bot ...]
+// Plays the bots (every built-in one by default, a path to a .so loads an agent plugin) against each other and prints their ratings
+// every N games and at the end.
+int main(int argc, char* argv[])
+{
+    TournamentOptions options;
+    options.rounds = 10;
+    options.reportEvery = 1000;
+    std::vector<std::string> names;
+    for(int index = 1; index < argc; ++index)
+    {
+        std::string argument = argv[index];
+        bool hasValue = index + 1 < argc;
+        if(argument == "--swiss") options.pairing = catan_game::PairingMode::Swiss;
+        else if(argument == "--rounds" && hasValue) options.rounds = std::strtoul(argv[++index], nullptr, 10);
+        else if(argument == "--seats" && hasValue) options.seatsPerGame = std::strtoul(argv[++index], nullptr, 10);
+        else if(argument == "--seed" && hasValue) options.firstSeed = static_cast<unsigned>(std::strtoul(argv[++index], nullptr, 10));
+        else if(argument == "--threads" && hasValue) options.numOfThreads = static_cast<unsigned>(std::strtoul(argv[++index], nullptr, 10));
+        else if(argument == "--report" && hasValue) options.reportEvery = std::strtoul(argv[++index], nullptr, 10);
+        else if(argument.rfind("--", 0) == 0)
+        {
+            std::cerr<<"Usage: "<<argv[0]<<" [--swiss] [--rounds N] [--seats K] [--seed S] [--threads T] [--report N] [bot ...]"<<std::endl;
+            return 1;
+        }
+        else names.push_back(argument);
+    }
+    if(names.empty()) names = catan_game::builtinAgentNames();
+
+    std::vector<AgentFactory> entrants;
+    try
+    {
+        for(const std::string& name: names)
+        {
+            entrants.push_back(catan_game::makeAgentFactory(name));
+        }
+        Tournament tournament(entrants, options);
+        tournament.run([&entrants](const RatingTable& ratings) { printRatings(entrants, ratings); });
+        if(options.reportEvery == 0 || tournament.getRatings().getTotalGames() % options.reportEvery != 0)
+        {
+            printRatings(entrants, tournament.getRatings());
+        }
+        std::cout<<"Unfinished games "<<tournament.getNumOfUnfinished()<<", forfeits "<<tournament.getNumOfForfeits()<<std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr<<"Tournament error: "<<e.what()<<std::endl;
+        return 1;
+    }
+    return 0;
+}